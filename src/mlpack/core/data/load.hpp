@@ -21,6 +21,7 @@
 #include "format.hpp"
 #include "dataset_mapper.hpp"
 #include "image_info.hpp"
+#include "mapped_matrix.hpp"
 
 namespace mlpack {
 namespace data /** Functions to load and save matrices and models. */ {
@@ -42,6 +43,10 @@ namespace data /** Functions to load and save matrices and models. */ {
  *  - Armadillo binary (arma_binary), denoted by .bin
  *  - HDF5, denoted by .hdf, .hdf5, .h5, or .he5
  *
+ * In addition, mlpack mapped binary files (see MappedMatrix), denoted by .mmb,
+ * are supported.  These hold the matrix exactly as it is stored in memory, so
+ * they are never transposed, regardless of the 'transpose' parameter.
+ *
  * If the file extension is not one of those types, an error will be given.
  * This is preferable to Armadillo's default behavior of loading an unknown
  * filetype as raw_binary, which can have very confusing effects.
@@ -65,6 +70,25 @@ bool Load(const std::string& filename,
           const bool fatal = false,
           const bool transpose = true);
 
+/**
+ * Map a matrix stored in an mlpack mapped binary file (denoted by .mmb) into
+ * memory, instead of reading it.  The matrix is then available through
+ * matrix.Matrix(), and uses the mapped memory directly; see MappedMatrix for
+ * details.  Files in this format can be written with data::Save().
+ *
+ * If the parameter 'fatal' is set to true, a std::runtime_error exception will
+ * be thrown if the matrix can't be mapped.
+ *
+ * @param filename Name of file to map.
+ * @param matrix MappedMatrix to map the file with.
+ * @param fatal If an error should be reported as fatal (default false).
+ * @return Boolean value indicating success or failure of the mapping.
+ */
+template<typename eT>
+bool Load(const std::string& filename,
+          MappedMatrix<eT>& matrix,
+          const bool fatal = false);
+
 /**
  * Don't document these with doxygen; these declarations aren't helpful to
  * users.
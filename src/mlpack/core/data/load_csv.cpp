@@ -3,7 +3,7 @@
  * @author Tham Ngap Wei
  * @author Mehul Kumar Nirala
  *
- * A CSV reader that uses boost::spirit.
+ * A parallel CSV reader.
  *
  * mlpack is free software; you may redistribute it and/or modify it under the
  * terms of the 3-clause BSD license.  You should have received a copy of the
@@ -12,7 +12,15 @@
  */
 #include "load_csv.hpp"
 
-using namespace boost::spirit;
+#include <algorithm>
+#include <cstdlib>
+
+#ifndef _WIN32
+  #include <fcntl.h>
+  #include <sys/mman.h>
+  #include <sys/stat.h>
+  #include <unistd.h>
+#endif
 
 namespace mlpack {
 namespace data {
@@ -20,67 +28,221 @@ namespace data {
 LoadCSV::LoadCSV(const std::string& file) :
   extension(Extension(file)),
   filename(file),
-  inFile(file)
+  inFile(file, std::ios::binary),
+  contents(NULL),
+  contentsSize(0),
+  mapping(NULL)
 {
   // Attempt to open stream.
   CheckOpen();
 
-  //! Spirit rule for parsing quoted string.
-  boost::spirit::qi::rule<std::string::iterator, iter_type()> quotedRule;
-  // Match quoted strings as: "string" or 'string'
-  quotedRule = qi::raw[(qi::char_("'") >> *((qi::char_ - "'") |
-                               "'" >> qi::char_("'")) >> "'") |
-                       (qi::char_('"') >> *((qi::char_ - '"') |
-                               '"' >> qi::char_('"')) >> '"') ];
-
-  // Set rules.
   if (extension == "csv")
+    delimiter = ',';
+  else if (extension == "txt")
+    delimiter = ' ';
+  else // TSV.
+    delimiter = '\t';
+}
+
+LoadCSV::~LoadCSV()
+{
+  ReleaseFile();
+}
+
+void LoadCSV::CheckOpen()
+{
+  if (!inFile.is_open())
   {
-    // Match all characters that are not ',', '\r', or '\n'.
-    stringRule = quotedRule.copy() | qi::raw[*~qi::char_(",\r\n")];
+    std::ostringstream oss;
+    oss << "Cannot open file '" << filename << "'. " << std::endl;
+    throw std::runtime_error(oss.str());
   }
-  else if (extension == "txt")
+
+  inFile.unsetf(std::ios::skipws);
+}
+
+void LoadCSV::ReadFile()
+{
+  if (contents != NULL)
+    return;
+
+  inFile.clear();
+  inFile.seekg(0, std::ios::end);
+  const std::streampos end = inFile.tellg();
+  inFile.seekg(0, std::ios::beg);
+  contentsSize = (end > 0) ? (size_t) end : 0;
+
+#ifndef _WIN32
+  // Map the file instead of reading it, so that the contents of a large file
+  // don't need as much memory again as the matrix it is parsed into.  The
+  // operating system can drop the pages that have been parsed.  (An empty file
+  // can't be mapped.)
+  if (contentsSize > 0)
   {
-    // Match all characters that are not ' ', ',', '\r', or '\n'.
-    stringRule = quotedRule.copy() | qi::raw[*~qi::char_(" ,\r\n")];
+    const int fd = open(filename.c_str(), O_RDONLY);
+    if (fd != -1)
+    {
+      void* fileMapping = mmap(NULL, contentsSize, PROT_READ, MAP_PRIVATE, fd,
+          0);
+      close(fd);
+      if (fileMapping != MAP_FAILED)
+      {
+        mapping = fileMapping;
+        contents = (const char*) mapping;
+      }
+    }
   }
-  else // TSV.
+#endif
+
+  // Read the whole file at once if it couldn't be mapped.
+  if (mapping == NULL)
   {
-    // Match all characters that are not '\t', '\r', or '\n'.
-    stringRule = quotedRule.copy() | qi::raw[*~qi::char_("\t\r\n")];
+    buffer.resize(contentsSize);
+    if (!buffer.empty() && !inFile.read(&buffer[0], buffer.size()))
+    {
+      std::ostringstream oss;
+      oss << "Cannot read file '" << filename << "'.";
+      throw std::runtime_error(oss.str());
+    }
+
+    contents = buffer.data();
   }
 
-  if (extension == "csv")
+  // Use several chunks per thread so that the work is balanced, but don't make
+  // the chunks smaller than 1MB.
+  #ifdef HAS_OPENMP
+  const size_t threads = omp_get_max_threads();
+  #else
+  const size_t threads = 1;
+  #endif
+  const size_t numChunks = std::max(std::min(8 * threads,
+      contentsSize / (1 << 20)), (size_t) 1);
+
+  // Move each boundary to the start of the next line.
+  chunkStarts.resize(numChunks + 1);
+  chunkStarts[0] = 0;
+  chunkStarts[numChunks] = contentsSize;
+  for (size_t i = 1; i < numChunks; ++i)
   {
-    // Extract a single comma as the delimiter, catching whitespace on either
-    // side.
-    delimiterRule = qi::raw[(*qi::char_(" ") >> qi::char_(",") >>
-        *qi::char_(" "))];
+    const size_t pos = std::max(i * (contentsSize / numChunks),
+        chunkStarts[i - 1]);
+    const char* newline = std::find(contents + pos, contents + contentsSize,
+        '\n');
+    chunkStarts[i] = (newline == contents + contentsSize) ? contentsSize :
+        (newline - contents) + 1;
   }
-  else if (extension == "txt")
+
+  // Count the lines of each chunk.  Only the last line of the file may not end
+  // with a newline.
+  chunkLines.resize(numChunks + 1);
+  chunkLines[0] = 0;
+  #pragma omp parallel for schedule(static)
+  for (omp_size_t i = 0; i < (omp_size_t) numChunks; ++i)
   {
-    // This one is a little more difficult, we need to catch any number of
-    // spaces more than one.
-    delimiterRule = qi::raw[+qi::char_(" ")];
+    const char* begin = contents + chunkStarts[i];
+    const char* end = contents + chunkStarts[i + 1];
+    size_t lines = std::count(begin, end, '\n');
+    if (begin != end && *(end - 1) != '\n')
+      ++lines;
+
+    chunkLines[i + 1] = lines;
   }
-  else // TSV.
+
+  for (size_t i = 0; i < numChunks; ++i)
+    chunkLines[i + 1] += chunkLines[i];
+}
+
+void LoadCSV::ReleaseFile()
+{
+#ifndef _WIN32
+  if (mapping != NULL)
+    munmap(mapping, contentsSize);
+#endif
+  mapping = NULL;
+
+  // Free the memory of the buffer too, not just its contents.
+  std::string().swap(buffer);
+  contents = NULL;
+  contentsSize = 0;
+}
+
+const char* LoadCSV::MatchDelimiter(const char* pos, const char* end) const
+{
+  if (delimiter == ' ')
   {
-    // Catch a tab character, possibly with whitespace on either side.
-    delimiterRule = qi::raw[(*qi::char_(" ") >> qi::char_("\t") >>
-        *qi::char_(" "))];
+    // Any positive number of spaces.
+    if (pos == end || *pos != ' ')
+      return NULL;
+
+    while (pos != end && *pos == ' ')
+      ++pos;
+    return pos;
   }
+
+  // A single delimiter, possibly with spaces on either side.
+  while (pos != end && *pos == ' ')
+    ++pos;
+  if (pos == end || *pos != delimiter)
+    return NULL;
+
+  ++pos;
+  while (pos != end && *pos == ' ')
+    ++pos;
+  return pos;
 }
 
-void LoadCSV::CheckOpen()
+const char* LoadCSV::MatchQuoted(const char* pos, const char* end)
 {
-  if (!inFile.is_open())
+  const char quote = *pos;
+  ++pos;
+  while (pos != end)
   {
-    std::ostringstream oss;
-    oss << "Cannot open file '" << filename << "'. " << std::endl;
-    throw std::runtime_error(oss.str());
+    if (*pos != quote)
+      ++pos;
+    else if (pos + 1 != end && *(pos + 1) == quote)
+      pos += 2; // An escaped quote.
+    else
+      return pos + 1;
   }
 
-  inFile.unsetf(std::ios::skipws);
+  return NULL;
+}
+
+void LoadCSV::Trim(const char*& begin, const char*& end)
+{
+  // These are the characters for which std::isspace() is true in the "C"
+  // locale.
+  auto isSpace = [](const char c)
+  {
+    return c == ' ' || c == '\t' || c == '\n' || c == '\v' || c == '\f' ||
+        c == '\r';
+  };
+
+  while (begin != end && isSpace(*begin))
+    ++begin;
+  while (end != begin && isSpace(*(end - 1)))
+    --end;
+}
+
+bool LoadCSV::ConvertNumber(const std::string& token, float& value)
+{
+  char* end;
+  value = std::strtof(token.c_str(), &end);
+  return !token.empty() && end == token.c_str() + token.size();
+}
+
+bool LoadCSV::ConvertNumber(const std::string& token, double& value)
+{
+  char* end;
+  value = std::strtod(token.c_str(), &end);
+  return !token.empty() && end == token.c_str() + token.size();
+}
+
+bool LoadCSV::ConvertNumber(const std::string& token, long double& value)
+{
+  char* end;
+  value = std::strtold(token.c_str(), &end);
+  return !token.empty() && end == token.c_str() + token.size();
 }
 
 } // namespace data
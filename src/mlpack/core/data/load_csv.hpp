@@ -12,9 +12,6 @@
 #ifndef MLPACK_CORE_DATA_LOAD_CSV_HPP
 #define MLPACK_CORE_DATA_LOAD_CSV_HPP
 
-#include <boost/spirit/include/qi.hpp>
-#include <boost/algorithm/string/trim.hpp>
-
 #include <mlpack/core.hpp>
 #include <mlpack/core/util/log.hpp>
 
@@ -29,19 +26,39 @@ namespace mlpack {
 namespace data {
 
 /**
- *Load the csv file.This class use boost::spirit
- *to implement the parser, please refer to following link
- *http://theboostcpplibraries.com/boost.spirit for quick review.
+ * Load a csv, tsv, or txt file.  The file is mapped into memory (or read, on
+ * platforms without mmap()) and split into chunks at newline boundaries; the
+ * chunks are then parsed in parallel (if OpenMP is enabled).  Since the file is
+ * mapped and not copied, loading a file needs little memory besides the matrix.
+ * Each chunk builds the categorical mappings of its own lines with its own copy
+ * of the DatasetMapper, and the mappings of the chunks are then merged in file
+ * order, so that the result is exactly the same as if the file were parsed line
+ * by line on one thread.
+ *
+ * Each line is split into tokens as follows.  For csv files, tokens are
+ * separated by a comma (possibly surrounded by spaces); for tsv files, they are
+ * separated by a tab (possibly surrounded by spaces); and for txt files, they
+ * are separated by one or more spaces.  A token may also be a string quoted
+ * with ' or " (a quote inside it is written twice); the quotes are kept as part
+ * of the token.  Whitespace around each line and each token is ignored.
  */
 class LoadCSV
 {
  public:
   /**
-   * Construct the LoadCSV object on the given file.  This will construct the
-   * rules necessary for loading and attempt to open the file.
+   * Construct the LoadCSV object on the given file.  This will set up the
+   * delimiters for the type of the file and attempt to open the file.
    */
   LoadCSV(const std::string& file);
 
+  //! Unmap the file, if it is mapped.
+  ~LoadCSV();
+
+  //! The mapping of the file can't be copied.
+  LoadCSV(const LoadCSV& other) = delete;
+  //! The mapping of the file can't be copied.
+  LoadCSV& operator=(const LoadCSV& other) = delete;
+
   /**
    * Load the file into the given matrix with the given DatasetMapper object.
    * Throws exceptions on errors.
@@ -77,64 +94,7 @@ class LoadCSV
   template<typename T, typename MapPolicy>
   void GetMatrixSize(size_t& rows, size_t& cols, DatasetMapper<MapPolicy>& info)
   {
-    using namespace boost::spirit;
-
-    // Take a pass through the file.  If the DatasetMapper policy requires it,
-    // we will pass everything string through MapString().  This might be useful
-    // if, e.g., the MapPolicy needs to find which dimensions are numeric or
-    // categorical.
-
-    // Reset to the start of the file.
-    inFile.clear();
-    inFile.seekg(0, std::ios::beg);
-    rows = 0;
-    cols = 0;
-
-    // First, count the number of rows in the file (this is the dimensionality).
-    std::string line;
-    while (std::getline(inFile, line))
-    {
-      ++rows;
-    }
-    info = DatasetMapper<MapPolicy>(rows);
-
-    // Now, jump back to the beginning of the file.
-    inFile.clear();
-    inFile.seekg(0, std::ios::beg);
-    rows = 0;
-
-    while (std::getline(inFile, line))
-    {
-      ++rows;
-      // Remove whitespace from either side.
-      boost::trim(line);
-
-      if (rows == 1)
-      {
-        // Extract the number of columns.
-        auto findColSize = [&cols](iter_type) { ++cols; };
-        qi::parse(line.begin(), line.end(),
-            stringRule[findColSize] % delimiterRule);
-      }
-
-      // I guess this is technically a second pass, but that's ok... still the
-      // same idea...
-      if (MapPolicy::NeedsFirstPass)
-      {
-        // In this case we must pass everything we parse to the MapPolicy.
-        auto firstPassMap = [&](const iter_type& iter)
-        {
-          std::string str(iter.begin(), iter.end());
-          boost::trim(str);
-
-          info.template MapFirstPass<T>(std::move(str), rows - 1);
-        };
-
-        // Now parse the line.
-        qi::parse(line.begin(), line.end(),
-            stringRule[firstPassMap] % delimiterRule);
-      }
-    }
+    FirstPass<T>(rows, cols, info, false);
   }
 
   /**
@@ -152,67 +112,44 @@ class LoadCSV
                               size_t& cols,
                               DatasetMapper<MapPolicy>& info)
   {
-    using namespace boost::spirit;
-
-    // Take a pass through the file.  If the DatasetMapper policy requires it,
-    // we will pass everything string through MapString().  This might be useful
-    // if, e.g., the MapPolicy needs to find which dimensions are numeric or
-    // categorical.
-
-    // Reset to the start of the file.
-    inFile.clear();
-    inFile.seekg(0, std::ios::beg);
-    rows = 0;
-    cols = 0;
-
-    std::string line;
-    while (std::getline(inFile, line))
-    {
-      ++cols;
-      // Remove whitespace from either side.
-      boost::trim(line);
-
-      if (cols == 1)
-      {
-        // Extract the number of dimensions.
-        auto findRowSize = [&rows](iter_type) { ++rows; };
-        qi::parse(line.begin(), line.end(),
-            stringRule[findRowSize] % delimiterRule);
-
-        // Now that we know the dimensionality, initialize the DatasetMapper.
-        info.SetDimensionality(rows);
-      }
-
-      // If we need to do a first pass for the DatasetMapper, do it.
-      if (MapPolicy::NeedsFirstPass)
-      {
-        size_t dim = 0;
-
-        // In this case we must pass everything we parse to the MapPolicy.
-        auto firstPassMap = [&](const iter_type& iter)
-        {
-          std::string str(iter.begin(), iter.end());
-          boost::trim(str);
-
-          info.template MapFirstPass<T>(std::move(str), dim++);
-        };
-
-        // Now parse the line.
-        qi::parse(line.begin(), line.end(),
-            stringRule[firstPassMap] % delimiterRule);
-      }
-    }
+    FirstPass<T>(rows, cols, info, true);
   }
 
  private:
-  using iter_type = boost::iterator_range<std::string::iterator>;
-
   /**
    * Check whether or not the file has successfully opened; throw an exception
    * if not.
    */
   void CheckOpen();
 
+  /**
+   * Map the file into memory (if that hasn't been done yet), split it into
+   * chunks at newline boundaries, and count the lines of each chunk.  Where
+   * mmap() is not available, the file is read into memory instead.
+   */
+  void ReadFile();
+
+  //! Unmap (or free) the contents of the file, once they have been parsed.
+  void ReleaseFile();
+
+  /**
+   * Take the first pass over the data: find the size of the matrix,
+   * re-initialize the DatasetMapper, and, if MapPolicy::NeedsFirstPass is true,
+   * pass every token to MapFirstPass().  The chunks are processed in parallel
+   * with their own copies of the DatasetMapper; a dimension is categorical if
+   * any chunk found it to be categorical.
+   *
+   * @param rows Variable to be filled with the number of rows.
+   * @param cols Variable to be filled with the number of columns.
+   * @param info DatasetMapper object to use for first pass.
+   * @param transpose Whether the matrix is transposed.
+   */
+  template<typename T, typename MapPolicy>
+  void FirstPass(size_t& rows,
+                 size_t& cols,
+                 DatasetMapper<MapPolicy>& info,
+                 const bool transpose);
+
   /**
    * Parse a non-transposed matrix.
    *
@@ -223,64 +160,7 @@ class LoadCSV
   void NonTransposeParse(arma::Mat<T>& inout,
                          DatasetMapper<PolicyType>& infoSet)
   {
-    using namespace boost::spirit;
-
-    // Get the size of the matrix.
-    size_t rows, cols;
-    GetMatrixSize<T>(rows, cols, infoSet);
-
-    // Set up output matrix.
-    inout.set_size(rows, cols);
-    size_t row = 0;
-    size_t col = 0;
-
-    // Reset file position.
-    std::string line;
-    inFile.clear();
-    inFile.seekg(0, std::ios::beg);
-
-    auto setCharClass = [&](iter_type const &iter)
-    {
-      std::string str(iter.begin(), iter.end());
-      if (str == "\t")
-      {
-        str.clear();
-      }
-      boost::trim(str);
-
-      inout(row, col++) = infoSet.template MapString<T>(std::move(str), row);
-    };
-
-    while (std::getline(inFile, line))
-    {
-      // Remove whitespace from either side.
-      boost::trim(line);
-
-      // Parse the numbers from a line (ex: 1,2,3,4); if the parser finds a
-      // number it will execute the setNum function.
-      const bool canParse = qi::parse(line.begin(), line.end(),
-          stringRule[setCharClass] % delimiterRule);
-
-      // Make sure we got the right number of rows.
-      if (col != cols)
-      {
-        std::ostringstream oss;
-        oss << "LoadCSV::NonTransposeParse(): wrong number of dimensions ("
-            << col << ") on line " << row << "; should be " << cols
-            << " dimensions.";
-        throw std::runtime_error(oss.str());
-      }
-
-      if (!canParse)
-      {
-        std::ostringstream oss;
-        oss << "LoadCSV::NonTransposeParse(): parsing error on line " << col
-            << "!";
-        throw std::runtime_error(oss.str());
-      }
-
-      ++row; col = 0;
-    }
+    Parse(inout, infoSet, false);
   }
 
   /**
@@ -292,75 +172,97 @@ class LoadCSV
   template<typename T, typename PolicyType>
   void TransposeParse(arma::Mat<T>& inout, DatasetMapper<PolicyType>& infoSet)
   {
-    using namespace boost::spirit;
-
-    // Get matrix size.  This also initializes infoSet correctly.
-    size_t rows, cols;
-    GetTransposeMatrixSize<T>(rows, cols, infoSet);
-
-    // Set the matrix size.
-    inout.set_size(rows, cols);
-
-    // Initialize auxiliary variables.
-    size_t row = 0;
-    size_t col = 0;
-    std::string line;
-    inFile.clear();
-    inFile.seekg(0, std::ios::beg);
+    Parse(inout, infoSet, true);
+  }
 
-    /**
-     * This is the parse rule for strings.  When we get a string we have to pass
-     * it to the DatasetMapper.
-     */
-    auto parseString = [&](iter_type const &iter)
-    {
-      // All parsed values must be mapped.
-      std::string str(iter.begin(), iter.end());
-      boost::trim(str);
+  /**
+   * Parse the matrix.  Every chunk maps its tokens with its own copy of the
+   * DatasetMapper and records each new mapping it makes.  Afterwards the new
+   * mappings are replayed on infoSet in file order, and the values of any
+   * mapping that got a different value in infoSet are corrected in the matrix.
+   *
+   * This relies on the value of a token only depending on the token, the type
+   * of its dimension (which is fixed after the first pass), and the mappings
+   * made before it in the same dimension; this holds for IncrementPolicy and
+   * MissingPolicy.
+   *
+   * @param inout Matrix to load into.
+   * @param infoSet DatasetMapper to load with.
+   * @param transpose Whether the matrix is transposed.
+   */
+  template<typename T, typename PolicyType>
+  void Parse(arma::Mat<T>& inout,
+             DatasetMapper<PolicyType>& infoSet,
+             const bool transpose);
 
-      inout(row, col) = infoSet.template MapString<T>(std::move(str), row);
-      ++row;
-    };
+  /**
+   * Split the given line into tokens, and call f(begin, end, index) for each
+   * token (without surrounding whitespace).  The number of tokens is returned.
+   *
+   * @param begin Start of the line.
+   * @param end End of the line (not including the newline).
+   * @param f Function to call for each token.
+   */
+  template<typename FunctionType>
+  size_t ParseLine(const char* begin,
+                   const char* end,
+                   FunctionType f) const;
 
-    while (std::getline(inFile, line))
-    {
-      // Remove whitespace from either side.
-      boost::trim(line);
+  /**
+   * Call f(begin, end, line) for each line of the given chunk, where line is
+   * the index of the line in the file, until f returns false.
+   *
+   * @param chunk Index of the chunk.
+   * @param f Function to call for each line.
+   */
+  template<typename FunctionType>
+  void ForEachLine(const size_t chunk, FunctionType f) const;
 
-      // Reset the row we are looking at.  (Remember this is transposed.)
-      row = 0;
+  //! Return whether the given character ends an unquoted token.
+  bool IsTokenEnd(const char c) const
+  {
+    if (c == '\r' || c == '\n')
+      return true;
+    // In txt files, commas also end tokens.
+    return (delimiter == ' ') ? (c == ' ' || c == ',') : (c == delimiter);
+  }
 
-      // Now use boost::spirit to parse the characters of the line;
-      // parseString() will be called when a token is detected.
-      const bool canParse = qi::parse(line.begin(), line.end(),
-          stringRule[parseString] % delimiterRule);
+  /**
+   * Match the delimiter that starts at the given position, and return the
+   * position after it, or NULL if there is no delimiter there.
+   */
+  const char* MatchDelimiter(const char* pos, const char* end) const;
 
-      // Make sure we got the right number of rows.
-      if (row != rows)
-      {
-        std::ostringstream oss;
-        oss << "LoadCSV::TransposeParse(): wrong number of dimensions (" << row
-            << ") on line " << col << "; should be " << rows << " dimensions.";
-        throw std::runtime_error(oss.str());
-      }
+  /**
+   * Match the quoted string that starts at the given position (which must be
+   * a quote), and return the position after it, or NULL if the string isn't
+   * closed.
+   */
+  static const char* MatchQuoted(const char* pos, const char* end);
 
-      if (!canParse)
-      {
-        std::ostringstream oss;
-        oss << "LoadCSV::TransposeParse(): parsing error on line " << col
-            << "!";
-        throw std::runtime_error(oss.str());
-      }
+  //! Remove whitespace from either side of the given range.
+  static void Trim(const char*& begin, const char*& end);
 
-      // Increment the column index.
-      ++col;
-    }
+  /**
+   * Convert the given token to a floating-point number with strtod(), which
+   * gives the same result as a stringstream extraction.  Return false if the
+   * whole token isn't a number.  For non-floating-point types, false is always
+   * returned, and the token must be converted by the DatasetMapper.
+   */
+  static bool ConvertNumber(const std::string& token, float& value);
+  //! Convert the given token to a number (see above).
+  static bool ConvertNumber(const std::string& token, double& value);
+  //! Convert the given token to a number (see above).
+  static bool ConvertNumber(const std::string& token, long double& value);
+  //! Convert the given token to a number (see above).
+  template<typename T>
+  static bool ConvertNumber(const std::string& /* token */, T& /* value */)
+  {
+    return false;
   }
 
-  //! Spirit rule for parsing.
-  boost::spirit::qi::rule<std::string::iterator, iter_type()> stringRule;
-  //! Spirit rule for delimiters (i.e. ',' for CSVs).
-  boost::spirit::qi::rule<std::string::iterator, iter_type()> delimiterRule;
+  //! Delimiter between tokens: ',' (csv), ' ' (txt), or '\t' (tsv).
+  char delimiter;
 
   //! Extension (type) of file.
   std::string extension;
@@ -368,9 +270,25 @@ class LoadCSV
   std::string filename;
   //! Opened stream for reading.
   std::ifstream inFile;
+
+  //! Contents of the file (once it has been mapped or read).
+  const char* contents;
+  //! Size of the contents of the file, in bytes.
+  size_t contentsSize;
+  //! Memory mapping of the file, or NULL if the file isn't mapped.
+  void* mapping;
+  //! Contents of the file, if it was read instead of mapped.
+  std::string buffer;
+  //! Offsets in the file where each chunk starts (and where the last ends).
+  std::vector<size_t> chunkStarts;
+  //! Index of the first line of each chunk (and the total number of lines).
+  std::vector<size_t> chunkLines;
 };
 
 } // namespace data
 } // namespace mlpack
 
+// Include implementation.
+#include "load_csv_impl.hpp"
+
 #endif
@@ -0,0 +1,287 @@
+/**
+ * @file load_csv_impl.hpp
+ *
+ * Implementation of the templated parts of the parallel CSV reader.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_DATA_LOAD_CSV_IMPL_HPP
+#define MLPACK_CORE_DATA_LOAD_CSV_IMPL_HPP
+
+// In case it hasn't been included yet.
+#include "load_csv.hpp"
+
+namespace mlpack {
+namespace data {
+
+template<typename T, typename MapPolicy>
+void LoadCSV::FirstPass(size_t& rows,
+                        size_t& cols,
+                        DatasetMapper<MapPolicy>& info,
+                        const bool transpose)
+{
+  ReadFile();
+
+  // The number of dimensions is the number of lines (non-transposed) or the
+  // number of tokens on the first line (transposed).
+  const size_t numLines = chunkLines.back();
+  size_t firstLineTokens = 0;
+  if (numLines > 0)
+  {
+    const char* begin = contents;
+    const char* end = begin + contentsSize;
+    const char* newline = std::find(begin, end, '\n');
+    firstLineTokens = ParseLine(begin, newline,
+        [](const char*, const char*, const size_t) { });
+  }
+
+  if (transpose)
+  {
+    rows = firstLineTokens;
+    cols = numLines;
+    if (numLines > 0)
+      info.SetDimensionality(rows);
+  }
+  else
+  {
+    rows = numLines;
+    cols = firstLineTokens;
+    info = DatasetMapper<MapPolicy>(rows);
+  }
+
+  if (!MapPolicy::NeedsFirstPass || numLines == 0)
+    return;
+
+  // Each chunk passes its tokens to its own copy of the DatasetMapper.  Lines
+  // with the wrong number of tokens are ignored here; they are reported while
+  // parsing.
+  const size_t numChunks = chunkStarts.size() - 1;
+  std::vector<DatasetMapper<MapPolicy>> chunkInfo(numChunks, info);
+
+  #pragma omp parallel for schedule(dynamic)
+  for (omp_size_t c = 0; c < (omp_size_t) numChunks; ++c)
+  {
+    std::string token;
+    ForEachLine(c, [&](const char* begin, const char* end, const size_t line)
+    {
+      ParseLine(begin, end,
+          [&](const char* tokenBegin, const char* tokenEnd, const size_t i)
+          {
+            if (transpose && i >= rows)
+              return;
+
+            token.assign(tokenBegin, tokenEnd);
+            chunkInfo[c].template MapFirstPass<T>(token,
+                transpose ? i : line);
+          });
+      return true;
+    });
+  }
+
+  // A dimension is categorical if any chunk found it to be categorical.
+  for (size_t c = 0; c < numChunks; ++c)
+  {
+    for (size_t d = 0; d < info.Dimensionality(); ++d)
+    {
+      if (chunkInfo[c].Type(d) == Datatype::categorical)
+        info.Type(d) = Datatype::categorical;
+    }
+  }
+}
+
+template<typename T, typename PolicyType>
+void LoadCSV::Parse(arma::Mat<T>& inout,
+                    DatasetMapper<PolicyType>& infoSet,
+                    const bool transpose)
+{
+  // Get the size of the matrix.  This also initializes infoSet correctly.
+  size_t rows, cols;
+  FirstPass<T>(rows, cols, infoSet, transpose);
+
+  inout.set_size(rows, cols);
+  const size_t tokensPerLine = transpose ? rows : cols;
+
+  // Tokens of numeric dimensions can be converted directly, without going
+  // through IncrementPolicy (which would use a much slower stringstream).
+  const bool convertNumeric = std::is_floating_point<T>::value &&
+      std::is_same<PolicyType, IncrementPolicy>::value;
+
+  // For each chunk: the new mappings it made, in order, with their values;
+  // and the first line with the wrong number of tokens.
+  const size_t numChunks = chunkStarts.size() - 1;
+  std::vector<std::vector<std::pair<size_t, std::string>>> newMappings(
+      numChunks);
+  std::vector<std::vector<T>> newValues(numChunks);
+  std::vector<size_t> badLines(numChunks, chunkLines.back());
+  std::vector<size_t> badLineTokens(numChunks, 0);
+
+  #pragma omp parallel for schedule(dynamic)
+  for (omp_size_t c = 0; c < (omp_size_t) numChunks; ++c)
+  {
+    DatasetMapper<PolicyType> chunkInfo(infoSet);
+    std::string token;
+
+    ForEachLine(c, [&](const char* begin, const char* end, const size_t line)
+    {
+      const size_t numTokens = ParseLine(begin, end,
+          [&](const char* tokenBegin, const char* tokenEnd, const size_t i)
+          {
+            if (i >= tokensPerLine)
+              return;
+
+            const size_t dim = transpose ? i : line;
+            T& value = transpose ? inout(i, line) : inout(line, i);
+            token.assign(tokenBegin, tokenEnd);
+
+            if (convertNumeric && chunkInfo.Type(dim) == Datatype::numeric &&
+                ConvertNumber(token, value))
+              return;
+
+            const size_t numMappings = chunkInfo.NumMappings(dim);
+            value = chunkInfo.template MapString<T>(token, dim);
+            if (chunkInfo.NumMappings(dim) != numMappings)
+            {
+              newMappings[c].push_back(std::make_pair(dim, token));
+              newValues[c].push_back(value);
+            }
+          });
+
+      if (numTokens != tokensPerLine)
+      {
+        badLines[c] = line;
+        badLineTokens[c] = numTokens;
+        return false;
+      }
+
+      return true;
+    });
+  }
+
+  // The contents of the file aren't needed anymore, so don't keep them while
+  // the mappings are merged.
+  ReleaseFile();
+
+  // Make sure every line had the right number of tokens; report the first one
+  // that didn't.
+  for (size_t c = 0; c < numChunks; ++c)
+  {
+    if (badLines[c] != chunkLines.back())
+    {
+      std::ostringstream oss;
+      oss << (transpose ? "LoadCSV::TransposeParse()" :
+          "LoadCSV::NonTransposeParse()") << ": wrong number of dimensions ("
+          << badLineTokens[c] << ") on line " << badLines[c] << "; should be "
+          << tokensPerLine << " dimensions.";
+      throw std::runtime_error(oss.str());
+    }
+  }
+
+  // Replay the new mappings of each chunk on infoSet, in the order of the
+  // file.  A mapping that was made by an earlier chunk may have a different
+  // value in infoSet than in the chunk that made it again.
+  std::vector<std::unordered_map<size_t, std::unordered_map<T, T>>> remaps(
+      numChunks);
+  for (size_t c = 0; c < numChunks; ++c)
+  {
+    for (size_t i = 0; i < newMappings[c].size(); ++i)
+    {
+      const size_t dim = newMappings[c][i].first;
+      const T value = infoSet.template MapString<T>(newMappings[c][i].second,
+          dim);
+
+      // NaN (from MissingPolicy) is never equal to itself.
+      const T oldValue = newValues[c][i];
+      if (value != oldValue && (value == value || oldValue == oldValue))
+        remaps[c][dim][oldValue] = value;
+    }
+  }
+
+  // Correct the values of the remapped mappings.
+  #pragma omp parallel for schedule(dynamic)
+  for (omp_size_t c = 0; c < (omp_size_t) numChunks; ++c)
+  {
+    if (remaps[c].empty())
+      continue;
+
+    for (auto& dimRemap : remaps[c])
+    {
+      const size_t dim = dimRemap.first;
+      const std::unordered_map<T, T>& remap = dimRemap.second;
+
+      // In a transposed matrix, the dimension is spread over the columns of
+      // the chunk; otherwise it is a single line.
+      const size_t first = transpose ? chunkLines[c] : 0;
+      const size_t last = transpose ? chunkLines[c + 1] : cols;
+      for (size_t i = first; i < last; ++i)
+      {
+        T& value = inout(dim, i);
+        typename std::unordered_map<T, T>::const_iterator it =
+            remap.find(value);
+        if (it != remap.end())
+          value = it->second;
+      }
+    }
+  }
+}
+
+template<typename FunctionType>
+size_t LoadCSV::ParseLine(const char* begin,
+                          const char* end,
+                          FunctionType f) const
+{
+  // Remove whitespace from either side.
+  Trim(begin, end);
+
+  // A line is a list of tokens separated by delimiters.  A token can be empty,
+  // so there is always at least one.
+  size_t numTokens = 0;
+  while (true)
+  {
+    // A token is either a quoted string or everything up to the next delimiter
+    // or newline.
+    const char* tokenEnd = NULL;
+    if (begin != end && (*begin == '\'' || *begin == '"'))
+      tokenEnd = MatchQuoted(begin, end);
+    if (tokenEnd == NULL)
+    {
+      tokenEnd = begin;
+      while (tokenEnd != end && !IsTokenEnd(*tokenEnd))
+        ++tokenEnd;
+    }
+
+    const char* tokenBegin = begin;
+    const char* trimmedEnd = tokenEnd;
+    Trim(tokenBegin, trimmedEnd);
+    f(tokenBegin, trimmedEnd, numTokens++);
+
+    // If there is no delimiter after the token, the line ends here (anything
+    // after it is ignored).
+    begin = MatchDelimiter(tokenEnd, end);
+    if (begin == NULL)
+      return numTokens;
+  }
+}
+
+template<typename FunctionType>
+void LoadCSV::ForEachLine(const size_t chunk, FunctionType f) const
+{
+  const char* pos = contents + chunkStarts[chunk];
+  const char* end = contents + chunkStarts[chunk + 1];
+  size_t line = chunkLines[chunk];
+  while (pos != end)
+  {
+    const char* lineEnd = std::find(pos, end, '\n');
+    if (!f(pos, lineEnd, line++) || lineEnd == end)
+      return;
+
+    pos = lineEnd + 1;
+  }
+}
+
+} // namespace data
+} // namespace mlpack
+
+#endif
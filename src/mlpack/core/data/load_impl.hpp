@@ -107,6 +107,35 @@ bool Load(const std::string& filename,
     return false;
   }
 
+  // mlpack mapped binary files aren't handled by Armadillo.  They hold the
+  // matrix as it is stored in memory, so they are never transposed.
+  if (extension == "mmb")
+  {
+    Log::Info << "Loading '" << filename << "' as mlpack mapped binary "
+        << "formatted data.  " << std::flush;
+
+    std::ifstream binaryStream(filename.c_str(), std::ifstream::binary);
+    std::string error;
+    if (!details::ReadMappedBinary(binaryStream, matrix, error))
+    {
+      Log::Info << std::endl;
+      Timer::Stop("loading_data");
+      if (fatal)
+        Log::Fatal << "Loading from '" << filename << "' failed: " << error
+            << "." << std::endl;
+      else
+        Log::Warn << "Loading from '" << filename << "' failed: " << error
+            << "." << std::endl;
+
+      return false;
+    }
+
+    Log::Info << "Size is " << matrix.n_rows << " x " << matrix.n_cols
+        << ".\n";
+    Timer::Stop("loading_data");
+    return true;
+  }
+
   bool unknownType = false;
   arma::file_type loadType;
   std::string stringType;
@@ -299,6 +328,49 @@ bool Load(const std::string& filename,
   return success;
 }
 
+template<typename eT>
+bool Load(const std::string& filename,
+          MappedMatrix<eT>& matrix,
+          const bool fatal)
+{
+  Timer::Start("loading_data");
+
+  if (Extension(filename) != "mmb")
+  {
+    Timer::Stop("loading_data");
+    if (fatal)
+      Log::Fatal << "Cannot map '" << filename << "'; only mlpack mapped "
+          << "binary files (.mmb) can be mapped." << std::endl;
+    else
+      Log::Warn << "Cannot map '" << filename << "'; only mlpack mapped "
+          << "binary files (.mmb) can be mapped.  Load failed." << std::endl;
+
+    return false;
+  }
+
+  try
+  {
+    matrix.Map(filename);
+  }
+  catch (std::exception& e)
+  {
+    Timer::Stop("loading_data");
+    if (fatal)
+      Log::Fatal << e.what() << "." << std::endl;
+    else
+      Log::Warn << e.what() << "; load failed." << std::endl;
+
+    return false;
+  }
+
+  Log::Info << "Mapped '" << filename << "' as mlpack mapped binary formatted "
+      << "data.  Size is " << matrix.Matrix().n_rows << " x "
+      << matrix.Matrix().n_cols << "." << std::endl;
+
+  Timer::Stop("loading_data");
+  return true;
+}
+
 // Load with mappings.  Unfortunately we have to implement this ourselves.
 template<typename eT, typename PolicyType>
 bool Load(const std::string& filename,
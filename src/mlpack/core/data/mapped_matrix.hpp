@@ -0,0 +1,187 @@
+/**
+ * @file mapped_matrix.hpp
+ *
+ * Definition of the mlpack mapped binary (.mmb) matrix format, and of the
+ * MappedMatrix class, which gives access to a matrix stored in that format by
+ * mapping the file into memory instead of reading it.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_DATA_MAPPED_MATRIX_HPP
+#define MLPACK_CORE_DATA_MAPPED_MATRIX_HPP
+
+#include <mlpack/prereqs.hpp>
+
+namespace mlpack {
+namespace data {
+
+/**
+ * The header of an mlpack mapped binary (.mmb) file.  The header is followed by
+ * the elements of the matrix in column-major order, exactly as they are stored
+ * in memory by Armadillo.  The elements start at the given offset, which is a
+ * multiple of 64 bytes, so that a memory mapping of the file can be used as the
+ * memory of a matrix directly.  All values are stored in the byte order of the
+ * machine that wrote the file.
+ */
+struct MappedBinaryHeader
+{
+  //! The magic string at the start of every .mmb file.
+  char magic[16];
+  //! The size of each element in bytes.
+  uint32_t elementSize;
+  //! The kind of each element: 'f' (floating point), 'i' (signed integer), or
+  //! 'u' (unsigned integer).
+  uint32_t elementKind;
+  //! The number of rows of the matrix.
+  uint64_t rows;
+  //! The number of columns of the matrix.
+  uint64_t cols;
+  //! The offset of the first element from the start of the file, in bytes.
+  uint64_t offset;
+  //! Unused; this pads the header to 64 bytes.
+  char reserved[16];
+
+  /**
+   * Create the header for a matrix with the given size and element type.
+   *
+   * @param rows Number of rows of the matrix.
+   * @param cols Number of columns of the matrix.
+   */
+  template<typename eT>
+  static MappedBinaryHeader Create(const size_t rows, const size_t cols);
+
+  /**
+   * Check that this is a valid header for a matrix with element type eT, in a
+   * file of the given size.  If it isn't, a description of the problem is
+   * stored in the given string.
+   *
+   * @param fileSize Size of the whole file, in bytes.
+   * @param error String to store a description of the problem in.
+   * @return Whether the header is valid.
+   */
+  template<typename eT>
+  bool Check(const size_t fileSize, std::string& error) const;
+};
+
+/**
+ * A matrix stored in an mlpack mapped binary (.mmb) file, which is mapped into
+ * memory instead of being read.  The matrix returned by Matrix() uses the
+ * mapped memory directly (it is created with copy_aux_mem = false), so opening
+ * even a very large file takes almost no time, and the operating system only
+ * reads the pages that are actually used.  Several processes that map the same
+ * file share the same physical pages.
+ *
+ * The file is mapped privately: the elements of the matrix can be modified,
+ * but modifications are never written back to the file, and modified pages
+ * are no longer shared with other processes.  The size of the matrix can't be
+ * changed.  The memory stays valid until the MappedMatrix is destroyed or
+ * Unmap() is called, so any matrix that aliases Matrix() must not outlive it.
+ *
+ * On platforms without mmap() (i.e. Windows), the file is read into memory
+ * instead.
+ *
+ * A MappedMatrix is usually filled with data::Load():
+ *
+ * @code
+ * data::MappedMatrix<double> dataset;
+ * data::Load("dataset.mmb", dataset, true);
+ * const arma::mat& matrix = dataset.Matrix();
+ * @endcode
+ *
+ * @tparam eT Element type of the matrix.
+ */
+template<typename eT>
+class MappedMatrix
+{
+ public:
+  //! Create an empty MappedMatrix that doesn't map any file.
+  MappedMatrix();
+
+  /**
+   * Map the given file.  A std::runtime_error is thrown if the file can't be
+   * opened or mapped, or if it is not a valid .mmb file with elements of type
+   * eT.
+   *
+   * @param filename Name of the .mmb file to map.
+   */
+  MappedMatrix(const std::string& filename);
+
+  //! Take ownership of the mapping of the given MappedMatrix.
+  MappedMatrix(MappedMatrix&& other);
+
+  //! Take ownership of the mapping of the given MappedMatrix.
+  MappedMatrix& operator=(MappedMatrix&& other);
+
+  //! A mapping can't be copied.
+  MappedMatrix(const MappedMatrix& other) = delete;
+  //! A mapping can't be copied.
+  MappedMatrix& operator=(const MappedMatrix& other) = delete;
+
+  //! Unmap the file, if one is mapped.
+  ~MappedMatrix();
+
+  /**
+   * Map the given file, unmapping any file that was mapped before.  A
+   * std::runtime_error is thrown if the file can't be opened or mapped, or if
+   * it is not a valid .mmb file with elements of type eT.
+   *
+   * @param filename Name of the .mmb file to map.
+   */
+  void Map(const std::string& filename);
+
+  //! Unmap the file, if one is mapped; Matrix() is then empty.
+  void Unmap();
+
+  //! Get the mapped matrix.
+  const arma::Mat<eT>& Matrix() const { return *matrix; }
+  //! Modify the elements of the mapped matrix (but don't resize it!).
+  arma::Mat<eT>& Matrix() { return *matrix; }
+
+ private:
+  //! The matrix, which uses the mapped memory.
+  arma::Mat<eT>* matrix;
+  //! The start of the mapping (NULL if nothing is mapped).
+  void* mapping;
+  //! The size of the mapping, in bytes.
+  size_t mappingSize;
+};
+
+namespace details {
+
+/**
+ * Read a matrix in mlpack mapped binary format from the given stream into
+ * regular memory.  If the stream doesn't hold a valid .mmb file with elements
+ * of type eT, a description of the problem is stored in the given string.
+ *
+ * @param stream Stream to read from (opened in binary mode).
+ * @param matrix Matrix to read into.
+ * @param error String to store a description of the problem in.
+ * @return Whether the matrix was read successfully.
+ */
+template<typename eT>
+bool ReadMappedBinary(std::istream& stream,
+                      arma::Mat<eT>& matrix,
+                      std::string& error);
+
+/**
+ * Write a matrix in mlpack mapped binary format to the given stream.
+ *
+ * @param stream Stream to write to (opened in binary mode).
+ * @param matrix Matrix to write.
+ * @return Whether the matrix was written successfully.
+ */
+template<typename eT>
+bool WriteMappedBinary(std::ostream& stream, const arma::Mat<eT>& matrix);
+
+} // namespace details
+
+} // namespace data
+} // namespace mlpack
+
+// Include implementation.
+#include "mapped_matrix_impl.hpp"
+
+#endif
@@ -0,0 +1,276 @@
+/**
+ * @file mapped_matrix_impl.hpp
+ *
+ * Implementation of the mlpack mapped binary (.mmb) matrix format and of the
+ * MappedMatrix class.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_DATA_MAPPED_MATRIX_IMPL_HPP
+#define MLPACK_CORE_DATA_MAPPED_MATRIX_IMPL_HPP
+
+// In case it hasn't been included yet.
+#include "mapped_matrix.hpp"
+
+#include <fstream>
+
+#ifndef _WIN32
+  #include <fcntl.h>
+  #include <sys/mman.h>
+  #include <sys/stat.h>
+  #include <unistd.h>
+#endif
+
+namespace mlpack {
+namespace data {
+
+//! The magic string at the start of every .mmb file (padded with zeros).
+static const char mappedBinaryMagic[16] = "MLPACK_MAT_MMB";
+
+template<typename eT>
+MappedBinaryHeader MappedBinaryHeader::Create(const size_t rows,
+                                              const size_t cols)
+{
+  static_assert(sizeof(MappedBinaryHeader) == 64,
+      "MappedBinaryHeader must be 64 bytes long");
+
+  MappedBinaryHeader header;
+  std::memset(&header, 0, sizeof(MappedBinaryHeader));
+  std::memcpy(header.magic, mappedBinaryMagic, sizeof(header.magic));
+
+  header.elementSize = sizeof(eT);
+  header.elementKind = std::is_floating_point<eT>::value ? 'f' :
+      (std::is_signed<eT>::value ? 'i' : 'u');
+  header.rows = rows;
+  header.cols = cols;
+  // The elements start right after the header, which is 64 bytes long.
+  header.offset = sizeof(MappedBinaryHeader);
+
+  return header;
+}
+
+template<typename eT>
+bool MappedBinaryHeader::Check(const size_t fileSize, std::string& error) const
+{
+  if (std::memcmp(magic, mappedBinaryMagic, sizeof(magic)) != 0)
+  {
+    error = "not an mlpack mapped binary file";
+    return false;
+  }
+
+  const uint32_t kind = std::is_floating_point<eT>::value ? 'f' :
+      (std::is_signed<eT>::value ? 'i' : 'u');
+  if (elementSize != sizeof(eT) || elementKind != kind)
+  {
+    std::ostringstream oss;
+    oss << "file holds elements of kind '" << (char) elementKind << "' and "
+        << "size " << elementSize << ", but elements of kind '" << (char) kind
+        << "' and size " << sizeof(eT) << " were requested";
+    error = oss.str();
+    return false;
+  }
+
+  if (offset < sizeof(MappedBinaryHeader) || offset % 64 != 0)
+  {
+    error = "invalid offset of matrix elements";
+    return false;
+  }
+
+  // rows * cols may overflow for a corrupt header, so it is never computed.
+  const uint64_t maxElements = (fileSize < offset) ? 0 :
+      (fileSize - offset) / sizeof(eT);
+  if (fileSize < offset || (cols != 0 && rows > maxElements / cols))
+  {
+    error = "file is too small for a matrix of the size given in its header";
+    return false;
+  }
+
+  return true;
+}
+
+template<typename eT>
+MappedMatrix<eT>::MappedMatrix() :
+    matrix(new arma::Mat<eT>()),
+    mapping(NULL),
+    mappingSize(0)
+{
+  // Nothing to do.
+}
+
+template<typename eT>
+MappedMatrix<eT>::MappedMatrix(const std::string& filename) :
+    matrix(new arma::Mat<eT>()),
+    mapping(NULL),
+    mappingSize(0)
+{
+  Map(filename);
+}
+
+template<typename eT>
+MappedMatrix<eT>::MappedMatrix(MappedMatrix&& other) :
+    matrix(other.matrix),
+    mapping(other.mapping),
+    mappingSize(other.mappingSize)
+{
+  other.matrix = new arma::Mat<eT>();
+  other.mapping = NULL;
+  other.mappingSize = 0;
+}
+
+template<typename eT>
+MappedMatrix<eT>& MappedMatrix<eT>::operator=(MappedMatrix&& other)
+{
+  if (this != &other)
+  {
+    Unmap();
+    std::swap(matrix, other.matrix);
+    std::swap(mapping, other.mapping);
+    std::swap(mappingSize, other.mappingSize);
+  }
+
+  return *this;
+}
+
+template<typename eT>
+MappedMatrix<eT>::~MappedMatrix()
+{
+  Unmap();
+  delete matrix;
+}
+
+template<typename eT>
+void MappedMatrix<eT>::Map(const std::string& filename)
+{
+  Unmap();
+
+#ifdef _WIN32
+  // There is no mmap(), so we just read the file.
+  std::ifstream stream(filename.c_str(), std::ifstream::binary);
+  if (!stream.is_open())
+    throw std::runtime_error("cannot open file '" + filename + "'");
+
+  std::string error;
+  if (!details::ReadMappedBinary(stream, *matrix, error))
+    throw std::runtime_error("cannot read '" + filename + "': " + error);
+#else
+  const int fd = open(filename.c_str(), O_RDONLY);
+  if (fd == -1)
+    throw std::runtime_error("cannot open file '" + filename + "'");
+
+  struct stat fileStat;
+  if (fstat(fd, &fileStat) != 0 ||
+      (size_t) fileStat.st_size < sizeof(MappedBinaryHeader))
+  {
+    close(fd);
+    throw std::runtime_error("cannot map '" + filename + "': file is too "
+        "small to be an mlpack mapped binary file");
+  }
+
+  // The mapping is private, so that the matrix can be modified without
+  // changing the file.  It stays valid after the file is closed.
+  const size_t fileSize = (size_t) fileStat.st_size;
+  void* fileMapping = mmap(NULL, fileSize, PROT_READ | PROT_WRITE,
+      MAP_PRIVATE, fd, 0);
+  close(fd);
+  if (fileMapping == MAP_FAILED)
+    throw std::runtime_error("cannot map '" + filename + "'");
+
+  MappedBinaryHeader header;
+  std::memcpy(&header, fileMapping, sizeof(MappedBinaryHeader));
+
+  std::string error;
+  if (!header.Check<eT>(fileSize, error))
+  {
+    munmap(fileMapping, fileSize);
+    throw std::runtime_error("cannot map '" + filename + "': " + error);
+  }
+
+  mapping = fileMapping;
+  mappingSize = fileSize;
+
+  // Use the mapped memory without copying it; strict mode ensures that the
+  // matrix can never be resized away from it.
+  eT* elements = (eT*) ((char*) mapping + header.offset);
+  delete matrix;
+  matrix = new arma::Mat<eT>(elements, header.rows, header.cols, false, true);
+#endif
+}
+
+template<typename eT>
+void MappedMatrix<eT>::Unmap()
+{
+  // The matrix must not refer to the mapping anymore after it is unmapped.
+  delete matrix;
+  matrix = new arma::Mat<eT>();
+
+#ifndef _WIN32
+  if (mapping)
+    munmap(mapping, mappingSize);
+#endif
+
+  mapping = NULL;
+  mappingSize = 0;
+}
+
+namespace details {
+
+template<typename eT>
+bool ReadMappedBinary(std::istream& stream,
+                      arma::Mat<eT>& matrix,
+                      std::string& error)
+{
+  // Find the size of the stream.
+  const std::streampos start = stream.tellg();
+  if (start == std::streampos(-1))
+  {
+    error = "could not read from file";
+    return false;
+  }
+
+  stream.seekg(0, std::ios::end);
+  const size_t size = (size_t) (stream.tellg() - start);
+  stream.seekg(start);
+
+  MappedBinaryHeader header;
+  if (size < sizeof(MappedBinaryHeader) ||
+      !stream.read((char*) &header, sizeof(MappedBinaryHeader)))
+  {
+    error = "file is too small to be an mlpack mapped binary file";
+    return false;
+  }
+
+  if (!header.Check<eT>(size, error))
+    return false;
+
+  matrix.set_size(header.rows, header.cols);
+  stream.seekg(start + (std::streamoff) header.offset);
+  if (!stream.read((char*) matrix.memptr(), matrix.n_elem * sizeof(eT)))
+  {
+    error = "could not read matrix elements";
+    return false;
+  }
+
+  return true;
+}
+
+template<typename eT>
+bool WriteMappedBinary(std::ostream& stream, const arma::Mat<eT>& matrix)
+{
+  const MappedBinaryHeader header =
+      MappedBinaryHeader::Create<eT>(matrix.n_rows, matrix.n_cols);
+
+  stream.write((const char*) &header, sizeof(MappedBinaryHeader));
+  stream.write((const char*) matrix.memptr(), matrix.n_elem * sizeof(eT));
+
+  return stream.good();
+}
+
+} // namespace details
+
+} // namespace data
+} // namespace mlpack
+
+#endif
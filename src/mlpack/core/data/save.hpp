@@ -40,6 +40,10 @@ namespace data /** Functions to load and save matrices. */ {
  *  - Armadillo binary (arma_binary), denoted by .bin
  *  - HDF5 (hdf5_binary), denoted by .hdf5, .hdf, .h5, or .he5
  *
+ * In addition, mlpack mapped binary files (see MappedMatrix), denoted by .mmb,
+ * are supported.  These hold the matrix exactly as it is stored in memory, so
+ * they are never transposed, regardless of the 'transpose' parameter.
+ *
  * If the file extension is not one of those types, an error will be given.  If
  * the 'fatal' parameter is set to true, a std::runtime_error exception will be
  * thrown upon failure.  If the 'transpose' parameter is set to true, the matrix
@@ -64,6 +64,30 @@ bool Save(const std::string& filename,
     return false;
   }
 
+  // mlpack mapped binary files aren't handled by Armadillo.  They hold the
+  // matrix as it is stored in memory, so they are never transposed.
+  if (extension == "mmb")
+  {
+    Log::Info << "Saving mlpack mapped binary formatted data to '" << filename
+        << "'." << std::endl;
+
+    std::ofstream binaryStream(filename.c_str(), std::ofstream::binary);
+    if (!binaryStream.is_open() ||
+        !details::WriteMappedBinary(binaryStream, matrix))
+    {
+      Timer::Stop("saving_data");
+      if (fatal)
+        Log::Fatal << "Save to '" << filename << "' failed." << std::endl;
+      else
+        Log::Warn << "Save to '" << filename << "' failed." << std::endl;
+
+      return false;
+    }
+
+    Timer::Stop("saving_data");
+    return true;
+  }
+
   // Catch errors opening the file.
   std::fstream stream;
 #ifdef  _WIN32 // Always open in binary mode on Windows.
@@ -0,0 +1,80 @@
+/**
+ * @file batch_distances.hpp
+ *
+ * A utility for rules classes to compute the distances between one query point
+ * and a range of consecutive reference points, such as all the points of a
+ * leaf, in one batch when the metric supports it.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_METRICS_BATCH_DISTANCES_HPP
+#define MLPACK_CORE_METRICS_BATCH_DISTANCES_HPP
+
+#include <mlpack/prereqs.hpp>
+#include <mlpack/core/metrics/lmetric.hpp>
+
+namespace mlpack {
+namespace metric {
+
+/**
+ * Compute the distances between the given query point and the reference points
+ * referenceBegin, ..., referenceBegin + referenceCount - 1, one at a time.
+ * This overload is used for metrics that can't compute distances in batches,
+ * and for sparse data.
+ *
+ * @param metric Instantiated metric.
+ * @param querySet Set of query points.
+ * @param referenceSet Set of reference points.
+ * @param queryIndex Index of the query point.
+ * @param referenceBegin Index of the first reference point.
+ * @param referenceCount Number of reference points.
+ * @param distances Vector to store the distances in.
+ */
+template<typename MetricType, typename MatType, typename eT>
+void BatchDistances(MetricType& metric,
+                    const MatType& querySet,
+                    const MatType& referenceSet,
+                    const size_t queryIndex,
+                    const size_t referenceBegin,
+                    const size_t referenceCount,
+                    arma::Col<eT>& distances)
+{
+  distances.set_size(referenceCount);
+  for (size_t i = 0; i < referenceCount; ++i)
+  {
+    distances[i] = metric.Evaluate(querySet.col(queryIndex),
+        referenceSet.col(referenceBegin + i));
+  }
+}
+
+/**
+ * Compute the distances between the given query point and the reference points
+ * referenceBegin, ..., referenceBegin + referenceCount - 1 with
+ * LMetric::BatchEvaluate().
+ */
+template<int Power, bool TakeRoot, typename eT>
+void BatchDistances(LMetric<Power, TakeRoot>& metric,
+                    const arma::Mat<eT>& querySet,
+                    const arma::Mat<eT>& referenceSet,
+                    const size_t queryIndex,
+                    const size_t referenceBegin,
+                    const size_t referenceCount,
+                    arma::Col<eT>& distances)
+{
+  if (referenceCount == 0)
+  {
+    distances.reset();
+    return;
+  }
+
+  metric.BatchEvaluate(querySet.col(queryIndex), referenceSet.cols(
+      referenceBegin, referenceBegin + referenceCount - 1), distances);
+}
+
+} // namespace metric
+} // namespace mlpack
+
+#endif
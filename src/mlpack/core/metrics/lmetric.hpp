@@ -83,6 +83,26 @@ class LMetric
   static typename VecTypeA::elem_type Evaluate(const VecTypeA& a,
                                                const VecTypeB& b);
 
+  /**
+   * Computes the distances between one point and each column of a matrix, such
+   * as all the points held in a leaf of a tree.  This is faster than calling
+   * Evaluate() for each column, because no temporary expressions are created
+   * and the loops over the dimensions can be vectorized by the compiler.
+   *
+   * @tparam VecType Type of the point (a dense vector, or a column of a dense
+   *      matrix).
+   * @tparam MatType Type of the matrix of points (a dense matrix, or a
+   *      submatrix of one, like the result of arma::mat::cols()).
+   * @param a Point to compute the distances from.
+   * @param points Matrix of points to compute the distances to.
+   * @param distances Vector to store the distances in; it will be set to have
+   *      one element for each column of the matrix.
+   */
+  template<typename VecType, typename MatType>
+  static void BatchEvaluate(const VecType& a,
+                            const MatType& points,
+                            arma::Col<typename MatType::elem_type>& distances);
+
   //! Serialize the metric (nothing to do).
   template<typename Archive>
   void serialize(Archive& /* ar */, const unsigned int /* version */) { }
@@ -106,6 +106,102 @@ typename VecTypeA::elem_type LMetric<INT_MAX, false>::Evaluate(
   return arma::as_scalar(arma::max(arma::abs(a - b)));
 }
 
+template<int Power, bool TakeRoot>
+template<typename VecType, typename MatType>
+void LMetric<Power, TakeRoot>::BatchEvaluate(
+    const VecType& a,
+    const MatType& points,
+    arma::Col<typename MatType::elem_type>& distances)
+{
+  typedef typename MatType::elem_type ElemType;
+
+  // Make sure the point is contiguous in memory.
+  const arma::Col<ElemType> point(a);
+  const ElemType* pointMem = point.memptr();
+  const size_t dims = points.n_rows;
+
+  distances.set_size(points.n_cols);
+
+  // Compilers don't vectorize a maximum over the dimensions of one column, so
+  // the L-infinity distance is computed for blocks of columns at a time, with
+  // one accumulator for each column, and the inner loop over the columns of the
+  // block is vectorized instead.  The elements of a block are gathered from
+  // several columns, which only pays off if there are enough dimensions.
+  if (Power == INT_MAX && dims >= 12)
+  {
+    const size_t blockSize = 8;
+    for (size_t begin = 0; begin < points.n_cols; begin += blockSize)
+    {
+      const size_t count = std::min((size_t) points.n_cols - begin,
+          blockSize);
+      const ElemType* cols[blockSize];
+      ElemType results[blockSize];
+      for (size_t j = 0; j < count; ++j)
+      {
+        cols[j] = points.colptr(begin + j);
+        results[j] = 0;
+      }
+
+      for (size_t i = 0; i < dims; ++i)
+      {
+        const ElemType value = pointMem[i];
+        for (size_t j = 0; j < count; ++j)
+        {
+          const ElemType diff = std::abs(value - cols[j][i]);
+          results[j] = (diff > results[j]) ? diff : results[j];
+        }
+      }
+
+      for (size_t j = 0; j < count; ++j)
+        distances[begin + j] = results[j];
+    }
+
+    return;
+  }
+
+  for (size_t j = 0; j < points.n_cols; ++j)
+  {
+    const ElemType* col = points.colptr(j);
+    ElemType result = 0;
+
+    // The branches are resolved at compile-time.
+    if (Power == 1)
+    {
+      for (size_t i = 0; i < dims; ++i)
+        result += std::abs(pointMem[i] - col[i]);
+    }
+    else if (Power == 2)
+    {
+      for (size_t i = 0; i < dims; ++i)
+      {
+        const ElemType diff = pointMem[i] - col[i];
+        result += diff * diff;
+      }
+
+      if (TakeRoot)
+        result = std::sqrt(result);
+    }
+    else if (Power == INT_MAX)
+    {
+      for (size_t i = 0; i < dims; ++i)
+      {
+        const ElemType diff = std::abs(pointMem[i] - col[i]);
+        result = (diff > result) ? diff : result;
+      }
+    }
+    else
+    {
+      for (size_t i = 0; i < dims; ++i)
+        result += std::pow(std::abs(pointMem[i] - col[i]), Power);
+
+      if (TakeRoot)
+        result = std::pow(result, 1.0 / Power);
+    }
+
+    distances[j] = result;
+  }
+}
+
 } // namespace metric
 } // namespace mlpack
 
@@ -0,0 +1,74 @@
+/**
+ * @file batch_base_cases.hpp
+ *
+ * A utility for traversers to run the base cases between a query point and a
+ * range of consecutive reference points, such as all the points of a leaf, in
+ * one batch when the rules support it.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_TREE_BATCH_BASE_CASES_HPP
+#define MLPACK_CORE_TREE_BATCH_BASE_CASES_HPP
+
+#include <mlpack/prereqs.hpp>
+#include <mlpack/core/util/sfinae_utility.hpp>
+
+namespace mlpack {
+namespace tree {
+
+HAS_MEM_FUNC(BatchBaseCase, HasBatchBaseCaseCheck);
+
+/**
+ * 'value' is true if the RuleType class has a member
+ * BatchBaseCase(const size_t queryIndex, const size_t referenceBegin,
+ * const size_t referenceCount).
+ */
+template<typename RuleType>
+struct HasBatchBaseCase
+{
+  static const bool value = HasBatchBaseCaseCheck<RuleType,
+      void(RuleType::*)(const size_t, const size_t, const size_t)>::value;
+};
+
+/**
+ * Run the base cases between the given query point and the reference points
+ * referenceBegin, ..., referenceBegin + referenceCount - 1 with a single call to
+ * BatchBaseCase().  This overload is used when the rules have BatchBaseCase().
+ */
+template<typename RuleType>
+inline void BatchBaseCases(
+    RuleType& rule,
+    const size_t queryIndex,
+    const size_t referenceBegin,
+    const size_t referenceCount,
+    const typename std::enable_if<HasBatchBaseCase<RuleType>::value>::type* = 0)
+{
+  rule.BatchBaseCase(queryIndex, referenceBegin, referenceCount);
+}
+
+/**
+ * Run the base cases between the given query point and the reference points
+ * referenceBegin, ..., referenceBegin + referenceCount - 1 one at a time.  This
+ * overload is used when the rules don't have BatchBaseCase().
+ */
+template<typename RuleType>
+inline void BatchBaseCases(
+    RuleType& rule,
+    const size_t queryIndex,
+    const size_t referenceBegin,
+    const size_t referenceCount,
+    const typename std::enable_if<!HasBatchBaseCase<RuleType>::value>::type* =
+        0)
+{
+  const size_t referenceEnd = referenceBegin + referenceCount;
+  for (size_t i = referenceBegin; i < referenceEnd; ++i)
+    rule.BaseCase(queryIndex, i);
+}
+
+} // namespace tree
+} // namespace mlpack
+
+#endif
@@ -19,6 +19,13 @@
 namespace mlpack {
 namespace tree /** Trees and tree-building procedures. */ {
 
+//! The orders in which BinarySpaceTree::Compact() can store the nodes.
+enum NodeLayout
+{
+  BREADTH_FIRST_LAYOUT,
+  VAN_EMDE_BOAS_LAYOUT
+};
+
 /**
  * A binary space partitioning tree, such as a KD-tree or a ball tree.  Once the
  * bound and type of dataset is defined, the tree will construct itself.  Call
@@ -88,6 +95,11 @@ class BinarySpaceTree
   //! The dataset.  If we are the root of the tree, we own the dataset and must
   //! delete it.
   MatType* dataset;
+  //! The block of memory holding all nodes below this one, if Compact() was
+  //! called on this node (NULL otherwise).
+  BinarySpaceTree* arena;
+  //! The number of nodes in the arena.
+  size_t arenaSize;
 
  public:
   //! A single-tree traverser for binary space trees; see
@@ -314,6 +326,29 @@ class BinarySpaceTree
    */
   ~BinarySpaceTree();
 
+  /**
+   * Move all nodes of the tree (except the root, which is this node) into one
+   * contiguous block of memory, in the given order.  Nodes that are visited
+   * together by a traversal are then close together in memory, which reduces
+   * cache misses when traversing large trees.  In breadth-first order, each
+   * level of the tree is contiguous; in van Emde Boas order, every subtree of
+   * a recursively halved height is contiguous, which is independent of the
+   * size of the cache.  The structure of the tree does not change, so all
+   * algorithms work on the compacted tree as before.
+   *
+   * This can only be called on the root of the tree, and invalidates all
+   * pointers and references to other nodes of the tree.  Statistics that hold
+   * pointers to nodes have to be recomputed.  The tree can be compacted again
+   * (for instance, with another layout).  Copies of a compacted tree are not
+   * compacted.
+   *
+   * @param layout Order in which to store the nodes.
+   */
+  void Compact(const NodeLayout layout = BREADTH_FIRST_LAYOUT);
+
+  //! Return whether the nodes below this one were compacted by Compact().
+  bool IsCompact() const { return arena != NULL; }
+
   //! Return the bound object for this node.
   const BoundType<MetricType>& Bound() const { return bound; }
   //! Return the bound object for this node.
@@ -545,6 +580,35 @@ class BinarySpaceTree
    */
   void UpdateBound(bound::HollowBallBound<MetricType>& boundToUpdate);
 
+  /**
+   * Delete all nodes below this one, and set the children of this node to
+   * NULL.  This handles nodes that were compacted by Compact().
+   */
+  void DeleteChildren();
+
+  //! Return the height of the subtree rooted at the given node.
+  static size_t Height(const BinarySpaceTree* node);
+
+  /**
+   * Append the nodes of the subtree rooted at the given node, down to the
+   * given height, to the given vector in van Emde Boas order.
+   *
+   * @param node Root of the subtree.
+   * @param height Number of levels of the subtree to add.
+   * @param nodes Vector to append the nodes to.
+   */
+  static void VanEmdeBoasOrder(BinarySpaceTree* node,
+                               const size_t height,
+                               std::vector<BinarySpaceTree*>& nodes);
+
+  /**
+   * Append the nodes at the given depth below the given node to the given
+   * vector, from left to right.
+   */
+  static void NodesAtDepth(BinarySpaceTree* node,
+                           const size_t depth,
+                           std::vector<BinarySpaceTree*>& nodes);
+
  protected:
   /**
    * A default constructor.  This is meant to only be used with
@@ -40,7 +40,9 @@ BinarySpaceTree(
     count(data.n_cols), /* and spans all of the dataset. */
     bound(data.n_rows),
     parentDistance(0), // Parent distance for the root is 0: it has no parent.
-    dataset(new MatType(data)) // Copies the dataset.
+    dataset(new MatType(data)), // Copies the dataset.
+    arena(NULL),
+    arenaSize(0)
 {
   // Do the actual splitting of this node.
   SplitType<BoundType<MetricType>, MatType> splitter;
@@ -68,7 +70,9 @@ BinarySpaceTree(
     count(data.n_cols),
     bound(data.n_rows),
     parentDistance(0), // Parent distance for the root is 0: it has no parent.
-    dataset(new MatType(data)) // Copies the dataset.
+    dataset(new MatType(data)), // Copies the dataset.
+    arena(NULL),
+    arenaSize(0)
 {
   // Initialize oldFromNew correctly.
   oldFromNew.resize(data.n_cols);
@@ -102,7 +106,9 @@ BinarySpaceTree(
     count(data.n_cols),
     bound(data.n_rows),
     parentDistance(0), // Parent distance for the root is 0: it has no parent.
-    dataset(new MatType(data)) // Copies the dataset.
+    dataset(new MatType(data)), // Copies the dataset.
+    arena(NULL),
+    arenaSize(0)
 {
   // Initialize the oldFromNew vector correctly.
   oldFromNew.resize(data.n_cols);
@@ -137,7 +143,9 @@ BinarySpaceTree(MatType&& data, const size_t maxLeafSize) :
     count(data.n_cols),
     bound(data.n_rows),
     parentDistance(0), // Parent distance for the root is 0: it has no parent.
-    dataset(new MatType(std::move(data)))
+    dataset(new MatType(std::move(data))),
+    arena(NULL),
+    arenaSize(0)
 {
   // Do the actual splitting of this node.
   SplitType<BoundType<MetricType>, MatType> splitter;
@@ -165,7 +173,9 @@ BinarySpaceTree(
     count(data.n_cols),
     bound(data.n_rows),
     parentDistance(0), // Parent distance for the root is 0: it has no parent.
-    dataset(new MatType(std::move(data)))
+    dataset(new MatType(std::move(data))),
+    arena(NULL),
+    arenaSize(0)
 {
   // Initialize oldFromNew correctly.
   oldFromNew.resize(dataset->n_cols);
@@ -199,7 +209,9 @@ BinarySpaceTree(
     count(data.n_cols),
     bound(data.n_rows),
     parentDistance(0), // Parent distance for the root is 0: it has no parent.
-    dataset(new MatType(std::move(data)))
+    dataset(new MatType(std::move(data))),
+    arena(NULL),
+    arenaSize(0)
 {
   // Initialize the oldFromNew vector correctly.
   oldFromNew.resize(dataset->n_cols);
@@ -238,7 +250,9 @@ BinarySpaceTree(
     begin(begin),
     count(count),
     bound(parent->Dataset().n_rows),
-    dataset(&parent->Dataset()) // Point to the parent's dataset.
+    dataset(&parent->Dataset()), // Point to the parent's dataset.
+    arena(NULL),
+    arenaSize(0)
 {
   // Perform the actual splitting.
   SplitNode(maxLeafSize, splitter);
@@ -267,7 +281,9 @@ BinarySpaceTree(
     begin(begin),
     count(count),
     bound(parent->Dataset().n_rows),
-    dataset(&parent->Dataset())
+    dataset(&parent->Dataset()),
+    arena(NULL),
+    arenaSize(0)
 {
   // Hopefully the vector is initialized correctly!  We can't check that
   // entirely but we can do a minor sanity check.
@@ -301,7 +317,9 @@ BinarySpaceTree(
     begin(begin),
     count(count),
     bound(parent->Dataset()->n_rows),
-    dataset(&parent->Dataset())
+    dataset(&parent->Dataset()),
+    arena(NULL),
+    arenaSize(0)
 {
   // Hopefully the vector is initialized correctly!  We can't check that
   // entirely but we can do a minor sanity check.
@@ -343,7 +361,9 @@ BinarySpaceTree(
     furthestDescendantDistance(other.furthestDescendantDistance),
     minimumBoundDistance(other.minimumBoundDistance),
     // Copy matrix, but only if we are the root.
-    dataset((other.parent == NULL) ? new MatType(*other.dataset) : NULL)
+    dataset((other.parent == NULL) ? new MatType(*other.dataset) : NULL),
+    arena(NULL),
+    arenaSize(0)
 {
   // Create left and right children (if any).
   if (other.Left())
@@ -399,11 +419,8 @@ operator=(const BinarySpaceTree& other)
 
   // Freeing memory that will not be used anymore.
   delete dataset;
-  delete left;
-  delete right;
+  DeleteChildren();
 
-  left = NULL;
-  right = NULL;
   parent = other.Parent();
   begin = other.Begin();
   count = other.Count();
@@ -471,8 +488,7 @@ operator=(BinarySpaceTree&& other)
 
   // Freeing memory that will not be used anymore.
   delete dataset;
-  delete left;
-  delete right;
+  DeleteChildren();
 
   parent = other.Parent();
   left = other.Left();
@@ -485,6 +501,8 @@ operator=(BinarySpaceTree&& other)
   furthestDescendantDistance = other.FurthestDescendantDistance();
   minimumBoundDistance = other.MinimumBoundDistance();
   dataset = other.dataset;
+  arena = other.arena;
+  arenaSize = other.arenaSize;
 
   other.left = NULL;
   other.right = NULL;
@@ -495,6 +513,8 @@ operator=(BinarySpaceTree&& other)
   other.furthestDescendantDistance = 0.0;
   other.minimumBoundDistance = 0.0;
   other.dataset = NULL;
+  other.arena = NULL;
+  other.arenaSize = 0;
 
   return *this;
 }
@@ -521,7 +541,9 @@ BinarySpaceTree(BinarySpaceTree&& other) :
     parentDistance(other.parentDistance),
     furthestDescendantDistance(other.furthestDescendantDistance),
     minimumBoundDistance(other.minimumBoundDistance),
-    dataset(other.dataset)
+    dataset(other.dataset),
+    arena(other.arena),
+    arenaSize(other.arenaSize)
 {
   // Now we are a clone of the other tree.  But we must also clear the other
   // tree's contents, so it doesn't delete anything when it is destructed.
@@ -534,6 +556,8 @@ BinarySpaceTree(BinarySpaceTree&& other) :
   other.furthestDescendantDistance = 0.0;
   other.minimumBoundDistance = 0.0;
   other.dataset = NULL;
+  other.arena = NULL;
+  other.arenaSize = 0;
 
   // Set new parent.
   if (left)
@@ -577,14 +601,93 @@ template<typename MetricType,
 BinarySpaceTree<MetricType, StatisticType, MatType, BoundType, SplitType>::
     ~BinarySpaceTree()
 {
-  delete left;
-  delete right;
+  DeleteChildren();
 
   // If we're the root, delete the matrix.
   if (!parent)
     delete dataset;
 }
 
+/**
+ * Move all nodes below the root into one block of memory, in the given order.
+ */
+template<typename MetricType,
+         typename StatisticType,
+         typename MatType,
+         template<typename BoundMetricType, typename...> class BoundType,
+         template<typename SplitBoundType, typename SplitMatType>
+             class SplitType>
+void BinarySpaceTree<MetricType, StatisticType, MatType, BoundType, SplitType>::
+    Compact(const NodeLayout layout)
+{
+  if (parent != NULL)
+  {
+    throw std::invalid_argument("BinarySpaceTree::Compact(): can only be "
+        "called on the root of the tree");
+  }
+
+  // Find the new order of the nodes.  In both orders, every node comes after
+  // its parent, and the root comes first.
+  std::vector<BinarySpaceTree*> nodes;
+  if (layout == VAN_EMDE_BOAS_LAYOUT)
+  {
+    VanEmdeBoasOrder(this, Height(this), nodes);
+  }
+  else
+  {
+    std::queue<BinarySpaceTree*> queue;
+    queue.push(this);
+    while (!queue.empty())
+    {
+      BinarySpaceTree* node = queue.front();
+      queue.pop();
+
+      nodes.push_back(node);
+      if (node->left)
+        queue.push(node->left);
+      if (node->right)
+        queue.push(node->right);
+    }
+  }
+
+  // The root itself stays where it is.
+  const size_t newArenaSize = nodes.size() - 1;
+  if (newArenaSize == 0)
+    return;
+
+  BinarySpaceTree* newArena = static_cast<BinarySpaceTree*>(
+      ::operator new(newArenaSize * sizeof(BinarySpaceTree)));
+
+  // Move each node into the new block.  The parent of the node has already
+  // been moved, and the move constructor points the children of the node to
+  // the new node, so only the parent has to be pointed to the new node.
+  for (size_t i = 0; i < newArenaSize; ++i)
+  {
+    BinarySpaceTree* oldNode = nodes[i + 1];
+    BinarySpaceTree* node = new (newArena + i) BinarySpaceTree(
+        std::move(*oldNode));
+
+    if (node->parent->left == oldNode)
+      node->parent->left = node;
+    else
+      node->parent->right = node;
+
+    // The moved-from node is empty now.
+    if (arena == NULL)
+      delete oldNode;
+  }
+
+  if (arena != NULL)
+  {
+    for (size_t i = 0; i < arenaSize; ++i)
+      arena[i].~BinarySpaceTree();
+    ::operator delete(arena);
+  }
+
+  arena = newArena;
+  arenaSize = newArenaSize;
+}
+
 template<typename MetricType,
          typename StatisticType,
          typename MatType,
@@ -1050,7 +1153,9 @@ BinarySpaceTree<MetricType, StatisticType, MatType, BoundType, SplitType>::
     stat(*this),
     parentDistance(0),
     furthestDescendantDistance(0),
-    dataset(NULL)
+    dataset(NULL),
+    arena(NULL),
+    arenaSize(0)
 {
   // Nothing to do.
 }
@@ -1071,16 +1176,11 @@ void BinarySpaceTree<MetricType, StatisticType, MatType, BoundType, SplitType>::
   // If we're loading, and we have children, they need to be deleted.
   if (Archive::is_loading::value)
   {
-    if (left)
-      delete left;
-    if (right)
-      delete right;
+    DeleteChildren();
     if (!parent)
       delete dataset;
 
     parent = NULL;
-    left = NULL;
-    right = NULL;
   }
 
   ar & BOOST_SERIALIZATION_NVP(begin);
@@ -1112,6 +1212,107 @@ void BinarySpaceTree<MetricType, StatisticType, MatType, BoundType, SplitType>::
   }
 }
 
+template<typename MetricType,
+         typename StatisticType,
+         typename MatType,
+         template<typename BoundMetricType, typename...> class BoundType,
+         template<typename SplitBoundType, typename SplitMatType>
+             class SplitType>
+void BinarySpaceTree<MetricType, StatisticType, MatType, BoundType, SplitType>::
+    DeleteChildren()
+{
+  if (arena != NULL)
+  {
+    // The nodes in the arena must not delete each other; destroy them in
+    // reverse order (children before parents) and then free the block.
+    for (size_t i = arenaSize; i > 0; --i)
+    {
+      arena[i - 1].left = NULL;
+      arena[i - 1].right = NULL;
+      arena[i - 1].~BinarySpaceTree();
+    }
+
+    ::operator delete(arena);
+    arena = NULL;
+    arenaSize = 0;
+  }
+  else
+  {
+    delete left;
+    delete right;
+  }
+
+  left = NULL;
+  right = NULL;
+}
+
+template<typename MetricType,
+         typename StatisticType,
+         typename MatType,
+         template<typename BoundMetricType, typename...> class BoundType,
+         template<typename SplitBoundType, typename SplitMatType>
+             class SplitType>
+size_t BinarySpaceTree<MetricType, StatisticType, MatType, BoundType,
+    SplitType>::Height(const BinarySpaceTree* node)
+{
+  if (node == NULL)
+    return 0;
+
+  return 1 + std::max(Height(node->left), Height(node->right));
+}
+
+template<typename MetricType,
+         typename StatisticType,
+         typename MatType,
+         template<typename BoundMetricType, typename...> class BoundType,
+         template<typename SplitBoundType, typename SplitMatType>
+             class SplitType>
+void BinarySpaceTree<MetricType, StatisticType, MatType, BoundType, SplitType>::
+    VanEmdeBoasOrder(BinarySpaceTree* node,
+                     const size_t height,
+                     std::vector<BinarySpaceTree*>& nodes)
+{
+  if (height == 1)
+  {
+    nodes.push_back(node);
+    return;
+  }
+
+  // First the top half of the levels, then each subtree hanging below it, from
+  // left to right.
+  const size_t topHeight = height / 2;
+  VanEmdeBoasOrder(node, topHeight, nodes);
+
+  std::vector<BinarySpaceTree*> bottomRoots;
+  NodesAtDepth(node, topHeight, bottomRoots);
+  for (size_t i = 0; i < bottomRoots.size(); ++i)
+    VanEmdeBoasOrder(bottomRoots[i], height - topHeight, nodes);
+}
+
+template<typename MetricType,
+         typename StatisticType,
+         typename MatType,
+         template<typename BoundMetricType, typename...> class BoundType,
+         template<typename SplitBoundType, typename SplitMatType>
+             class SplitType>
+void BinarySpaceTree<MetricType, StatisticType, MatType, BoundType, SplitType>::
+    NodesAtDepth(BinarySpaceTree* node,
+                 const size_t depth,
+                 std::vector<BinarySpaceTree*>& nodes)
+{
+  if (node == NULL)
+    return;
+
+  if (depth == 0)
+  {
+    nodes.push_back(node);
+    return;
+  }
+
+  NodesAtDepth(node->left, depth - 1, nodes);
+  NodesAtDepth(node->right, depth - 1, nodes);
+}
+
 } // namespace tree
 } // namespace mlpack
 
@@ -16,6 +16,7 @@
 
 // In case it hasn't been included yet.
 #include "dual_tree_traverser.hpp"
+#include <mlpack/core/tree/batch_base_cases.hpp>
 
 namespace mlpack {
 namespace tree {
@@ -73,7 +74,6 @@ DualTreeTraverser<RuleType>::Traverse(
   {
     // Loop through each of the points in each node.
     const size_t queryEnd = queryNode.Begin() + queryNode.Count();
-    const size_t refEnd = referenceNode.Begin() + referenceNode.Count();
     for (size_t query = queryNode.Begin(); query < queryEnd; ++query)
     {
       // See if we need to investigate this point (this function should be
@@ -85,8 +85,8 @@ DualTreeTraverser<RuleType>::Traverse(
       if (childScore == DBL_MAX)
         continue; // We can't improve this particular point.
 
-      for (size_t ref = referenceNode.Begin(); ref < refEnd; ++ref)
-        rule.BaseCase(query, ref);
+      BatchBaseCases(rule, query, referenceNode.Begin(),
+          referenceNode.Count());
 
       numBaseCases += referenceNode.Count();
     }
@@ -50,6 +50,11 @@ namespace tree {
  * -- non-leaf nodes with more than one child.  A leaf node has no children, and
  * its scale level is INT_MIN.
  *
+ * When mlpack is compiled with OpenMP, the distances to the large point sets
+ * near the root of the tree, which make up most of the construction time, are
+ * computed with all available threads.  The tree that is built is the same for
+ * any number of threads.
+ *
  * For more information on cover trees, see
  *
  * @code
@@ -459,14 +464,68 @@ class CoverTree
   //! The metric used for this tree.
   MetricType* metric;
 
+  //! The smallest point set whose distances are computed with several threads.
+  static const size_t ParallelDistancesThreshold = 4096;
+  //! The smallest near set whose children are built independently of each
+  //! other (see CreateIndependentChildren()).
+  static const size_t IndependentChildrenThreshold = 4096;
+
   /**
    * Create the children for this node.
+   *
+   * @param indices Array of indices, ordered [ nearSet | farSet | usedSet ].
+   * @param distances Array of distances, ordered the same way as the indices.
+   * @param nearSetSize Size of the near set.
+   * @param farSetSize Size of the far set; may be modified.
+   * @param usedSetSize The number of points used will be added to this number.
+   * @param inBuildTasks If true, this is called from an OpenMP task of the
+   *     tree construction, and independent children may be built in new tasks.
    */
   void CreateChildren(arma::Col<size_t>& indices,
                       arma::vec& distances,
                       size_t nearSetSize,
                       size_t& farSetSize,
-                      size_t& usedSetSize);
+                      size_t& usedSetSize,
+                      const bool inBuildTasks = false);
+
+  /**
+   * Create the children for this node, at the given scale, such that they can
+   * be built independently of each other.  Unlike in CreateChildren(), each
+   * child only gets a near set (every point within the bound of the child that
+   * no earlier child took), and no far set, so the children can't take points
+   * from each other.  The near sets are found first, and then the subtrees are
+   * built in parallel with OpenMP tasks.  The tree may differ from the one
+   * CreateChildren() would build, but it is a valid cover tree, and it does not
+   * depend on the number of threads.
+   *
+   * @param indices Array of indices, ordered [ nearSet | farSet | usedSet ].
+   * @param distances Array of distances, ordered the same way as the indices.
+   * @param nearSetSize Size of the near set.
+   * @param farSetSize Size of the far set; may be modified.
+   * @param usedSetSize The number of points used will be added to this number.
+   * @param nextScale Scale of the children.
+   * @param inBuildTasks If true, this is called from an OpenMP task of the
+   *     tree construction, so the subtrees are built in new tasks.
+   */
+  void CreateIndependentChildren(arma::Col<size_t>& indices,
+                                 arma::vec& distances,
+                                 size_t nearSetSize,
+                                 size_t& farSetSize,
+                                 size_t& usedSetSize,
+                                 const int nextScale,
+                                 const bool inBuildTasks);
+
+  /**
+   * Build the subtrees of the given new children, whose near sets are stored
+   * one after the other in the given arrays; the near set of child i starts at
+   * nearSetBegins[i] and ends at nearSetBegins[i + 1].  If inBuildTasks is
+   * true, each subtree is built in its own OpenMP task.
+   */
+  void BuildIndependentChildren(const std::vector<CoverTree*>& newChildren,
+                                arma::Col<size_t>& childIndices,
+                                arma::vec& childDistances,
+                                const std::vector<size_t>& nearSetBegins,
+                                const bool inBuildTasks);
 
   /**
    * Fill the vector of distances with the distances between the point specified
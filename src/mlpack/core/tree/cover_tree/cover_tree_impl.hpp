@@ -1138,7 +1138,8 @@ CoverTree<MetricType, StatisticType, MatType, RootPointPolicy>::CreateChildren(
     arma::vec& distances,
     size_t nearSetSize,
     size_t& farSetSize,
-    size_t& usedSetSize)
+    size_t& usedSetSize,
+    const bool inBuildTasks)
 {
   // Determine the next scale level.  This should be the first level where there
   // are any points in the far set.  So, if we know the maximum distance in the
@@ -1185,6 +1186,15 @@ CoverTree<MetricType, StatisticType, MatType, RootPointPolicy>::CreateChildren(
 
   const int nextScale = std::min(scale,
       (int) ceil(log(maxDistance) / log(base))) - 1;
+
+  // Near the root of the tree, build the children in parallel.
+  if (nearSetSize >= IndependentChildrenThreshold)
+  {
+    CreateIndependentChildren(indices, distances, nearSetSize, farSetSize,
+        usedSetSize, nextScale, inBuildTasks);
+    return;
+  }
+
   const ElemType bound = pow(base, nextScale);
 
   // First, make the self child.  We must split the given near set into the near
@@ -1321,6 +1331,205 @@ CoverTree<MetricType, StatisticType, MatType, RootPointPolicy>::CreateChildren(
       furthestDescendantDistance = distances[i];
 }
 
+template<
+    typename MetricType,
+    typename StatisticType,
+    typename MatType,
+    typename RootPointPolicy
+>
+void CoverTree<MetricType, StatisticType, MatType, RootPointPolicy>::
+    CreateIndependentChildren(arma::Col<size_t>& indices,
+                              arma::vec& distances,
+                              size_t nearSetSize,
+                              size_t& farSetSize,
+                              size_t& usedSetSize,
+                              const int nextScale,
+                              const bool inBuildTasks)
+{
+  const ElemType bound = pow(base, nextScale);
+
+  // The near sets of the children are stored one after the other.  Together,
+  // they can't hold more points than the near and far set.
+  std::vector<CoverTree*> newChildren;
+  arma::Col<size_t> childIndices(nearSetSize + farSetSize);
+  arma::vec childDistances(nearSetSize + farSetSize);
+  std::vector<size_t> nearSetBegins(1, 0);
+
+  // The near set of the self child holds the points of our near set within the
+  // bound, and we already know the distances to them.  Move them to the used
+  // set: [ childNear | near | far | used ] becomes [ near | far | used ].
+  const size_t selfNearSetSize =
+      SplitNearFar(indices, distances, bound, nearSetSize);
+  newChildren.push_back(new CoverTree(*dataset, base, point, nextScale, this,
+      0, 0, metric));
+  for (size_t i = 0; i < selfNearSetSize; ++i)
+  {
+    childIndices[i] = indices[i];
+    childDistances[i] = distances[i];
+  }
+  nearSetBegins.push_back(selfNearSetSize);
+
+  SortPointSet(indices, distances, 0, selfNearSetSize,
+      nearSetSize - selfNearSetSize + farSetSize);
+  nearSetSize -= selfNearSetSize;
+  usedSetSize += selfNearSetSize;
+
+  // Each other child is centered at a point of the near set.
+  while (nearSetSize > 0)
+  {
+    // Swap the last point of the near set to the front.
+    const size_t newPointIndex = nearSetSize - 1;
+    if (newPointIndex != 0)
+    {
+      const size_t tempIndex = indices[newPointIndex];
+      const ElemType tempDist = distances[newPointIndex];
+
+      indices[newPointIndex] = indices[0];
+      distances[newPointIndex] = distances[0];
+
+      indices[0] = tempIndex;
+      distances[0] = tempDist;
+    }
+
+    newChildren.push_back(new CoverTree(*dataset, base, indices[0], nextScale,
+        this, distances[0], 0, metric));
+
+    // Compute the distances from the new point to the rest of the near and far
+    // set.
+    const size_t pointSetSize = nearSetSize + farSetSize - 1;
+    arma::Col<size_t> pointIndices(indices.memptr() + 1, pointSetSize);
+    arma::vec pointDistances(pointSetSize);
+    ComputeDistances(indices[0], pointIndices, pointDistances, pointSetSize);
+
+    // The points within the bound make up the near set of the child.  Take
+    // them (and the new point itself) out of our near and far set, which keep
+    // their order, and put them into the used set right after the far set.
+    size_t childNearSetEnd = nearSetBegins.back();
+    arma::Col<size_t> usedIndices(pointSetSize + 1);
+    arma::vec usedDistances(pointSetSize + 1);
+    usedIndices[0] = indices[0];
+    usedDistances[0] = distances[0];
+    size_t newUsedSetSize = 1;
+    size_t newNearSetSize = 0;
+    size_t newFarSetSize = 0;
+    for (size_t i = 0; i < pointSetSize; ++i)
+    {
+      const size_t from = i + 1;
+      if (pointDistances[i] <= bound)
+      {
+        usedIndices[newUsedSetSize] = indices[from];
+        usedDistances[newUsedSetSize] = distances[from];
+        ++newUsedSetSize;
+
+        childIndices[childNearSetEnd] = indices[from];
+        childDistances[childNearSetEnd] = pointDistances[i];
+        ++childNearSetEnd;
+      }
+      else
+      {
+        // The point stays in the near or far set; points only move forward.
+        const size_t to = (from < nearSetSize) ? newNearSetSize++ :
+            newNearSetSize + newFarSetSize++;
+        indices[to] = indices[from];
+        distances[to] = distances[from];
+      }
+    }
+
+    for (size_t i = 0; i < newUsedSetSize; ++i)
+    {
+      indices[newNearSetSize + newFarSetSize + i] = usedIndices[i];
+      distances[newNearSetSize + newFarSetSize + i] = usedDistances[i];
+    }
+
+    nearSetSize = newNearSetSize;
+    farSetSize = newFarSetSize;
+    usedSetSize += newUsedSetSize;
+    nearSetBegins.push_back(childNearSetEnd);
+  }
+
+  // Build the subtrees.  If we aren't in a task of the tree construction yet,
+  // start the tasks here; trees built inside another parallel region (such as
+  // by the parallel FastMKS search) are built serially.
+#ifdef HAS_OPENMP
+  if (!inBuildTasks && !omp_in_parallel() && omp_get_max_threads() > 1)
+  {
+    #pragma omp parallel
+    #pragma omp single
+    BuildIndependentChildren(newChildren, childIndices, childDistances,
+        nearSetBegins, true);
+  }
+  else
+#endif
+  {
+    BuildIndependentChildren(newChildren, childIndices, childDistances,
+        nearSetBegins, inBuildTasks);
+  }
+
+  for (size_t i = 0; i < newChildren.size(); ++i)
+  {
+    children.push_back(newChildren[i]);
+    numDescendants += children.back()->NumDescendants();
+
+    // Remove any implicit nodes.
+    RemoveNewImplicitNodes();
+
+    distanceComps += children.back()->DistanceComps();
+  }
+
+  // Every descendant is in the used set now.
+  furthestDescendantDistance = 0;
+  for (size_t i = (nearSetSize + farSetSize); i < (nearSetSize + farSetSize +
+      usedSetSize); ++i)
+    if (distances[i] > furthestDescendantDistance)
+      furthestDescendantDistance = distances[i];
+}
+
+template<
+    typename MetricType,
+    typename StatisticType,
+    typename MatType,
+    typename RootPointPolicy
+>
+void CoverTree<MetricType, StatisticType, MatType, RootPointPolicy>::
+    BuildIndependentChildren(const std::vector<CoverTree*>& newChildren,
+                             arma::Col<size_t>& childIndices,
+                             arma::vec& childDistances,
+                             const std::vector<size_t>& nearSetBegins,
+                             const bool inBuildTasks)
+{
+  for (size_t i = 0; i < newChildren.size(); ++i)
+  {
+    CoverTree* child = newChildren[i];
+    size_t* nearIndices = childIndices.memptr() + nearSetBegins[i];
+    double* nearDistances = childDistances.memptr() + nearSetBegins[i];
+    const size_t nearSetSize = nearSetBegins[i + 1] - nearSetBegins[i];
+
+    // Each task only touches its own child and its own part of the arrays.
+    #pragma omp task if (inBuildTasks) \
+        firstprivate(child, nearIndices, nearDistances, nearSetSize)
+    {
+      if (nearSetSize == 0)
+      {
+        // The child is a leaf.
+        child->scale = INT_MIN;
+        child->numDescendants = 1;
+      }
+      else
+      {
+        // The arrays use the memory of the given arrays without copying it.
+        arma::Col<size_t> indices(nearIndices, nearSetSize, false, true);
+        arma::vec distances(nearDistances, nearSetSize, false, true);
+        size_t farSetSize = 0;
+        size_t usedSetSize = 0;
+        child->CreateChildren(indices, distances, nearSetSize, farSetSize,
+            usedSetSize, inBuildTasks);
+      }
+    }
+  }
+
+  #pragma omp taskwait
+}
+
 template<
     typename MetricType,
     typename StatisticType,
@@ -1392,9 +1601,15 @@ void CoverTree<MetricType, StatisticType, MatType, RootPointPolicy>::
                      const size_t pointSetSize)
 {
   // For each point, rebuild the distances.  The indices do not need to be
-  // modified.
+  // modified.  Near the root of the tree the point sets hold most of the
+  // dataset, so large sets are split between threads; each distance is written
+  // by exactly one thread, so the tree does not depend on the number of
+  // threads.  Trees built inside a parallel region (such as by the parallel
+  // FastMKS search) compute the distances serially.
   distanceComps += pointSetSize;
-  for (size_t i = 0; i < pointSetSize; ++i)
+  #pragma omp parallel for schedule(static) \
+      if (pointSetSize >= ParallelDistancesThreshold && !omp_in_parallel())
+  for (omp_size_t i = 0; i < (omp_size_t) pointSetSize; ++i)
   {
     distances[i] = metric->Evaluate(dataset->col(pointIndex),
         dataset->col(indices[i]));
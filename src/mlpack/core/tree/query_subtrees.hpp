@@ -0,0 +1,79 @@
+/**
+ * @file query_subtrees.hpp
+ *
+ * Utilities to split a query tree into subtrees that can be traversed
+ * independently, so that parallel dual-tree algorithms can hand out the
+ * subtrees to different threads.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_TREE_QUERY_SUBTREES_HPP
+#define MLPACK_CORE_TREE_QUERY_SUBTREES_HPP
+
+#include <mlpack/prereqs.hpp>
+#include <mlpack/core/tree/tree_traits.hpp>
+
+namespace mlpack {
+namespace tree {
+
+/**
+ * 'value' is true if the subtrees of a tree of type TreeType can be traversed
+ * independently as query trees; that is, if each point belongs to exactly one
+ * subtree.  This is not the case for trees with self-children (like the cover
+ * tree) or with duplicated points (like the spill tree).
+ */
+template<typename TreeType>
+struct HasIndependentSubtrees
+{
+  static const bool value = !TreeTraits<TreeType>::HasSelfChildren &&
+      !TreeTraits<TreeType>::HasDuplicatedPoints &&
+      TreeTraits<TreeType>::UniqueNumDescendants;
+};
+
+/**
+ * Split the upper levels of the given tree, one level at a time, until there
+ * are at least the given number of subtrees or no subtree can be split further.
+ * A node that holds points itself is not split, because those points would then
+ * not belong to any subtree.  If the subtrees of the tree can't be traversed
+ * independently (see HasIndependentSubtrees), the tree itself is the only
+ * subtree.
+ *
+ * @param tree Tree to split.
+ * @param minSubtrees Number of subtrees to stop splitting at.
+ * @param subtrees Vector to store the subtrees in.
+ */
+template<typename TreeType>
+void SplitQuerySubtrees(TreeType& tree,
+                        const size_t minSubtrees,
+                        std::vector<TreeType*>& subtrees)
+{
+  subtrees.assign(1, &tree);
+  bool splitAny = HasIndependentSubtrees<TreeType>::value;
+  while (splitAny && subtrees.size() < minSubtrees)
+  {
+    splitAny = false;
+    std::vector<TreeType*> nextSubtrees;
+    for (size_t i = 0; i < subtrees.size(); ++i)
+    {
+      if (subtrees[i]->NumChildren() == 0 || subtrees[i]->NumPoints() > 0)
+      {
+        nextSubtrees.push_back(subtrees[i]);
+        continue;
+      }
+
+      for (size_t j = 0; j < subtrees[i]->NumChildren(); ++j)
+        nextSubtrees.push_back(&subtrees[i]->Child(j));
+      splitAny = true;
+    }
+
+    subtrees.swap(nextSubtrees);
+  }
+}
+
+} // namespace tree
+} // namespace mlpack
+
+#endif
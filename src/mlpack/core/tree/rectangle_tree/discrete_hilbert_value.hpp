@@ -197,6 +197,17 @@ class DiscreteHilbertValue
   template<typename TreeType>
   void UpdateLargestValue(TreeType* node);
 
+  /**
+   * Set the Hilbert values of a node that was built by bulk loading, once its
+   * points or children are set.  The Hilbert values of the points of a leaf
+   * are calculated (the points must already be sorted by Hilbert value), and
+   * an intermediate node takes the largest Hilbert value of its last child.
+   *
+   * @param node The node in which the values should be set.
+   */
+  template<typename TreeType>
+  void BulkLoadValues(TreeType* node);
+
   /**
    * This method updates the largest Hilbert value of a leaf node and
    * redistributes the Hilbert values of points according to their new position
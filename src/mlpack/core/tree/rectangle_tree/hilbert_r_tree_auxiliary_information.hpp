@@ -14,6 +14,8 @@
 #ifndef MLPACK_CORE_TREE_RECTANGLE_TREE_HR_TREE_AUXILIARY_INFO_HPP
 #define MLPACK_CORE_TREE_RECTANGLE_TREE_HR_TREE_AUXILIARY_INFO_HPP
 
+#include "../hrectbound.hpp"
+
 namespace mlpack {
 namespace tree {
 
@@ -109,6 +111,28 @@ class HilbertRTreeAuxiliaryInformation
    */
   bool HandleNodeRemoval(TreeType* node, const size_t nodeIndex);
 
+  /**
+   * The Hilbert R tree is bulk loaded by packing the points in the order of
+   * their Hilbert values.  This method sorts the points of the dataset of the
+   * node by Hilbert value, and returns true, so that the nodes take
+   * consecutive runs of the points.
+   *
+   * @param node The root of the tree that is being bulk loaded.
+   * @param points The indices of the points in the dataset; will be sorted.
+   */
+  bool HandleBulkLoad(TreeType* node, std::vector<size_t>& points);
+
+  /**
+   * Set the Hilbert values of a node that was built by bulk loading, once its
+   * points or children are set.
+   *
+   * @param node The node that was built.
+   * @param cell The region of space assigned to the node (not used here).
+   */
+  void BulkLoadAuxiliaryInfo(
+      TreeType* node,
+      const bound::HRectBound<metric::EuclideanDistance, ElemType>& cell);
+
   /**
    * Update the auxiliary information in the node. The method returns true if
    * the update should be propagated downward.
@@ -150,6 +150,56 @@ HandleNodeRemoval(TreeType* node, const size_t nodeIndex)
   return true;
 }
 
+template<typename TreeType,
+         template<typename> class HilbertValueType>
+bool HilbertRTreeAuxiliaryInformation<TreeType, HilbertValueType>::
+HandleBulkLoad(TreeType* node, std::vector<size_t>& points)
+{
+  typedef typename HilbertValueType<ElemType>::HilbertElemType HilbertElemType;
+
+  const typename TreeType::Mat& dataset = node->Dataset();
+  arma::Mat<HilbertElemType> values(dataset.n_rows, points.size());
+  #pragma omp parallel for schedule(static)
+  for (omp_size_t i = 0; i < (omp_size_t) points.size(); ++i)
+  {
+    values.col(i) = HilbertValueType<ElemType>::CalculateValue(
+        dataset.col(points[i]));
+  }
+
+  // Hilbert values are compared lexicographically; ties are broken by the
+  // index of the point.
+  std::vector<size_t> order(points.size());
+  for (size_t i = 0; i < order.size(); ++i)
+    order[i] = i;
+
+  std::sort(order.begin(), order.end(), [&](const size_t a, const size_t b)
+  {
+    const HilbertElemType* aValue = values.colptr(a);
+    const HilbertElemType* bValue = values.colptr(b);
+    for (size_t k = 0; k < values.n_rows; ++k)
+      if (aValue[k] != bValue[k])
+        return aValue[k] < bValue[k];
+    return points[a] < points[b];
+  });
+
+  std::vector<size_t> sortedPoints(points.size());
+  for (size_t i = 0; i < order.size(); ++i)
+    sortedPoints[i] = points[order[i]];
+  points.swap(sortedPoints);
+
+  return true;
+}
+
+template<typename TreeType,
+         template<typename> class HilbertValueType>
+void HilbertRTreeAuxiliaryInformation<TreeType, HilbertValueType>::
+BulkLoadAuxiliaryInfo(
+    TreeType* node,
+    const bound::HRectBound<metric::EuclideanDistance, ElemType>& /* cell */)
+{
+  hilbertValue.BulkLoadValues(node);
+}
+
 template<typename TreeType,
          template<typename> class HilbertValueType>
 bool HilbertRTreeAuxiliaryInformation<TreeType, HilbertValueType>::
@@ -101,6 +101,38 @@ class NoAuxiliaryInformation
     return false;
   }
 
+  /**
+   * Some tree types require the points to be bulk loaded in a certain order.
+   * This method allows the auxiliary information the option of sorting the
+   * points before the tree is bulk loaded. If the auxiliary information does
+   * that, then the method should return true and the nodes will hold
+   * consecutive runs of the sorted points; if the method returns false the
+   * points are tiled with Sort-Tile-Recursive.
+   *
+   * @param node The root of the tree that is being bulk loaded.
+   * @param points The indices of the points in the dataset.
+   */
+  bool HandleBulkLoad(TreeType* /* node */, std::vector<size_t>& /* points */)
+  {
+    return false;
+  }
+
+  /**
+   * Some tree types require to save some properties of the nodes that are
+   * created by bulk loading.  This method is called for each node once its
+   * points or children are set, from the leaves up.
+   *
+   * @param node The node that was built.
+   * @param cell The region of space assigned to the node.  The regions of the
+   *        children of a node cover the region of the node without overlapping
+   *        (except on their boundaries).
+   */
+  void BulkLoadAuxiliaryInfo(
+      TreeType* /* node */,
+      const bound::HRectBound<metric::EuclideanDistance,
+                              typename TreeType::ElemType>& /* cell */)
+  { }
+
   /**
    * Some tree types require to propagate the information upward.
    * This method should return false if this is not the case. If true is
@@ -113,6 +113,25 @@ class RPlusPlusTreeAuxiliaryInformation
    */
   bool HandleNodeRemoval(TreeType* /* node */, const size_t /* nodeIndex */);
 
+  /**
+   * The R++ tree does not require the points to be bulk loaded in a certain
+   * order, so the points are tiled with Sort-Tile-Recursive.  This method
+   * returns false.
+   *
+   * @param node The root of the tree that is being bulk loaded.
+   * @param points The indices of the points in the dataset.
+   */
+  bool HandleBulkLoad(TreeType* /* node */, std::vector<size_t>& /* points */);
+
+  /**
+   * The maximum bounding rectangle of a node that was built by bulk loading is
+   * the region of space assigned to the node; the regions of the children of a
+   * node cover the region of the node.
+   *
+   * @param node The node that was built.
+   * @param cell The region of space assigned to the node.
+   */
+  void BulkLoadAuxiliaryInfo(TreeType* /* node */, const BoundType& cell);
 
   /**
    * Some tree types require to propagate the information upward.
@@ -89,6 +89,20 @@ bool RPlusPlusTreeAuxiliaryInformation<TreeType>::HandleNodeRemoval(
   return false;
 }
 
+template<typename TreeType>
+bool RPlusPlusTreeAuxiliaryInformation<TreeType>::HandleBulkLoad(
+    TreeType* /* node */, std::vector<size_t>& /* points */)
+{
+  return false;
+}
+
+template<typename TreeType>
+void RPlusPlusTreeAuxiliaryInformation<TreeType>::BulkLoadAuxiliaryInfo(
+    TreeType* /* node */, const BoundType& cell)
+{
+  outerBound = cell;
+}
+
 template<typename TreeType>
 bool RPlusPlusTreeAuxiliaryInformation<TreeType>::UpdateAuxiliaryInfo(
     TreeType* /* node */)
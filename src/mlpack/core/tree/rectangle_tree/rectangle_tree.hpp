@@ -64,6 +64,10 @@ class RectangleTree
   typedef typename MatType::elem_type ElemType;
   //! The auxiliary information type held by the tree.
   typedef AuxiliaryInformationType<RectangleTree> AuxiliaryInformation;
+
+  //! A tag type to select the bulk loading constructors.
+  struct BulkLoadTag { };
+
  private:
   //! The max number of child nodes a non-leaf node can have.
   size_t maxNumChildren;
@@ -156,6 +160,62 @@ class RectangleTree
                 const size_t minNumChildren = 2,
                 const size_t firstDataIndex = 0);
 
+  /**
+   * Construct this as the root node of a rectangle type tree using the given
+   * dataset, building the whole tree at once instead of inserting the points
+   * one at a time.  This is much faster than the other constructors for large
+   * datasets.
+   *
+   * The points are split top-down: the points of each node are divided among
+   * as few children as possible with Sort-Tile-Recursive, which sorts the
+   * points into slabs along the dimension in which they are spread the most,
+   * and then tiles each slab recursively.  The Hilbert R tree instead packs
+   * consecutive runs of the points sorted by their Hilbert values.  The leaves
+   * are packed nearly full, all the leaves are at the same depth, and the
+   * children of a node do not overlap (except on their boundaries), so the
+   * tree is also valid for R+ and R++ trees.  Once the top levels are split,
+   * the subtrees are built in parallel.
+   *
+   * Points can be inserted and deleted afterwards, as with the other
+   * constructors.
+   *
+   * @param data Dataset from which to create the tree.
+   * @param tag Selects bulk loading; pass BulkLoadTag().
+   * @param maxLeafSize Maximum size of each leaf in the tree.
+   * @param minLeafSize Minimum size of each leaf in the tree.
+   * @param maxNumChildren The maximum number of child nodes a non-leaf node may
+   *      have.
+   * @param minNumChildren The minimum number of child nodes a non-leaf node may
+   *      have.
+   */
+  RectangleTree(const MatType& data,
+                const BulkLoadTag tag,
+                const size_t maxLeafSize = 20,
+                const size_t minLeafSize = 8,
+                const size_t maxNumChildren = 5,
+                const size_t minNumChildren = 2);
+
+  /**
+   * Construct this as the root node of a rectangle type tree using the given
+   * dataset with bulk loading (see above), and taking ownership of the given
+   * dataset.
+   *
+   * @param data Dataset from which to create the tree.
+   * @param tag Selects bulk loading; pass BulkLoadTag().
+   * @param maxLeafSize Maximum size of each leaf in the tree.
+   * @param minLeafSize Minimum size of each leaf in the tree.
+   * @param maxNumChildren The maximum number of child nodes a non-leaf node may
+   *      have.
+   * @param minNumChildren The minimum number of child nodes a non-leaf node may
+   *      have.
+   */
+  RectangleTree(MatType&& data,
+                const BulkLoadTag tag,
+                const size_t maxLeafSize = 20,
+                const size_t minLeafSize = 8,
+                const size_t maxNumChildren = 5,
+                const size_t minNumChildren = 2);
+
   /**
    * Construct this as an empty node with the specified parent.  Copying the
    * parameters (maxLeafSize, minLeafSize, maxNumChildren, minNumChildren,
@@ -563,6 +623,86 @@ class RectangleTree
    */
   void BuildStatistics(RectangleTree* node);
 
+  //! The type of the region of space assigned to a node during bulk loading.
+  typedef bound::HRectBound<metric::EuclideanDistance, ElemType> CellType;
+
+  //! A node that is being bulk loaded, with its points and its region.
+  struct BulkLoadNode
+  {
+    //! The node.
+    RectangleTree* node;
+    //! The position of the first point of the node in the point order.
+    size_t begin;
+    //! The position after the last point of the node in the point order.
+    size_t end;
+    //! The region of space assigned to the node.
+    CellType cell;
+  };
+
+  /**
+   * Build the tree below this (empty) root node with bulk loading.
+   */
+  void BulkLoad();
+
+  /**
+   * Create the children of a bulk loaded node at the given height (a leaf has
+   * height 1), and divide its points among them.  The new children are added
+   * to the given list.
+   *
+   * @param order The order of the points; reordered for the children.
+   * @param node The node to split, with its points and region.
+   * @param height The height of the node.
+   * @param packed If true, the children take consecutive runs of the points
+   *     in their current order; otherwise the points are tiled.
+   * @param newNodes The list to add the children to.
+   */
+  void SplitBulkLoadedNode(std::vector<size_t>& order,
+                           const BulkLoadNode& node,
+                           const size_t height,
+                           const bool packed,
+                           std::vector<BulkLoadNode>& newNodes);
+
+  /**
+   * Build the whole subtree of a bulk loaded node at the given height.
+   *
+   * @param order The order of the points; reordered for the subtree.
+   * @param node This node, with its points and region.
+   * @param height The height of the node.
+   * @param packed If true, nodes take consecutive runs of the points.
+   */
+  void BuildBulkLoadedNode(std::vector<size_t>& order,
+                           const BulkLoadNode& node,
+                           const size_t height,
+                           const bool packed);
+
+  /**
+   * Set the bound, the number of descendants and the auxiliary information of
+   * a bulk loaded node, once its points or children are set.
+   *
+   * @param cell The region of space assigned to the node.
+   */
+  void FinishBulkLoadedNode(const CellType& cell);
+
+  /**
+   * Reorder the points of consecutive groups with Sort-Tile-Recursive, so that
+   * each group holds a tile of the points, and narrow the regions of the
+   * groups to their tiles.
+   *
+   * @param order The order of the points.
+   * @param boundaries The position of the first point of each group, and the
+   *     position after the last point.
+   * @param cells The region of each group.
+   * @param firstGroup The first group to tile.
+   * @param endGroup The group after the last group to tile.
+   * @param numDimensions The number of dimensions left to slice along.
+   */
+  void TileBulkLoadedPoints(std::vector<size_t>& order,
+                            const std::vector<size_t>& boundaries,
+                            std::vector<CellType>& cells,
+                            const size_t firstGroup,
+                            const size_t endGroup,
+                            const size_t numDimensions);
+
  protected:
   /**
    * A default constructor.  This is meant to only be used with
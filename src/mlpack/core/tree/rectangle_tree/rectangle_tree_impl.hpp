@@ -122,6 +122,80 @@ RectangleTree(MatType&& data,
   BuildStatistics(this);
 }
 
+template<typename MetricType,
+         typename StatisticType,
+         typename MatType,
+         typename SplitType,
+         typename DescentType,
+         template<typename> class AuxiliaryInformationType>
+RectangleTree<MetricType, StatisticType, MatType, SplitType, DescentType,
+              AuxiliaryInformationType>::
+RectangleTree(const MatType& data,
+              const BulkLoadTag /* tag */,
+              const size_t maxLeafSize,
+              const size_t minLeafSize,
+              const size_t maxNumChildren,
+              const size_t minNumChildren) :
+    maxNumChildren(maxNumChildren),
+    minNumChildren(minNumChildren),
+    numChildren(0),
+    children(maxNumChildren + 1), // Add one to make splitting the node simpler.
+    parent(NULL),
+    begin(0),
+    count(0),
+    numDescendants(0),
+    maxLeafSize(maxLeafSize),
+    minLeafSize(minLeafSize),
+    bound(data.n_rows),
+    parentDistance(0),
+    dataset(new MatType(data)),
+    ownsDataset(true),
+    points(maxLeafSize + 1), // Add one to make splitting the node simpler.
+    auxiliaryInfo(this)
+{
+  BulkLoad();
+
+  // Initialize statistic recursively after tree construction is complete.
+  BuildStatistics(this);
+}
+
+template<typename MetricType,
+         typename StatisticType,
+         typename MatType,
+         typename SplitType,
+         typename DescentType,
+         template<typename> class AuxiliaryInformationType>
+RectangleTree<MetricType, StatisticType, MatType, SplitType, DescentType,
+              AuxiliaryInformationType>::
+RectangleTree(MatType&& data,
+              const BulkLoadTag /* tag */,
+              const size_t maxLeafSize,
+              const size_t minLeafSize,
+              const size_t maxNumChildren,
+              const size_t minNumChildren) :
+    maxNumChildren(maxNumChildren),
+    minNumChildren(minNumChildren),
+    numChildren(0),
+    children(maxNumChildren + 1), // Add one to make splitting the node simpler.
+    parent(NULL),
+    begin(0),
+    count(0),
+    numDescendants(0),
+    maxLeafSize(maxLeafSize),
+    minLeafSize(minLeafSize),
+    bound(data.n_rows),
+    parentDistance(0),
+    dataset(new MatType(std::move(data))),
+    ownsDataset(true),
+    points(maxLeafSize + 1), // Add one to make splitting the node simpler.
+    auxiliaryInfo(this)
+{
+  BulkLoad();
+
+  // Initialize statistic recursively after tree construction is complete.
+  BuildStatistics(this);
+}
+
 template<typename MetricType,
          typename StatisticType,
          typename MatType,
@@ -1002,6 +1076,287 @@ inline size_t RectangleTree<MetricType, StatisticType, MatType, SplitType,
   }
 }
 
+/**
+ * Build the tree with bulk loading.  The height of the tree is the smallest
+ * height at which full nodes can hold all of the points, and each node is
+ * split among as few children as possible.  The top levels are split one at a
+ * time, until there are enough subtrees to keep all threads busy; then the
+ * subtrees are built in parallel, and the top levels are finished bottom-up.
+ */
+template<typename MetricType,
+         typename StatisticType,
+         typename MatType,
+         typename SplitType,
+         typename DescentType,
+         template<typename> class AuxiliaryInformationType>
+void RectangleTree<MetricType, StatisticType, MatType, SplitType, DescentType,
+                   AuxiliaryInformationType>::BulkLoad()
+{
+  std::vector<size_t> order(dataset->n_cols);
+  for (size_t i = 0; i < order.size(); ++i)
+    order[i] = i;
+
+  // The auxiliary information may sort the points itself, so that nodes
+  // should take consecutive runs of them.
+  const bool packed = auxiliaryInfo.HandleBulkLoad(this, order);
+
+  size_t height = 1;
+  size_t capacity = maxLeafSize;
+  while (capacity < order.size())
+  {
+    capacity *= maxNumChildren;
+    ++height;
+  }
+
+  // The root is assigned the whole space.
+  CellType cell(dataset->n_rows);
+  for (size_t k = 0; k < cell.Dim(); ++k)
+  {
+    cell[k].Lo() = std::numeric_limits<ElemType>::lowest();
+    cell[k].Hi() = std::numeric_limits<ElemType>::max();
+  }
+
+  size_t numThreads = 1;
+  #ifdef HAS_OPENMP
+    numThreads = omp_get_max_threads();
+  #endif
+
+  // Each node only reorders its own points, so the nodes of a level can be
+  // split at the same time.
+  std::vector<std::vector<BulkLoadNode>> levels(1);
+  levels[0].push_back(BulkLoadNode { this, 0, order.size(), cell });
+  while (height > 1 && levels.back().size() < 4 * numThreads)
+  {
+    const std::vector<BulkLoadNode>& level = levels.back();
+    std::vector<std::vector<BulkLoadNode>> newNodes(level.size());
+    #pragma omp parallel for schedule(dynamic)
+    for (omp_size_t i = 0; i < (omp_size_t) level.size(); ++i)
+    {
+      level[i].node->SplitBulkLoadedNode(order, level[i], height, packed,
+          newNodes[i]);
+    }
+
+    std::vector<BulkLoadNode> nextLevel;
+    for (size_t i = 0; i < newNodes.size(); ++i)
+      nextLevel.insert(nextLevel.end(), newNodes[i].begin(), newNodes[i].end());
+
+    levels.push_back(std::move(nextLevel));
+    --height;
+  }
+
+  const std::vector<BulkLoadNode>& subtrees = levels.back();
+  #pragma omp parallel for schedule(dynamic)
+  for (omp_size_t i = 0; i < (omp_size_t) subtrees.size(); ++i)
+  {
+    subtrees[i].node->BuildBulkLoadedNode(order, subtrees[i], height, packed);
+  }
+
+  for (size_t l = levels.size() - 1; l > 0; --l)
+    for (size_t i = 0; i < levels[l - 1].size(); ++i)
+      levels[l - 1][i].node->FinishBulkLoadedNode(levels[l - 1][i].cell);
+}
+
+template<typename MetricType,
+         typename StatisticType,
+         typename MatType,
+         typename SplitType,
+         typename DescentType,
+         template<typename> class AuxiliaryInformationType>
+void RectangleTree<MetricType, StatisticType, MatType, SplitType, DescentType,
+                   AuxiliaryInformationType>::
+    SplitBulkLoadedNode(std::vector<size_t>& order,
+                        const BulkLoadNode& node,
+                        const size_t height,
+                        const bool packed,
+                        std::vector<BulkLoadNode>& newNodes)
+{
+  // Each child can hold as many points as a full subtree of its height.
+  size_t childCapacity = maxLeafSize;
+  for (size_t h = 2; h < height; ++h)
+    childCapacity *= maxNumChildren;
+
+  // The points are divided evenly among the children, so that every node at
+  // a level holds about the same number of points.
+  const size_t numPoints = node.end - node.begin;
+  const size_t numGroups = (numPoints + childCapacity - 1) / childCapacity;
+  std::vector<size_t> boundaries(numGroups + 1);
+  for (size_t j = 0; j <= numGroups; ++j)
+    boundaries[j] = node.begin + (numPoints * j) / numGroups;
+
+  std::vector<CellType> cells(numGroups, node.cell);
+  if (!packed)
+  {
+    TileBulkLoadedPoints(order, boundaries, cells, 0, numGroups,
+        dataset->n_rows);
+  }
+
+  for (size_t j = 0; j < numGroups; ++j)
+  {
+    RectangleTree* child = new RectangleTree(this);
+    children[numChildren++] = child;
+    newNodes.push_back(BulkLoadNode { child, boundaries[j], boundaries[j + 1],
+        cells[j] });
+  }
+}
+
+template<typename MetricType,
+         typename StatisticType,
+         typename MatType,
+         typename SplitType,
+         typename DescentType,
+         template<typename> class AuxiliaryInformationType>
+void RectangleTree<MetricType, StatisticType, MatType, SplitType, DescentType,
+                   AuxiliaryInformationType>::
+    BuildBulkLoadedNode(std::vector<size_t>& order,
+                        const BulkLoadNode& node,
+                        const size_t height,
+                        const bool packed)
+{
+  if (height == 1)
+  {
+    for (size_t i = node.begin; i < node.end; ++i)
+      points[count++] = order[i];
+  }
+  else
+  {
+    std::vector<BulkLoadNode> newNodes;
+    SplitBulkLoadedNode(order, node, height, packed, newNodes);
+    for (size_t j = 0; j < newNodes.size(); ++j)
+    {
+      newNodes[j].node->BuildBulkLoadedNode(order, newNodes[j], height - 1,
+          packed);
+    }
+  }
+
+  FinishBulkLoadedNode(node.cell);
+}
+
+template<typename MetricType,
+         typename StatisticType,
+         typename MatType,
+         typename SplitType,
+         typename DescentType,
+         template<typename> class AuxiliaryInformationType>
+void RectangleTree<MetricType, StatisticType, MatType, SplitType, DescentType,
+                   AuxiliaryInformationType>::
+    FinishBulkLoadedNode(const CellType& cell)
+{
+  if (numChildren == 0)
+  {
+    for (size_t i = 0; i < count; ++i)
+      bound |= dataset->col(points[i]);
+    numDescendants = count;
+  }
+  else
+  {
+    numDescendants = 0;
+    for (size_t i = 0; i < numChildren; ++i)
+    {
+      bound |= children[i]->Bound();
+      numDescendants += children[i]->NumDescendants();
+    }
+  }
+
+  auxiliaryInfo.BulkLoadAuxiliaryInfo(this, cell);
+}
+
+/**
+ * Reorder the points of the given groups with Sort-Tile-Recursive.  The points
+ * are divided into slabs of whole groups along the dimension in which they are
+ * spread the most, and each slab is tiled recursively along the remaining
+ * dimensions; the region of each group is cut halfway between neighboring
+ * slabs, so that the regions of the groups still cover the whole region.
+ */
+template<typename MetricType,
+         typename StatisticType,
+         typename MatType,
+         typename SplitType,
+         typename DescentType,
+         template<typename> class AuxiliaryInformationType>
+void RectangleTree<MetricType, StatisticType, MatType, SplitType, DescentType,
+                   AuxiliaryInformationType>::
+    TileBulkLoadedPoints(std::vector<size_t>& order,
+                         const std::vector<size_t>& boundaries,
+                         std::vector<CellType>& cells,
+                         const size_t firstGroup,
+                         const size_t endGroup,
+                         const size_t numDimensions)
+{
+  const size_t numGroups = endGroup - firstGroup;
+  if (numGroups <= 1)
+    return;
+
+  const size_t begin = boundaries[firstGroup];
+  const size_t end = boundaries[endGroup];
+
+  CellType pointBound(dataset->n_rows);
+  for (size_t i = begin; i < end; ++i)
+    pointBound |= dataset->col(order[i]);
+
+  size_t axis = 0;
+  for (size_t k = 1; k < pointBound.Dim(); ++k)
+    if (pointBound[k].Width() > pointBound[axis].Width())
+      axis = k;
+
+  // With d dimensions left, there are about the d-th root of the number of
+  // groups slabs.
+  size_t numSlabs = numGroups;
+  if (numDimensions > 1)
+  {
+    numSlabs = (size_t) std::ceil(std::pow((double) numGroups,
+        1.0 / numDimensions));
+  }
+  const size_t groupsPerSlab = (numGroups + numSlabs - 1) / numSlabs;
+  numSlabs = (numGroups + groupsPerSlab - 1) / groupsPerSlab;
+
+  // Ties are broken by the index of the point, so the order is deterministic.
+  const MatType& data = *dataset;
+  auto lessAlongAxis = [&data, axis](const size_t a, const size_t b)
+  {
+    return (data(axis, a) < data(axis, b)) ||
+        (data(axis, a) == data(axis, b) && a < b);
+  };
+
+  std::vector<ElemType> slabLo(numSlabs);
+  std::vector<ElemType> slabHi(numSlabs);
+  for (size_t t = 0; t < numSlabs; ++t)
+  {
+    const size_t slabBegin = boundaries[firstGroup + t * groupsPerSlab];
+    const size_t slabEnd = boundaries[std::min(firstGroup + (t + 1) *
+        groupsPerSlab, endGroup)];
+    if (t + 1 < numSlabs)
+    {
+      std::nth_element(order.begin() + slabBegin, order.begin() + slabEnd,
+          order.begin() + end, lessAlongAxis);
+    }
+
+    slabLo[t] = std::numeric_limits<ElemType>::max();
+    slabHi[t] = std::numeric_limits<ElemType>::lowest();
+    for (size_t i = slabBegin; i < slabEnd; ++i)
+    {
+      slabLo[t] = std::min(slabLo[t], (ElemType) data(axis, order[i]));
+      slabHi[t] = std::max(slabHi[t], (ElemType) data(axis, order[i]));
+    }
+  }
+
+  for (size_t t = 0; t < numSlabs; ++t)
+  {
+    const size_t slabFirstGroup = firstGroup + t * groupsPerSlab;
+    const size_t slabEndGroup = std::min(slabFirstGroup + groupsPerSlab,
+        endGroup);
+    for (size_t j = slabFirstGroup; j < slabEndGroup; ++j)
+    {
+      if (t > 0)
+        cells[j][axis].Lo() = slabHi[t - 1] + (slabLo[t] - slabHi[t - 1]) / 2;
+      if (t + 1 < numSlabs)
+        cells[j][axis].Hi() = slabHi[t] + (slabLo[t + 1] - slabHi[t]) / 2;
+    }
+
+    TileBulkLoadedPoints(order, boundaries, cells, slabFirstGroup,
+        slabEndGroup, std::max(numDimensions, (size_t) 2) - 1);
+  }
+}
+
 /**
  * Split the tree.  This calls the SplitType code to split a node.  This method
  * should only be called on a leaf node.
@@ -145,6 +145,32 @@ class XTreeAuxiliaryInformation
     return false;
   }
 
+  /**
+   * Some tree types require the points to be bulk loaded in a certain order.
+   * If the auxiliary information sorts the points, then the method should
+   * return true; if the method returns false the points are tiled with
+   * Sort-Tile-Recursive.
+   * @param node The root of the tree that is being bulk loaded.
+   * @param points The indices of the points in the dataset.
+   */
+  bool HandleBulkLoad(TreeType* , std::vector<size_t>& )
+  {
+    return false;
+  }
+
+  /**
+   * Some tree types require to save some properties of the nodes that are
+   * created by bulk loading.  The X tree starts without supernodes and with an
+   * empty split history, so there is nothing to do.
+   * @param node The node that was built.
+   * @param cell The region of space assigned to the node.
+   */
+  void BulkLoadAuxiliaryInfo(
+      TreeType* ,
+      const bound::HRectBound<metric::EuclideanDistance,
+                              typename TreeType::ElemType>& )
+  { }
+
   /**
    * Some tree types require to propagate the information upward.
    * This method should return false if this is not the case. If true is
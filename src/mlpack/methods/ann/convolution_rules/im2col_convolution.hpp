@@ -0,0 +1,442 @@
+/**
+ * @file im2col_convolution.hpp
+ *
+ * Implementation of the convolution through the im2col transformation, which
+ * turns the convolution into a matrix multiplication.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_ANN_CONVOLUTION_RULES_IM2COL_CONVOLUTION_HPP
+#define MLPACK_METHODS_ANN_CONVOLUTION_RULES_IM2COL_CONVOLUTION_HPP
+
+#include <mlpack/prereqs.hpp>
+#include "border_modes.hpp"
+
+namespace mlpack {
+namespace ann /** Artificial Neural Network. */ {
+
+/**
+ * Computes the two-dimensional convolution by lowering the input into a matrix
+ * (im2col), where each column holds the input elements that are covered by the
+ * filter for one output element.  The convolution is then a single matrix
+ * multiplication, which is done by BLAS.  This class allows specification of
+ * the type of the border type. The convolution can be compute with the valid
+ * border type of the full border type (default).
+ *
+ * FullConvolution: returns the full two-dimensional convolution.
+ * ValidConvolution: returns only those parts of the convolution that are
+ * computed without the zero-padded edges.
+ *
+ * When Im2ColConvolution is used as a convolution rule of the Convolution
+ * layer, the layer lowers all input maps of many samples at once with Im2Col()
+ * and Col2Im(), so that the forward pass, the backward pass, and the gradient
+ * of all maps and samples are computed by a few large matrix multiplications.
+ *
+ * @tparam BorderMode Type of the border mode (FullConvolution or
+ * ValidConvolution).
+ */
+template<typename BorderMode = FullConvolution>
+class Im2ColConvolution
+{
+ public:
+  /*
+   * Perform a convolution (valid mode).
+   *
+   * @param input Input used to perform the convolution.
+   * @param filter Filter used to perform the convolution.
+   * @param output Output data that contains the results of the convolution.
+   * @param dW Stride of filter application in the x direction.
+   * @param dH Stride of filter application in the y direction.
+   * @param dilationW The dilation factor in x direction.
+   * @param dilationH The dilation factor in y direction.
+   */
+  template<typename eT, typename Border = BorderMode>
+  static typename std::enable_if<
+      std::is_same<Border, ValidConvolution>::value, void>::type
+  Convolution(const arma::Mat<eT>& input,
+              const arma::Mat<eT>& filter,
+              arma::Mat<eT>& output,
+              const size_t dW = 1,
+              const size_t dH = 1,
+              const size_t dilationW = 1,
+              const size_t dilationH = 1)
+  {
+    const size_t outputRows =
+        (input.n_rows - (filter.n_rows - 1) * dilationW - 1) / dW + 1;
+    const size_t outputCols =
+        (input.n_cols - (filter.n_cols - 1) * dilationH - 1) / dH + 1;
+
+    // Each column holds the input elements under the filter for one output
+    // element.
+    arma::Mat<eT> lowered(filter.n_elem, outputRows * outputCols);
+    for (size_t j = 0; j < outputCols; ++j)
+    {
+      for (size_t i = 0; i < outputRows; ++i)
+      {
+        eT* loweredPtr = lowered.colptr(i + j * outputRows);
+        for (size_t kj = 0; kj < filter.n_cols; ++kj)
+        {
+          const eT* inputPtr = input.colptr(j * dH + kj * dilationH) + i * dW;
+          for (size_t ki = 0; ki < filter.n_rows; ++ki, inputPtr += dilationW)
+            *(loweredPtr++) = *inputPtr;
+        }
+      }
+    }
+
+    output.set_size(outputRows, outputCols);
+    arma::Row<eT> outputRow(output.memptr(), output.n_elem, false, true);
+    outputRow = arma::vectorise(filter).t() * lowered;
+  }
+
+  /*
+   * Perform a convolution (full mode).
+   *
+   * @param input Input used to perform the convolution.
+   * @param filter Filter used to perform the convolution.
+   * @param output Output data that contains the results of the convolution.
+   * @param dW Stride of filter application in the x direction.
+   * @param dH Stride of filter application in the y direction.
+   * @param dilationW The dilation factor in x direction.
+   * @param dilationH The dilation factor in y direction.
+   */
+  template<typename eT, typename Border = BorderMode>
+  static typename std::enable_if<
+      std::is_same<Border, FullConvolution>::value, void>::type
+  Convolution(const arma::Mat<eT>& input,
+              const arma::Mat<eT>& filter,
+              arma::Mat<eT>& output,
+              const size_t dW = 1,
+              const size_t dH = 1,
+              const size_t dilationW = 1,
+              const size_t dilationH = 1)
+  {
+    // This is the same padding that NaiveConvolution uses.
+    size_t outputRows = (input.n_rows - 1) * dW + 2 * (filter.n_rows - 1)
+        * dilationW + 1;
+    size_t outputCols = (input.n_cols - 1) * dH + 2 * (filter.n_cols - 1)
+        * dilationH + 1;
+
+    for (size_t i = 0; i < dW; i++)
+    {
+      if (((((i + outputRows - 2 * (filter.n_rows - 1) * dilationW - 1) % dW)
+          + dW) % dW) == i)
+      {
+        outputRows += i;
+        break;
+      }
+    }
+    for (size_t i = 0; i < dH; i++)
+    {
+      if (((((i + outputCols - 2 * (filter.n_cols - 1) * dilationH - 1) % dH)
+          + dH) % dH) == i)
+      {
+        outputCols += i;
+        break;
+      }
+    }
+
+    // Pad filter and input to the working output shape.
+    arma::Mat<eT> inputPadded = arma::zeros<arma::Mat<eT> >(outputRows,
+        outputCols);
+    inputPadded.submat((filter.n_rows - 1) * dilationW, (filter.n_cols - 1)
+        * dilationH, (filter.n_rows - 1) * dilationW + input.n_rows - 1,
+        (filter.n_cols - 1) * dilationH + input.n_cols - 1) = input;
+
+    Im2ColConvolution<ValidConvolution>::Convolution(inputPadded, filter,
+        output, 1, 1, dilationW, dilationH);
+  }
+
+  /*
+   * Perform a convolution using 3rd order tensors.
+   *
+   * @param input Input used to perform the convolution.
+   * @param filter Filter used to perform the convolution.
+   * @param output Output data that contains the results of the convolution.
+   * @param dW Stride of filter application in the x direction.
+   * @param dH Stride of filter application in the y direction.
+   * @param dilationW The dilation factor in x direction.
+   * @param dilationH The dilation factor in y direction.
+   */
+  template<typename eT>
+  static void Convolution(const arma::Cube<eT>& input,
+                          const arma::Cube<eT>& filter,
+                          arma::Cube<eT>& output,
+                          const size_t dW = 1,
+                          const size_t dH = 1,
+                          const size_t dilationW = 1,
+                          const size_t dilationH = 1)
+  {
+    arma::Mat<eT> convOutput;
+    Im2ColConvolution<BorderMode>::Convolution(input.slice(0),
+        filter.slice(0), convOutput, dW, dH, dilationW, dilationH);
+
+    output = arma::Cube<eT>(convOutput.n_rows, convOutput.n_cols,
+        input.n_slices);
+    output.slice(0) = convOutput;
+
+    for (size_t i = 1; i < input.n_slices; i++)
+    {
+      Im2ColConvolution<BorderMode>::Convolution(input.slice(i),
+          filter.slice(i), output.slice(i), dW, dH, dilationW, dilationH);
+    }
+  }
+
+  /*
+   * Perform a convolution using dense matrix as input and a 3rd order tensors
+   * as filter and output.  The input is only lowered once for all filters.
+   *
+   * @param input Input used to perform the convolution.
+   * @param filter Filter used to perform the convolution.
+   * @param output Output data that contains the results of the convolution.
+   * @param dW Stride of filter application in the x direction.
+   * @param dH Stride of filter application in the y direction.
+   * @param dilationW The dilation factor in x direction.
+   * @param dilationH The dilation factor in y direction.
+   */
+  template<typename eT>
+  static void Convolution(const arma::Mat<eT>& input,
+                          const arma::Cube<eT>& filter,
+                          arma::Cube<eT>& output,
+                          const size_t dW = 1,
+                          const size_t dH = 1,
+                          const size_t dilationW = 1,
+                          const size_t dilationH = 1)
+  {
+    arma::Mat<eT> convOutput;
+    Im2ColConvolution<BorderMode>::Convolution(input, filter.slice(0),
+        convOutput, dW, dH, dilationW, dilationH);
+
+    output = arma::Cube<eT>(convOutput.n_rows, convOutput.n_cols,
+        filter.n_slices);
+    output.slice(0) = convOutput;
+
+    for (size_t i = 1; i < filter.n_slices; i++)
+    {
+      Im2ColConvolution<BorderMode>::Convolution(input, filter.slice(i),
+          output.slice(i), dW, dH, dilationW, dilationH);
+    }
+  }
+
+  /*
+   * Perform a convolution using a 3rd order tensors as input and output and a
+   * dense matrix as filter.
+   *
+   * @param input Input used to perform the convolution.
+   * @param filter Filter used to perform the convolution.
+   * @param output Output data that contains the results of the convolution.
+   * @param dW Stride of filter application in the x direction.
+   * @param dH Stride of filter application in the y direction.
+   * @param dilationW The dilation factor in x direction.
+   * @param dilationH The dilation factor in y direction.
+   */
+  template<typename eT>
+  static void Convolution(const arma::Cube<eT>& input,
+                          const arma::Mat<eT>& filter,
+                          arma::Cube<eT>& output,
+                          const size_t dW = 1,
+                          const size_t dH = 1,
+                          const size_t dilationW = 1,
+                          const size_t dilationH = 1)
+  {
+    arma::Mat<eT> convOutput;
+    Im2ColConvolution<BorderMode>::Convolution(input.slice(0), filter,
+        convOutput, dW, dH, dilationW, dilationH);
+
+    output = arma::Cube<eT>(convOutput.n_rows, convOutput.n_cols,
+        input.n_slices);
+    output.slice(0) = convOutput;
+
+    for (size_t i = 1; i < input.n_slices; i++)
+    {
+      Im2ColConvolution<BorderMode>::Convolution(input.slice(i), filter,
+          output.slice(i), dW, dH, dilationW, dilationH);
+    }
+  }
+
+  /**
+   * Lower some samples of a batch of multi-map inputs.  Each column of the
+   * input holds one sample, which consists of the given number of maps of size
+   * inputWidth x inputHeight.  Each column of the lowered matrix holds the
+   * (implicitly zero-padded) input elements under the filter of all maps for
+   * one output element of one sample; its rows are ordered like the elements
+   * of the filters of all maps (kernel row, kernel column, map).  The columns
+   * of sample s start at column (s - firstSample) * outputWidth *
+   * outputHeight.
+   *
+   * @param input Input batch, with one sample per column.
+   * @param firstSample Index of the first sample to lower.
+   * @param numSamples Number of samples to lower.
+   * @param inputWidth Width of each input map.
+   * @param inputHeight Height of each input map.
+   * @param maps Number of input maps.
+   * @param kernelWidth Width of the filter.
+   * @param kernelHeight Height of the filter.
+   * @param strideWidth Stride of the filter in the x direction.
+   * @param strideHeight Stride of the filter in the y direction.
+   * @param padW Padding on the left of each input map.
+   * @param padH Padding on the top of each input map.
+   * @param outputWidth Width of each output map.
+   * @param outputHeight Height of each output map.
+   * @param lowered Matrix to store the lowered input in.
+   */
+  template<typename eT>
+  static void Im2Col(const arma::Mat<eT>& input,
+                     const size_t firstSample,
+                     const size_t numSamples,
+                     const size_t inputWidth,
+                     const size_t inputHeight,
+                     const size_t maps,
+                     const size_t kernelWidth,
+                     const size_t kernelHeight,
+                     const size_t strideWidth,
+                     const size_t strideHeight,
+                     const size_t padW,
+                     const size_t padH,
+                     const size_t outputWidth,
+                     const size_t outputHeight,
+                     arma::Mat<eT>& lowered)
+  {
+    const size_t mapSize = inputWidth * inputHeight;
+    lowered.set_size(kernelWidth * kernelHeight * maps,
+        outputWidth * outputHeight * numSamples);
+
+    #pragma omp parallel for schedule(static)
+    for (omp_size_t s = 0; s < (omp_size_t) numSamples; ++s)
+    {
+      const eT* sample = input.colptr(firstSample + s);
+      for (size_t j = 0; j < outputHeight; ++j)
+      {
+        for (size_t i = 0; i < outputWidth; ++i)
+        {
+          eT* loweredPtr = lowered.colptr((s * outputHeight + j) *
+              outputWidth + i);
+          for (size_t m = 0; m < maps; ++m)
+          {
+            for (size_t kj = 0; kj < kernelHeight; ++kj)
+            {
+              // The position in the unpadded map; it is outside of the map if
+              // it underflows.
+              const size_t col = j * strideHeight + kj - padH;
+              if (col >= inputHeight)
+              {
+                for (size_t ki = 0; ki < kernelWidth; ++ki)
+                  *(loweredPtr++) = 0;
+                continue;
+              }
+
+              const eT* mapCol = sample + m * mapSize + col * inputWidth;
+              for (size_t ki = 0; ki < kernelWidth; ++ki)
+              {
+                const size_t row = i * strideWidth + ki - padW;
+                *(loweredPtr++) = (row < inputWidth) ? mapCol[row] : 0;
+              }
+            }
+          }
+        }
+      }
+    }
+  }
+
+  /**
+   * Add a lowered matrix (with the layout that Im2Col() produces) back to the
+   * given samples of a batch of multi-map inputs.  Elements that are covered
+   * by the filter several times are summed, and elements in the padding are
+   * ignored.  The parameters are the same as for Im2Col().
+   *
+   * @param lowered Lowered matrix.
+   * @param firstSample Index of the first sample.
+   * @param numSamples Number of samples.
+   * @param inputWidth Width of each input map.
+   * @param inputHeight Height of each input map.
+   * @param maps Number of input maps.
+   * @param kernelWidth Width of the filter.
+   * @param kernelHeight Height of the filter.
+   * @param strideWidth Stride of the filter in the x direction.
+   * @param strideHeight Stride of the filter in the y direction.
+   * @param padW Padding on the left of each input map.
+   * @param padH Padding on the top of each input map.
+   * @param outputWidth Width of each output map.
+   * @param outputHeight Height of each output map.
+   * @param output Batch to add the lowered matrix to, with one sample per
+   *     column.
+   */
+  template<typename eT>
+  static void Col2Im(const arma::Mat<eT>& lowered,
+                     const size_t firstSample,
+                     const size_t numSamples,
+                     const size_t inputWidth,
+                     const size_t inputHeight,
+                     const size_t maps,
+                     const size_t kernelWidth,
+                     const size_t kernelHeight,
+                     const size_t strideWidth,
+                     const size_t strideHeight,
+                     const size_t padW,
+                     const size_t padH,
+                     const size_t outputWidth,
+                     const size_t outputHeight,
+                     arma::Mat<eT>& output)
+  {
+    const size_t mapSize = inputWidth * inputHeight;
+
+    // Samples don't overlap, so they can be processed in parallel.
+    #pragma omp parallel for schedule(static)
+    for (omp_size_t s = 0; s < (omp_size_t) numSamples; ++s)
+    {
+      eT* sample = output.colptr(firstSample + s);
+      for (size_t j = 0; j < outputHeight; ++j)
+      {
+        for (size_t i = 0; i < outputWidth; ++i)
+        {
+          const eT* loweredPtr = lowered.colptr((s * outputHeight + j) *
+              outputWidth + i);
+          for (size_t m = 0; m < maps; ++m)
+          {
+            for (size_t kj = 0; kj < kernelHeight; ++kj)
+            {
+              const size_t col = j * strideHeight + kj - padH;
+              if (col >= inputHeight)
+              {
+                loweredPtr += kernelWidth;
+                continue;
+              }
+
+              eT* mapCol = sample + m * mapSize + col * inputWidth;
+              for (size_t ki = 0; ki < kernelWidth; ++ki, ++loweredPtr)
+              {
+                const size_t row = i * strideWidth + ki - padW;
+                if (row < inputWidth)
+                  mapCol[row] += *loweredPtr;
+              }
+            }
+          }
+        }
+      }
+    }
+  }
+};  // class Im2ColConvolution
+
+/**
+ * Whether the given convolution rule is an Im2ColConvolution, so that the
+ * Convolution layer can lower whole batches with it.
+ */
+template<typename ConvolutionRuleType>
+struct IsIm2ColConvolution
+{
+  static const bool value = false;
+};
+
+//! Im2ColConvolution is an im2col convolution rule.
+template<typename BorderMode>
+struct IsIm2ColConvolution<Im2ColConvolution<BorderMode> >
+{
+  static const bool value = true;
+};
+
+} // namespace ann
+} // namespace mlpack
+
+#endif
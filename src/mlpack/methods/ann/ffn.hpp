@@ -24,6 +24,7 @@
 #include "visitor/weight_size_visitor.hpp"
 #include "visitor/copy_visitor.hpp"
 #include "visitor/loss_visitor.hpp"
+#include "visitor/forward_function_visitor.hpp"
 
 #include "init_rules/network_init.hpp"
 
@@ -168,13 +169,36 @@ class FFN
    * reflect the output of the given output layer as returned by the
    * output layer function.
    *
-   * If you want to pass in a parameter and discard the original parameter
-   * object, be sure to use std::move to avoid unnecessary copy.
+   * By default the points are passed through the network one by one; call
+   * PlanInference() first to pass them through in batches.
    *
    * @param predictors Input predictors.
    * @param results Matrix to put output predictions of responses into.
    */
-  void Predict(arma::mat predictors, arma::mat& results);
+  void Predict(const arma::mat& predictors, arma::mat& results);
+
+  /**
+   * Prepare the network for fast inference: after this, Predict() passes
+   * batches of up to maxBatchSize points through the network at once, and
+   * calls the Forward() function of each layer directly instead of visiting
+   * the layer.
+   *
+   * The first call to Predict() passes one point through the network to find
+   * the output size of each layer, and then allocates a single arena that
+   * holds the activations of two consecutive layers for a full batch; the
+   * layers write their outputs alternately into its two halves.  The first
+   * layer reads the predictors directly, and the last layer writes into the
+   * results directly.  So, once the results matrix has the right size,
+   * Predict() doesn't allocate any memory, except for temporaries that some
+   * layers allocate in their Forward() function.
+   *
+   * The plan is made again if the dimensionality of the predictors or the
+   * number of layers changes.  Pass 0 to go back to predicting point by point.
+   *
+   * @param maxBatchSize Maximum number of points to pass through the network
+   *     at once.
+   */
+  void PlanInference(const size_t maxBatchSize);
 
   /**
    * Evaluate the feedforward network with the given predictors and responses.
@@ -427,6 +451,24 @@ class FFN
    */
   void ResetGradients(arma::mat& gradient);
 
+  /**
+   * Pass the first point of the given predictors through the network to find
+   * the output size of each layer, and make the inference plan that Predict()
+   * uses after PlanInference() was called.  If a layer doesn't output one
+   * column per point, no plan is made.
+   *
+   * @param predictors Input predictors.
+   */
+  void BuildInferencePlan(const arma::mat& predictors);
+
+  /**
+   * Predict the responses to the given predictors with the inference plan.
+   *
+   * @param predictors Input predictors.
+   * @param results Matrix to put output predictions of responses into.
+   */
+  void PredictPlanned(const arma::mat& predictors, arma::mat& results);
+
   /**
    * Swap the content of this network with given network.
    *
@@ -510,6 +552,24 @@ class FFN
   //! Locally-stored copy visitor
   CopyVisitor<CustomLayers...> copyVisitor;
 
+  //! The maximum number of points that Predict() passes through the network at
+  //! once (0 if it predicts point by point).
+  size_t inferenceBatchSize;
+
+  //! The dimensionality of the predictors that the inference plan was made
+  //! for.
+  size_t inferenceInputSize;
+
+  //! The output size of each layer, for the inference plan.
+  std::vector<size_t> inferenceOutputSize;
+
+  //! The Forward() function of each layer, for the inference plan (empty if
+  //! the plan can't be used).
+  std::vector<LayerForwardFunction> inferenceForward;
+
+  //! Memory for the activations of the inference plan.
+  arma::mat inferenceArena;
+
   // The GAN class should have access to internal members.
   template<
     typename Model,
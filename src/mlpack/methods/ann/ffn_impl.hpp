@@ -39,7 +39,9 @@ FFN<OutputLayerType, InitializationRuleType, CustomLayers...>::FFN(
     height(0),
     reset(false),
     numFunctions(0),
-    deterministic(true)
+    deterministic(true),
+    inferenceBatchSize(0),
+    inferenceInputSize(0)
 {
   /* Nothing to do here. */
 }
@@ -223,7 +225,7 @@ double FFN<OutputLayerType, InitializationRuleType, CustomLayers...>::Backward(
 template<typename OutputLayerType, typename InitializationRuleType,
          typename... CustomLayers>
 void FFN<OutputLayerType, InitializationRuleType, CustomLayers...>::Predict(
-    arma::mat predictors, arma::mat& results)
+    const arma::mat& predictors, arma::mat& results)
 {
   if (parameter.is_empty())
     ResetParameters();
@@ -234,8 +236,24 @@ void FFN<OutputLayerType, InitializationRuleType, CustomLayers...>::Predict(
     ResetDeterministic();
   }
 
+  if (inferenceBatchSize > 0 && predictors.n_cols > 0)
+  {
+    if (inferenceInputSize != predictors.n_rows ||
+        inferenceOutputSize.size() != network.size())
+      BuildInferencePlan(predictors);
+
+    if (!inferenceForward.empty())
+    {
+      PredictPlanned(predictors, results);
+      return;
+    }
+  }
+
+  // The points are only read.
+  arma::mat& input = const_cast<arma::mat&>(predictors);
+
   arma::mat resultsTemp;
-  Forward(arma::mat(predictors.colptr(0), predictors.n_rows, 1, false, true));
+  Forward(arma::mat(input.colptr(0), input.n_rows, 1, false, true));
   resultsTemp = boost::apply_visitor(outputParameterVisitor,
       network.back()).col(0);
 
@@ -244,7 +262,7 @@ void FFN<OutputLayerType, InitializationRuleType, CustomLayers...>::Predict(
 
   for (size_t i = 1; i < predictors.n_cols; i++)
   {
-    Forward(arma::mat(predictors.colptr(i), predictors.n_rows, 1, false, true));
+    Forward(arma::mat(input.colptr(i), input.n_rows, 1, false, true));
 
     resultsTemp = boost::apply_visitor(outputParameterVisitor,
         network.back());
@@ -252,6 +270,102 @@ void FFN<OutputLayerType, InitializationRuleType, CustomLayers...>::Predict(
   }
 }
 
+template<typename OutputLayerType, typename InitializationRuleType,
+         typename... CustomLayers>
+void FFN<OutputLayerType, InitializationRuleType,
+         CustomLayers...>::PlanInference(const size_t maxBatchSize)
+{
+  inferenceBatchSize = maxBatchSize;
+
+  // The plan is made by the next call to Predict().
+  inferenceInputSize = 0;
+  inferenceOutputSize.clear();
+  inferenceForward.clear();
+  inferenceArena.reset();
+}
+
+template<typename OutputLayerType, typename InitializationRuleType,
+         typename... CustomLayers>
+void FFN<OutputLayerType, InitializationRuleType,
+         CustomLayers...>::BuildInferencePlan(const arma::mat& predictors)
+{
+  inferenceInputSize = predictors.n_rows;
+  inferenceOutputSize.clear();
+  inferenceForward.clear();
+  inferenceArena.reset();
+
+  // Pass the first point through the network; this also sets the input width
+  // and height of each layer.
+  arma::mat& input = const_cast<arma::mat&>(predictors);
+  Forward(arma::mat(input.colptr(0), input.n_rows, 1, false, true));
+
+  bool usable = true;
+  for (size_t i = 0; i < network.size(); ++i)
+  {
+    const arma::mat& output = boost::apply_visitor(outputParameterVisitor,
+        network[i]);
+    inferenceOutputSize.push_back(output.n_rows);
+    if (output.n_cols != 1)
+      usable = false;
+  }
+
+  if (!usable)
+  {
+    Log::Warn << "FFN::PlanInference(): not all layers give one output column "
+        << "per point; predicting point by point instead." << std::endl;
+    return;
+  }
+
+  // The output of the last layer is written into the results, so it doesn't
+  // need space in the arena.
+  size_t maxOutputSize = 0;
+  for (size_t i = 0; i + 1 < network.size(); ++i)
+    maxOutputSize = std::max(maxOutputSize, inferenceOutputSize[i]);
+
+  inferenceArena.set_size(maxOutputSize, 2 * inferenceBatchSize);
+
+  for (size_t i = 0; i < network.size(); ++i)
+  {
+    inferenceForward.push_back(boost::apply_visitor(ForwardFunctionVisitor(),
+        network[i]));
+  }
+}
+
+template<typename OutputLayerType, typename InitializationRuleType,
+         typename... CustomLayers>
+void FFN<OutputLayerType, InitializationRuleType,
+         CustomLayers...>::PredictPlanned(const arma::mat& predictors,
+                                          arma::mat& results)
+{
+  results.set_size(inferenceOutputSize.back(), predictors.n_cols);
+
+  for (size_t first = 0; first < predictors.n_cols;
+      first += inferenceBatchSize)
+  {
+    const size_t points = std::min(inferenceBatchSize,
+        (size_t) predictors.n_cols - first);
+
+    // The layers alternately write into the first and the second half of the
+    // arena; the matrices below only point to existing memory.
+    for (size_t i = 0; i < network.size(); ++i)
+    {
+      double* inputMemory = (i == 0) ?
+          const_cast<double*>(predictors.colptr(first)) :
+          inferenceArena.colptr(((i - 1) % 2) * inferenceBatchSize);
+      double* outputMemory = (i + 1 == network.size()) ?
+          results.colptr(first) :
+          inferenceArena.colptr((i % 2) * inferenceBatchSize);
+
+      const arma::mat input(inputMemory, (i == 0) ? predictors.n_rows :
+          inferenceOutputSize[i - 1], points, false, true);
+      arma::mat output(outputMemory, inferenceOutputSize[i], points, false,
+          true);
+
+      inferenceForward[i](input, output);
+    }
+  }
+}
+
 template<typename OutputLayerType, typename InitializationRuleType,
          typename... CustomLayers>
 template<typename PredictorsType, typename ResponsesType>
@@ -596,6 +710,12 @@ void FFN<OutputLayerType, InitializationRuleType, CustomLayers...>::serialize(
 
     deterministic = true;
     ResetDeterministic();
+
+    // The layers have changed, so the inference plan must be made again.
+    inferenceInputSize = 0;
+    inferenceOutputSize.clear();
+    inferenceForward.clear();
+    inferenceArena.reset();
   }
 }
 
@@ -620,6 +740,11 @@ void FFN<OutputLayerType, InitializationRuleType,
   std::swap(inputParameter, network.inputParameter);
   std::swap(outputParameter, network.outputParameter);
   std::swap(gradient, network.gradient);
+  std::swap(inferenceBatchSize, network.inferenceBatchSize);
+  std::swap(inferenceInputSize, network.inferenceInputSize);
+  std::swap(inferenceOutputSize, network.inferenceOutputSize);
+  std::swap(inferenceForward, network.inferenceForward);
+  std::swap(inferenceArena, network.inferenceArena);
 };
 
 template<typename OutputLayerType, typename InitializationRuleType,
@@ -640,8 +765,12 @@ FFN<OutputLayerType, InitializationRuleType, CustomLayers...>::FFN(
     delta(network.delta),
     inputParameter(network.inputParameter),
     outputParameter(network.outputParameter),
-    gradient(network.gradient)
+    gradient(network.gradient),
+    inferenceBatchSize(network.inferenceBatchSize),
+    inferenceInputSize(0)
 {
+  // The inference plan refers to the layers of the other network, so it is
+  // made again for the new layers when it is needed.
   // Build new layers according to source network
   for (size_t i = 0; i < network.network.size(); ++i)
   {
@@ -668,7 +797,12 @@ FFN<OutputLayerType, InitializationRuleType, CustomLayers...>::FFN(
     delta(std::move(network.delta)),
     inputParameter(std::move(network.inputParameter)),
     outputParameter(std::move(network.outputParameter)),
-    gradient(std::move(network.gradient))
+    gradient(std::move(network.gradient)),
+    inferenceBatchSize(network.inferenceBatchSize),
+    inferenceInputSize(network.inferenceInputSize),
+    inferenceOutputSize(std::move(network.inferenceOutputSize)),
+    inferenceForward(std::move(network.inferenceForward)),
+    inferenceArena(std::move(network.inferenceArena))
 {
   this->network = std::move(network.network);
 };
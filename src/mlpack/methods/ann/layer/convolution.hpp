@@ -18,6 +18,7 @@
 #include <mlpack/methods/ann/convolution_rules/naive_convolution.hpp>
 #include <mlpack/methods/ann/convolution_rules/fft_convolution.hpp>
 #include <mlpack/methods/ann/convolution_rules/svd_convolution.hpp>
+#include <mlpack/methods/ann/convolution_rules/im2col_convolution.hpp>
 #include <mlpack/core/util/to_lower.hpp>
 
 #include "layer_types.hpp"
@@ -277,6 +278,65 @@ class Convolution
    */
   void InitializeSamePadding();
 
+  /*
+   * Perform the forward pass with im2col: the input maps of a block of samples
+   * are lowered into one matrix, and all output maps are computed with one
+   * matrix multiplication.  This is used if ForwardConvolutionRule is an
+   * Im2ColConvolution.
+   *
+   * @param input Input data used for evaluating the specified function.
+   * @param output Resulting output activation.
+   */
+  template<typename eT>
+  void ForwardIm2Col(const arma::Mat<eT>& input, arma::Mat<eT>& output);
+
+  /*
+   * Perform the backward pass with col2im: the error with respect to the
+   * lowered input of a block of samples is computed with one matrix
+   * multiplication and then added back to the input maps.  This is used if
+   * BackwardConvolutionRule is an Im2ColConvolution.
+   *
+   * @param gy The backpropagated error.
+   * @param g The calculated gradient.
+   */
+  template<typename eT>
+  void BackwardIm2Col(const arma::Mat<eT>& gy, arma::Mat<eT>& g);
+
+  /*
+   * Calculate the gradient with im2col: the gradient of all filters is the
+   * product of the lowered input and the error.  This is used if
+   * GradientConvolutionRule is an Im2ColConvolution.
+   *
+   * @param input The input parameter used for calculating the gradient.
+   * @param error The calculated error.
+   * @param gradient The calculated gradient.
+   */
+  template<typename eT>
+  void GradientIm2Col(const arma::Mat<eT>& input,
+                      const arma::Mat<eT>& error,
+                      arma::Mat<eT>& gradient);
+
+  /*
+   * Return the number of samples that are lowered at once by the im2col
+   * passes, so that the lowered matrix doesn't get too large.
+   */
+  size_t Im2ColBlockSize() const;
+
+  /*
+   * Rearrange the error of the given samples so that each column holds one
+   * output map of all the samples, as the im2col passes need it.
+   *
+   * @param error The error, with one sample per column.
+   * @param firstSample Index of the first sample.
+   * @param numSamples Number of samples.
+   * @param loweredError Matrix to store the rearranged error in.
+   */
+  template<typename eT>
+  void LowerError(const arma::Mat<eT>& error,
+                  const size_t firstSample,
+                  const size_t numSamples,
+                  arma::Mat<eT>& loweredError);
+
   /*
    * Rotates a 3rd-order tensor counterclockwise by 180 degrees.
    *
@@ -375,6 +435,13 @@ class Convolution
   //! Locally-stored padding layer.
   ann::Padding<> padding;
 
+  //! Locally-stored lowered input of the im2col passes.
+  OutputDataType loweredInput;
+
+  //! Locally-stored output or error of the im2col passes, with one column for
+  //! each output map.
+  OutputDataType loweredOutput;
+
   //! Locally-stored delta object.
   OutputDataType delta;
 
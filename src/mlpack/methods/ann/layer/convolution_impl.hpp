@@ -180,7 +180,12 @@ void Convolution<
   arma::cube inputTemp(const_cast<arma::Mat<eT>&>(input).memptr(),
       inputWidth, inputHeight, inSize * batchSize, false, false);
 
-  if (padWLeft != 0 || padWRight != 0 || padHTop != 0 || padHBottom != 0)
+  // The im2col passes pad the input implicitly, so the padded input is only
+  // needed by the other convolution rules.
+  const bool im2colOnly = IsIm2ColConvolution<ForwardConvolutionRule>::value &&
+      IsIm2ColConvolution<GradientConvolutionRule>::value;
+  if (!im2colOnly &&
+      (padWLeft != 0 || padWRight != 0 || padHTop != 0 || padHBottom != 0))
   {
     inputPaddedTemp.set_size(inputTemp.n_rows + padWLeft + padWRight,
         inputTemp.n_cols + padHTop + padHBottom, inputTemp.n_slices);
@@ -191,6 +196,12 @@ void Convolution<
     }
   }
 
+  if (IsIm2ColConvolution<ForwardConvolutionRule>::value)
+  {
+    ForwardIm2Col(input, output);
+    return;
+  }
+
   size_t wConv = ConvOutSize(inputWidth, kernelWidth, strideWidth, padWLeft,
       padWRight);
   size_t hConv = ConvOutSize(inputHeight, kernelHeight, strideHeight, padHTop,
@@ -254,6 +265,12 @@ void Convolution<
 >::Backward(
     const arma::Mat<eT>& /* input */, const arma::Mat<eT>& gy, arma::Mat<eT>& g)
 {
+  if (IsIm2ColConvolution<BackwardConvolutionRule>::value)
+  {
+    BackwardIm2Col(gy, g);
+    return;
+  }
+
   arma::cube mappedError(((arma::Mat<eT>&) gy).memptr(), outputWidth,
       outputHeight, outSize * batchSize, false, false);
 
@@ -311,15 +328,20 @@ void Convolution<
     const arma::Mat<eT>& error,
     arma::Mat<eT>& gradient)
 {
+  if (IsIm2ColConvolution<GradientConvolutionRule>::value)
+  {
+    GradientIm2Col(input, error, gradient);
+    return;
+  }
+
   arma::cube mappedError(((arma::Mat<eT>&) error).memptr(), outputWidth,
       outputHeight, outSize * batchSize, false, false);
   arma::cube inputTemp(((arma::Mat<eT>&) input).memptr(), inputWidth,
       inputHeight, inSize * batchSize, false, false);
 
-  gradient.set_size(weights.n_elem, 1);
+  gradient.zeros(weights.n_elem, 1);
   gradientTemp = arma::Cube<eT>(gradient.memptr(), weight.n_rows,
       weight.n_cols, weight.n_slices, false, false);
-  gradientTemp.zeros();
 
   for (size_t outMap = 0, outMapIdx = 0, batchCount = 0; outMap <
       outSize * batchSize; outMap++)
@@ -366,8 +388,197 @@ void Convolution<
       }
     }
 
-    gradient.submat(weight.n_elem + (outMap % outSize), 0, weight.n_elem +
-        (outMap % outSize), 0) = arma::accu(mappedError.slice(outMap));
+    // The bias gradient is summed over all samples of the batch.
+    gradient(weight.n_elem + (outMap % outSize)) +=
+        arma::accu(mappedError.slice(outMap));
+  }
+}
+
+template<
+    typename ForwardConvolutionRule,
+    typename BackwardConvolutionRule,
+    typename GradientConvolutionRule,
+    typename InputDataType,
+    typename OutputDataType
+>
+template<typename eT>
+void Convolution<
+    ForwardConvolutionRule,
+    BackwardConvolutionRule,
+    GradientConvolutionRule,
+    InputDataType,
+    OutputDataType
+>::ForwardIm2Col(const arma::Mat<eT>& input, arma::Mat<eT>& output)
+{
+  outputWidth = ConvOutSize(inputWidth, kernelWidth, strideWidth, padWLeft,
+      padWRight);
+  outputHeight = ConvOutSize(inputHeight, kernelHeight, strideHeight, padHTop,
+      padHBottom);
+  const size_t mapSize = outputWidth * outputHeight;
+
+  // Column o holds the filters of output map o for all input maps, in the
+  // order of the rows of the lowered input.
+  const OutputDataType filters(weight.memptr(), kernelWidth * kernelHeight *
+      inSize, outSize, false, true);
+
+  output.set_size(mapSize * outSize, batchSize);
+  const size_t blockSize = Im2ColBlockSize();
+  for (size_t first = 0; first < batchSize; first += blockSize)
+  {
+    const size_t samples = std::min(blockSize, batchSize - first);
+    Im2ColConvolution<>::Im2Col(input, first, samples, inputWidth, inputHeight,
+        inSize, kernelWidth, kernelHeight, strideWidth, strideHeight, padWLeft,
+        padHTop, outputWidth, outputHeight, loweredInput);
+
+    // All output maps of all samples of the block at once.
+    loweredOutput = loweredInput.t() * filters;
+
+    for (size_t s = 0; s < samples; ++s)
+    {
+      for (size_t o = 0; o < outSize; ++o)
+      {
+        arma::Col<eT> outputMap(output.colptr(first + s) + o * mapSize,
+            mapSize, false, true);
+        outputMap = loweredOutput.col(o).subvec(s * mapSize,
+            (s + 1) * mapSize - 1) + bias(o);
+      }
+    }
+  }
+}
+
+template<
+    typename ForwardConvolutionRule,
+    typename BackwardConvolutionRule,
+    typename GradientConvolutionRule,
+    typename InputDataType,
+    typename OutputDataType
+>
+template<typename eT>
+void Convolution<
+    ForwardConvolutionRule,
+    BackwardConvolutionRule,
+    GradientConvolutionRule,
+    InputDataType,
+    OutputDataType
+>::BackwardIm2Col(const arma::Mat<eT>& gy, arma::Mat<eT>& g)
+{
+  const OutputDataType filters(weight.memptr(), kernelWidth * kernelHeight *
+      inSize, outSize, false, true);
+
+  g.zeros(inputWidth * inputHeight * inSize, batchSize);
+  const size_t blockSize = Im2ColBlockSize();
+  for (size_t first = 0; first < batchSize; first += blockSize)
+  {
+    const size_t samples = std::min(blockSize, batchSize - first);
+    LowerError(gy, first, samples, loweredOutput);
+
+    // The error with respect to the lowered input of all samples of the block;
+    // it is added back to the (unpadded) input maps.
+    loweredInput = filters * loweredOutput.t();
+    Im2ColConvolution<>::Col2Im(loweredInput, first, samples, inputWidth,
+        inputHeight, inSize, kernelWidth, kernelHeight, strideWidth,
+        strideHeight, padWLeft, padHTop, outputWidth, outputHeight, g);
+  }
+}
+
+template<
+    typename ForwardConvolutionRule,
+    typename BackwardConvolutionRule,
+    typename GradientConvolutionRule,
+    typename InputDataType,
+    typename OutputDataType
+>
+template<typename eT>
+void Convolution<
+    ForwardConvolutionRule,
+    BackwardConvolutionRule,
+    GradientConvolutionRule,
+    InputDataType,
+    OutputDataType
+>::GradientIm2Col(
+    const arma::Mat<eT>& input,
+    const arma::Mat<eT>& error,
+    arma::Mat<eT>& gradient)
+{
+  const size_t mapSize = outputWidth * outputHeight;
+
+  gradient.zeros(weights.n_elem, 1);
+  arma::Mat<eT> filterGradient(gradient.memptr(),
+      kernelWidth * kernelHeight * inSize, outSize, false, true);
+
+  const size_t blockSize = Im2ColBlockSize();
+  for (size_t first = 0; first < batchSize; first += blockSize)
+  {
+    const size_t samples = std::min(blockSize, batchSize - first);
+    Im2ColConvolution<>::Im2Col(input, first, samples, inputWidth, inputHeight,
+        inSize, kernelWidth, kernelHeight, strideWidth, strideHeight, padWLeft,
+        padHTop, outputWidth, outputHeight, loweredInput);
+    LowerError(error, first, samples, loweredOutput);
+
+    filterGradient += loweredInput * loweredOutput;
+  }
+
+  // The gradient of the bias of each output map is the sum of its error.
+  for (size_t o = 0; o < outSize; ++o)
+  {
+    gradient(weight.n_elem + o) = arma::accu(error.rows(o * mapSize,
+        (o + 1) * mapSize - 1));
+  }
+}
+
+template<
+    typename ForwardConvolutionRule,
+    typename BackwardConvolutionRule,
+    typename GradientConvolutionRule,
+    typename InputDataType,
+    typename OutputDataType
+>
+size_t Convolution<
+    ForwardConvolutionRule,
+    BackwardConvolutionRule,
+    GradientConvolutionRule,
+    InputDataType,
+    OutputDataType
+>::Im2ColBlockSize() const
+{
+  // Limit the lowered input to about 2^22 elements (32MB for doubles); a
+  // single sample is always lowered at once, even if it is larger.
+  const size_t sampleSize = kernelWidth * kernelHeight * inSize *
+      outputWidth * outputHeight;
+  return std::max((size_t) (1 << 22) / std::max(sampleSize, (size_t) 1),
+      (size_t) 1);
+}
+
+template<
+    typename ForwardConvolutionRule,
+    typename BackwardConvolutionRule,
+    typename GradientConvolutionRule,
+    typename InputDataType,
+    typename OutputDataType
+>
+template<typename eT>
+void Convolution<
+    ForwardConvolutionRule,
+    BackwardConvolutionRule,
+    GradientConvolutionRule,
+    InputDataType,
+    OutputDataType
+>::LowerError(
+    const arma::Mat<eT>& error,
+    const size_t firstSample,
+    const size_t numSamples,
+    arma::Mat<eT>& loweredError)
+{
+  const size_t mapSize = outputWidth * outputHeight;
+  loweredError.set_size(mapSize * numSamples, outSize);
+  for (size_t o = 0; o < outSize; ++o)
+  {
+    for (size_t s = 0; s < numSamples; ++s)
+    {
+      loweredError.col(o).subvec(s * mapSize, (s + 1) * mapSize - 1) =
+          error.col(firstSample + s).subvec(o * mapSize,
+          (o + 1) * mapSize - 1);
+    }
   }
 }
 
@@ -0,0 +1,79 @@
+/**
+ * @file forward_function_visitor.hpp
+ *
+ * This file provides a visitor that resolves the Forward() function of a layer
+ * once, so that it can later be called without visiting the layer again.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_ANN_VISITOR_FORWARD_FUNCTION_VISITOR_HPP
+#define MLPACK_METHODS_ANN_VISITOR_FORWARD_FUNCTION_VISITOR_HPP
+
+#include <mlpack/methods/ann/layer/layer_traits.hpp>
+#include <mlpack/methods/ann/layer/layer_types.hpp>
+
+#include <boost/variant.hpp>
+
+namespace mlpack {
+namespace ann {
+
+/**
+ * The Forward() function of a layer, bound to the layer.  Calling it is an
+ * indirect function call, instead of a visit of the layer variant.
+ */
+class LayerForwardFunction
+{
+ public:
+  //! The type of the function that calls Forward() on the given layer.
+  typedef void (*FunctionType)(void* layer,
+                               const arma::mat& input,
+                               arma::mat& output);
+
+  //! Create the LayerForwardFunction object for the given layer and function.
+  LayerForwardFunction(void* layer = NULL, FunctionType function = NULL) :
+      layer(layer), function(function) { }
+
+  //! Execute the Forward() function of the layer.
+  void operator()(const arma::mat& input, arma::mat& output) const
+  {
+    function(layer, input, output);
+  }
+
+ private:
+  //! The layer.
+  void* layer;
+
+  //! The function that calls Forward() on the layer.
+  FunctionType function;
+};
+
+/**
+ * ForwardFunctionVisitor returns the Forward() function of the given layer as
+ * a LayerForwardFunction.
+ */
+class ForwardFunctionVisitor :
+    public boost::static_visitor<LayerForwardFunction>
+{
+ public:
+  //! Return the Forward() function of the layer.
+  template<typename LayerType>
+  LayerForwardFunction operator()(LayerType* layer) const;
+
+  LayerForwardFunction operator()(MoreTypes layer) const;
+
+ private:
+  //! Execute the Forward() function of the given layer.
+  template<typename LayerType>
+  static void Forward(void* layer, const arma::mat& input, arma::mat& output);
+};
+
+} // namespace ann
+} // namespace mlpack
+
+// Include implementation.
+#include "forward_function_visitor_impl.hpp"
+
+#endif
@@ -0,0 +1,46 @@
+/**
+ * @file forward_function_visitor_impl.hpp
+ *
+ * Implementation of the ForwardFunctionVisitor class.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_ANN_VISITOR_FORWARD_FUNCTION_VISITOR_IMPL_HPP
+#define MLPACK_METHODS_ANN_VISITOR_FORWARD_FUNCTION_VISITOR_IMPL_HPP
+
+// In case it hasn't been included yet.
+#include "forward_function_visitor.hpp"
+
+namespace mlpack {
+namespace ann {
+
+//! ForwardFunctionVisitor visitor class.
+template<typename LayerType>
+inline LayerForwardFunction ForwardFunctionVisitor::operator()(
+    LayerType* layer) const
+{
+  return LayerForwardFunction(layer,
+      &ForwardFunctionVisitor::Forward<LayerType>);
+}
+
+inline LayerForwardFunction ForwardFunctionVisitor::operator()(
+    MoreTypes layer) const
+{
+  return layer.apply_visitor(*this);
+}
+
+template<typename LayerType>
+inline void ForwardFunctionVisitor::Forward(void* layer,
+                                            const arma::mat& input,
+                                            arma::mat& output)
+{
+  static_cast<LayerType*>(layer)->Forward(input, output);
+}
+
+} // namespace ann
+} // namespace mlpack
+
+#endif
@@ -59,6 +59,11 @@ namespace cf /** Collaborative filtering. **/ {
  * are in a matrix that holds doubles, should hold integer (or size_t) values.
  * The user and item indices are assumed to start at 0.
  *
+ * Recommendations are generated in parallel (with OpenMP) over blocks of
+ * users; the ratings of all the neighbors of a block are computed with a single
+ * matrix multiplication, through the GetRatingOfUsers() method of the
+ * DecompositionPolicy.
+ *
  * @tparam DecompositionPolicy The policy used to decompose the rating matrix.
  *     It also provides methods to compute prediction and neighborhood.
  * @tparam NormalizationType The type of normalization performed on raw data.
@@ -200,6 +205,7 @@ class CFType
 
   /**
    * Generates the given number of recommendations for the specified users.
+   * The users are processed in parallel, in blocks.
    *
    * @tparam NeighborSearchPolicy The policy used to search neighbors of
    *     query set in referece set.
@@ -274,6 +280,10 @@ class CFType
   //! Data normalization object.
   NormalizationType normalization;
 
+  //! The maximum number of neighbor ratings held at once by each thread in
+  //! GetRecommendations().
+  static const size_t RecommendationBlockElements = 1 << 22;
+
   //! Candidate represents a possible recommendation (value, item).
   typedef std::pair<double, size_t> Candidate;
 
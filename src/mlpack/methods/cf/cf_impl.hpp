@@ -201,71 +201,115 @@ GetRecommendations(const size_t numRecs,
   // Generate recommendations for each query user by finding the maximum numRecs
   // elements in the ratings vector.
   recommendations.set_size(numRecs, users.n_elem);
-  arma::mat values(numRecs, users.n_elem);
   recommendations.fill(SIZE_MAX);
-  values.fill(DBL_MAX);
 
   // Initialization of an InterpolationPolicy object should be put ahead of the
   // following loop, because the initialization may takes a relatively long
   // time and we don't want to repeat the initialization process in each loop.
   InterpolationPolicy interpolation(cleanedData);
 
+  // Calculate interpolation weights.  Some interpolation policies cache values
+  // between calls, so this is not done in parallel.
+  arma::mat weights(numUsersForSimilarity, users.n_elem);
   for (size_t i = 0; i < users.n_elem; i++)
   {
-    // First, calculate the weighted sum of neighborhood values.
-    arma::vec ratings;
-    ratings.zeros(cleanedData.n_rows);
-
-    // Calculate interpolation weights.
-    arma::vec weights(numUsersForSimilarity);
-    interpolation.GetWeights(weights, decomposition, users(i),
+    interpolation.GetWeights(weights.col(i), decomposition, users(i),
         neighborhood.col(i), similarities.col(i), cleanedData);
+  }
 
-    for (size_t j = 0; j < neighborhood.n_rows; ++j)
+  // The users are handled in blocks.  The ratings of all the neighbors of a
+  // block are computed at once, so each block holds at most about
+  // RecommendationBlockElements ratings; there should also be enough blocks to
+  // keep all threads busy.
+  size_t numThreads = 1;
+  #ifdef HAS_OPENMP
+    numThreads = omp_get_max_threads();
+  #endif
+  const size_t blockSize = std::max((size_t) 1, std::min(
+      RecommendationBlockElements / (cleanedData.n_rows * neighborhood.n_rows +
+      1), (size_t) users.n_elem / (4 * numThreads)));
+  const size_t numBlocks = (users.n_elem + blockSize - 1) / blockSize;
+
+  // Default candidate: the smallest possible value and invalid item number.
+  const Candidate def = std::make_pair(-DBL_MAX, cleanedData.n_rows);
+  typedef std::priority_queue<Candidate, std::vector<Candidate>, CandidateCmp>
+      CandidateList;
+
+  #pragma omp parallel for schedule(dynamic)
+  for (omp_size_t b = 0; b < (omp_size_t) numBlocks; ++b)
+  {
+    const size_t blockBegin = b * blockSize;
+    const size_t blockEnd = std::min(blockBegin + blockSize,
+        (size_t) users.n_elem);
+
+    // Find the ratings of every user in the neighborhood of the block.
+    std::vector<size_t> blockNeighbors(neighborhood.colptr(blockBegin),
+        neighborhood.colptr(blockBegin) + (blockEnd - blockBegin) *
+        neighborhood.n_rows);
+    std::sort(blockNeighbors.begin(), blockNeighbors.end());
+    blockNeighbors.erase(std::unique(blockNeighbors.begin(),
+        blockNeighbors.end()), blockNeighbors.end());
+
+    arma::mat neighborRatings;
+    decomposition.GetRatingOfUsers(arma::Col<size_t>(blockNeighbors),
+        neighborRatings);
+
+    arma::vec ratings(cleanedData.n_rows);
+    for (size_t i = blockBegin; i < blockEnd; ++i)
     {
-      arma::vec neighborRatings;
-      decomposition.GetRatingOfUser(neighborhood(j, i), neighborRatings);
-      ratings += weights(j) * neighborRatings;
-    }
+      // First, calculate the weighted sum of neighborhood values.
+      ratings.zeros();
+      for (size_t j = 0; j < neighborhood.n_rows; ++j)
+      {
+        const size_t neighborIndex = std::lower_bound(blockNeighbors.begin(),
+            blockNeighbors.end(), neighborhood(j, i)) - blockNeighbors.begin();
+        ratings += weights(j, i) * neighborRatings.unsafe_col(neighborIndex);
+      }
 
-    // Let's build the list of candidate recomendations for the given user.
-    // Default candidate: the smallest possible value and invalid item number.
-    const Candidate def = std::make_pair(-DBL_MAX, cleanedData.n_rows);
-    std::vector<Candidate> vect(numRecs, def);
-    typedef std::priority_queue<Candidate, std::vector<Candidate>, CandidateCmp>
-        CandidateList;
-    CandidateList pqueue(CandidateCmp(), std::move(vect));
+      // Let's build the list of candidate recomendations for the given user.
+      std::vector<Candidate> vect(numRecs, def);
+      CandidateList pqueue(CandidateCmp(), std::move(vect));
+
+      // Look through the ratings column corresponding to the current user.
+      // The items that the user already rated are skipped by walking through
+      // the user's column of cleanedData alongside.  The algorithm omits
+      // rating of zero. Thus, when normalizing original ratings in
+      // Normalize(), if normalized rating equals zero, it is set to the
+      // smallest positive double value.
+      arma::sp_mat::const_iterator rated = cleanedData.begin_col(users(i));
+      const arma::sp_mat::const_iterator ratedEnd =
+          cleanedData.end_col(users(i));
+      for (size_t j = 0; j < ratings.n_rows; ++j)
+      {
+        if (rated != ratedEnd && rated.row() == j)
+        {
+          ++rated;
+          continue; // The user already rated the item.
+        }
+
+        // Is the estimated value better than the worst candidate?
+        // Denormalize rating before comparison.
+        double realRating = normalization.Denormalize(users(i), j, ratings[j]);
+        if (realRating > pqueue.top().first)
+        {
+          Candidate c = std::make_pair(realRating, j);
+          pqueue.pop();
+          pqueue.push(c);
+        }
+      }
 
-    // Look through the ratings column corresponding to the current user.
-    for (size_t j = 0; j < ratings.n_rows; ++j)
-    {
-      // Ensure that the user hasn't already rated the item.
-      // The algorithm omits rating of zero. Thus, when normalizing original
-      // ratings in Normalize(), if normalized rating equals zero, it is set
-      // to the smallest positive double value.
-      if (cleanedData(j, users(i)) != 0.0)
-        continue; // The user already rated the item.
-
-      // Is the estimated value better than the worst candidate?
-      // Denormalize rating before comparison.
-      double realRating = normalization.Denormalize(users(i), j, ratings[j]);
-      if (realRating > pqueue.top().first)
+      for (size_t p = 1; p <= numRecs; p++)
       {
-        Candidate c = std::make_pair(realRating, j);
+        recommendations(numRecs - p, i) = pqueue.top().second;
         pqueue.pop();
-        pqueue.push(c);
       }
     }
+  }
 
-    for (size_t p = 1; p <= numRecs; p++)
-    {
-      recommendations(numRecs - p, i) = pqueue.top().second;
-      values(numRecs - p, i) = pqueue.top().first;
-      pqueue.pop();
-    }
-
-    // If we were not able to come up with enough recommendations, issue a
-    // warning.
+  // If we were not able to come up with enough recommendations, issue a
+  // warning.
+  for (size_t i = 0; i < users.n_elem; i++)
+  {
     if (recommendations(numRecs - 1, i) == def.second)
       Log::Warn << "Could not provide " << numRecs << " recommendations "
           << "for user " << users(i) << " (not enough un-rated items)!"
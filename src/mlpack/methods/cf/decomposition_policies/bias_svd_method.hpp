@@ -106,6 +106,20 @@ class BiasSVDPolicy
     rating = w * h.col(user) + p + q(user);
   }
 
+  /**
+   * Get predicted ratings for a set of users, with one matrix multiplication.
+   *
+   * @param users User IDs.
+   * @param ratings Resulting ratings; each column holds the ratings of a user.
+   */
+  void GetRatingOfUsers(const arma::Col<size_t>& users,
+                        arma::mat& ratings) const
+  {
+    ratings = w * h.cols(users);
+    ratings.each_col() += p;
+    ratings.each_row() += q.elem(users).t();
+  }
+
   /**
    * Get the neighborhood and corresponding similarities for a set of users.
    *
@@ -113,6 +113,18 @@ class RandomizedSVDPolicy
     rating = w * h.col(user);
   }
 
+  /**
+   * Get predicted ratings for a set of users, with one matrix multiplication.
+   *
+   * @param users User IDs.
+   * @param ratings Resulting ratings; each column holds the ratings of a user.
+   */
+  void GetRatingOfUsers(const arma::Col<size_t>& users,
+                        arma::mat& ratings) const
+  {
+    ratings = w * h.cols(users);
+  }
+
   /**
    * Get the neighborhood and corresponding similarities for a set of users.
    *
@@ -18,6 +18,7 @@
 #include <mlpack/methods/emst/union_find.hpp>
 #include "random_point_selection.hpp"
 #include "ordered_point_selection.hpp"
+#include "grid_range_search.hpp"
 #include <boost/dynamic_bitset.hpp>
 
 namespace mlpack {
@@ -44,6 +45,10 @@ namespace dbscan {
  * range search technique used and the point selection strategy by means of
  * template parameters.
  *
+ * For low-dimensional data, GridRangeSearch can be used as the range search
+ * technique; then the neighborhoods of the points are never stored, and the
+ * batchMode parameter and the point selection strategy are ignored.
+ *
  * @tparam RangeSearchType Class to use for range searching.
  * @tparam PointSelectionPolicy Strategy for selecting next point to cluster
  *      with.
@@ -129,6 +134,34 @@ class DBSCAN
   //! Instantiated point selection policy.
   PointSelectionPolicy pointSelector;
 
+  /**
+   * Find the connected components of the graph that links all pairs of points
+   * within distance epsilon of each other, with the range search.  The
+   * component of each point is stored in assignments.
+   *
+   * @param data Dataset to cluster.
+   * @param assignments Component of each point.
+   */
+  template<typename MatType, typename RST = RangeSearchType>
+  void Components(const MatType& data,
+                  arma::Row<size_t>& assignments,
+                  const typename std::enable_if<
+                      !std::is_same<RST, GridRangeSearch>::value>::type* = 0);
+
+  /**
+   * Find the connected components of the graph that links all pairs of points
+   * within distance epsilon of each other, with the grid of GridRangeSearch.
+   * The component of each point is stored in assignments.
+   *
+   * @param data Dataset to cluster.
+   * @param assignments Component of each point.
+   */
+  template<typename MatType, typename RST = RangeSearchType>
+  void Components(const MatType& data,
+                  arma::Row<size_t>& assignments,
+                  const typename std::enable_if<
+                      std::is_same<RST, GridRangeSearch>::value>::type* = 0);
+
   /**
    * Performs DBSCAN clustering on the data, returning the number of clusters and
    * also the list of cluster assignments.  This searches each point iteratively,
@@ -100,19 +100,8 @@ size_t DBSCAN<RangeSearchType, PointSelectionPolicy>::Cluster(
     const MatType& data,
     arma::Row<size_t>& assignments)
 {
-  // Initialize the UnionFind object.
-  emst::UnionFind uf(data.n_cols);
-  rangeSearch.Train(data);
-
-  if (batchMode)
-    BatchCluster(data, uf);
-  else
-    PointwiseCluster(data, uf);
-
-  // Now set assignments.
-  assignments.set_size(data.n_cols);
-  for (size_t i = 0; i < data.n_cols; ++i)
-    assignments[i] = uf.Find(i);
+  // Find the component of each point.
+  Components(data, assignments);
 
   // Get a count of all clusters.
   const size_t numClusters = arma::max(assignments) + 1;
@@ -140,6 +129,48 @@ size_t DBSCAN<RangeSearchType, PointSelectionPolicy>::Cluster(
   return currentCluster;
 }
 
+/**
+ * Find the component of each point with the range search.
+ */
+template<typename RangeSearchType, typename PointSelectionPolicy>
+template<typename MatType, typename RST>
+void DBSCAN<RangeSearchType, PointSelectionPolicy>::Components(
+    const MatType& data,
+    arma::Row<size_t>& assignments,
+    const typename std::enable_if<
+        !std::is_same<RST, GridRangeSearch>::value>::type*)
+{
+  // Initialize the UnionFind object.
+  emst::UnionFind uf(data.n_cols);
+  rangeSearch.Train(data);
+
+  if (batchMode)
+    BatchCluster(data, uf);
+  else
+    PointwiseCluster(data, uf);
+
+  // Now set assignments.
+  assignments.set_size(data.n_cols);
+  for (size_t i = 0; i < data.n_cols; ++i)
+    assignments[i] = uf.Find(i);
+}
+
+/**
+ * Find the component of each point with the grid, without computing the
+ * neighborhoods of the points.
+ */
+template<typename RangeSearchType, typename PointSelectionPolicy>
+template<typename MatType, typename RST>
+void DBSCAN<RangeSearchType, PointSelectionPolicy>::Components(
+    const MatType& data,
+    arma::Row<size_t>& assignments,
+    const typename std::enable_if<
+        std::is_same<RST, GridRangeSearch>::value>::type*)
+{
+  rangeSearch.Train(data);
+  rangeSearch.Components(epsilon, assignments);
+}
+
 /**
  * Performs DBSCAN clustering on the data, returning the number of clusters and
  * also the list of cluster assignments.  This searches each point iteratively,
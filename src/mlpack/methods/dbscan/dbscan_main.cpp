@@ -60,6 +60,12 @@ PROGRAM_INFO("DBSCAN clustering",
     "search (as opposed to the default dual-tree search), and '" +
     PRINT_PARAM_STRING("naive") + " will force brute-force range search."
     "\n\n"
+    "For low-dimensional data (up to 4 dimensions), the " +
+    PRINT_PARAM_STRING("grid") + " parameter may be specified to bucket the "
+    "points into a grid instead of performing range searches; this does not "
+    "store the neighborhood of each point, and uses multiple threads.  The "
+    "clustering is the same, but the clusters may be numbered differently."
+    "\n\n"
     "An example usage to run DBSCAN on the dataset in " +
     PRINT_DATASET("input") + " with a radius of 0.5 and a minimum cluster size"
     " of 5 is given below:"
@@ -89,14 +95,26 @@ PARAM_FLAG("single_mode", "If set, single-tree range search (not dual-tree) "
     "will be used.", "S");
 PARAM_FLAG("naive", "If set, brute-force range search (not tree-based) "
     "will be used.", "N");
+PARAM_FLAG("grid", "If set, the points will be bucketed into a grid instead of "
+    "using range search (only for data with up to 4 dimensions).", "g");
+
+// Set single-tree search, if requested.
+template<typename RangeSearchType>
+void SetSingleMode(RangeSearchType& rs)
+{
+  if (CLI::HasParam("single_mode"))
+    rs.SingleMode() = true;
+}
+
+// The grid has no single-tree mode.
+void SetSingleMode(GridRangeSearch& /* rs */) { }
 
 // Actually run the clustering, and process the output.
 template<typename RangeSearchType, typename PointSelectionPolicy>
 void RunDBSCAN(RangeSearchType rs,
                PointSelectionPolicy pointSelector = PointSelectionPolicy())
 {
-  if (CLI::HasParam("single_mode"))
-    rs.SingleMode() = true;
+  SetSingleMode(rs);
 
   // Load dataset.
   arma::mat dataset = std::move(CLI::GetParam<arma::mat>("input"));
@@ -143,6 +161,10 @@ static void mlpackMain()
       "no output will be saved");
 
   ReportIgnoredParam({{ "naive", true }}, "single_mode");
+  ReportIgnoredParam({{ "grid", true }}, "single_mode");
+  ReportIgnoredParam({{ "grid", true }}, "naive");
+  ReportIgnoredParam({{ "grid", true }}, "tree_type");
+  ReportIgnoredParam({{ "grid", true }}, "selection_type");
 
   RequireParamInSet<string>("tree_type", { "kd", "cover", "r", "r-star", "x",
       "hilbert-r", "r-plus", "r-plus-plus", "ball" }, true,
@@ -156,8 +178,21 @@ static void mlpackMain()
   RequireParamValue<int>("min_size", [](int y) { return y > 0; },
       true, "invalid value of min_size specified");
 
-  // Fire off naive search if needed.
-  if (CLI::HasParam("naive"))
+  // Use the grid if requested; otherwise, fire off naive search if needed.
+  if (CLI::HasParam("grid"))
+  {
+    const size_t dimensionality = CLI::GetParam<arma::mat>("input").n_rows;
+    if (dimensionality > GridRangeSearch::MaxDimensionality)
+    {
+      Log::Fatal << "Input dimensionality (" << dimensionality << ") is too "
+          << "high for " << PRINT_PARAM_STRING("grid") << "; the grid can only "
+          << "be used for data with up to "
+          << GridRangeSearch::MaxDimensionality << " dimensions!" << endl;
+    }
+
+    RunDBSCAN<GridRangeSearch, OrderedPointSelection>(GridRangeSearch());
+  }
+  else if (CLI::HasParam("naive"))
   {
     RangeSearch<> rs(true);
     ChoosePointSelectionPolicy(rs);
@@ -0,0 +1,245 @@
+/**
+ * @file grid_range_search.cpp
+ *
+ * Implementation of GridRangeSearch.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#include "grid_range_search.hpp"
+#include <mlpack/methods/emst/concurrent_union_find.hpp>
+
+using namespace mlpack;
+using namespace mlpack::dbscan;
+
+void GridRangeSearch::Train(const arma::mat& data)
+{
+  if (data.n_rows > MaxDimensionality)
+  {
+    std::ostringstream oss;
+    oss << "GridRangeSearch::Train(): dimensionality of data (" << data.n_rows
+        << ") is greater than the maximum supported dimensionality ("
+        << MaxDimensionality << ")!";
+    throw std::invalid_argument(oss.str());
+  }
+
+  dataset = data;
+  oldFromNew.resize(data.n_cols);
+  for (size_t i = 0; i < data.n_cols; ++i)
+    oldFromNew[i] = i;
+}
+
+void GridRangeSearch::Components(const double epsilon,
+                                 arma::Row<size_t>& components)
+{
+  const size_t dimensionality = dataset.n_rows;
+  const size_t n = dataset.n_cols;
+  components.set_size(n);
+  if (n == 0)
+    return;
+
+  // With this cell size, the diagonal of a cell is epsilon.
+  const double cellSize = epsilon / std::sqrt((double) dimensionality);
+  const arma::vec minimums = arma::min(dataset, 1);
+  const arma::vec maximums = arma::max(dataset, 1);
+  if (!(epsilon > 0.0) ||
+      arma::max(maximums - minimums) / cellSize >= std::pow(2.0, 52.0))
+  {
+    std::ostringstream oss;
+    oss << "GridRangeSearch::Components(): epsilon (" << epsilon << ") is too "
+        << "small for the range of the data!";
+    throw std::invalid_argument(oss.str());
+  }
+
+  // Find the cell of each point.
+  arma::Mat<size_t> coordinates(dimensionality, n);
+  #pragma omp parallel for schedule(static)
+  for (omp_size_t i = 0; i < (omp_size_t) n; ++i)
+  {
+    for (size_t k = 0; k < dimensionality; ++k)
+    {
+      coordinates(k, i) = (size_t) std::floor((dataset(k, i) - minimums[k]) /
+          cellSize);
+    }
+  }
+
+  // Sort the points by cell, in lexicographic order of the cell coordinates;
+  // the points of a cell stay in their original order.
+  std::vector<size_t> order(n);
+  for (size_t i = 0; i < n; ++i)
+    order[i] = i;
+  std::sort(order.begin(), order.end(), [&](const size_t a, const size_t b)
+  {
+    const size_t* aCoordinates = coordinates.colptr(a);
+    const size_t* bCoordinates = coordinates.colptr(b);
+    for (size_t k = 0; k < dimensionality; ++k)
+      if (aCoordinates[k] != bCoordinates[k])
+        return aCoordinates[k] < bCoordinates[k];
+    return a < b;
+  });
+
+  // Reorder the points, so that the points of each cell are contiguous.
+  arma::mat sortedDataset(dimensionality, n);
+  arma::Mat<size_t> sortedCoordinates(dimensionality, n);
+  std::vector<size_t> sortedOldFromNew(n);
+  #pragma omp parallel for schedule(static)
+  for (omp_size_t i = 0; i < (omp_size_t) n; ++i)
+  {
+    sortedDataset.col(i) = dataset.col(order[i]);
+    sortedCoordinates.col(i) = coordinates.col(order[i]);
+    sortedOldFromNew[i] = oldFromNew[order[i]];
+  }
+  dataset = std::move(sortedDataset);
+  oldFromNew.swap(sortedOldFromNew);
+
+  // Find where each cell begins.
+  std::vector<size_t> cellBegin(1, 0);
+  for (size_t i = 1; i < n; ++i)
+  {
+    if (!std::equal(sortedCoordinates.colptr(i),
+        sortedCoordinates.colptr(i) + dimensionality,
+        sortedCoordinates.colptr(i - 1)))
+      cellBegin.push_back(i);
+  }
+  const size_t numCells = cellBegin.size();
+  cellBegin.push_back(n);
+
+  arma::Mat<size_t> cellCoordinates(dimensionality, numCells);
+  for (size_t c = 0; c < numCells; ++c)
+    cellCoordinates.col(c) = sortedCoordinates.col(cellBegin[c]);
+
+  // Two cells can hold points within distance epsilon if the sum of the
+  // squared gaps between them along each dimension is at most d cells.  Only
+  // the offsets whose first nonzero coordinate is positive are kept, so each
+  // pair of cells is checked once, from the cell that comes first.
+  ptrdiff_t reach = 1;
+  while ((size_t) (reach * reach) < dimensionality)
+    ++reach;
+
+  std::vector<ptrdiff_t> offsets;
+  std::vector<ptrdiff_t> offset(dimensionality, -reach);
+  while (true)
+  {
+    size_t firstNonzero = 0;
+    while (firstNonzero < dimensionality && offset[firstNonzero] == 0)
+      ++firstNonzero;
+
+    size_t gap = 0;
+    for (size_t k = 0; k < dimensionality; ++k)
+    {
+      const size_t distance = (size_t) std::abs(offset[k]);
+      if (distance > 1)
+        gap += (distance - 1) * (distance - 1);
+    }
+
+    if (firstNonzero < dimensionality && offset[firstNonzero] > 0 &&
+        gap <= dimensionality)
+      offsets.insert(offsets.end(), offset.begin(), offset.end());
+
+    // Move to the next offset.
+    size_t k = 0;
+    while (k < dimensionality && offset[k] == reach)
+      offset[k++] = -reach;
+    if (k == dimensionality)
+      break;
+    ++offset[k];
+  }
+  const size_t numOffsets = offsets.size() / dimensionality;
+
+  // All the points of a cell are within distance epsilon of each other, so
+  // only the cells need to be merged.  The cells are handed out dynamically,
+  // because dense cells take longer to check.
+  emst::ConcurrentUnionFind cellConnections(numCells);
+  const double squaredEpsilon = epsilon * epsilon;
+  #pragma omp parallel
+  {
+    std::vector<size_t> neighborCoordinates(dimensionality);
+
+    #pragma omp for schedule(dynamic, 256)
+    for (omp_size_t c = 0; c < (omp_size_t) numCells; ++c)
+    {
+      for (size_t o = 0; o < numOffsets; ++o)
+      {
+        bool valid = true;
+        for (size_t k = 0; k < dimensionality; ++k)
+        {
+          const ptrdiff_t coordinate = (ptrdiff_t) cellCoordinates(k, c) +
+              offsets[o * dimensionality + k];
+          if (coordinate < 0)
+          {
+            valid = false;
+            break;
+          }
+
+          neighborCoordinates[k] = (size_t) coordinate;
+        }
+
+        if (!valid)
+          continue;
+
+        // Binary search for the neighboring cell, which comes after this one.
+        size_t low = c + 1;
+        size_t high = numCells;
+        while (low < high)
+        {
+          const size_t middle = low + (high - low) / 2;
+          if (std::lexicographical_compare(cellCoordinates.colptr(middle),
+              cellCoordinates.colptr(middle) + dimensionality,
+              neighborCoordinates.begin(), neighborCoordinates.end()))
+            low = middle + 1;
+          else
+            high = middle;
+        }
+
+        if (low == numCells || !std::equal(neighborCoordinates.begin(),
+            neighborCoordinates.end(), cellCoordinates.colptr(low)))
+          continue;
+
+        if (cellConnections.Find(c) == cellConnections.Find(low))
+          continue;
+
+        if (CellsConnected(cellBegin[c], cellBegin[c + 1], cellBegin[low],
+            cellBegin[low + 1], squaredEpsilon))
+          cellConnections.Union(c, low);
+      }
+    }
+  }
+
+  // The label of each point is the root of its cell's component.
+  #pragma omp parallel for schedule(static)
+  for (omp_size_t c = 0; c < (omp_size_t) numCells; ++c)
+  {
+    const size_t component = cellConnections.Find(c);
+    for (size_t i = cellBegin[c]; i < cellBegin[c + 1]; ++i)
+      components[oldFromNew[i]] = component;
+  }
+}
+
+bool GridRangeSearch::CellsConnected(const size_t begin1,
+                                     const size_t end1,
+                                     const size_t begin2,
+                                     const size_t end2,
+                                     const double squaredEpsilon) const
+{
+  for (size_t i = begin1; i < end1; ++i)
+  {
+    const double* point1 = dataset.colptr(i);
+    for (size_t j = begin2; j < end2; ++j)
+    {
+      const double* point2 = dataset.colptr(j);
+      double distance = 0.0;
+      for (size_t k = 0; k < dataset.n_rows; ++k)
+      {
+        const double diff = point1[k] - point2[k];
+        distance += diff * diff;
+      }
+
+      if (distance <= squaredEpsilon)
+        return true;
+    }
+  }
+
+  return false;
+}
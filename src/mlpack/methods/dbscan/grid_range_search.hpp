@@ -0,0 +1,93 @@
+/**
+ * @file grid_range_search.hpp
+ *
+ * Definition of GridRangeSearch, a range search strategy for DBSCAN on
+ * low-dimensional data that buckets the points into a grid.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_DBSCAN_GRID_RANGE_SEARCH_HPP
+#define MLPACK_METHODS_DBSCAN_GRID_RANGE_SEARCH_HPP
+
+#include <mlpack/prereqs.hpp>
+
+namespace mlpack {
+namespace dbscan {
+
+/**
+ * GridRangeSearch can be used as the RangeSearchType of DBSCAN to cluster
+ * low-dimensional data (such as 2-D or 3-D geospatial data) without
+ * computing the neighborhood of every point.
+ *
+ * The points are bucketed into a grid whose cells have a diagonal of length
+ * epsilon, so that all the points of a cell are in the same cluster.  The
+ * points are then sorted by cell, so that each cell is contiguous in memory,
+ * and the clusters are found by merging neighboring cells that hold at least
+ * one pair of points within distance epsilon.  The cells are processed in
+ * parallel, and merged with a lock-free union-find; the pairs of points
+ * between two cells are only checked until one pair is close enough, and
+ * never when the cells are already in the same cluster.
+ *
+ * Only the Euclidean distance and dense data are supported.  Because the
+ * number of neighboring cells grows exponentially with the dimensionality,
+ * data with more than MaxDimensionality dimensions is not supported.
+ *
+ * @code
+ * DBSCAN<GridRangeSearch> dbscan(epsilon, minPoints);
+ * dbscan.Cluster(data, assignments);
+ * @endcode
+ */
+class GridRangeSearch
+{
+ public:
+  //! The largest dimensionality supported.
+  static const size_t MaxDimensionality = 4;
+
+  /**
+   * Set the data to search.  The data is copied, and will be reordered by
+   * Components().
+   *
+   * @param data Dataset to search.
+   */
+  void Train(const arma::mat& data);
+
+  /**
+   * Find the connected components of the graph that links all pairs of points
+   * within distance epsilon of each other.  The component of each point is
+   * identified by a label between 0 and the number of points; the labels are
+   * not contiguous.
+   *
+   * @param epsilon Maximum distance between linked points.
+   * @param components Output component label of each point.
+   */
+  void Components(const double epsilon, arma::Row<size_t>& components);
+
+  //! Get the (reordered) dataset.
+  const arma::mat& Dataset() const { return dataset; }
+  //! Get the original index of each point of the reordered dataset.
+  const std::vector<size_t>& OldFromNew() const { return oldFromNew; }
+
+ private:
+  /**
+   * Return whether any point of the first cell is within the given squared
+   * distance of any point of the second cell.
+   */
+  bool CellsConnected(const size_t begin1,
+                      const size_t end1,
+                      const size_t begin2,
+                      const size_t end2,
+                      const double squaredEpsilon) const;
+
+  //! The dataset, sorted by cell.
+  arma::mat dataset;
+  //! The original index of each point of the dataset.
+  std::vector<size_t> oldFromNew;
+};
+
+} // namespace dbscan
+} // namespace mlpack
+
+#endif
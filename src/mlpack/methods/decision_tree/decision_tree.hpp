@@ -17,6 +17,7 @@
 #include "gini_gain.hpp"
 #include "information_gain.hpp"
 #include "best_binary_numeric_split.hpp"
+#include "histogram_numeric_split.hpp"
 #include "all_categorical_split.hpp"
 #include "all_dimension_select.hpp"
 #include <type_traits>
@@ -292,6 +293,8 @@ class DecisionTree :
    * @param minimumGainSplit Minimum gain for the node to split.
    * @param maximumDepth Maximum depth for the tree.
    * @param dimensionSelector Instantiated dimension selection policy.
+   * @param parallel If true, use all OpenMP threads to build the tree (see
+   *      TrainParallel()).
    * @return The final entropy of decision tree.
    */
   template<typename MatType, typename LabelsType>
@@ -303,7 +306,8 @@ class DecisionTree :
                const double minimumGainSplit = 1e-7,
                const size_t maximumDepth = 0,
                DimensionSelectionType dimensionSelector =
-                   DimensionSelectionType());
+                   DimensionSelectionType(),
+               const bool parallel = false);
 
   /**
    * Train the decision tree on the given data, assuming that all dimensions are
@@ -321,6 +325,8 @@ class DecisionTree :
    * @param minimumGainSplit Minimum gain for the node to split.
    * @param maximumDepth Maximum depth for the tree.
    * @param dimensionSelector Instantiated dimension selection policy.
+   * @param parallel If true, use all OpenMP threads to build the tree (see
+   *      TrainParallel()).
    * @return The final entropy of decision tree.
    */
   template<typename MatType, typename LabelsType>
@@ -331,7 +337,8 @@ class DecisionTree :
                const double minimumGainSplit = 1e-7,
                const size_t maximumDepth = 0,
                DimensionSelectionType dimensionSelector =
-                   DimensionSelectionType());
+                   DimensionSelectionType(),
+               const bool parallel = false);
 
   /**
    * Train the decision tree on the given weighted data.  This will overwrite
@@ -352,6 +359,8 @@ class DecisionTree :
    * @param minimumGainSplit Minimum gain for the node to split.
    * @param maximumDepth Maximum depth for the tree.
    * @param dimensionSelector Instantiated dimension selection policy.
+   * @param parallel If true, use all OpenMP threads to build the tree (see
+   *      TrainParallel()).
    * @return The final entropy of decision tree.
    */
   template<typename MatType, typename LabelsType, typename WeightsType>
@@ -365,6 +374,7 @@ class DecisionTree :
                const size_t maximumDepth = 0,
                DimensionSelectionType dimensionSelector =
                    DimensionSelectionType(),
+               const bool parallel = false,
                const std::enable_if_t<arma::is_arma_type<typename
                    std::remove_reference<WeightsType>::type>::value>* = 0);
 
@@ -385,6 +395,8 @@ class DecisionTree :
    * @param minimumGainSplit Minimum gain for the node to split.
    * @param maximumDepth Maximum depth for the tree.
    * @param dimensionSelector Instantiated dimension selection policy.
+   * @param parallel If true, use all OpenMP threads to build the tree (see
+   *      TrainParallel()).
    * @return The final entropy of decision tree.
    */
   template<typename MatType, typename LabelsType, typename WeightsType>
@@ -397,6 +409,7 @@ class DecisionTree :
                const size_t maximumDepth = 0,
                DimensionSelectionType dimensionSelector =
                    DimensionSelectionType(),
+               const bool parallel = false,
                const std::enable_if_t<arma::is_arma_type<typename
                    std::remove_reference<WeightsType>::type>::value>* = 0);
 
@@ -466,6 +479,19 @@ class DecisionTree :
   //! Get the split dimension (only meaningful if this is a non-leaf in a
   //! trained tree).
   size_t SplitDimension() const { return splitDimension; }
+  //! Get the type of the split dimension (only meaningful if this is a
+  //! non-leaf in a trained tree).
+  data::Datatype SplitDimensionType() const
+  {
+    return (data::Datatype) dimensionTypeOrMajorityClass;
+  }
+
+  /**
+   * Get the class probabilities of a leaf.  If this node is not a leaf, this
+   * holds the information used by the split type's CalculateDirection()
+   * function instead (for BestBinaryNumericSplit, the split value).
+   */
+  const arma::vec& ClassProbabilities() const { return classProbabilities; }
 
   /**
    * Given a point and that this node is not a leaf, calculate the index of the
@@ -515,6 +541,93 @@ class DecisionTree :
                                    const size_t numClasses,
                                    const WeightsRowType& weights);
 
+  //! A subtree whose training was deferred by TrainParallel(), so that it can
+  //! be trained independently of the other deferred subtrees.
+  struct DeferredSubtree
+  {
+    //! The (still untrained) root of the subtree.
+    DecisionTree* node;
+    //! Index of the first point of the subtree.
+    size_t begin;
+    //! Number of points in the subtree.
+    size_t count;
+    //! Maximum depth of the subtree.
+    size_t maximumDepth;
+  };
+
+  /**
+   * Train the tree using all OpenMP threads.  The top levels of the tree are
+   * built first; at each of their nodes, the candidate dimensions given by the
+   * dimension selector are all evaluated in parallel, and the dimension with
+   * the best gain is used.  (This may differ from the serial build, which takes
+   * the first dimension that improves on the previous one by at least
+   * minimumGainSplit.)  Every child with few enough points that its subtree is
+   * a small part of the work is not built immediately; instead, once the top
+   * levels are done, all these subtrees are built in parallel, each by one
+   * thread with its own copy of the dimension selector.
+   *
+   * If this is called from inside a parallel region (for instance while a
+   * RandomForest is trained), no new threads are started, so the threads are
+   * not oversubscribed.
+   *
+   * @param data Dataset to train on.
+   * @param datasetInfo Type information for each dimension, or NULL if all
+   *      dimensions are numeric.
+   * @param labels Labels for each training point.
+   * @param numClasses Number of classes in the dataset.
+   * @param weights Weights of all the labels.
+   * @param minimumLeafSize Minimum number of points in each leaf node.
+   * @param minimumGainSplit Minimum gain for the node to split.
+   * @param maximumDepth Maximum depth for the tree.
+   * @param dimensionSelector Instantiated dimension selection policy.
+   * @return The final entropy of decision tree.
+   */
+  template<bool UseWeights, typename MatType>
+  double TrainParallel(MatType& data,
+                       const data::DatasetInfo* datasetInfo,
+                       arma::Row<size_t>& labels,
+                       const size_t numClasses,
+                       arma::rowvec& weights,
+                       const size_t minimumLeafSize,
+                       const double minimumGainSplit,
+                       const size_t maximumDepth,
+                       DimensionSelectionType& dimensionSelector);
+
+  /**
+   * Evaluate all the dimensions given by the dimension selector in parallel,
+   * and keep the split of the one with the best gain (the first one, if there
+   * are ties).  The split information is stored in classProbabilities and the
+   * auxiliary split information of this node.
+   *
+   * @param data Dataset to train on.
+   * @param begin Index of the starting point in the dataset that belongs to
+   *      this node.
+   * @param count Number of points in this node.
+   * @param datasetInfo Type information for each dimension, or NULL if all
+   *      dimensions are numeric.
+   * @param labels Labels for each training point.
+   * @param numClasses Number of classes in the dataset.
+   * @param weights Weights of all the labels.
+   * @param minimumLeafSize Minimum number of points in each leaf node.
+   * @param minimumGainSplit Minimum gain for the node to split.
+   * @param dimensionSelector Instantiated dimension selection policy.
+   * @param bestGain Gain of the node; set to the gain of the best split.
+   * @return The best dimension, or the number of dimensions if no dimension
+   *      gives a better split.
+   */
+  template<bool UseWeights, typename MatType>
+  size_t BestDimensionParallel(const MatType& data,
+                               const size_t begin,
+                               const size_t count,
+                               const data::DatasetInfo* datasetInfo,
+                               const arma::Row<size_t>& labels,
+                               const size_t numClasses,
+                               const arma::rowvec& weights,
+                               const size_t minimumLeafSize,
+                               const double minimumGainSplit,
+                               DimensionSelectionType& dimensionSelector,
+                               double& bestGain);
+
   /**
    * Corresponding to the public Train() method, this method is designed for
    * avoiding unnecessary copies during training.  This function is called to
@@ -530,6 +643,11 @@ class DecisionTree :
    * @param minimumLeafSize Minimum number of points in each leaf node.
    * @param minimumGainSplit Minimum gain for the node to split.
    * @param maximumDepth Maximum depth for the tree.
+   * @param dimensionSelector Instantiated dimension selection policy.
+   * @param deferred If not NULL, the node is trained by TrainParallel(), and
+   *      subtrees with at most deferCount points are added to this list
+   *      instead of being trained.
+   * @param deferCount Maximum number of points in a deferred subtree.
    * @return The final entropy of decision tree.
    */
   template<bool UseWeights, typename MatType>
@@ -543,7 +661,9 @@ class DecisionTree :
                const size_t minimumLeafSize,
                const double minimumGainSplit,
                const size_t maximumDepth,
-               DimensionSelectionType& dimensionSelector);
+               DimensionSelectionType& dimensionSelector,
+               std::vector<DeferredSubtree>* deferred = NULL,
+               const size_t deferCount = 0);
 
   /**
    * Corresponding to the public Train() method, this method is designed for
@@ -559,6 +679,11 @@ class DecisionTree :
    * @param minimumLeafSize Minimum number of points in each leaf node.
    * @param minimumGainSplit Minimum gain for the node to split.
    * @param maximumDepth Maximum depth for the tree.
+   * @param dimensionSelector Instantiated dimension selection policy.
+   * @param deferred If not NULL, the node is trained by TrainParallel(), and
+   *      subtrees with at most deferCount points are added to this list
+   *      instead of being trained.
+   * @param deferCount Maximum number of points in a deferred subtree.
    * @return The final entropy of decision tree.
    */
   template<bool UseWeights, typename MatType>
@@ -571,7 +696,9 @@ class DecisionTree :
                const size_t minimumLeafSize,
                const double minimumGainSplit,
                const size_t maximumDepth,
-               DimensionSelectionType& dimensionSelector);
+               DimensionSelectionType& dimensionSelector,
+               std::vector<DeferredSubtree>* deferred = NULL,
+               const size_t deferCount = 0);
 };
 
 /**
@@ -466,7 +466,8 @@ double DecisionTree<FitnessFunction,
     const size_t minimumLeafSize,
     const double minimumGainSplit,
     const size_t maximumDepth,
-    DimensionSelectionType dimensionSelector)
+    DimensionSelectionType dimensionSelector,
+    const bool parallel)
 {
   // Sanity check on data.
   if (data.n_cols != labels.n_elem)
@@ -490,6 +491,13 @@ double DecisionTree<FitnessFunction,
 
   // Pass off work to the Train() method.
   arma::rowvec weights; // Fake weights, not used.
+  if (parallel)
+  {
+    return TrainParallel<false>(tmpData, &datasetInfo, tmpLabels, numClasses,
+        weights, minimumLeafSize, minimumGainSplit, maximumDepth,
+        dimensionSelector);
+  }
+
   return Train<false>(tmpData, 0, tmpData.n_cols, datasetInfo, tmpLabels,
       numClasses, weights, minimumLeafSize, minimumGainSplit, maximumDepth,
       dimensionSelector);
@@ -515,7 +523,8 @@ double DecisionTree<FitnessFunction,
     const size_t minimumLeafSize,
     const double minimumGainSplit,
     const size_t maximumDepth,
-    DimensionSelectionType dimensionSelector)
+    DimensionSelectionType dimensionSelector,
+    const bool parallel)
 {
   // Sanity check on data.
   if (data.n_cols != labels.n_elem)
@@ -539,6 +548,12 @@ double DecisionTree<FitnessFunction,
 
   // Pass off work to the Train() method.
   arma::rowvec weights; // Fake weights, not used.
+  if (parallel)
+  {
+    return TrainParallel<false>(tmpData, NULL, tmpLabels, numClasses, weights,
+        minimumLeafSize, minimumGainSplit, maximumDepth, dimensionSelector);
+  }
+
   return Train<false>(tmpData, 0, tmpData.n_cols, tmpLabels, numClasses,
       weights, minimumLeafSize, minimumGainSplit, maximumDepth,
       dimensionSelector);
@@ -567,6 +582,7 @@ double DecisionTree<FitnessFunction,
     const double minimumGainSplit,
     const size_t maximumDepth,
     DimensionSelectionType dimensionSelector,
+    const bool parallel,
     const std::enable_if_t<
         arma::is_arma_type<
         typename std::remove_reference<
@@ -595,6 +611,13 @@ double DecisionTree<FitnessFunction,
   dimensionSelector.Dimensions() = tmpData.n_rows;
 
   // Pass off work to the Train() method.
+  if (parallel)
+  {
+    return TrainParallel<true>(tmpData, &datasetInfo, tmpLabels, numClasses,
+        tmpWeights, minimumLeafSize, minimumGainSplit, maximumDepth,
+        dimensionSelector);
+  }
+
   return Train<true>(tmpData, 0, tmpData.n_cols, datasetInfo, tmpLabels,
       numClasses, tmpWeights, minimumLeafSize, minimumGainSplit, maximumDepth,
       dimensionSelector);
@@ -622,6 +645,7 @@ double DecisionTree<FitnessFunction,
     const double minimumGainSplit,
     const size_t maximumDepth,
     DimensionSelectionType dimensionSelector,
+    const bool parallel,
     const std::enable_if_t<
         arma::is_arma_type<
         typename std::remove_reference<
@@ -650,11 +674,199 @@ double DecisionTree<FitnessFunction,
   dimensionSelector.Dimensions() = tmpData.n_rows;
 
   // Pass off work to the Train() method.
+  if (parallel)
+  {
+    return TrainParallel<true>(tmpData, NULL, tmpLabels, numClasses,
+        tmpWeights, minimumLeafSize, minimumGainSplit, maximumDepth,
+        dimensionSelector);
+  }
+
   return Train<true>(tmpData, 0, tmpData.n_cols, tmpLabels, numClasses,
       tmpWeights, minimumLeafSize, minimumGainSplit, maximumDepth,
       dimensionSelector);
 }
 
+//! Train on the given data using all OpenMP threads.
+template<typename FitnessFunction,
+         template<typename> class NumericSplitType,
+         template<typename> class CategoricalSplitType,
+         typename DimensionSelectionType,
+         typename ElemType,
+         bool NoRecursion>
+template<bool UseWeights, typename MatType>
+double DecisionTree<FitnessFunction,
+                    NumericSplitType,
+                    CategoricalSplitType,
+                    DimensionSelectionType,
+                    ElemType,
+                    NoRecursion>::TrainParallel(
+    MatType& data,
+    const data::DatasetInfo* datasetInfo,
+    arma::Row<size_t>& labels,
+    const size_t numClasses,
+    arma::rowvec& weights,
+    const size_t minimumLeafSize,
+    const double minimumGainSplit,
+    const size_t maximumDepth,
+    DimensionSelectionType& dimensionSelector)
+{
+  size_t numThreads = 1;
+  #ifdef HAS_OPENMP
+    numThreads = omp_get_max_threads();
+  #endif
+
+  // Build the top levels of the tree, deferring every subtree that holds at
+  // most a quarter of the points per thread, so that there are enough deferred
+  // subtrees to keep all threads busy.
+  std::vector<DeferredSubtree> deferred;
+  const size_t deferCount = data.n_cols / (4 * numThreads);
+  double gain;
+  if (datasetInfo != NULL)
+  {
+    gain = Train<UseWeights>(data, 0, data.n_cols, *datasetInfo, labels,
+        numClasses, weights, minimumLeafSize, minimumGainSplit, maximumDepth,
+        dimensionSelector, &deferred, deferCount);
+  }
+  else
+  {
+    gain = Train<UseWeights>(data, 0, data.n_cols, labels, numClasses,
+        weights, minimumLeafSize, minimumGainSplit, maximumDepth,
+        dimensionSelector, &deferred, deferCount);
+  }
+
+  // Now build the deferred subtrees.  They hold disjoint sets of points, so
+  // they can reorder their part of the dataset independently.  The entropy of
+  // each subtree is weighted by its fraction of all points (the weights of its
+  // ancestors multiply to this).
+  double deferredGain = 0.0;
+  #pragma omp parallel for schedule(dynamic) reduction(+:deferredGain) \
+      if (!omp_in_parallel())
+  for (omp_size_t i = 0; i < (omp_size_t) deferred.size(); ++i)
+  {
+    const DeferredSubtree& subtree = deferred[i];
+    DimensionSelectionType subtreeDimensionSelector(dimensionSelector);
+
+    double subtreeGain;
+    if (datasetInfo != NULL)
+    {
+      subtreeGain = subtree.node->template Train<UseWeights>(data,
+          subtree.begin, subtree.count, *datasetInfo, labels, numClasses,
+          weights, minimumLeafSize, minimumGainSplit, subtree.maximumDepth,
+          subtreeDimensionSelector);
+    }
+    else
+    {
+      subtreeGain = subtree.node->template Train<UseWeights>(data,
+          subtree.begin, subtree.count, labels, numClasses, weights,
+          minimumLeafSize, minimumGainSplit, subtree.maximumDepth,
+          subtreeDimensionSelector);
+    }
+
+    deferredGain += double(subtree.count) / double(data.n_cols) * subtreeGain;
+  }
+
+  return gain + deferredGain;
+}
+
+//! Find the best split of a node, evaluating all dimensions in parallel.
+template<typename FitnessFunction,
+         template<typename> class NumericSplitType,
+         template<typename> class CategoricalSplitType,
+         typename DimensionSelectionType,
+         typename ElemType,
+         bool NoRecursion>
+template<bool UseWeights, typename MatType>
+size_t DecisionTree<FitnessFunction,
+                    NumericSplitType,
+                    CategoricalSplitType,
+                    DimensionSelectionType,
+                    ElemType,
+                    NoRecursion>::BestDimensionParallel(
+    const MatType& data,
+    const size_t begin,
+    const size_t count,
+    const data::DatasetInfo* datasetInfo,
+    const arma::Row<size_t>& labels,
+    const size_t numClasses,
+    const arma::rowvec& weights,
+    const size_t minimumLeafSize,
+    const double minimumGainSplit,
+    DimensionSelectionType& dimensionSelector,
+    double& bestGain)
+{
+  const size_t noSplit = (datasetInfo != NULL) ?
+      datasetInfo->Dimensionality() : (size_t) data.n_rows;
+
+  // The dimension selector is not thread-safe, so collect the dimensions
+  // first.
+  std::vector<size_t> dimensions;
+  for (size_t i = dimensionSelector.Begin(); i != dimensionSelector.End();
+       i = dimensionSelector.Next())
+    dimensions.push_back(i);
+
+  // Every dimension is compared against the gain of the node, and stores its
+  // split in its own objects.
+  const double nodeGain = bestGain;
+  std::vector<double> gains(dimensions.size(), DBL_MAX);
+  std::vector<arma::vec> splitInfo(dimensions.size());
+  std::vector<NumericAuxiliarySplitInfo> numericAux(dimensions.size());
+  std::vector<CategoricalAuxiliarySplitInfo> categoricalAux(dimensions.size());
+
+  #pragma omp parallel for schedule(dynamic) if (!omp_in_parallel())
+  for (omp_size_t d = 0; d < (omp_size_t) dimensions.size(); ++d)
+  {
+    const size_t i = dimensions[d];
+    if (datasetInfo != NULL &&
+        datasetInfo->Type(i) == data::Datatype::categorical)
+    {
+      gains[d] = CategoricalSplit::template SplitIfBetter<UseWeights>(nodeGain,
+          data.cols(begin, begin + count - 1).row(i),
+          datasetInfo->NumMappings(i),
+          labels.subvec(begin, begin + count - 1),
+          numClasses,
+          UseWeights ? weights.subvec(begin, begin + count - 1) : weights,
+          minimumLeafSize,
+          minimumGainSplit,
+          splitInfo[d],
+          categoricalAux[d]);
+    }
+    else
+    {
+      gains[d] = NumericSplit::template SplitIfBetter<UseWeights>(nodeGain,
+          data.cols(begin, begin + count - 1).row(i),
+          labels.subvec(begin, begin + count - 1),
+          numClasses,
+          UseWeights ? weights.subvec(begin, begin + count - 1) : weights,
+          minimumLeafSize,
+          minimumGainSplit,
+          splitInfo[d],
+          numericAux[d]);
+    }
+  }
+
+  // Take the best dimension.  Ties go to the first dimension, so the result
+  // does not depend on the number of threads.
+  size_t best = dimensions.size();
+  for (size_t d = 0; d < dimensions.size(); ++d)
+  {
+    // If the splitter reported that it did not split, skip the dimension.
+    if (gains[d] == DBL_MAX)
+      continue;
+
+    if (best == dimensions.size() || gains[d] > gains[best])
+      best = d;
+  }
+
+  if (best == dimensions.size())
+    return noSplit;
+
+  bestGain = gains[best];
+  classProbabilities = std::move(splitInfo[best]);
+  NumericAuxiliarySplitInfo::operator=(numericAux[best]);
+  CategoricalAuxiliarySplitInfo::operator=(categoricalAux[best]);
+  return dimensions[best];
+}
+
 //! Train on the given data, assuming all dimensions are numeric.
 template<typename FitnessFunction,
          template<typename> class NumericSplitType,
@@ -679,7 +891,9 @@ double DecisionTree<FitnessFunction,
     const size_t minimumLeafSize,
     const double minimumGainSplit,
     const size_t maximumDepth,
-    DimensionSelectionType& dimensionSelector)
+    DimensionSelectionType& dimensionSelector,
+    std::vector<DeferredSubtree>* deferred,
+    const size_t deferCount)
 {
   // Clear children if needed.
   for (size_t i = 0; i < children.size(); ++i)
@@ -698,7 +912,13 @@ double DecisionTree<FitnessFunction,
   size_t bestDim = datasetInfo.Dimensionality(); // This means "no split".
   const size_t end = dimensionSelector.End();
 
-  if (maximumDepth != 1)
+  if (maximumDepth != 1 && deferred != NULL)
+  {
+    bestDim = BestDimensionParallel<UseWeights>(data, begin, count,
+        &datasetInfo, labels, numClasses, weights, minimumLeafSize,
+        minimumGainSplit, dimensionSelector, bestGain);
+  }
+  else if (maximumDepth != 1)
   {
     for (size_t i = dimensionSelector.Begin(); i != end;
          i = dimensionSelector.Next())
@@ -813,13 +1033,22 @@ double DecisionTree<FitnessFunction,
             weights, currentCol - currentChildBegin, minimumGainSplit,
             maximumDepth - 1, dimensionSelector);
       }
+      else if (deferred != NULL &&
+               currentCol - currentChildBegin <= deferCount)
+      {
+        // The subtree is small; it will be trained later, in parallel with
+        // the other deferred subtrees.
+        const DeferredSubtree subtree = { child, currentChildBegin,
+            currentCol - currentChildBegin, maximumDepth - 1 };
+        deferred->push_back(subtree);
+      }
       else
       {
         // During recursion entropy of child node may change.
         double childGain = child->Train<UseWeights>(data, currentChildBegin,
             currentCol - currentChildBegin, datasetInfo, labels, numClasses,
             weights, minimumLeafSize, minimumGainSplit, maximumDepth - 1,
-            dimensionSelector);
+            dimensionSelector, deferred, deferCount);
         bestGain += double(childCounts[i]) / double(count) * (-childGain);
       }
       children.push_back(child);
@@ -864,7 +1093,9 @@ double DecisionTree<FitnessFunction,
     const size_t minimumLeafSize,
     const double minimumGainSplit,
     const size_t maximumDepth,
-    DimensionSelectionType& dimensionSelector)
+    DimensionSelectionType& dimensionSelector,
+    std::vector<DeferredSubtree>* deferred,
+    const size_t deferCount)
 {
   // Clear children if needed.
   for (size_t i = 0; i < children.size(); ++i)
@@ -885,7 +1116,13 @@ double DecisionTree<FitnessFunction,
       UseWeights ? weights.subvec(begin, begin + count - 1) : weights);
   size_t bestDim = data.n_rows; // This means "no split".
 
-  if (maximumDepth != 1)
+  if (maximumDepth != 1 && deferred != NULL)
+  {
+    bestDim = BestDimensionParallel<UseWeights>(data, begin, count, NULL,
+        labels, numClasses, weights, minimumLeafSize, minimumGainSplit,
+        dimensionSelector, bestGain);
+  }
+  else if (maximumDepth != 1)
   {
     for (size_t i = dimensionSelector.Begin(); i != dimensionSelector.End();
          i = dimensionSelector.Next())
@@ -972,13 +1209,22 @@ double DecisionTree<FitnessFunction,
             currentCol - currentChildBegin, minimumGainSplit, maximumDepth - 1,
             dimensionSelector);
       }
+      else if (deferred != NULL &&
+               currentCol - currentChildBegin <= deferCount)
+      {
+        // The subtree is small; it will be trained later, in parallel with
+        // the other deferred subtrees.
+        const DeferredSubtree subtree = { child, currentChildBegin,
+            currentCol - currentChildBegin, maximumDepth - 1 };
+        deferred->push_back(subtree);
+      }
       else
       {
         // During recursion entropy of child node may change.
         double childGain = child->Train<UseWeights>(data, currentChildBegin,
             currentCol - currentChildBegin, labels, numClasses, weights,
             minimumLeafSize, minimumGainSplit, maximumDepth - 1,
-            dimensionSelector);
+            dimensionSelector, deferred, deferCount);
         bestGain += double(childCounts[i]) / double(count) * (-childGain);
       }
       children.push_back(child);
@@ -0,0 +1,236 @@
+/**
+ * @file histogram_numeric_split_impl.hpp
+ *
+ * Implementation of strategy that finds the best binary numeric split between
+ * the bins of a histogram.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_DECISION_TREE_HISTOGRAM_NUMERIC_SPLIT_IMPL_HPP
+#define MLPACK_METHODS_DECISION_TREE_HISTOGRAM_NUMERIC_SPLIT_IMPL_HPP
+
+// In case it hasn't been included yet.
+#include "histogram_numeric_split.hpp"
+
+namespace mlpack {
+namespace tree {
+
+template<typename FitnessFunction>
+template<bool UseWeights, typename VecType, typename WeightVecType>
+double HistogramNumericSplit<FitnessFunction>::SplitIfBetter(
+    const double bestGain,
+    const VecType& data,
+    const arma::Row<size_t>& labels,
+    const size_t numClasses,
+    const WeightVecType& weights,
+    const size_t minimumLeafSize,
+    const double minimumGainSplit,
+    arma::Col<typename VecType::elem_type>& classProbabilities,
+    AuxiliarySplitInfo<typename VecType::elem_type>& /* aux */)
+{
+  typedef typename VecType::elem_type ElemType;
+
+  // First sanity check: if we don't have enough points, we can't split.
+  const size_t n = data.n_elem;
+  if (n < (minimumLeafSize * 2))
+    return DBL_MAX;
+  if (bestGain == 0.0)
+    return DBL_MAX; // It can't be outperformed.
+
+  // Sanity check: if all the values are the same, we can't split in this
+  // dimension.
+  const ElemType minValue = data.min();
+  const ElemType maxValue = data.max();
+  if (minValue == maxValue)
+    return DBL_MAX;
+
+  // Take an evenly spaced sample of the values, and use its distinct values
+  // (except the maximum, which would leave the right child empty) as the upper
+  // bounds of the bins.  If there are too many, use quantiles of them.
+  const size_t step = (n + SampleSize - 1) / SampleSize;
+  std::vector<ElemType> sample;
+  sample.reserve((n + step - 1) / step);
+  for (size_t i = 0; i < n; i += step)
+  {
+    if (data[i] < maxValue)
+      sample.push_back(data[i]);
+  }
+  std::sort(sample.begin(), sample.end());
+  sample.erase(std::unique(sample.begin(), sample.end()), sample.end());
+  if (sample.empty())
+    sample.push_back(minValue);
+
+  std::vector<ElemType> thresholds;
+  if (sample.size() < MaxBins)
+  {
+    thresholds.swap(sample);
+  }
+  else
+  {
+    thresholds.resize(MaxBins - 1);
+    for (size_t b = 0; b < MaxBins - 1; ++b)
+      thresholds[b] = sample[b * sample.size() / (MaxBins - 1)];
+  }
+  const size_t numBins = thresholds.size() + 1;
+
+  // Accumulate the class counts (or weights) of each bin.  A point goes to the
+  // first bin whose upper bound is at least the value of the point, so
+  // splitting after bin b sends exactly the points with value at most
+  // thresholds[b] to the left.
+  arma::Mat<size_t> binClassCounts;
+  arma::mat binClassWeights;
+  arma::Col<size_t> binCounts(numBins, arma::fill::zeros);
+  arma::vec binWeights;
+  if (UseWeights)
+  {
+    binClassWeights.zeros(numClasses, numBins);
+    binWeights.zeros(numBins);
+  }
+  else
+  {
+    binClassCounts.zeros(numClasses, numBins);
+  }
+
+  for (size_t i = 0; i < n; ++i)
+  {
+    const size_t bin = std::lower_bound(thresholds.begin(), thresholds.end(),
+        data[i]) - thresholds.begin();
+    ++binCounts[bin];
+    if (UseWeights)
+    {
+      binClassWeights(labels[i], bin) += weights[i];
+      binWeights[bin] += weights[i];
+    }
+    else
+    {
+      ++binClassCounts(labels[i], bin);
+    }
+  }
+
+  // Loop through all bin boundaries, choosing the best one.  Also, force a
+  // minimum leaf size of 1 (empty children don't make sense).
+  double bestFoundGain = std::min(bestGain + minimumGainSplit, 0.0);
+  bool improved = false;
+  const size_t minimum = std::max(minimumLeafSize, (size_t) 1);
+
+  // The class counts (or weights) of the left and right child.
+  arma::Mat<size_t> classCounts;
+  arma::mat classWeightSums;
+  double totalWeight = 0.0;
+  double totalLeftWeight = 0.0;
+  double totalRightWeight = 0.0;
+  if (UseWeights)
+  {
+    classWeightSums.zeros(numClasses, 2);
+    classWeightSums.col(1) = arma::sum(binClassWeights, 1);
+    totalWeight = arma::accu(binWeights);
+    totalRightWeight = totalWeight;
+    bestFoundGain *= totalWeight;
+  }
+  else
+  {
+    classCounts.zeros(numClasses, 2);
+    classCounts.col(1) = arma::sum(binClassCounts, 1);
+    bestFoundGain *= n;
+  }
+
+  size_t leftCount = 0;
+  for (size_t b = 0; b < numBins - 1; ++b)
+  {
+    // Move the bin to the left child.
+    if (UseWeights)
+    {
+      classWeightSums.col(0) += binClassWeights.col(b);
+      classWeightSums.col(1) -= binClassWeights.col(b);
+      totalLeftWeight += binWeights[b];
+      totalRightWeight -= binWeights[b];
+    }
+    else
+    {
+      classCounts.col(0) += binClassCounts.col(b);
+      classCounts.col(1) -= binClassCounts.col(b);
+    }
+    leftCount += binCounts[b];
+
+    // An empty bin gives the same split as the bin before it.
+    if (binCounts[b] == 0 || leftCount < minimum)
+      continue;
+    if (n - leftCount < minimum)
+      break;
+
+    // Calculate the gain for the left and right child.  Only use weights if
+    // needed.
+    const double leftGain = UseWeights ?
+        FitnessFunction::template EvaluatePtr<true>(classWeightSums.colptr(0),
+            numClasses, totalLeftWeight) :
+        FitnessFunction::template EvaluatePtr<false>(classCounts.colptr(0),
+            numClasses, leftCount);
+    const double rightGain = UseWeights ?
+        FitnessFunction::template EvaluatePtr<true>(classWeightSums.colptr(1),
+            numClasses, totalRightWeight) :
+        FitnessFunction::template EvaluatePtr<false>(classCounts.colptr(1),
+            numClasses, size_t(n - leftCount));
+
+    double gain;
+    if (UseWeights)
+    {
+      gain = totalLeftWeight * leftGain + totalRightWeight * rightGain;
+    }
+    else
+    {
+      // Calculate the gain at this split point.
+      gain = double(leftCount) * leftGain + double(n - leftCount) * rightGain;
+    }
+
+    // Corner case: is this the best possible split?
+    if (gain >= 0.0)
+    {
+      // We can take a shortcut: no split will be better than this, so just take
+      // this one.
+      classProbabilities.set_size(1);
+      classProbabilities[0] = thresholds[b];
+      return gain;
+    }
+    else if (gain > bestFoundGain)
+    {
+      // We still have a better split.
+      bestFoundGain = gain;
+      classProbabilities.set_size(1);
+      classProbabilities[0] = thresholds[b];
+      improved = true;
+    }
+  }
+
+  // If we didn't improve, return the original gain exactly as we got it
+  // (without introducing floating point errors).
+  if (!improved)
+    return DBL_MAX;
+
+  if (UseWeights)
+    bestFoundGain /= totalWeight;
+  else
+    bestFoundGain /= n;
+
+  return bestFoundGain;
+}
+
+template<typename FitnessFunction>
+template<typename ElemType>
+size_t HistogramNumericSplit<FitnessFunction>::CalculateDirection(
+    const ElemType& point,
+    const arma::Col<ElemType>& classProbabilities,
+    const AuxiliarySplitInfo<ElemType>& /* aux */)
+{
+  if (point <= classProbabilities[0])
+    return 0; // Go left.
+  else
+    return 1; // Go right.
+}
+
+} // namespace tree
+} // namespace mlpack
+
+#endif
@@ -0,0 +1,99 @@
+/**
+ * @file concurrent_union_find.hpp
+ *
+ * Implements a union-find data structure that can be used by several threads
+ * at once.  The parent pointers are atomic and are only modified with
+ * compare-and-swap operations, so no locks are needed.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_EMST_CONCURRENT_UNION_FIND_HPP
+#define MLPACK_METHODS_EMST_CONCURRENT_UNION_FIND_HPP
+
+#include <mlpack/prereqs.hpp>
+
+#include <atomic>
+
+namespace mlpack {
+namespace emst {
+
+/**
+ * A lock-free Union-Find data structure.  Like UnionFind, each point is
+ * initially in its own component; Union(x, y) unites the components containing
+ * x and y, and Find(x) returns the index of the component containing x.  Both
+ * can be called concurrently by any number of threads.
+ *
+ * A root is always linked below the root with the smaller index, so the parent
+ * of every point has a smaller index than the point itself and concurrent
+ * unions can never create a cycle.  Find() halves the paths it walks through.
+ */
+class ConcurrentUnionFind
+{
+ private:
+  std::vector<std::atomic<size_t>> parent;
+
+ public:
+  //! Construct the object with the given size.
+  ConcurrentUnionFind(const size_t size) : parent(size)
+  {
+    for (size_t i = 0; i < size; ++i)
+      parent[i].store(i);
+  }
+
+  /**
+   * Returns the component containing an element.
+   *
+   * @param x the component to be found
+   * @return The index of the component containing x
+   */
+  size_t Find(size_t x)
+  {
+    while (true)
+    {
+      size_t xParent = parent[x].load();
+      const size_t xGrandparent = parent[xParent].load();
+      if (xParent == xGrandparent)
+        return xParent;
+
+      // Point x to its grandparent.  If another thread changed the parent of x
+      // in the meantime, x already points higher up and nothing is lost.
+      parent[x].compare_exchange_weak(xParent, xGrandparent);
+      x = xGrandparent;
+    }
+  }
+
+  /**
+   * Union the components containing x and y.
+   *
+   * @param x one component
+   * @param y the other component
+   * @return true if the components were merged by this call, and false if x
+   *     and y were already in the same component.
+   */
+  bool Union(const size_t x, const size_t y)
+  {
+    while (true)
+    {
+      size_t xRoot = Find(x);
+      size_t yRoot = Find(y);
+
+      if (xRoot == yRoot)
+        return false;
+      if (xRoot < yRoot)
+        std::swap(xRoot, yRoot);
+
+      // This fails if xRoot is not a root anymore, in which case we try again.
+      size_t expected = xRoot;
+      if (parent[xRoot].compare_exchange_strong(expected, yRoot))
+        return true;
+    }
+  }
+}; // class ConcurrentUnionFind
+
+} // namespace emst
+} // namespace mlpack
+
+#endif // MLPACK_METHODS_EMST_CONCURRENT_UNION_FIND_HPP
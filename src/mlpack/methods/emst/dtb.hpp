@@ -27,6 +27,7 @@
 
 #include "dtb_stat.hpp"
 #include "edge_pair.hpp"
+#include "concurrent_union_find.hpp"
 
 #include <mlpack/prereqs.hpp>
 #include <mlpack/core/metrics/lmetric.hpp>
@@ -172,9 +173,16 @@ class DualTreeBoruvka
    * index of the edge; the second row will contain the greater index of the
    * edge; and the third row will contain the distance between the two edges.
    *
+   * In parallel mode, the query subtrees (or the query points, in naive mode)
+   * are searched by several threads during each iteration, and the components
+   * are merged with a lock-free union-find.  When several edges of the same
+   * length are candidates, the edges chosen may differ from the serial mode,
+   * but the total length of the tree is the same.
+   *
    * @param results Matrix which results will be stored in.
+   * @param parallel Whether to run the iterations with multiple threads.
    */
-  void ComputeMST(arma::mat& results);
+  void ComputeMST(arma::mat& results, const bool parallel = false);
 
  private:
   /**
@@ -187,6 +195,19 @@ class DualTreeBoruvka
    */
   void AddAllEdges();
 
+  /**
+   * Run the Boruvka iterations with multiple threads.
+   */
+  void ParallelIterations();
+
+  /**
+   * Add the candidate edge of each component found in one parallel iteration,
+   * merging the components with the given union-find.  Each thread collects
+   * its edges in its own buffer.
+   */
+  void AddAllEdges(ConcurrentUnionFind& parallelConnections,
+                   const arma::Col<size_t>& components);
+
   /**
    * Unpermute the edge list and output it to results.
    */
@@ -196,12 +217,14 @@ class DualTreeBoruvka
    * This function resets the values in the nodes of the tree nearest neighbor
    * distance, and checks for fully connected nodes.
    */
-  void CleanupHelper(Tree* tree);
+  template<typename UnionFindType>
+  void CleanupHelper(Tree* tree, UnionFindType& unionFind);
 
   /**
    * The values stored in the tree must be reset on each iteration.
    */
-  void Cleanup();
+  template<typename UnionFindType>
+  void Cleanup(UnionFindType& unionFind);
 }; // class DualTreeBoruvka
 
 } // namespace emst
@@ -13,6 +13,9 @@
 #define MLPACK_METHODS_EMST_DTB_IMPL_HPP
 
 #include "dtb_rules.hpp"
+#include "parallel_dtb_rules.hpp"
+
+#include <mlpack/core/tree/query_subtrees.hpp>
 
 namespace mlpack {
 namespace emst {
@@ -117,48 +120,165 @@ template<
              typename TreeStatType,
              typename TreeMatType> class TreeType>
 void DualTreeBoruvka<MetricType, MatType, TreeType>::ComputeMST(
-    arma::mat& results)
+    arma::mat& results,
+    const bool parallel)
 {
   Timer::Start("emst/mst_computation");
 
   totalDist = 0; // Reset distance.
 
-  typedef DTBRules<MetricType, Tree> RuleType;
-  RuleType rules(data, connections, neighborsDistances, neighborsInComponent,
-                 neighborsOutComponent, metric);
+  if (parallel)
+  {
+    ParallelIterations();
+  }
+  else
+  {
+    typedef DTBRules<MetricType, Tree> RuleType;
+    RuleType rules(data, connections, neighborsDistances, neighborsInComponent,
+                   neighborsOutComponent, metric);
+    while (edges.size() < (data.n_cols - 1))
+    {
+      if (naive)
+      {
+        // Full O(N^2) traversal.
+        for (size_t i = 0; i < data.n_cols; ++i)
+          for (size_t j = 0; j < data.n_cols; ++j)
+            rules.BaseCase(i, j);
+      }
+      else
+      {
+        typename Tree::template DualTreeTraverser<RuleType> traverser(rules);
+        traverser.Traverse(*tree, *tree);
+      }
+
+      AddAllEdges();
+
+      Cleanup(connections);
+
+      Log::Info << edges.size() << " edges found so far." << std::endl;
+      if (!naive)
+      {
+        Log::Info << rules.BaseCases() << " cumulative base cases."
+            << std::endl;
+        Log::Info << rules.Scores() << " cumulative node combinations scored."
+            << std::endl;
+      }
+    }
+  }
+
+  Timer::Stop("emst/mst_computation");
+
+  EmitResults(results);
+
+  Log::Info << "Total spanning tree length: " << totalDist << std::endl;
+}
+
+/**
+ * Run the Boruvka iterations with multiple threads, until the MST is complete.
+ */
+template<
+    typename MetricType,
+    typename MatType,
+    template<typename TreeMetricType,
+             typename TreeStatType,
+             typename TreeMatType> class TreeType>
+void DualTreeBoruvka<MetricType, MatType, TreeType>::ParallelIterations()
+{
+  size_t numThreads = 1;
+  #ifdef HAS_OPENMP
+    numThreads = omp_get_max_threads();
+  #endif
+
+  // Split the tree into enough query subtrees to balance the work between all
+  // threads.
+  std::vector<Tree*> subtrees;
+  if (!naive)
+    tree::SplitQuerySubtrees(*tree, 8 * numThreads, subtrees);
+
+  // The candidate edge of each point, and the distance to the best candidate
+  // of each component, which the threads use for pruning.
+  ConcurrentUnionFind parallelConnections(data.n_cols);
+  arma::Col<size_t> components(data.n_cols);
+  arma::vec pointDistances(data.n_cols);
+  arma::Col<size_t> pointNeighbors(data.n_cols);
+  std::vector<std::atomic<double>> componentBounds(data.n_cols);
+
+  typedef ParallelDTBRules<MetricType, Tree> RuleType;
+  size_t baseCases = 0;
+  size_t scores = 0;
   while (edges.size() < (data.n_cols - 1))
   {
+    // The components can't change during an iteration, so they are looked up
+    // once for each point.
+    #pragma omp parallel for schedule(static)
+    for (omp_size_t i = 0; i < (omp_size_t) data.n_cols; ++i)
+    {
+      components[i] = parallelConnections.Find(i);
+      pointDistances[i] = DBL_MAX;
+      componentBounds[i].store(DBL_MAX, std::memory_order_relaxed);
+    }
+
+    // Each point is only written by the thread that owns it.  The subtrees
+    // vary a lot in cost, so they are handed out dynamically.
+    size_t iterationBaseCases = 0;
+    size_t iterationScores = 0;
     if (naive)
     {
-      // Full O(N^2) traversal.
-      for (size_t i = 0; i < data.n_cols; ++i)
+      #pragma omp parallel for schedule(dynamic) \
+          reduction(+:iterationBaseCases)
+      for (omp_size_t i = 0; i < (omp_size_t) data.n_cols; ++i)
+      {
+        RuleType rules(data, components, componentBounds, pointDistances,
+            pointNeighbors, metric);
         for (size_t j = 0; j < data.n_cols; ++j)
           rules.BaseCase(i, j);
+
+        iterationBaseCases += rules.BaseCases();
+      }
     }
     else
     {
-      typename Tree::template DualTreeTraverser<RuleType> traverser(rules);
-      traverser.Traverse(*tree, *tree);
+      #pragma omp parallel for schedule(dynamic) \
+          reduction(+:iterationBaseCases, iterationScores)
+      for (omp_size_t i = 0; i < (omp_size_t) subtrees.size(); ++i)
+      {
+        RuleType rules(data, components, componentBounds, pointDistances,
+            pointNeighbors, metric);
+        typename Tree::template DualTreeTraverser<RuleType> traverser(rules);
+        traverser.Traverse(*subtrees[i], *tree);
+
+        iterationBaseCases += rules.BaseCases();
+        iterationScores += rules.Scores();
+      }
+    }
+    baseCases += iterationBaseCases;
+    scores += iterationScores;
+
+    // The candidate of each component is the best candidate of its points;
+    // ties go to the point with the smallest index.
+    for (size_t i = 0; i < data.n_cols; ++i)
+    {
+      const size_t component = components[i];
+      if (pointDistances[i] < neighborsDistances[component])
+      {
+        neighborsDistances[component] = pointDistances[i];
+        neighborsInComponent[component] = i;
+        neighborsOutComponent[component] = pointNeighbors[i];
+      }
     }
 
-    AddAllEdges();
+    AddAllEdges(parallelConnections, components);
 
-    Cleanup();
+    Cleanup(parallelConnections);
 
     Log::Info << edges.size() << " edges found so far." << std::endl;
     if (!naive)
     {
-      Log::Info << rules.BaseCases() << " cumulative base cases." << std::endl;
-      Log::Info << rules.Scores() << " cumulative node combinations scored."
+      Log::Info << baseCases << " cumulative base cases." << std::endl;
+      Log::Info << scores << " cumulative node combinations scored."
           << std::endl;
     }
   }
-
-  Timer::Stop("emst/mst_computation");
-
-  EmitResults(results);
-
-  Log::Info << "Total spanning tree length: " << totalDist << std::endl;
 }
 
 /**
@@ -211,6 +331,52 @@ void DualTreeBoruvka<MetricType, MatType, TreeType>::AddAllEdges()
   }
 }
 
+/**
+ * Adds the candidate edges found in one parallel iteration, with one buffer of
+ * edges for each thread.
+ */
+template<
+    typename MetricType,
+    typename MatType,
+    template<typename TreeMetricType,
+             typename TreeStatType,
+             typename TreeMatType> class TreeType>
+void DualTreeBoruvka<MetricType, MatType, TreeType>::AddAllEdges(
+    ConcurrentUnionFind& parallelConnections,
+    const arma::Col<size_t>& components)
+{
+  #pragma omp parallel
+  {
+    std::vector<EdgePair> threadEdges;
+    double threadDist = 0.0;
+
+    #pragma omp for schedule(static)
+    for (omp_size_t i = 0; i < (omp_size_t) data.n_cols; ++i)
+    {
+      // Only the root of each component holds a candidate edge.
+      if (components[i] != (size_t) i || neighborsDistances[i] == DBL_MAX)
+        continue;
+
+      // When two components chose edges between each other, only the thread
+      // that actually merges them adds its edge, so no cycle is created.
+      const size_t inEdge = neighborsInComponent[i];
+      const size_t outEdge = neighborsOutComponent[i];
+      if (parallelConnections.Union(inEdge, outEdge))
+      {
+        threadDist += neighborsDistances[i];
+        threadEdges.push_back(EdgePair(std::min(inEdge, outEdge),
+            std::max(inEdge, outEdge), neighborsDistances[i]));
+      }
+    }
+
+    #pragma omp critical(DTBAddAllEdges)
+    {
+      edges.insert(edges.end(), threadEdges.begin(), threadEdges.end());
+      totalDist += threadDist;
+    }
+  }
+}
+
 /**
  * Unpermute the edge list (if necessary) and output it to results.
  */
@@ -276,7 +442,10 @@ template<
     template<typename TreeMetricType,
              typename TreeStatType,
              typename TreeMatType> class TreeType>
-void DualTreeBoruvka<MetricType, MatType, TreeType>::CleanupHelper(Tree* tree)
+template<typename UnionFindType>
+void DualTreeBoruvka<MetricType, MatType, TreeType>::CleanupHelper(
+    Tree* tree,
+    UnionFindType& unionFind)
 {
   // Reset the statistic information.
   tree->Stat().MaxNeighborDistance() = DBL_MAX;
@@ -285,13 +454,13 @@ void DualTreeBoruvka<MetricType, MatType, TreeType>::CleanupHelper(Tree* tree)
 
   // Recurse into all children.
   for (size_t i = 0; i < tree->NumChildren(); ++i)
-    CleanupHelper(&tree->Child(i));
+    CleanupHelper(&tree->Child(i), unionFind);
 
   // Get the component of the first child or point.  Then we will check to see
   // if all other components of children and points are the same.
   const int component = (tree->NumChildren() != 0) ?
       tree->Child(0).Stat().ComponentMembership() :
-      connections.Find(tree->Point(0));
+      unionFind.Find(tree->Point(0));
 
   // Check components of children.
   for (size_t i = 0; i < tree->NumChildren(); ++i)
@@ -300,7 +469,7 @@ void DualTreeBoruvka<MetricType, MatType, TreeType>::CleanupHelper(Tree* tree)
 
   // Check components of points.
   for (size_t i = 0; i < tree->NumPoints(); ++i)
-    if (connections.Find(tree->Point(i)) != size_t(component))
+    if (unionFind.Find(tree->Point(i)) != size_t(component))
       return;
 
   // If we made it this far, all components are the same.
@@ -316,13 +485,15 @@ template<
     template<typename TreeMetricType,
              typename TreeStatType,
              typename TreeMatType> class TreeType>
-void DualTreeBoruvka<MetricType, MatType, TreeType>::Cleanup()
+template<typename UnionFindType>
+void DualTreeBoruvka<MetricType, MatType, TreeType>::Cleanup(
+    UnionFindType& unionFind)
 {
   for (size_t i = 0; i < data.n_cols; i++)
     neighborsDistances[i] = DBL_MAX;
 
   if (!naive)
-    CleanupHelper(tree);
+    CleanupHelper(tree, unionFind);
 }
 
 } // namespace emst
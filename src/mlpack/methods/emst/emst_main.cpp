@@ -47,7 +47,11 @@ PROGRAM_INFO("Fast Euclidean Minimum Spanning Tree",
     "and if the " + PRINT_PARAM_STRING("naive") + " option is given, then "
     "brute-force search is used (this is typically much slower in low "
     "dimensions).  The leaf size does not affect the results, but it may have "
-    "some effect on the runtime of the algorithm."
+    "some effect on the runtime of the algorithm.  If the " +
+    PRINT_PARAM_STRING("parallel") + " option is given, each iteration of the "
+    "algorithm is run with multiple threads; when several edges have the same "
+    "length, the edges chosen may then differ, but the total length of the "
+    "tree does not."
     "\n\n"
     "For example, the minimum spanning tree of the input dataset " +
     PRINT_DATASET("data") + " can be calculated with a leaf size of 20 and "
@@ -72,6 +76,7 @@ PROGRAM_INFO("Fast Euclidean Minimum Spanning Tree",
 PARAM_MATRIX_IN_REQ("input", "Input data matrix.", "i");
 PARAM_MATRIX_OUT("output", "Output data.  Stored as an edge list.", "o");
 PARAM_FLAG("naive", "Compute the MST using O(n^2) naive algorithm.", "n");
+PARAM_FLAG("parallel", "Compute the MST using multiple threads.", "P");
 PARAM_INT_IN("leaf_size", "Leaf size in the kd-tree.  One-element leaves give "
     "the empirically best performance, but at the cost of greater memory "
     "requirements.", "l", 1);
@@ -88,6 +93,7 @@ static void mlpackMain()
   RequireAtLeastOnePassed({ "output" }, false, "no output will be saved");
 
   arma::mat dataPoints = std::move(CLI::GetParam<arma::mat>("input"));
+  const bool parallel = CLI::GetParam<bool>("parallel");
 
   // Do naive computation if necessary.
   if (CLI::GetParam<bool>("naive"))
@@ -97,7 +103,7 @@ static void mlpackMain()
     DualTreeBoruvka<> naive(dataPoints, true);
 
     arma::mat naiveResults;
-    naive.ComputeMST(naiveResults);
+    naive.ComputeMST(naiveResults, parallel);
 
     if (CLI::HasParam("output"))
       CLI::GetParam<arma::mat>("output") = std::move(naiveResults);
@@ -126,7 +132,7 @@ static void mlpackMain()
     // Run the DTB algorithm.
     Log::Info << "Calculating minimum spanning tree." << endl;
     arma::mat results;
-    dtb.ComputeMST(results);
+    dtb.ComputeMST(results, parallel);
 
     // Unmap the results.
     arma::mat unmappedResults(results.n_rows, results.n_cols);
@@ -0,0 +1,150 @@
+/**
+ * @file parallel_dtb_rules.hpp
+ *
+ * Tree traverser rules for the parallel mode of the DualTreeBoruvka algorithm,
+ * where several query subtrees are traversed at the same time.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_EMST_PARALLEL_DTB_RULES_HPP
+#define MLPACK_METHODS_EMST_PARALLEL_DTB_RULES_HPP
+
+#include <mlpack/prereqs.hpp>
+
+#include <mlpack/core/tree/traversal_info.hpp>
+
+#include <atomic>
+
+namespace mlpack {
+namespace emst {
+
+/**
+ * The rules for one query subtree in a parallel Boruvka iteration.  Unlike
+ * DTBRules, the candidate edge is stored for each query point, so that a point
+ * is only ever written by the thread traversing the subtree that holds it; the
+ * candidate of each component is the best candidate of its points.  The
+ * distance of the best candidate found so far for each component is shared by
+ * all threads through an atomic value, and is only used for pruning.
+ *
+ * The component of each point is read from an array, because the components
+ * can't change during an iteration.
+ */
+template<typename MetricType, typename TreeType>
+class ParallelDTBRules
+{
+ public:
+  ParallelDTBRules(const arma::mat& dataSet,
+                   const arma::Col<size_t>& components,
+                   std::vector<std::atomic<double>>& componentBounds,
+                   arma::vec& pointDistances,
+                   arma::Col<size_t>& pointNeighbors,
+                   MetricType& metric);
+
+  double BaseCase(const size_t queryIndex, const size_t referenceIndex);
+
+  /**
+   * Get the score for recursion order.  A low score indicates priority for
+   * recursion, while DBL_MAX indicates that the node should not be recursed
+   * into at all (it should be pruned).
+   *
+   * @param queryIndex Index of query point.
+   * @param referenceNode Candidate node to be recursed into.
+   */
+  double Score(const size_t queryIndex, TreeType& referenceNode);
+
+  /**
+   * Re-evaluate the score for recursion order, checking the old score against
+   * the current pruning bound.
+   *
+   * @param queryIndex Index of query point.
+   * @param referenceNode Candidate node to be recursed into.
+   * @param oldScore Old score produced by Score() (or Rescore()).
+   */
+  double Rescore(const size_t queryIndex,
+                 TreeType& referenceNode,
+                 const double oldScore);
+
+  /**
+   * Get the score for recursion order.  A low score indicates priority for
+   * recursion, while DBL_MAX indicates that the node should not be recursed
+   * into at all (it should be pruned).
+   *
+   * @param queryNode Candidate query node to recurse into.
+   * @param referenceNode Candidate reference node to recurse into.
+   */
+  double Score(TreeType& queryNode, TreeType& referenceNode);
+
+  /**
+   * Re-evaluate the score for recursion order, checking the old score against
+   * the current pruning bound.
+   *
+   * @param queryNode Candidate query node to recurse into.
+   * @param referenceNode Candidate reference node to recurse into.
+   * @param oldScore Old score produced by Score() (or Rescore()).
+   */
+  double Rescore(TreeType& queryNode,
+                 TreeType& referenceNode,
+                 const double oldScore) const;
+
+  typedef typename tree::TraversalInfo<TreeType> TraversalInfoType;
+
+  const TraversalInfoType& TraversalInfo() const { return traversalInfo; }
+  TraversalInfoType& TraversalInfo() { return traversalInfo; }
+
+  //! Get the number of base cases performed.
+  size_t BaseCases() const { return baseCases; }
+  //! Modify the number of base cases performed.
+  size_t& BaseCases() { return baseCases; }
+
+  //! Get the number of node combinations that have been scored.
+  size_t Scores() const { return scores; }
+  //! Modify the number of node combinations that have been scored.
+  size_t& Scores() { return scores; }
+
+ private:
+  //! The data points.
+  const arma::mat& dataSet;
+
+  //! The component of each point.
+  const arma::Col<size_t>& components;
+
+  //! The distance to the best candidate found so far for each component.
+  std::vector<std::atomic<double>>& componentBounds;
+
+  //! The distance to the candidate nearest neighbor for each point.
+  arma::vec& pointDistances;
+
+  //! The candidate nearest neighbor (in another component) for each point.
+  arma::Col<size_t>& pointNeighbors;
+
+  //! The instantiated metric.
+  MetricType& metric;
+
+  //! Get the pruning bound of the given component.
+  double ComponentBound(const size_t component) const
+  {
+    return componentBounds[component].load(std::memory_order_relaxed);
+  }
+
+  /**
+   * Update the bound for the given query node.
+   */
+  inline double CalculateBound(TreeType& queryNode) const;
+
+  TraversalInfoType traversalInfo;
+
+  //! The number of base cases calculated.
+  size_t baseCases;
+  //! The number of node combinations that have been scored.
+  size_t scores;
+}; // class ParallelDTBRules
+
+} // namespace emst
+} // namespace mlpack
+
+#include "parallel_dtb_rules_impl.hpp"
+
+#endif
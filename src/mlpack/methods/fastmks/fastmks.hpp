@@ -15,6 +15,7 @@
 
 #include <mlpack/prereqs.hpp>
 #include <mlpack/core/metrics/ip_metric.hpp>
+#include <mlpack/core/kernels/linear_kernel.hpp>
 #include "fastmks_stat.hpp"
 #include <mlpack/core/tree/cover_tree.hpp>
 #include <queue>
@@ -228,6 +229,14 @@ class FastMKS
    * to use single-tree search, either by setting singleMode to false in the
    * constructor or with SingleMode().
    *
+   * When OpenMP is available, naive and dual-tree search process blocks of the
+   * query set in parallel; for dual-tree search, a query tree is built on each
+   * block.  In naive mode with the linear kernel, the kernel values between a
+   * block of queries and a block of reference points are computed with a
+   * single matrix multiplication.  The self-kernels of the reference points
+   * are computed once and reused by all later calls to Search(), so a large
+   * query set can be searched in batches without extra cost.
+   *
    * @param querySet Set of query points (can be a single point).
    * @param k The number of maximum kernels to find.
    * @param indices Matrix to store resulting indices of max-kernel search in.
@@ -285,8 +294,13 @@ class FastMKS
 
   //! Get the inner-product metric induced by the given kernel.
   const metric::IPMetric<KernelType>& Metric() const { return metric; }
-  //! Modify the inner-product metric induced by the given kernel.
-  metric::IPMetric<KernelType>& Metric() { return metric; }
+  //! Modify the inner-product metric induced by the given kernel.  This clears
+  //! the cached self-kernels of the reference points.
+  metric::IPMetric<KernelType>& Metric()
+  {
+    referenceKernels.reset();
+    return metric;
+  }
 
   //! Get whether or not single-tree search is used.
   bool SingleMode() const { return singleMode; }
@@ -321,6 +335,56 @@ class FastMKS
   //! The instantiated inner-product metric induced by the given kernel.
   metric::IPMetric<KernelType> metric;
 
+  //! The square root of the self-kernel of each reference point, cached
+  //! between calls to Search().  It is empty until it is first needed.
+  arma::vec referenceKernels;
+
+  //! Get the cached self-kernels of the reference points, computing them if
+  //! necessary.
+  const arma::vec& ReferenceKernels();
+
+  /**
+   * Run brute-force search for the given query set, in parallel over blocks of
+   * queries.  If sameSet is true, the query set is the reference set, and no
+   * point is returned as its own candidate.
+   */
+  void NaiveSearch(const MatType& querySet,
+                   const size_t k,
+                   arma::Mat<size_t>& indices,
+                   arma::mat& kernels,
+                   const bool sameSet);
+
+  /**
+   * Compute the kernel values between the reference points in the given range
+   * and the query points in the given range, with one matrix multiplication.
+   * This is only available for the linear kernel.  products(i, j) is the kernel
+   * value between reference point (referenceBegin + i) and query point
+   * (queryBegin + j).
+   */
+  template<typename KType = KernelType>
+  void BlockKernels(const MatType& querySet,
+                    const size_t queryBegin,
+                    const size_t queryEnd,
+                    const size_t referenceBegin,
+                    const size_t referenceEnd,
+                    arma::mat& products,
+                    const typename std::enable_if<std::is_same<KType,
+                        kernel::LinearKernel>::value>::type* = 0);
+
+  /**
+   * Compute the kernel values between the reference points in the given range
+   * and the query points in the given range, one pair at a time.
+   */
+  template<typename KType = KernelType>
+  void BlockKernels(const MatType& querySet,
+                    const size_t queryBegin,
+                    const size_t queryEnd,
+                    const size_t referenceBegin,
+                    const size_t referenceEnd,
+                    arma::mat& products,
+                    const typename std::enable_if<!std::is_same<KType,
+                        kernel::LinearKernel>::value>::type* = 0);
+
   //! Candidate represents a possible candidate point (value, index).
   typedef std::pair<double, size_t> Candidate;
 
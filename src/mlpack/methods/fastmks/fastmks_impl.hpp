@@ -180,7 +180,8 @@ FastMKS<KernelType, MatType, TreeType>::FastMKS(const FastMKS& other) :
     setOwner(other.referenceTree == NULL),
     singleMode(other.singleMode),
     naive(other.naive),
-    metric(other.metric)
+    metric(other.metric),
+    referenceKernels(other.referenceKernels)
 {
   // Set reference set correctly.
   if (referenceTree)
@@ -201,7 +202,8 @@ FastMKS<KernelType, MatType, TreeType>::FastMKS(FastMKS&& other) :
     setOwner(other.setOwner),
     singleMode(other.singleMode),
     naive(other.naive),
-    metric(std::move(other.metric))
+    metric(std::move(other.metric)),
+    referenceKernels(std::move(other.referenceKernels))
 {
   // Clear information from the other.
   other.referenceSet = NULL;
@@ -248,6 +250,7 @@ FastMKS<KernelType, MatType, TreeType>::operator=(const FastMKS& other)
 
   singleMode = other.singleMode;
   naive = other.naive;
+  referenceKernels = other.referenceKernels;
 }
 
 template<typename KernelType,
@@ -271,6 +274,9 @@ template<typename KernelType,
                   typename TreeMatType> class TreeType>
 void FastMKS<KernelType, MatType, TreeType>::Train(const MatType& referenceSet)
 {
+  // The cached self-kernels belong to the old reference set.
+  referenceKernels.reset();
+
   if (setOwner)
     delete this->referenceSet;
 
@@ -294,6 +300,9 @@ template<typename KernelType,
 void FastMKS<KernelType, MatType, TreeType>::Train(const MatType& referenceSet,
                                                    KernelType& kernel)
 {
+  // The cached self-kernels belong to the old reference set.
+  referenceKernels.reset();
+
   if (setOwner)
     delete this->referenceSet;
 
@@ -317,6 +326,9 @@ template<typename KernelType,
                   typename TreeMatType> class TreeType>
 void FastMKS<KernelType, MatType, TreeType>::Train(MatType&& referenceSet)
 {
+  // The cached self-kernels belong to the old reference set.
+  referenceKernels.reset();
+
   if (setOwner)
     delete this->referenceSet;
 
@@ -344,6 +356,9 @@ template<typename KernelType,
 void FastMKS<KernelType, MatType, TreeType>::Train(MatType&& referenceSet,
                                                    KernelType& kernel)
 {
+  // The cached self-kernels belong to the old reference set.
+  referenceKernels.reset();
+
   if (setOwner)
     delete this->referenceSet;
 
@@ -375,6 +390,9 @@ void FastMKS<KernelType, MatType, TreeType>::Train(Tree* tree)
     throw std::invalid_argument("cannot call FastMKS::Train() with a tree when "
         "in naive search mode");
 
+  // The cached self-kernels belong to the old reference set.
+  referenceKernels.reset();
+
   if (setOwner)
     delete this->referenceSet;
 
@@ -426,46 +444,22 @@ void FastMKS<KernelType, MatType, TreeType>::Search(
   // Naive implementation.
   if (naive)
   {
-    // Simple double loop.  Stupid, slow, but a good benchmark.
-    for (size_t q = 0; q < querySet.n_cols; ++q)
-    {
-      const Candidate def = std::make_pair(-DBL_MAX, size_t() - 1);
-      std::vector<Candidate> cList(k, def);
-      CandidateList pqueue(CandidateCmp(), std::move(cList));
-
-      for (size_t r = 0; r < referenceSet->n_cols; ++r)
-      {
-        const double eval = metric.Kernel().Evaluate(querySet.col(q),
-                                                     referenceSet->col(r));
-
-        if (eval > pqueue.top().first)
-        {
-          Candidate c = std::make_pair(eval, r);
-          pqueue.pop();
-          pqueue.push(c);
-        }
-      }
-
-      for (size_t j = 1; j <= k; j++)
-      {
-        indices(k - j, q) = pqueue.top().second;
-        kernels(k - j, q) = pqueue.top().first;
-        pqueue.pop();
-      }
-    }
+    NaiveSearch(querySet, k, indices, kernels, false);
 
     Timer::Stop("computing_products");
 
     return;
   }
 
+  typedef FastMKSRules<KernelType, Tree> RuleType;
+
   // Single-tree implementation.
   if (singleMode)
   {
     // Create rules object (this will store the results).  This constructor
-    // precalculates each self-kernel value.
-    typedef FastMKSRules<KernelType, Tree> RuleType;
-    RuleType rules(*referenceSet, querySet, k, metric.Kernel());
+    // precalculates each query self-kernel value.
+    RuleType rules(*referenceSet, querySet, k, metric.Kernel(),
+        ReferenceKernels());
 
     typename Tree::template SingleTreeTraverser<RuleType> traverser(rules);
 
@@ -481,14 +475,65 @@ void FastMKS<KernelType, MatType, TreeType>::Search(
     return;
   }
 
-  // Dual-tree implementation.  First, we need to build the query tree.  We are
-  // assuming it doesn't map anything...
-  Timer::Stop("computing_products");
-  Timer::Start("tree_building");
-  Tree queryTree(querySet);
-  Timer::Stop("tree_building");
+  size_t numThreads = 1;
+  #ifdef HAS_OPENMP
+    numThreads = omp_get_max_threads();
+  #endif
+
+  if (numThreads == 1 || querySet.n_cols < 2 * numThreads)
+  {
+    // Dual-tree implementation.  First, we need to build the query tree.  We
+    // are assuming it doesn't map anything...
+    Timer::Stop("computing_products");
+    Timer::Start("tree_building");
+    Tree queryTree(querySet);
+    Timer::Stop("tree_building");
+
+    Search(&queryTree, k, indices, kernels);
+    return;
+  }
 
-  Search(&queryTree, k, indices, kernels);
+  // Parallel dual-tree implementation.  The query set is split into blocks,
+  // and each block is searched with its own query tree and rules object.  The
+  // traversal only modifies the statistics of the query tree, so the reference
+  // tree can be shared by all threads.  There are more blocks than threads, to
+  // balance the load between them.
+  const arma::vec& selfKernels = ReferenceKernels();
+  const size_t numBlocks = std::min((size_t) querySet.n_cols, 4 * numThreads);
+  size_t baseCases = 0;
+  size_t scores = 0;
+
+  #pragma omp parallel for schedule(dynamic) reduction(+:baseCases, scores)
+  for (omp_size_t b = 0; b < (omp_size_t) numBlocks; ++b)
+  {
+    const size_t begin = b * querySet.n_cols / numBlocks;
+    const size_t end = (b + 1) * querySet.n_cols / numBlocks;
+
+    // The tree holds a reference to the block, so the block must outlive it.
+    const MatType queryBlock = querySet.cols(begin, end - 1);
+    Tree queryTree(queryBlock);
+
+    RuleType rules(*referenceSet, queryTree.Dataset(), k, metric.Kernel(),
+        selfKernels);
+
+    typename Tree::template DualTreeTraverser<RuleType> traverser(rules);
+
+    traverser.Traverse(queryTree, *referenceTree);
+
+    arma::Mat<size_t> blockIndices;
+    arma::mat blockKernels;
+    rules.GetResults(blockIndices, blockKernels);
+    indices.cols(begin, end - 1) = blockIndices;
+    kernels.cols(begin, end - 1) = blockKernels;
+
+    baseCases += rules.BaseCases();
+    scores += rules.Scores();
+  }
+
+  Log::Info << baseCases << " base cases." << std::endl;
+  Log::Info << scores << " scores." << std::endl;
+
+  Timer::Stop("computing_products");
 }
 
 template<typename KernelType,
@@ -531,7 +576,8 @@ void FastMKS<KernelType, MatType, TreeType>::Search(
 
   Timer::Start("computing_products");
   typedef FastMKSRules<KernelType, Tree> RuleType;
-  RuleType rules(*referenceSet, queryTree->Dataset(), k, metric.Kernel());
+  RuleType rules(*referenceSet, queryTree->Dataset(), k, metric.Kernel(),
+      ReferenceKernels());
 
   typename Tree::template DualTreeTraverser<RuleType> traverser(rules);
 
@@ -563,36 +609,7 @@ void FastMKS<KernelType, MatType, TreeType>::Search(
   // Naive implementation.
   if (naive)
   {
-    // Simple double loop.  Stupid, slow, but a good benchmark.
-    for (size_t q = 0; q < referenceSet->n_cols; ++q)
-    {
-      const Candidate def = std::make_pair(-DBL_MAX, size_t() - 1);
-      std::vector<Candidate> cList(k, def);
-      CandidateList pqueue(CandidateCmp(), std::move(cList));
-
-      for (size_t r = 0; r < referenceSet->n_cols; ++r)
-      {
-        if (q == r)
-          continue; // Don't return the point as its own candidate.
-
-        const double eval = metric.Kernel().Evaluate(referenceSet->col(q),
-                                                     referenceSet->col(r));
-
-        if (eval > pqueue.top().first)
-        {
-          Candidate c = std::make_pair(eval, r);
-          pqueue.pop();
-          pqueue.push(c);
-        }
-      }
-
-      for (size_t j = 1; j <= k; j++)
-      {
-        indices(k - j, q) = pqueue.top().second;
-        kernels(k - j, q) = pqueue.top().first;
-        pqueue.pop();
-      }
-    }
+    NaiveSearch(*referenceSet, k, indices, kernels, true);
 
     Timer::Stop("computing_products");
 
@@ -603,9 +620,10 @@ void FastMKS<KernelType, MatType, TreeType>::Search(
   if (singleMode)
   {
     // Create rules object (this will store the results).  This constructor
-    // precalculates each self-kernel value.
+    // precalculates each query self-kernel value.
     typedef FastMKSRules<KernelType, Tree> RuleType;
-    RuleType rules(*referenceSet, *referenceSet, k, metric.Kernel());
+    RuleType rules(*referenceSet, *referenceSet, k, metric.Kernel(),
+        ReferenceKernels());
 
     typename Tree::template SingleTreeTraverser<RuleType> traverser(rules);
 
@@ -632,6 +650,150 @@ void FastMKS<KernelType, MatType, TreeType>::Search(
   Search(referenceTree, k, indices, kernels);
 }
 
+template<typename KernelType,
+         typename MatType,
+         template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType>
+const arma::vec& FastMKS<KernelType, MatType, TreeType>::ReferenceKernels()
+{
+  if (referenceKernels.n_elem != referenceSet->n_cols)
+  {
+    referenceKernels.set_size(referenceSet->n_cols);
+
+    #pragma omp parallel for schedule(static)
+    for (omp_size_t i = 0; i < (omp_size_t) referenceSet->n_cols; ++i)
+    {
+      referenceKernels[i] = sqrt(metric.Kernel().Evaluate(
+          referenceSet->col(i), referenceSet->col(i)));
+    }
+  }
+
+  return referenceKernels;
+}
+
+template<typename KernelType,
+         typename MatType,
+         template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType>
+void FastMKS<KernelType, MatType, TreeType>::NaiveSearch(
+    const MatType& querySet,
+    const size_t k,
+    arma::Mat<size_t>& indices,
+    arma::mat& kernels,
+    const bool sameSet)
+{
+  // Simple double loop, blocked so that a block of reference points is
+  // compared with a block of queries at a time while it is in cache.  The
+  // blocks of queries are independent, so they are searched in parallel.
+  const size_t blockSize = 256;
+  const size_t numQueryBlocks = (querySet.n_cols + blockSize - 1) / blockSize;
+
+  #pragma omp parallel for schedule(dynamic)
+  for (omp_size_t b = 0; b < (omp_size_t) numQueryBlocks; ++b)
+  {
+    const size_t queryBegin = b * blockSize;
+    const size_t queryEnd = std::min(queryBegin + blockSize,
+        (size_t) querySet.n_cols);
+
+    const Candidate def = std::make_pair(-DBL_MAX, size_t() - 1);
+    std::vector<CandidateList> pqueues;
+    pqueues.reserve(queryEnd - queryBegin);
+    for (size_t q = queryBegin; q < queryEnd; ++q)
+      pqueues.emplace_back(CandidateCmp(), std::vector<Candidate>(k, def));
+
+    arma::mat products;
+    for (size_t referenceBegin = 0; referenceBegin < referenceSet->n_cols;
+         referenceBegin += blockSize)
+    {
+      const size_t referenceEnd = std::min(referenceBegin + blockSize,
+          (size_t) referenceSet->n_cols);
+
+      BlockKernels(querySet, queryBegin, queryEnd, referenceBegin,
+          referenceEnd, products);
+
+      for (size_t q = queryBegin; q < queryEnd; ++q)
+      {
+        CandidateList& pqueue = pqueues[q - queryBegin];
+        for (size_t r = referenceBegin; r < referenceEnd; ++r)
+        {
+          if (sameSet && q == r)
+            continue; // Don't return the point as its own candidate.
+
+          const double eval = products(r - referenceBegin, q - queryBegin);
+          if (eval > pqueue.top().first)
+          {
+            Candidate c = std::make_pair(eval, r);
+            pqueue.pop();
+            pqueue.push(c);
+          }
+        }
+      }
+    }
+
+    for (size_t q = queryBegin; q < queryEnd; ++q)
+    {
+      CandidateList& pqueue = pqueues[q - queryBegin];
+      for (size_t j = 1; j <= k; j++)
+      {
+        indices(k - j, q) = pqueue.top().second;
+        kernels(k - j, q) = pqueue.top().first;
+        pqueue.pop();
+      }
+    }
+  }
+}
+
+template<typename KernelType,
+         typename MatType,
+         template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType>
+template<typename KType>
+void FastMKS<KernelType, MatType, TreeType>::BlockKernels(
+    const MatType& querySet,
+    const size_t queryBegin,
+    const size_t queryEnd,
+    const size_t referenceBegin,
+    const size_t referenceEnd,
+    arma::mat& products,
+    const typename std::enable_if<std::is_same<KType,
+        kernel::LinearKernel>::value>::type*)
+{
+  // The linear kernel is the inner product, so all the kernel values of the
+  // two blocks are given by a single matrix multiplication.
+  products = referenceSet->cols(referenceBegin, referenceEnd - 1).t() *
+      querySet.cols(queryBegin, queryEnd - 1);
+}
+
+template<typename KernelType,
+         typename MatType,
+         template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType>
+template<typename KType>
+void FastMKS<KernelType, MatType, TreeType>::BlockKernels(
+    const MatType& querySet,
+    const size_t queryBegin,
+    const size_t queryEnd,
+    const size_t referenceBegin,
+    const size_t referenceEnd,
+    arma::mat& products,
+    const typename std::enable_if<!std::is_same<KType,
+        kernel::LinearKernel>::value>::type*)
+{
+  products.set_size(referenceEnd - referenceBegin, queryEnd - queryBegin);
+  for (size_t q = queryBegin; q < queryEnd; ++q)
+  {
+    for (size_t r = referenceBegin; r < referenceEnd; ++r)
+    {
+      products(r - referenceBegin, q - queryBegin) = metric.Kernel().Evaluate(
+          querySet.col(q), referenceSet->col(r));
+    }
+  }
+}
+
 //! Serialize the model.
 template<typename KernelType,
          typename MatType,
@@ -647,6 +809,9 @@ void FastMKS<KernelType, MatType, TreeType>::serialize(
   ar & BOOST_SERIALIZATION_NVP(naive);
   ar & BOOST_SERIALIZATION_NVP(singleMode);
 
+  if (Archive::is_loading::value)
+    referenceKernels.reset();
+
   // If we are doing naive search, serialize the dataset.  Otherwise we
   // serialize the tree.
   if (naive)
@@ -48,6 +48,29 @@ class FastMKSRules
                const size_t k,
                KernelType& kernel);
 
+  /**
+   * Construct the FastMKSRules object with the precomputed self-kernels of the
+   * reference points, so that they are not computed again for every set of
+   * queries.  The given vector must stay valid while the object is used.
+   *
+   * @param referenceSet Set of reference data.
+   * @param querySet Set of query data.
+   * @param k Number of candidates to search for.
+   * @param kernel Kernel to run FastMKS with.
+   * @param referenceKernels Square root of the self-kernel of each reference
+   *     point.
+   */
+  FastMKSRules(const typename TreeType::Mat& referenceSet,
+               const typename TreeType::Mat& querySet,
+               const size_t k,
+               KernelType& kernel,
+               const arma::vec& referenceKernels);
+
+  //! A copy could refer to the self-kernels held by the original object.
+  FastMKSRules(const FastMKSRules& other) = delete;
+  //! A copy could refer to the self-kernels held by the original object.
+  FastMKSRules& operator=(const FastMKSRules& other) = delete;
+
   /**
    * Store the list of candidates for each query point in the given matrices.
    *
@@ -156,8 +179,10 @@ class FastMKSRules
 
   //! Cached query set self-kernels (|| q || for each q).
   arma::vec queryKernels;
+  //! Reference set self-kernels, if they were computed by this object.
+  arma::vec localReferenceKernels;
   //! Cached reference set self-kernels (|| r || for each r).
-  arma::vec referenceKernels;
+  const arma::vec& referenceKernels;
 
   //! The instantiated kernel.
   KernelType& kernel;
@@ -24,9 +24,27 @@ FastMKSRules<KernelType, TreeType>::FastMKSRules(
     const typename TreeType::Mat& querySet,
     const size_t k,
     KernelType& kernel) :
+    FastMKSRules(referenceSet, querySet, k, kernel, localReferenceKernels)
+{
+  // The other constructor only binds to the reference self-kernels, so we can
+  // compute them now.
+  localReferenceKernels.set_size(referenceSet.n_cols);
+  for (size_t i = 0; i < referenceSet.n_cols; ++i)
+    localReferenceKernels[i] = sqrt(kernel.Evaluate(referenceSet.col(i),
+                                                    referenceSet.col(i)));
+}
+
+template<typename KernelType, typename TreeType>
+FastMKSRules<KernelType, TreeType>::FastMKSRules(
+    const typename TreeType::Mat& referenceSet,
+    const typename TreeType::Mat& querySet,
+    const size_t k,
+    KernelType& kernel,
+    const arma::vec& referenceKernels) :
     referenceSet(referenceSet),
     querySet(querySet),
     k(k),
+    referenceKernels(referenceKernels),
     kernel(kernel),
     lastQueryIndex(-1),
     lastReferenceIndex(-1),
@@ -40,11 +58,6 @@ FastMKSRules<KernelType, TreeType>::FastMKSRules(
     queryKernels[i] = sqrt(kernel.Evaluate(querySet.col(i),
                                            querySet.col(i)));
 
-  referenceKernels.set_size(referenceSet.n_cols);
-  for (size_t i = 0; i < referenceSet.n_cols; ++i)
-    referenceKernels[i] = sqrt(kernel.Evaluate(referenceSet.col(i),
-                                               referenceSet.col(i)));
-
   // Set to invalid memory, so that the first node combination does not try to
   // dereference null pointers.
   traversalInfo.LastQueryNode() = (TreeType*) this;
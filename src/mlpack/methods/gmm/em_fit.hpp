@@ -164,6 +164,68 @@ class EMFit
       const std::vector<Distribution>& dists,
       const arma::vec& weights) const;
 
+  //! The type of the covariance of a distribution (a vector of the diagonal
+  //! elements for DiagonalGaussianDistribution).
+  typedef typename std::conditional<std::is_same<Distribution,
+      distribution::DiagonalGaussianDistribution>::value,
+      arma::vec, arma::mat>::type CovarianceType;
+
+  //! The number of points processed together in the E-step.
+  static const size_t BlockSize = 1024;
+
+  /**
+   * Run the E-step of the EM algorithm: calculate the conditional
+   * probabilities of each Gaussian for each observation, and sum the weighted
+   * statistics needed by the M-step.  The observations are processed in blocks
+   * of BlockSize points, in parallel; each thread sums into its own statistics,
+   * which are added together at the end.  The observations and outer products
+   * are taken relative to the current mean of each Gaussian, which keeps the
+   * covariance calculation in Maximization() numerically stable.
+   *
+   * @tparam UseWeights Whether or not to use the probabilities of each
+   *      observation.
+   * @param observations List of observations.
+   * @param probabilities Probability of each point being from this model (only
+   *      used if UseWeights is true).
+   * @param dists Current distributions.
+   * @param weights Current a priori weights.
+   * @param probSums Output sum of the conditional probabilities of each
+   *      Gaussian.
+   * @param meanSums Output weighted sums of the observations minus the mean of
+   *      each Gaussian.
+   * @param covSums Output weighted sums of the outer products of the
+   *      observations minus the mean of each Gaussian.
+   * @return Log-likelihood of the current model.
+   */
+  template<bool UseWeights>
+  double Expectation(const arma::mat& observations,
+                     const arma::vec& probabilities,
+                     const std::vector<Distribution>& dists,
+                     const arma::vec& weights,
+                     arma::vec& probSums,
+                     std::vector<arma::vec>& meanSums,
+                     std::vector<CovarianceType>& covSums) const;
+
+  /**
+   * Run the M-step of the EM algorithm: update the distributions and the a
+   * priori weights from the statistics of Expectation().
+   *
+   * @param probSums Sum of the conditional probabilities of each Gaussian.
+   * @param meanSums Weighted sums of the observations minus the mean of each
+   *      Gaussian.
+   * @param covSums Weighted sums of the outer products of the observations
+   *      minus the mean of each Gaussian.
+   * @param totalWeight Total weight of all observations.
+   * @param dists Distributions to update.
+   * @param weights A priori weights to update.
+   */
+  void Maximization(const arma::vec& probSums,
+                    const std::vector<arma::vec>& meanSums,
+                    const std::vector<CovarianceType>& covSums,
+                    const double totalWeight,
+                    std::vector<Distribution>& dists,
+                    arma::vec& weights);
+
   /**
    * Use the Armadillo gmm_diag clusterer to train a GMM with diagonal
    * covariance.  If InitialClusteringType == kmeans::KMeans<>, this will use
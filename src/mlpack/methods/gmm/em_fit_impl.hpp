@@ -71,13 +71,18 @@ Estimate(const arma::mat& observations,
   if (!useInitialModel)
     InitialClustering(observations, dists, weights);
 
-  double l = LogLikelihood(observations, dists, weights);
+  // The E-step also gives the log-likelihood of the current model, so the
+  // statistics for the next M-step are computed with the log-likelihood.
+  arma::vec probSums;
+  std::vector<arma::vec> meanSums;
+  std::vector<CovarianceType> covSums;
+  double l = Expectation<false>(observations, arma::vec(), dists, weights,
+      probSums, meanSums, covSums);
 
   Log::Debug << "EMFit::Estimate(): initial clustering log-likelihood: "
       << l << std::endl;
 
   double lOld = -DBL_MAX;
-  arma::mat condLogProb(observations.n_cols, dists.size());
 
   // Iterate to update the model until no more improvement is found.
   size_t iteration = 1;
@@ -86,81 +91,15 @@ Estimate(const arma::mat& observations,
     Log::Info << "EMFit::Estimate(): iteration " << iteration << ", "
         << "log-likelihood " << l << "." << std::endl;
 
-    // Calculate the conditional probabilities of choosing a particular
-    // Gaussian given the observations and the present theta value.
-    for (size_t i = 0; i < dists.size(); i++)
-    {
-      // Store conditional log probabilities into condLogProb vector for each
-      // Gaussian.  First we make an alias of the condLogProb vector.
-      arma::vec condLogProbAlias = condLogProb.unsafe_col(i);
-      dists[i].LogProbability(observations, condLogProbAlias);
-      condLogProbAlias += log(weights[i]);
-    }
-
-    // Normalize row-wise.
-    for (size_t i = 0; i < condLogProb.n_rows; i++)
-    {
-      // Avoid dividing by zero; if the probability for everything is 0, we
-      // don't want to make it NaN.
-      const double probSum = mlpack::math::AccuLog(condLogProb.row(i));
-      if (probSum != -std::numeric_limits<double>::infinity())
-        condLogProb.row(i) -= probSum;
-    }
-
-    // Store the sum of the probability of each state over all the observations.
-    arma::vec probRowSums(dists.size());
-    for (size_t i = 0; i < dists.size(); ++i)
-    {
-      probRowSums(i) = mlpack::math::AccuLog(condLogProb.col(i));
-    }
-
-    // Calculate the new value of the means using the updated conditional
-    // probabilities.
-    for (size_t i = 0; i < dists.size(); i++)
-    {
-      // Don't update if there's no probability of the Gaussian having points.
-      if (probRowSums[i] != -std::numeric_limits<double>::infinity())
-        dists[i].Mean() = observations * arma::exp(condLogProb.col(i) -
-                                                   probRowSums[i]);
-      else
-        continue;
-
-      // Calculate the new value of the covariances using the updated
-      // conditional probabilities and the updated means.
-      arma::mat tmp = observations.each_col() - dists[i].Mean();
-
-      // If the distribution is DiagonalGaussianDistribution, calculate the
-      // covariance only with diagonal components.
-      if (std::is_same<Distribution,
-          distribution::DiagonalGaussianDistribution>::value)
-      {
-        arma::vec covariance = arma::sum((tmp % tmp) %
-            (arma::ones<arma::vec>(observations.n_rows) *
-            trans(arma::exp(condLogProb.col(i) - probRowSums[i]))), 1);
-
-        // Apply covariance constraint.
-        constraint.ApplyConstraint(covariance);
-        dists[i].Covariance(std::move(covariance));
-      }
-      else
-      {
-        arma::mat tmpB = tmp.each_row() % trans(arma::exp(condLogProb.col(i) -
-                                                          probRowSums[i]));
-        arma::mat covariance = tmp * trans(tmpB);
-
-        // Apply covariance constraint.
-        constraint.ApplyConstraint(covariance);
-        dists[i].Covariance(std::move(covariance));
-      }
-    }
-
-    // Calculate the new values for omega using the updated conditional
-    // probabilities.
-    weights = arma::exp(probRowSums - log(observations.n_cols));
+    // Update the model from the conditional probabilities of the current one.
+    Maximization(probSums, meanSums, covSums, observations.n_cols, dists,
+        weights);
 
-    // Update values of l; calculate new log-likelihood.
+    // Update values of l; calculate new log-likelihood and the statistics of
+    // the new model.
     lOld = l;
-    l = LogLikelihood(observations, dists, weights);
+    l = Expectation<false>(observations, arma::vec(), dists, weights,
+        probSums, meanSums, covSums);
 
     iteration++;
   }
@@ -179,104 +118,187 @@ Estimate(const arma::mat& observations,
   if (!useInitialModel)
     InitialClustering(observations, dists, weights);
 
-  double l = LogLikelihood(observations, dists, weights);
+  arma::vec probSums;
+  std::vector<arma::vec> meanSums;
+  std::vector<CovarianceType> covSums;
+  double l = Expectation<true>(observations, probabilities, dists, weights,
+      probSums, meanSums, covSums);
 
   Log::Debug << "EMFit::Estimate(): initial clustering log-likelihood: "
       << l << std::endl;
 
   double lOld = -DBL_MAX;
-  arma::mat condLogProb(observations.n_cols, dists.size());
+  const double totalWeight = arma::accu(probabilities);
 
   // Iterate to update the model until no more improvement is found.
   size_t iteration = 1;
   while (std::abs(l - lOld) > tolerance && iteration != maxIterations)
   {
-    // Calculate the conditional probabilities of choosing a particular
-    // Gaussian given the observations and the present theta value.
-    for (size_t i = 0; i < dists.size(); i++)
-    {
-      // Store conditional log probabilities into condLogProb vector for each
-      // Gaussian.  First we make an alias of the condLogProb vector.
-      arma::vec condLogProbAlias = condLogProb.unsafe_col(i);
-      dists[i].LogProbability(observations, condLogProbAlias);
-      condLogProbAlias += log(weights[i]);
-    }
+    // Update the model from the conditional probabilities of the current one.
+    Maximization(probSums, meanSums, covSums, totalWeight, dists, weights);
 
-    // Normalize row-wise.
-    for (size_t i = 0; i < condLogProb.n_rows; i++)
-    {
-      // Avoid dividing by zero; if the probability for everything is 0, we
-      // don't want to make it NaN.
-      const double probSum = mlpack::math::AccuLog(condLogProb.row(i));
-      if (probSum != -std::numeric_limits<double>::infinity())
-        condLogProb.row(i) -= probSum;
-    }
+    // Update values of l; calculate new log-likelihood and the statistics of
+    // the new model.
+    lOld = l;
+    l = Expectation<true>(observations, probabilities, dists, weights,
+        probSums, meanSums, covSums);
 
-    // This will store the sum of probabilities of each state over all the
-    // observations.
-    arma::vec probRowSums(dists.size());
+    iteration++;
+  }
+}
 
-    // Calculate the new value of the means using the updated conditional
-    // probabilities.
-    arma::vec logProbabilities = arma::log(probabilities);
-    for (size_t i = 0; i < dists.size(); i++)
+template<typename InitialClusteringType,
+         typename CovarianceConstraintPolicy,
+         typename Distribution>
+template<bool UseWeights>
+double EMFit<InitialClusteringType, CovarianceConstraintPolicy, Distribution>::
+Expectation(const arma::mat& observations,
+            const arma::vec& probabilities,
+            const std::vector<Distribution>& dists,
+            const arma::vec& weights,
+            arma::vec& probSums,
+            std::vector<arma::vec>& meanSums,
+            std::vector<CovarianceType>& covSums) const
+{
+  probSums.zeros(dists.size());
+  meanSums.resize(dists.size());
+  covSums.resize(dists.size());
+  for (size_t i = 0; i < dists.size(); ++i)
+  {
+    meanSums[i].zeros(observations.n_rows);
+    covSums[i] = dists[i].Covariance();
+    covSums[i].zeros();
+  }
+
+  const arma::vec logWeights = arma::log(weights);
+  const size_t numBlocks = (observations.n_cols + BlockSize - 1) / BlockSize;
+  double logLikelihood = 0;
+
+  #pragma omp parallel reduction(+:logLikelihood)
+  {
+    // Each thread sums the statistics of its blocks separately.
+    arma::vec threadProbSums(probSums);
+    std::vector<arma::vec> threadMeanSums(meanSums);
+    std::vector<CovarianceType> threadCovSums(covSums);
+
+    arma::mat condLogProb;
+    arma::vec logProbs;
+
+    #pragma omp for schedule(static)
+    for (omp_size_t b = 0; b < (omp_size_t) numBlocks; ++b)
     {
-      // Calculate the sum of probabilities of points, which is the
-      // conditional probability of each point being from Gaussian i
-      // multiplied by the probability of the point being from this mixture
-      // model.
-      arma::vec tmpProb = condLogProb.col(i) + logProbabilities;
-      probRowSums[i] = mlpack::math::AccuLog(tmpProb);
-
-      // Don't update if there's no probability of the Gaussian having points.
-      if (probRowSums[i] != -std::numeric_limits<double>::infinity())
+      const size_t begin = b * BlockSize;
+      const size_t count = std::min(begin + BlockSize,
+          (size_t) observations.n_cols) - begin;
+      const arma::mat block(const_cast<double*>(observations.colptr(begin)),
+          observations.n_rows, count, false, true);
+
+      // Calculate the conditional log probabilities of choosing a particular
+      // Gaussian given the observations and the present theta value.
+      condLogProb.set_size(dists.size(), count);
+      for (size_t i = 0; i < dists.size(); ++i)
       {
-        dists[i].Mean() = observations *
-              arma::exp(condLogProb.col(i) + logProbabilities - probRowSums[i]);
+        dists[i].LogProbability(block, logProbs);
+        condLogProb.row(i) = logWeights[i] + logProbs.t();
       }
-      else
-        continue;
 
-      // Calculate the new value of the covariances using the updated
-      // conditional probabilities and the updated means.
-      arma::mat tmp = observations.each_col() - dists[i].Mean();
+      // Normalize each point, and sum its likelihood.
+      for (size_t j = 0; j < count; ++j)
+      {
+        // Avoid dividing by zero; if the probability for everything is 0, we
+        // don't want to make it NaN.
+        const double probSum = mlpack::math::AccuLog(condLogProb.col(j));
+        logLikelihood += probSum;
+        if (probSum != -std::numeric_limits<double>::infinity())
+          condLogProb.col(j) -= probSum;
+      }
 
-      // If the distribution is DiagonalGaussianDistribution, calculate the
-      // covariance only with diagonal components.
-      if (std::is_same<Distribution,
-          distribution::DiagonalGaussianDistribution>::value)
+      arma::mat condProb = arma::exp(condLogProb);
+      if (UseWeights)
       {
-        arma::vec cov = arma::sum((tmp % tmp) %
-            (arma::ones<arma::vec>(observations.n_rows) *
-            trans(arma::exp(condLogProb.col(i) +
-                            logProbabilities - probRowSums[i]))), 1);
-
-        // Apply covariance constraint.
-        constraint.ApplyConstraint(cov);
-        dists[i].Covariance(std::move(cov));
+        condProb.each_row() %=
+            probabilities.subvec(begin, begin + count - 1).t();
       }
-      else
+
+      for (size_t i = 0; i < dists.size(); ++i)
       {
-        arma::mat tmpB = tmp.each_row() % trans(arma::exp(condLogProb.col(i) +
-            logProbabilities - probRowSums[i]));
-        arma::mat cov = (tmp * trans(tmpB));
+        const arma::rowvec condProbRow = condProb.row(i);
+        const arma::mat diffs = block.each_col() - dists[i].Mean();
+
+        threadProbSums[i] += arma::accu(condProbRow);
+        threadMeanSums[i] += diffs * condProbRow.t();
+
+        // If the distribution is DiagonalGaussianDistribution, only the
+        // diagonal components of the covariance are needed.
+        if (std::is_same<Distribution,
+            distribution::DiagonalGaussianDistribution>::value)
+          threadCovSums[i] += (diffs % diffs) * condProbRow.t();
+        else
+          threadCovSums[i] += (diffs.each_row() % condProbRow) * diffs.t();
+      }
+    }
 
-        // Apply covariance constraint.
-        constraint.ApplyConstraint(cov);
-        dists[i].Covariance(std::move(cov));
+    #pragma omp critical(EMFitExpectation)
+    {
+      probSums += threadProbSums;
+      for (size_t i = 0; i < dists.size(); ++i)
+      {
+        meanSums[i] += threadMeanSums[i];
+        covSums[i] += threadCovSums[i];
       }
     }
+  }
 
-    // Calculate the new values for omega using the updated conditional
-    // probabilities.
-    weights = arma::exp(probRowSums - mlpack::math::AccuLog(logProbabilities));
+  return logLikelihood;
+}
 
-    // Update values of l; calculate new log-likelihood.
-    lOld = l;
-    l = LogLikelihood(observations, dists, weights);
+template<typename InitialClusteringType,
+         typename CovarianceConstraintPolicy,
+         typename Distribution>
+void EMFit<InitialClusteringType, CovarianceConstraintPolicy, Distribution>::
+Maximization(const arma::vec& probSums,
+             const std::vector<arma::vec>& meanSums,
+             const std::vector<CovarianceType>& covSums,
+             const double totalWeight,
+             std::vector<Distribution>& dists,
+             arma::vec& weights)
+{
+  for (size_t i = 0; i < dists.size(); ++i)
+  {
+    // Don't update if there's no probability of the Gaussian having points.
+    if (probSums[i] == 0)
+      continue;
+
+    // The sums are relative to the old mean, so the weighted mean of the
+    // differences is the change of the mean.
+    const arma::vec meanShift = meanSums[i] / probSums[i];
+    dists[i].Mean() += meanShift;
+
+    // If the distribution is DiagonalGaussianDistribution, calculate the
+    // covariance only with diagonal components.
+    if (std::is_same<Distribution,
+        distribution::DiagonalGaussianDistribution>::value)
+    {
+      arma::vec covariance = covSums[i] / probSums[i] - meanShift % meanShift;
 
-    iteration++;
+      // Apply covariance constraint.
+      constraint.ApplyConstraint(covariance);
+      dists[i].Covariance(std::move(covariance));
+    }
+    else
+    {
+      arma::mat covariance = covSums[i] / probSums[i] -
+          meanShift * meanShift.t();
+
+      // Apply covariance constraint.
+      constraint.ApplyConstraint(covariance);
+      dists[i].Covariance(std::move(covariance));
+    }
   }
+
+  // Calculate the new values for omega using the updated conditional
+  // probabilities.
+  weights = probSums / totalWeight;
 }
 
 template<typename InitialClusteringType,
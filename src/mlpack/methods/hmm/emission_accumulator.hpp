@@ -0,0 +1,189 @@
+/**
+ * @file emission_accumulator.hpp
+ *
+ * Accumulators of the weighted sufficient statistics of emission
+ * distributions, used by the streaming Baum-Welch training of the HMM class.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_HMM_EMISSION_ACCUMULATOR_HPP
+#define MLPACK_METHODS_HMM_EMISSION_ACCUMULATOR_HPP
+
+#include <mlpack/prereqs.hpp>
+#include <mlpack/core/dists/discrete_distribution.hpp>
+#include <mlpack/core/dists/gaussian_distribution.hpp>
+#include <mlpack/methods/gmm/positive_definite_constraint.hpp>
+
+namespace mlpack {
+namespace hmm {
+
+/**
+ * An EmissionAccumulator collects the sufficient statistics needed to train an
+ * emission distribution on weighted observations, without keeping the
+ * observations.  Accumulators of different sets of observations can be merged,
+ * and training a distribution from the merged accumulator gives the same
+ * result (up to floating-point error) as calling Train() on all the
+ * observations and their weights.
+ *
+ * Only the distributions with a specialization of this class can be used for
+ * streaming training of an HMM.  A specialization must provide the following
+ * functions:
+ *
+ * @code
+ * // Create empty statistics for the given distribution.
+ * EmissionAccumulator(const Distribution& distribution);
+ *
+ * // Add an observation with the given weight.
+ * template<typename VecType>
+ * void Add(const VecType& observation, const double probability);
+ *
+ * // Add the statistics of another accumulator.
+ * void Merge(const EmissionAccumulator& other);
+ *
+ * // Train the given distribution on the accumulated statistics.
+ * void Train(Distribution& distribution) const;
+ * @endcode
+ *
+ * @tparam Distribution Type of emission distribution.
+ */
+template<typename Distribution>
+class EmissionAccumulator
+{
+  static_assert(sizeof(Distribution) == 0, "EmissionAccumulator: streaming "
+      "HMM training is not supported for this emission distribution");
+};
+
+/**
+ * Accumulator for a DiscreteDistribution: the weighted count of each possible
+ * observation in each dimension.
+ */
+template<>
+class EmissionAccumulator<distribution::DiscreteDistribution>
+{
+ public:
+  //! Create empty statistics for the given distribution.
+  EmissionAccumulator(const distribution::DiscreteDistribution& distribution) :
+      counts(distribution.Dimensionality())
+  {
+    for (size_t i = 0; i < counts.size(); ++i)
+      counts[i].zeros(distribution.Probabilities(i).n_elem);
+  }
+
+  //! Add an observation with the given weight.
+  template<typename VecType>
+  void Add(const VecType& observation, const double probability)
+  {
+    for (size_t i = 0; i < counts.size(); ++i)
+    {
+      // Round the observation, like DiscreteDistribution::Train().
+      const size_t obs = size_t(observation[i] + 0.5);
+      if (obs >= counts[i].n_elem)
+      {
+        std::ostringstream oss;
+        oss << "observation in dimension " << i << " (" << observation[i]
+            << ") is invalid; must be in [0, " << counts[i].n_elem << "] for "
+            << "this distribution";
+        throw std::invalid_argument(oss.str());
+      }
+
+      counts[i][obs] += probability;
+    }
+  }
+
+  //! Add the statistics of another accumulator.
+  void Merge(const EmissionAccumulator& other)
+  {
+    for (size_t i = 0; i < counts.size(); ++i)
+      counts[i] += other.counts[i];
+  }
+
+  //! Train the given distribution on the accumulated statistics.
+  void Train(distribution::DiscreteDistribution& distribution) const
+  {
+    for (size_t i = 0; i < counts.size(); ++i)
+    {
+      const double sum = arma::accu(counts[i]);
+      if (sum > 0)
+        distribution.Probabilities(i) = counts[i] / sum;
+      else // Force normalization.
+        distribution.Probabilities(i).fill(1.0 / counts[i].n_elem);
+    }
+  }
+
+ private:
+  //! The weighted count of each observation, for each dimension.
+  std::vector<arma::vec> counts;
+};
+
+/**
+ * Accumulator for a GaussianDistribution: the sum of the weights, and the
+ * weighted sums of the observations and of their outer products.
+ */
+template<>
+class EmissionAccumulator<distribution::GaussianDistribution>
+{
+ public:
+  //! Create empty statistics for the given distribution.
+  EmissionAccumulator(const distribution::GaussianDistribution& distribution) :
+      sumProb(0.0),
+      sum(distribution.Dimensionality(), arma::fill::zeros),
+      outerSum(distribution.Dimensionality(), distribution.Dimensionality(),
+          arma::fill::zeros)
+  { }
+
+  //! Add an observation with the given weight.
+  template<typename VecType>
+  void Add(const VecType& observation, const double probability)
+  {
+    sumProb += probability;
+    sum += probability * observation;
+    outerSum += probability * (observation * observation.t());
+  }
+
+  //! Add the statistics of another accumulator.
+  void Merge(const EmissionAccumulator& other)
+  {
+    sumProb += other.sumProb;
+    sum += other.sum;
+    outerSum += other.outerSum;
+  }
+
+  //! Train the given distribution on the accumulated statistics.
+  void Train(distribution::GaussianDistribution& distribution) const
+  {
+    if (sumProb == 0)
+    {
+      // Nothing in this Gaussian!  At least set the covariance so that it's
+      // invertible, like GaussianDistribution::Train().
+      distribution.Mean().zeros(sum.n_elem);
+      arma::mat covariance(sum.n_elem, sum.n_elem, arma::fill::zeros);
+      covariance.diag() += 1e-50;
+      distribution.Covariance(std::move(covariance));
+      return;
+    }
+
+    distribution.Mean() = sum / sumProb;
+    arma::mat covariance = outerSum / sumProb -
+        distribution.Mean() * distribution.Mean().t();
+
+    // Ensure that the covariance is positive definite.
+    gmm::PositiveDefiniteConstraint::ApplyConstraint(covariance);
+    distribution.Covariance(std::move(covariance));
+  }
+
+ private:
+  //! The sum of the weights.
+  double sumProb;
+  //! The weighted sum of the observations.
+  arma::vec sum;
+  //! The weighted sum of the outer products of the observations.
+  arma::mat outerSum;
+};
+
+} // namespace hmm
+} // namespace mlpack
+
+#endif
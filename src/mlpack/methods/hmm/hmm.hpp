@@ -16,6 +16,7 @@
 
 #include <mlpack/prereqs.hpp>
 #include <mlpack/core/dists/discrete_distribution.hpp>
+#include "emission_accumulator.hpp"
 
 namespace mlpack {
 namespace hmm /** Hidden Markov Models. */ {
@@ -164,11 +165,43 @@ class HMM
    * for training.
    * @endnote
    *
+   * The forward-backward passes over the sequences (the E-step) are run in
+   * parallel with OpenMP.
+   *
    * @param dataSeq Vector of observation sequences.
    * @return Log-likelihood of state sequence.
    */
   double Train(const std::vector<arma::mat>& dataSeq);
 
+  /**
+   * Train the model using the Baum-Welch algorithm on unlabeled observation
+   * sequences that are given by a sequence source instead of being held in
+   * memory, so that very large sets of sequences can be used.  Each iteration
+   * asks the source for every sequence once; the sequences are processed in
+   * parallel with OpenMP, but the source is never called by two threads at
+   * the same time.  The sequence source must be callable as
+   *
+   * @code
+   * void operator()(const size_t index, arma::mat& dataSeq);
+   * @endcode
+   *
+   * and must store the sequence with the given index (between 0 and
+   * numSequences - 1) in dataSeq.
+   *
+   * Instead of keeping all the observations for the training of the emission
+   * distributions, only their sufficient statistics are kept, with the
+   * EmissionAccumulator class; so this is only available for the emission
+   * distributions that EmissionAccumulator supports (DiscreteDistribution and
+   * GaussianDistribution).  Otherwise, the result is the same as the other
+   * overload of Train() with the same sequences.
+   *
+   * @param numSequences Number of observation sequences.
+   * @param sequenceSource Source of the observation sequences.
+   * @return Log-likelihood of state sequence.
+   */
+  template<typename SequenceSourceType>
+  double Train(const size_t numSequences, SequenceSourceType sequenceSource);
+
   /**
    * Train the model using the given labeled observations; the transition and
    * emission matrices are directly estimated.  Each matrix in the vector of
@@ -421,6 +454,41 @@ class HMM
    */
   void ConvertToLogSpace() const;
 
+  /**
+   * Run the Forward-Backward algorithm on the given sequence (the E-step of
+   * the Baum-Welch algorithm), and add the contribution of the sequence to the
+   * given (log-space) estimates of the initial state probabilities and the
+   * transition matrix.  ConvertToLogSpace() must have been called.
+   *
+   * @param dataSeq Observation sequence.
+   * @param stateLogProb Matrix in which the log probabilities of each state at
+   *      each time step will be saved.
+   * @param newLogInitial Estimate of the initial state probabilities.
+   * @param newLogTransition Estimate of the transition matrix.
+   * @return Log-likelihood of the sequence.
+   */
+  double ExpectationStep(const arma::mat& dataSeq,
+                         arma::mat& stateLogProb,
+                         arma::vec& newLogInitial,
+                         arma::mat& newLogTransition) const;
+
+  /**
+   * Set the initial state probabilities and the transition matrix from the
+   * estimates given by ExpectationStep() over all sequences.
+   *
+   * @param newLogInitial Estimate of the initial state probabilities.
+   * @param newLogTransition Estimate of the transition matrix.
+   * @param numSequences Number of sequences.
+   */
+  void MaximizationStep(const arma::vec& newLogInitial,
+                        const arma::mat& newLogTransition,
+                        const size_t numSequences);
+
+  /**
+   * Add the log-space values of y to x: x = log(exp(x) + exp(y)).
+   */
+  static void LogAddTo(arma::mat& x, const arma::mat& y);
+
   /**
    * A proxy vriable in linear space for logInitial.
    * Should be removed in mlpack 4.0.
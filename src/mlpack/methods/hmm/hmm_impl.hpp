@@ -101,10 +101,13 @@ double HMM<Distribution>::Train(const std::vector<arma::mat>& dataSeq)
   // Maximum iterations?
   size_t iterations = 1000;
 
-  // Find length of all sequences and ensure they are the correct size.
+  // Find length of all sequences and ensure they are the correct size.  Also
+  // find where the observations of each sequence go in emissionList.
   size_t totalLength = 0;
+  std::vector<size_t> offsets(dataSeq.size());
   for (size_t seq = 0; seq < dataSeq.size(); seq++)
   {
+    offsets[seq] = totalLength;
     totalLength += dataSeq[seq].n_cols;
 
     if (dataSeq[seq].n_rows != dimensionality)
@@ -124,6 +127,8 @@ double HMM<Distribution>::Train(const std::vector<arma::mat>& dataSeq)
   // Markov Models: Estimation and Control", pp. 36-40.
   for (size_t iter = 0; iter < iterations; iter++)
   {
+    ConvertToLogSpace();
+
     // Clear new transition matrix and emission probabilities.
     arma::vec newLogInitial(logTransition.n_rows);
     newLogInitial.fill(-std::numeric_limits<double>::infinity());
@@ -133,56 +138,67 @@ double HMM<Distribution>::Train(const std::vector<arma::mat>& dataSeq)
     // Reset log likelihood.
     loglik = 0;
 
-    // Sum over time.
-    size_t sumTime = 0;
+    // The sequences are independent, so the E-step is done in parallel.  Each
+    // thread has its own estimates of the initial probabilities and the
+    // transition matrix, and each sequence has its own part of emissionList.
+    // Errors can't be thrown out of the parallel region, so the first one is
+    // kept and reported afterwards.
+    std::string error;
 
-    // Loop over each sequence.
-    for (size_t seq = 0; seq < dataSeq.size(); seq++)
+    #pragma omp parallel
     {
-      arma::mat stateLogProb;
-      arma::mat forwardLog;
-      arma::mat backwardLog;
-      arma::vec logScales;
-
-      // Add the log-likelihood of this sequence.  This is the E-step.
-      loglik += LogEstimate(dataSeq[seq], stateLogProb, forwardLog,
-          backwardLog, logScales);
-
-      // Add to estimate of initial probability for state j.
-      for (size_t j = 0; j < logTransition.n_cols; ++j)
-        newLogInitial[j] = math::LogAdd(newLogInitial[j], stateLogProb(j, 0));
-
-      // Now re-estimate the parameters.  This is the M-step.
-      //   pi_i = sum_d ((1 / P(seq[d])) sum_t (f(i, 0) b(i, 0))
-      //   T_ij = sum_d ((1 / P(seq[d])) sum_t (f(i, t) T_ij E_i(seq[d][t]) b(i,
-      //           t + 1)))
-      //   E_ij = sum_d ((1 / P(seq[d])) sum_{t | seq[d][t] = j} f(i, t) b(i, t)
-      // We store the new estimates in a different matrix.
-      for (size_t t = 0; t < dataSeq[seq].n_cols; ++t)
+      arma::vec threadLogInitial(newLogInitial.n_elem);
+      threadLogInitial.fill(-std::numeric_limits<double>::infinity());
+      arma::mat threadLogTransition(newLogTransition.n_rows,
+          newLogTransition.n_cols);
+      threadLogTransition.fill(-std::numeric_limits<double>::infinity());
+      double threadLoglik = 0;
+
+      #pragma omp for schedule(dynamic)
+      for (omp_size_t seq = 0; seq < (omp_size_t) dataSeq.size(); seq++)
       {
-        for (size_t j = 0; j < logTransition.n_cols; ++j)
+        std::string seqError;
+        try
         {
-          if (t < dataSeq[seq].n_cols - 1)
+          // Add the log-likelihood of this sequence.
+          arma::mat stateLogProb;
+          threadLoglik += ExpectationStep(dataSeq[seq], stateLogProb,
+              threadLogInitial, threadLogTransition);
+
+          // Add to list of emission observations, for Distribution::Train().
+          for (size_t t = 0; t < dataSeq[seq].n_cols; ++t)
           {
-            // Estimate of T_ij (probability of transition from state j to state
-            // i).  We postpone multiplication of the old T_ij until later.
-            for (size_t i = 0; i < logTransition.n_rows; i++)
-            {
-              newLogTransition(i, j) = math::LogAdd(newLogTransition(i, j),
-                  forwardLog(j, t) + backwardLog(i, t + 1) +
-                  emission[i].LogProbability(dataSeq[seq].unsafe_col(t + 1)) -
-                  logScales[t + 1]);
-            }
+            emissionList.col(offsets[seq] + t) = dataSeq[seq].col(t);
+            for (size_t j = 0; j < logTransition.n_cols; ++j)
+              emissionProb[j][offsets[seq] + t] = exp(stateLogProb(j, t));
           }
+        }
+        catch (std::exception& e)
+        {
+          seqError = e.what();
+        }
 
-          // Add to list of emission observations, for Distribution::Train().
-          emissionList.col(sumTime) = dataSeq[seq].col(t);
-          emissionProb[j][sumTime] = exp(stateLogProb(j, t));
+        if (!seqError.empty())
+        {
+          #pragma omp critical(HMMTrainError)
+          {
+            if (error.empty())
+              error = seqError;
+          }
         }
-        sumTime++;
+      }
+
+      #pragma omp critical
+      {
+        loglik += threadLoglik;
+        LogAddTo(newLogInitial, threadLogInitial);
+        LogAddTo(newLogTransition, threadLogTransition);
       }
     }
 
+    if (!error.empty())
+      Log::Fatal << "HMM::Train(): " << error << std::endl;
+
     if (std::abs(oldLoglik - loglik) < tolerance)
     {
       Log::Debug << "Converged after " << iter << " iterations." << std::endl;
@@ -191,33 +207,153 @@ double HMM<Distribution>::Train(const std::vector<arma::mat>& dataSeq)
 
     oldLoglik = loglik;
 
-    // Normalize the new initial probabilities.
-    if (dataSeq.size() > 1)
-      logInitial = newLogInitial - log(dataSeq.size());
-    else
-      logInitial = newLogInitial;
+    MaximizationStep(newLogInitial, newLogTransition, dataSeq.size());
+
+    // Now estimate emission probabilities.
+    for (size_t state = 0; state < logTransition.n_cols; state++)
+      emission[state].Train(emissionList, emissionProb[state]);
 
-    // Assign the new transition matrix.  We use %= (element-wise
-    // multiplication) because every element of the new transition matrix must
-    // still be multiplied by the old elements (this is the multiplication we
-    // earlier postponed).
-    logTransition += newLogTransition;
+    Log::Debug << "Iteration " << iter << ": log-likelihood " << loglik
+        << "." << std::endl;
+  }
+  return loglik;
+}
 
-    // Now we normalize the transition matrix.
-    for (size_t i = 0; i < logTransition.n_cols; i++)
+/**
+ * Train the model using the Baum-Welch algorithm, with unlabeled observations
+ * given by a sequence source.
+ */
+template<typename Distribution>
+template<typename SequenceSourceType>
+double HMM<Distribution>::Train(const size_t numSequences,
+                                SequenceSourceType sequenceSource)
+{
+  double loglik = 0;
+  double oldLoglik = 0;
+
+  // Maximum iterations?
+  size_t iterations = 1000;
+
+  for (size_t iter = 0; iter < iterations; iter++)
+  {
+    ConvertToLogSpace();
+
+    // Clear new transition matrix and emission statistics.
+    arma::vec newLogInitial(logTransition.n_rows);
+    newLogInitial.fill(-std::numeric_limits<double>::infinity());
+    arma::mat newLogTransition(logTransition.n_rows, logTransition.n_cols);
+    newLogTransition.fill(-std::numeric_limits<double>::infinity());
+    std::vector<EmissionAccumulator<Distribution>> newEmission;
+    for (size_t state = 0; state < logTransition.n_cols; state++)
+      newEmission.push_back(EmissionAccumulator<Distribution>(emission[state]));
+
+    // Reset log likelihood.
+    loglik = 0;
+
+    // Errors can't be thrown out of the parallel region, so the first one is
+    // kept and reported afterwards.
+    std::string error;
+
+    #pragma omp parallel
     {
-      const double sum = math::AccuLog(logTransition.col(i));
-      if (std::isfinite(sum))
-        logTransition.col(i) -= sum;
-      else
-        logTransition.col(i).fill(-log((double) logTransition.n_rows));
+      arma::vec threadLogInitial(newLogInitial.n_elem);
+      threadLogInitial.fill(-std::numeric_limits<double>::infinity());
+      arma::mat threadLogTransition(newLogTransition.n_rows,
+          newLogTransition.n_cols);
+      threadLogTransition.fill(-std::numeric_limits<double>::infinity());
+      std::vector<EmissionAccumulator<Distribution>> threadEmission(
+          newEmission);
+      double threadLoglik = 0;
+      arma::mat dataSeq;
+
+      #pragma omp for schedule(dynamic)
+      for (omp_size_t seq = 0; seq < (omp_size_t) numSequences; seq++)
+      {
+        std::string seqError;
+
+        // The sequence source does not have to be thread-safe.
+        #pragma omp critical(HMMSequenceSource)
+        {
+          try
+          {
+            sequenceSource((size_t) seq, dataSeq);
+          }
+          catch (std::exception& e)
+          {
+            seqError = e.what();
+          }
+        }
+
+        if (seqError.empty() && dataSeq.n_rows != dimensionality)
+        {
+          std::ostringstream oss;
+          oss << "data sequence " << seq << " has dimensionality "
+              << dataSeq.n_rows << " (expected " << dimensionality
+              << " dimensions).";
+          seqError = oss.str();
+        }
+
+        if (seqError.empty())
+        {
+          try
+          {
+            // Add the log-likelihood of this sequence.
+            arma::mat stateLogProb;
+            threadLoglik += ExpectationStep(dataSeq, stateLogProb,
+                threadLogInitial, threadLogTransition);
+
+            // Add the observations to the emission statistics.
+            for (size_t t = 0; t < dataSeq.n_cols; ++t)
+            {
+              for (size_t j = 0; j < logTransition.n_cols; ++j)
+              {
+                threadEmission[j].Add(dataSeq.unsafe_col(t),
+                    exp(stateLogProb(j, t)));
+              }
+            }
+          }
+          catch (std::exception& e)
+          {
+            seqError = e.what();
+          }
+        }
+
+        if (!seqError.empty())
+        {
+          #pragma omp critical(HMMTrainError)
+          {
+            if (error.empty())
+              error = seqError;
+          }
+        }
+      }
+
+      #pragma omp critical
+      {
+        loglik += threadLoglik;
+        LogAddTo(newLogInitial, threadLogInitial);
+        LogAddTo(newLogTransition, threadLogTransition);
+        for (size_t state = 0; state < newEmission.size(); state++)
+          newEmission[state].Merge(threadEmission[state]);
+      }
     }
 
-    initialProxy = exp(logInitial);
-    transitionProxy = exp(logTransition);
+    if (!error.empty())
+      Log::Fatal << "HMM::Train(): " << error << std::endl;
+
+    if (std::abs(oldLoglik - loglik) < tolerance)
+    {
+      Log::Debug << "Converged after " << iter << " iterations." << std::endl;
+      break;
+    }
+
+    oldLoglik = loglik;
+
+    MaximizationStep(newLogInitial, newLogTransition, numSequences);
+
     // Now estimate emission probabilities.
     for (size_t state = 0; state < logTransition.n_cols; state++)
-      emission[state].Train(emissionList, emissionProb[state]);
+      newEmission[state].Train(emission[state]);
 
     Log::Debug << "Iteration " << iter << ": log-likelihood " << loglik
         << "." << std::endl;
@@ -659,6 +795,96 @@ void HMM<Distribution>::Backward(const arma::mat& dataSeq,
   }
 }
 
+/**
+ * The E-step of the Baum-Welch algorithm for one sequence.
+ */
+template<typename Distribution>
+double HMM<Distribution>::ExpectationStep(const arma::mat& dataSeq,
+                                          arma::mat& stateLogProb,
+                                          arma::vec& newLogInitial,
+                                          arma::mat& newLogTransition) const
+{
+  arma::mat forwardLog;
+  arma::mat backwardLog;
+  arma::vec logScales;
+
+  const double loglik = LogEstimate(dataSeq, stateLogProb, forwardLog,
+      backwardLog, logScales);
+
+  // Add to estimate of initial probability for state j.
+  for (size_t j = 0; j < logTransition.n_cols; ++j)
+    newLogInitial[j] = math::LogAdd(newLogInitial[j], stateLogProb(j, 0));
+
+  // Now add to the estimate of the transition matrix.
+  //   pi_i = sum_d ((1 / P(seq[d])) sum_t (f(i, 0) b(i, 0))
+  //   T_ij = sum_d ((1 / P(seq[d])) sum_t (f(i, t) T_ij E_i(seq[d][t]) b(i,
+  //           t + 1)))
+  //   E_ij = sum_d ((1 / P(seq[d])) sum_{t | seq[d][t] = j} f(i, t) b(i, t)
+  // We postpone multiplication of the old T_ij until the M-step.
+  arma::vec emissionLogProb(logTransition.n_rows);
+  for (size_t t = 0; t + 1 < dataSeq.n_cols; ++t)
+  {
+    for (size_t i = 0; i < logTransition.n_rows; i++)
+      emissionLogProb[i] = emission[i].LogProbability(
+          dataSeq.unsafe_col(t + 1));
+
+    for (size_t j = 0; j < logTransition.n_cols; ++j)
+    {
+      // Estimate of T_ij (probability of transition from state j to state i).
+      for (size_t i = 0; i < logTransition.n_rows; i++)
+      {
+        newLogTransition(i, j) = math::LogAdd(newLogTransition(i, j),
+            forwardLog(j, t) + backwardLog(i, t + 1) + emissionLogProb[i] -
+            logScales[t + 1]);
+      }
+    }
+  }
+
+  return loglik;
+}
+
+/**
+ * The M-step of the Baum-Welch algorithm for the initial state probabilities
+ * and the transition matrix.
+ */
+template<typename Distribution>
+void HMM<Distribution>::MaximizationStep(const arma::vec& newLogInitial,
+                                         const arma::mat& newLogTransition,
+                                         const size_t numSequences)
+{
+  // Normalize the new initial probabilities.
+  if (numSequences > 1)
+    logInitial = newLogInitial - log(numSequences);
+  else
+    logInitial = newLogInitial;
+
+  // Assign the new transition matrix.  We use %= (element-wise
+  // multiplication) because every element of the new transition matrix must
+  // still be multiplied by the old elements (this is the multiplication we
+  // earlier postponed).
+  logTransition += newLogTransition;
+
+  // Now we normalize the transition matrix.
+  for (size_t i = 0; i < logTransition.n_cols; i++)
+  {
+    const double sum = math::AccuLog(logTransition.col(i));
+    if (std::isfinite(sum))
+      logTransition.col(i) -= sum;
+    else
+      logTransition.col(i).fill(-log((double) logTransition.n_rows));
+  }
+
+  initialProxy = exp(logInitial);
+  transitionProxy = exp(logTransition);
+}
+
+template<typename Distribution>
+void HMM<Distribution>::LogAddTo(arma::mat& x, const arma::mat& y)
+{
+  for (size_t i = 0; i < x.n_elem; ++i)
+    x[i] = math::LogAdd(x[i], y[i]);
+}
+
 /**
  * Make sure the variables in log space are in sync with the linear counter parts
  */
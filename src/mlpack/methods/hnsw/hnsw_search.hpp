@@ -0,0 +1,293 @@
+/**
+ * @file hnsw_search.hpp
+ *
+ * Defines the HNSWSearch class, which performs approximate nearest neighbor
+ * search with a hierarchical navigable small world graph.
+ *
+ * The details of this method can be found in the following paper:
+ *
+ * @article{malkov2020efficient,
+ *   title={Efficient and robust approximate nearest neighbor search using
+ *       hierarchical navigable small world graphs},
+ *   author={Malkov, Yu A. and Yashunin, Dmitry A.},
+ *   journal={IEEE Transactions on Pattern Analysis and Machine Intelligence},
+ *   volume={42},
+ *   number={4},
+ *   pages={824--836},
+ *   year={2020}
+ * }
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_HNSW_HNSW_SEARCH_HPP
+#define MLPACK_METHODS_HNSW_HNSW_SEARCH_HPP
+
+#include <mlpack/prereqs.hpp>
+#include <mlpack/core/metrics/lmetric.hpp>
+
+#include <queue>
+
+namespace mlpack {
+namespace neighbor {
+
+/**
+ * The HNSWSearch class builds a hierarchical navigable small world (HNSW) graph
+ * on a reference set, and uses it to find the approximate nearest neighbors of
+ * query points.
+ *
+ * Each point of the reference set is a node in a number of layers of the graph;
+ * the number of layers of a point is drawn at random, so that the higher layers
+ * hold exponentially fewer points.  In each layer, a point is linked to some of
+ * its nearest neighbors in that layer.  A search descends greedily through the
+ * upper layers to find a good entry point in the bottom layer, and then runs a
+ * best-first search in the bottom layer that keeps the ef closest points found
+ * so far.  Larger values of ef give better recall but slower searches.
+ *
+ * Points can be added to the graph at any time with Insert(); Train() builds
+ * the graph by inserting all points of the reference set in order.
+ *
+ * @code
+ * HNSWSearch<> hnsw(std::move(referenceSet));
+ * hnsw.Search(querySet, k, neighbors, distances, 100);
+ * @endcode
+ *
+ * @tparam MetricType The metric to use for computation.
+ * @tparam MatType Type of (dense) matrix to use to store the data.
+ */
+template<typename MetricType = metric::EuclideanDistance,
+         typename MatType = arma::mat>
+class HNSWSearch
+{
+ public:
+  /**
+   * Build the graph on the given reference set.  In order to avoid copying
+   * the reference set, pass it with std::move().
+   *
+   * @param referenceSet Set of reference points.
+   * @param maxNeighbors Maximum number of links of each point in each layer
+   *     above the bottom layer; points in the bottom layer can have twice as
+   *     many links.
+   * @param efConstruction Number of closest points kept by the search for the
+   *     neighbors of each inserted point.
+   * @param metric Instantiated metric.
+   */
+  HNSWSearch(MatType referenceSet,
+             const size_t maxNeighbors = 16,
+             const size_t efConstruction = 200,
+             MetricType metric = MetricType());
+
+  /**
+   * Create an empty graph.  Points can be added with Insert(), or the graph can
+   * be built with Train().
+   *
+   * @param maxNeighbors Maximum number of links of each point in each layer
+   *     above the bottom layer; points in the bottom layer can have twice as
+   *     many links.
+   * @param efConstruction Number of closest points kept by the search for the
+   *     neighbors of each inserted point.
+   * @param metric Instantiated metric.
+   */
+  HNSWSearch(const size_t maxNeighbors = 16,
+             const size_t efConstruction = 200,
+             MetricType metric = MetricType());
+
+  /**
+   * Build the graph on the given reference set, replacing any existing graph.
+   * In order to avoid copying the reference set, pass it with std::move().
+   *
+   * @param referenceSet Set of reference points.
+   */
+  void Train(MatType referenceSet);
+
+  /**
+   * Add the given point to the graph.  Its index is the number of points in the
+   * graph before the insertion.
+   *
+   * @param point Point to add.
+   */
+  template<typename VecType>
+  void Insert(const VecType& point);
+
+  /**
+   * Compute the approximate nearest neighbors of the points in the given query
+   * set.  The matrices will be set to k rows by n columns, where n is the
+   * number of points in the query set.  The queries are searched in parallel.
+   *
+   * @param querySet Set of query points.
+   * @param k Number of neighbors to search for.
+   * @param neighbors Matrix storing lists of neighbors for each query point.
+   * @param distances Matrix storing distances of neighbors for each query
+   *     point.
+   * @param ef Number of closest points kept by the search; if less than k, k
+   *     is used.
+   */
+  void Search(const MatType& querySet,
+              const size_t k,
+              arma::Mat<size_t>& neighbors,
+              arma::mat& distances,
+              const size_t ef = 50);
+
+  /**
+   * Compute the approximate nearest neighbors of each point in the reference
+   * set (not including the point itself).  The matrices will be set to k rows
+   * by n columns, where n is the number of points in the reference set.
+   *
+   * @param k Number of neighbors to search for.
+   * @param neighbors Matrix storing lists of neighbors for each point.
+   * @param distances Matrix storing distances of neighbors for each point.
+   * @param ef Number of closest points kept by the search; if less than k + 1,
+   *     k + 1 is used.
+   */
+  void Search(const size_t k,
+              arma::Mat<size_t>& neighbors,
+              arma::mat& distances,
+              const size_t ef = 50);
+
+  /**
+   * Compute the recall (% of neighbors found) given the neighbors returned by
+   * HNSWSearch::Search() and a "ground truth" set of neighbors.  The recall
+   * returned will be in the range [0, 1].
+   *
+   * @param foundNeighbors Set of neighbors to compute recall of.
+   * @param realNeighbors Set of "ground truth" neighbors to compute recall
+   *     against.
+   */
+  static double ComputeRecall(const arma::Mat<size_t>& foundNeighbors,
+                              const arma::Mat<size_t>& realNeighbors);
+
+  //! Get the number of points in the graph.
+  size_t NumPoints() const { return numPoints; }
+  //! Get the dimensionality of the points (0 if the graph is empty).
+  size_t Dimensionality() const { return referenceSet.n_rows; }
+  //! Get the given point of the graph.
+  arma::Col<typename MatType::elem_type> Point(const size_t i) const
+  { return referenceSet.col(i); }
+
+  //! Get the maximum number of links of a point in the upper layers.
+  size_t MaxNeighbors() const { return maxNeighbors; }
+  //! Get the number of closest points kept when inserting a point.
+  size_t EFConstruction() const { return efConstruction; }
+  //! Get the index of the highest layer.
+  size_t MaxLevel() const { return maxLevel; }
+  //! Get the links of the given point in the given layer.
+  const std::vector<size_t>& Links(const size_t point, const size_t layer)
+      const { return graph[point][layer]; }
+
+  //! Get the instantiated metric.
+  const MetricType& Metric() const { return metric; }
+  //! Modify the instantiated metric.
+  MetricType& Metric() { return metric; }
+
+  /**
+   * Serialize the model.
+   */
+  template<typename Archive>
+  void serialize(Archive& ar, const unsigned int /* version */);
+
+ private:
+  //! A candidate neighbor: (distance, index).
+  typedef std::pair<double, size_t> Candidate;
+
+  /**
+   * Link the point at the given index, which is already stored in the
+   * reference set, into the graph.
+   */
+  void InsertPoint(const size_t index);
+
+  /**
+   * Search the given layer for the ef closest points to the given point.
+   * Points whose entry in visitedTags equals the incremented tag have already
+   * been seen.
+   *
+   * @param point Point to search for.
+   * @param results On input, the entry points; on output, the closest points
+   *     found, sorted by distance.
+   * @param ef Number of closest points to keep.
+   * @param layer Layer to search.
+   * @param visitedTags Tag of the last search that saw each point.
+   * @param tag Tag of the last search; incremented for this search.
+   */
+  template<typename VecType>
+  void SearchLayer(const VecType& point,
+                   std::vector<Candidate>& results,
+                   const size_t ef,
+                   const size_t layer,
+                   std::vector<size_t>& visitedTags,
+                   size_t& tag);
+
+  /**
+   * Search all layers for the ef closest points to the given point in the
+   * bottom layer.
+   */
+  template<typename VecType>
+  void SearchGraph(const VecType& point,
+                   std::vector<Candidate>& results,
+                   const size_t ef,
+                   std::vector<size_t>& visitedTags,
+                   size_t& tag);
+
+  /**
+   * Search for the neighbors of the given queries.  If skipSelf is true, the
+   * queries are the first points of the reference set, and each query is not
+   * returned as its own neighbor.
+   */
+  void SearchQueries(const MatType& querySet,
+                     const size_t numQueries,
+                     const size_t k,
+                     arma::Mat<size_t>& neighbors,
+                     arma::mat& distances,
+                     const size_t ef,
+                     const bool skipSelf);
+
+  /**
+   * Select at most maxCount links from the given candidates, sorted by
+   * distance: a candidate is only kept if it is closer to the point than to
+   * all candidates kept before it, so that the links point in different
+   * directions.
+   */
+  void SelectNeighbors(const std::vector<Candidate>& candidates,
+                       const size_t maxCount,
+                       std::vector<size_t>& selected);
+
+  /**
+   * Add a link from the given neighbor to the given point in the given layer,
+   * and prune the links of the neighbor if there are too many.
+   */
+  void Connect(const size_t point, const size_t neighbor, const size_t layer);
+
+  //! Draw the level of a new point.
+  size_t RandomLevel() const;
+
+  //! Reference points; columns after numPoints are unused capacity.
+  MatType referenceSet;
+  //! The number of points in the graph.
+  size_t numPoints;
+  //! The maximum number of links of a point in the upper layers.
+  size_t maxNeighbors;
+  //! The number of closest points kept when inserting a point.
+  size_t efConstruction;
+  //! The index of the point the searches start from.
+  size_t entryPoint;
+  //! The index of the highest layer.
+  size_t maxLevel;
+  //! The links of each point in each of its layers.
+  std::vector<std::vector<std::vector<size_t>>> graph;
+  //! Instantiated metric.
+  MetricType metric;
+
+  //! Tag of the last insertion search that saw each point.
+  std::vector<size_t> visited;
+  //! Tag of the last insertion search.
+  size_t visitTag;
+}; // class HNSWSearch
+
+} // namespace neighbor
+} // namespace mlpack
+
+// Include implementation.
+#include "hnsw_search_impl.hpp"
+
+#endif
@@ -0,0 +1,436 @@
+/**
+ * @file hnsw_search_impl.hpp
+ *
+ * Implementation of the HNSWSearch class.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_HNSW_HNSW_SEARCH_IMPL_HPP
+#define MLPACK_METHODS_HNSW_HNSW_SEARCH_IMPL_HPP
+
+// In case it hasn't been included yet.
+#include "hnsw_search.hpp"
+
+namespace mlpack {
+namespace neighbor {
+
+template<typename MetricType, typename MatType>
+HNSWSearch<MetricType, MatType>::HNSWSearch(MatType referenceSet,
+                                            const size_t maxNeighbors,
+                                            const size_t efConstruction,
+                                            MetricType metric) :
+    numPoints(0),
+    maxNeighbors(maxNeighbors),
+    efConstruction(efConstruction),
+    entryPoint(0),
+    maxLevel(0),
+    metric(metric),
+    visitTag(0)
+{
+  if (maxNeighbors < 2)
+    throw std::invalid_argument("HNSWSearch::HNSWSearch(): maxNeighbors must "
+        "be at least 2");
+
+  Train(std::move(referenceSet));
+}
+
+template<typename MetricType, typename MatType>
+HNSWSearch<MetricType, MatType>::HNSWSearch(const size_t maxNeighbors,
+                                            const size_t efConstruction,
+                                            MetricType metric) :
+    numPoints(0),
+    maxNeighbors(maxNeighbors),
+    efConstruction(efConstruction),
+    entryPoint(0),
+    maxLevel(0),
+    metric(metric),
+    visitTag(0)
+{
+  if (maxNeighbors < 2)
+    throw std::invalid_argument("HNSWSearch::HNSWSearch(): maxNeighbors must "
+        "be at least 2");
+}
+
+template<typename MetricType, typename MatType>
+void HNSWSearch<MetricType, MatType>::Train(MatType referenceSetIn)
+{
+  referenceSet = std::move(referenceSetIn);
+  numPoints = referenceSet.n_cols;
+  entryPoint = 0;
+  maxLevel = 0;
+
+  graph.clear();
+  graph.reserve(numPoints);
+  visited.assign(numPoints, 0);
+  visitTag = 0;
+
+  for (size_t i = 0; i < numPoints; ++i)
+    InsertPoint(i);
+}
+
+template<typename MetricType, typename MatType>
+template<typename VecType>
+void HNSWSearch<MetricType, MatType>::Insert(const VecType& point)
+{
+  if (numPoints > 0 && point.n_elem != referenceSet.n_rows)
+  {
+    std::ostringstream oss;
+    oss << "HNSWSearch::Insert(): dimensionality of point (" << point.n_elem
+        << ") is not equal to the dimensionality of the graph ("
+        << referenceSet.n_rows << ")!";
+    throw std::invalid_argument(oss.str());
+  }
+
+  // Grow the reference set geometrically, so that inserting points one at a
+  // time does not copy the whole reference set each time.
+  if (numPoints == referenceSet.n_cols)
+  {
+    referenceSet.resize(point.n_elem, std::max(2 * numPoints, (size_t) 16));
+    visited.resize(referenceSet.n_cols, 0);
+  }
+
+  referenceSet.col(numPoints) = point;
+  InsertPoint(numPoints++);
+}
+
+template<typename MetricType, typename MatType>
+void HNSWSearch<MetricType, MatType>::InsertPoint(const size_t index)
+{
+  const size_t level = RandomLevel();
+  graph.push_back(std::vector<std::vector<size_t>>(level + 1));
+
+  if (index == 0)
+  {
+    entryPoint = 0;
+    maxLevel = level;
+    return;
+  }
+
+  // Descend greedily through the layers above the level of the new point.
+  std::vector<Candidate> entries(1, Candidate(metric.Evaluate(
+      referenceSet.col(index), referenceSet.col(entryPoint)), entryPoint));
+  for (size_t layer = maxLevel; layer > level; --layer)
+    SearchLayer(referenceSet.col(index), entries, 1, layer, visited, visitTag);
+
+  // Now link the point in each of its layers, starting from the closest points
+  // found in the layer above.
+  for (size_t layer = std::min(level, maxLevel) + 1; layer > 0; --layer)
+  {
+    SearchLayer(referenceSet.col(index), entries, efConstruction, layer - 1,
+        visited, visitTag);
+
+    std::vector<size_t>& links = graph[index][layer - 1];
+    SelectNeighbors(entries, maxNeighbors, links);
+    for (size_t i = 0; i < links.size(); ++i)
+      Connect(index, links[i], layer - 1);
+  }
+
+  if (level > maxLevel)
+  {
+    maxLevel = level;
+    entryPoint = index;
+  }
+}
+
+template<typename MetricType, typename MatType>
+template<typename VecType>
+void HNSWSearch<MetricType, MatType>::SearchLayer(
+    const VecType& point,
+    std::vector<Candidate>& results,
+    const size_t ef,
+    const size_t layer,
+    std::vector<size_t>& visitedTags,
+    size_t& tag)
+{
+  ++tag;
+
+  // The candidates to expand, closest first, and the closest points found so
+  // far, furthest first.
+  std::priority_queue<Candidate, std::vector<Candidate>,
+      std::greater<Candidate>> candidates;
+  std::priority_queue<Candidate> best;
+  for (size_t i = 0; i < results.size(); ++i)
+  {
+    visitedTags[results[i].second] = tag;
+    candidates.push(results[i]);
+    best.push(results[i]);
+    if (best.size() > ef)
+      best.pop();
+  }
+
+  while (!candidates.empty())
+  {
+    const Candidate current = candidates.top();
+    if (best.size() == ef && current.first > best.top().first)
+      break; // No candidate can improve the results anymore.
+    candidates.pop();
+
+    const std::vector<size_t>& links = graph[current.second][layer];
+    for (size_t i = 0; i < links.size(); ++i)
+    {
+      const size_t neighbor = links[i];
+      if (visitedTags[neighbor] == tag)
+        continue;
+      visitedTags[neighbor] = tag;
+
+      const double distance = metric.Evaluate(point,
+          referenceSet.col(neighbor));
+      if (best.size() < ef || distance < best.top().first)
+      {
+        candidates.push(Candidate(distance, neighbor));
+        best.push(Candidate(distance, neighbor));
+        if (best.size() > ef)
+          best.pop();
+      }
+    }
+  }
+
+  results.resize(best.size());
+  for (size_t i = best.size(); i > 0; --i)
+  {
+    results[i - 1] = best.top();
+    best.pop();
+  }
+}
+
+template<typename MetricType, typename MatType>
+template<typename VecType>
+void HNSWSearch<MetricType, MatType>::SearchGraph(
+    const VecType& point,
+    std::vector<Candidate>& results,
+    const size_t ef,
+    std::vector<size_t>& visitedTags,
+    size_t& tag)
+{
+  results.assign(1, Candidate(metric.Evaluate(point,
+      referenceSet.col(entryPoint)), entryPoint));
+  for (size_t layer = maxLevel; layer > 0; --layer)
+    SearchLayer(point, results, 1, layer, visitedTags, tag);
+
+  SearchLayer(point, results, ef, 0, visitedTags, tag);
+}
+
+template<typename MetricType, typename MatType>
+void HNSWSearch<MetricType, MatType>::Search(const MatType& querySet,
+                                             const size_t k,
+                                             arma::Mat<size_t>& neighbors,
+                                             arma::mat& distances,
+                                             const size_t ef)
+{
+  // Ensure the dimensionality of the query set is correct.
+  if (numPoints > 0 && querySet.n_rows != referenceSet.n_rows)
+  {
+    std::ostringstream oss;
+    oss << "HNSWSearch::Search(): dimensionality of query set ("
+        << querySet.n_rows << ") is not equal to the dimensionality the model "
+        << "was trained on (" << referenceSet.n_rows << ")!" << std::endl;
+    throw std::invalid_argument(oss.str());
+  }
+
+  if (k > numPoints)
+  {
+    std::ostringstream oss;
+    oss << "HNSWSearch::Search(): requested " << k << " approximate nearest "
+        << "neighbors, but reference set has " << numPoints << " points!"
+        << std::endl;
+    throw std::invalid_argument(oss.str());
+  }
+
+  SearchQueries(querySet, querySet.n_cols, k, neighbors, distances,
+      std::max(ef, k), false);
+}
+
+template<typename MetricType, typename MatType>
+void HNSWSearch<MetricType, MatType>::Search(const size_t k,
+                                             arma::Mat<size_t>& neighbors,
+                                             arma::mat& distances,
+                                             const size_t ef)
+{
+  if (k >= numPoints && numPoints > 0)
+  {
+    std::ostringstream oss;
+    oss << "HNSWSearch::Search(): requested " << k << " approximate nearest "
+        << "neighbors, but reference set has " << numPoints << " points!"
+        << std::endl;
+    throw std::invalid_argument(oss.str());
+  }
+
+  SearchQueries(referenceSet, numPoints, k, neighbors, distances,
+      std::max(ef, k + 1), true);
+}
+
+template<typename MetricType, typename MatType>
+void HNSWSearch<MetricType, MatType>::SearchQueries(
+    const MatType& querySet,
+    const size_t numQueries,
+    const size_t k,
+    arma::Mat<size_t>& neighbors,
+    arma::mat& distances,
+    const size_t ef,
+    const bool skipSelf)
+{
+  neighbors.set_size(k, numQueries);
+  distances.set_size(k, numQueries);
+
+  // If the user asked for 0 nearest neighbors... we're done.
+  if (k == 0)
+    return;
+
+  #pragma omp parallel
+  {
+    // Each thread has its own record of the points it has seen.
+    std::vector<size_t> queryVisited(numPoints, 0);
+    size_t queryTag = 0;
+    std::vector<Candidate> results;
+
+    #pragma omp for schedule(dynamic, 16)
+    for (omp_size_t i = 0; i < (omp_size_t) numQueries; ++i)
+    {
+      SearchGraph(querySet.col(i), results, ef, queryVisited, queryTag);
+
+      size_t count = 0;
+      for (size_t j = 0; j < results.size() && count < k; ++j)
+      {
+        if (skipSelf && results[j].second == (size_t) i)
+          continue;
+
+        neighbors(count, i) = results[j].second;
+        distances(count, i) = results[j].first;
+        ++count;
+      }
+
+      // The search may have found fewer than k points.
+      for (; count < k; ++count)
+      {
+        neighbors(count, i) = SIZE_MAX;
+        distances(count, i) = DBL_MAX;
+      }
+    }
+  }
+}
+
+template<typename MetricType, typename MatType>
+void HNSWSearch<MetricType, MatType>::SelectNeighbors(
+    const std::vector<Candidate>& candidates,
+    const size_t maxCount,
+    std::vector<size_t>& selected)
+{
+  selected.clear();
+  for (size_t i = 0; i < candidates.size() && selected.size() < maxCount; ++i)
+  {
+    const size_t candidate = candidates[i].second;
+    bool keep = true;
+    for (size_t j = 0; j < selected.size(); ++j)
+    {
+      if (metric.Evaluate(referenceSet.col(candidate),
+          referenceSet.col(selected[j])) < candidates[i].first)
+      {
+        keep = false;
+        break;
+      }
+    }
+
+    if (keep)
+      selected.push_back(candidate);
+  }
+}
+
+template<typename MetricType, typename MatType>
+void HNSWSearch<MetricType, MatType>::Connect(const size_t point,
+                                              const size_t neighbor,
+                                              const size_t layer)
+{
+  std::vector<size_t>& links = graph[neighbor][layer];
+  links.push_back(point);
+
+  // The bottom layer allows twice as many links.
+  const size_t maxCount = (layer == 0) ? 2 * maxNeighbors : maxNeighbors;
+  if (links.size() <= maxCount)
+    return;
+
+  std::vector<Candidate> candidates(links.size());
+  for (size_t i = 0; i < links.size(); ++i)
+  {
+    candidates[i] = Candidate(metric.Evaluate(referenceSet.col(neighbor),
+        referenceSet.col(links[i])), links[i]);
+  }
+  std::sort(candidates.begin(), candidates.end());
+
+  SelectNeighbors(candidates, maxCount, links);
+}
+
+template<typename MetricType, typename MatType>
+size_t HNSWSearch<MetricType, MatType>::RandomLevel() const
+{
+  // The level is exponentially distributed, with the number of points in each
+  // layer decreasing by a factor of maxNeighbors.
+  const double levelMultiplier = 1.0 / std::log((double) maxNeighbors);
+  return (size_t) std::floor(-std::log(1.0 - math::Random()) *
+      levelMultiplier);
+}
+
+template<typename MetricType, typename MatType>
+double HNSWSearch<MetricType, MatType>::ComputeRecall(
+    const arma::Mat<size_t>& foundNeighbors,
+    const arma::Mat<size_t>& realNeighbors)
+{
+  if (foundNeighbors.n_rows != realNeighbors.n_rows ||
+      foundNeighbors.n_cols != realNeighbors.n_cols)
+    throw std::invalid_argument("HNSWSearch::ComputeRecall(): matrices "
+        "provided must have equal size");
+
+  // The recall is the set intersection of found and real neighbors.
+  size_t found = 0;
+  for (size_t col = 0; col < foundNeighbors.n_cols; ++col)
+    for (size_t row = 0; row < foundNeighbors.n_rows; ++row)
+      for (size_t nei = 0; nei < realNeighbors.n_rows; ++nei)
+        if (realNeighbors(row, col) == foundNeighbors(nei, col))
+        {
+          found++;
+          break;
+        }
+
+  return ((double) found) / realNeighbors.n_elem;
+}
+
+template<typename MetricType, typename MatType>
+template<typename Archive>
+void HNSWSearch<MetricType, MatType>::serialize(
+    Archive& ar,
+    const unsigned int /* version */)
+{
+  // Don't save the unused capacity of the reference set.  The used points are
+  // saved through an alias, so that saving doesn't modify the index.
+  if (Archive::is_saving::value)
+  {
+    MatType usedPoints(referenceSet.memptr(), referenceSet.n_rows, numPoints,
+        false, true);
+    ar & boost::serialization::make_nvp("referenceSet", usedPoints);
+  }
+  else
+  {
+    ar & BOOST_SERIALIZATION_NVP(referenceSet);
+  }
+
+  ar & BOOST_SERIALIZATION_NVP(numPoints);
+  ar & BOOST_SERIALIZATION_NVP(maxNeighbors);
+  ar & BOOST_SERIALIZATION_NVP(efConstruction);
+  ar & BOOST_SERIALIZATION_NVP(entryPoint);
+  ar & BOOST_SERIALIZATION_NVP(maxLevel);
+  ar & BOOST_SERIALIZATION_NVP(graph);
+  ar & BOOST_SERIALIZATION_NVP(metric);
+
+  if (Archive::is_loading::value)
+  {
+    visited.assign(numPoints, 0);
+    visitTag = 0;
+  }
+}
+
+} // namespace neighbor
+} // namespace mlpack
+
+#endif
@@ -161,6 +161,12 @@ class HoeffdingTree
    * Train on a set of points, either in streaming mode or in batch mode, with
    * the given labels.
    *
+   * The points are routed to the leaves of the tree in parallel, and then the
+   * leaves are trained in parallel (or, for a single leaf, the statistics of
+   * each dimension are updated in parallel) with OpenMP.  Split checks are done
+   * after the same points as when the points are given one at a time with
+   * Train(point, label), so the resulting tree is the same.
+   *
    * @param data Data points to train on.
    * @param label Labels of data points.
    * @param batchTraining If true, perform training in batch.
@@ -355,6 +361,37 @@ class HoeffdingTree
   typename NumericSplitType<FitnessFunction>::SplitInfo numericSplit;
   //! If the split has occurred, these are the children.
   std::vector<HoeffdingTree*> children;
+
+  /**
+   * Train in streaming mode on the given points of the dataset, in the given
+   * order.  Each point is routed to its leaf, and then every leaf is trained
+   * on its points with TrainLeaf().  Since a leaf (and the subtree it grows) is
+   * only changed by its own points, this gives the same tree as training on
+   * the points one at a time.
+   *
+   * @param data Dataset to train on.
+   * @param labels Labels of the points of the dataset.
+   * @param indices Indices of the points to train on.
+   */
+  template<typename MatType>
+  void TrainStream(const MatType& data,
+                   const arma::Row<size_t>& labels,
+                   const std::vector<size_t>& indices);
+
+  /**
+   * Train this leaf in streaming mode on the given points of the dataset, in
+   * the given order.  The statistics of all dimensions are updated for all
+   * points up to the next split check at once; if the leaf splits, the rest of
+   * the points are passed to TrainStream().
+   *
+   * @param data Dataset to train on.
+   * @param labels Labels of the points of the dataset.
+   * @param indices Indices of the points to train on.
+   */
+  template<typename MatType>
+  void TrainLeaf(const MatType& data,
+                 const arma::Row<size_t>& labels,
+                 const std::vector<size_t>& indices);
 };
 
 } // namespace tree
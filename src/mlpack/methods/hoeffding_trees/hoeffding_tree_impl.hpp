@@ -258,8 +258,10 @@ void HoeffdingTree<
     // Don't split if there are fewer than five points.
     size_t oldMaxSamples = maxSamples;
     maxSamples = std::max(size_t(data.n_cols - 1), size_t(5));
+    std::vector<size_t> indices(data.n_cols);
     for (size_t i = 0; i < data.n_cols; ++i)
-      Train(data.col(i), labels[i]);
+      indices[i] = i;
+    TrainStream(data, labels, indices);
     maxSamples = oldMaxSamples;
 
     // Now, if we did split, find out which points go to which child, and
@@ -310,9 +312,11 @@ void HoeffdingTree<
   }
   else
   {
-    // We aren't training in batch mode; loop through the points.
+    // We aren't training in batch mode; stream the points in order.
+    std::vector<size_t> indices(data.n_cols);
     for (size_t i = 0; i < data.n_cols; ++i)
-      Train(data.col(i), labels[i]);
+      indices[i] = i;
+    TrainStream(data, labels, indices);
   }
 }
 
@@ -429,6 +433,139 @@ void HoeffdingTree<
   }
 }
 
+//! Train on a set of points in streaming mode.
+template<typename FitnessFunction,
+         template<typename> class NumericSplitType,
+         template<typename> class CategoricalSplitType>
+template<typename MatType>
+void HoeffdingTree<
+    FitnessFunction,
+    NumericSplitType,
+    CategoricalSplitType
+>::TrainStream(const MatType& data,
+               const arma::Row<size_t>& labels,
+               const std::vector<size_t>& indices)
+{
+  if (indices.empty())
+    return;
+
+  // Find the leaf of each point.
+  std::vector<HoeffdingTree*> pointLeaves(indices.size());
+  #pragma omp parallel for if (!omp_in_parallel())
+  for (omp_size_t i = 0; i < (omp_size_t) indices.size(); ++i)
+  {
+    HoeffdingTree* node = this;
+    while (!node->children.empty())
+    {
+      node = node->children[node->CalculateDirection(
+          data.col(indices[i]))];
+    }
+    pointLeaves[i] = node;
+  }
+
+  // Collect the points of each leaf, keeping their order.
+  std::unordered_map<HoeffdingTree*, size_t> leafIndices;
+  std::vector<HoeffdingTree*> leaves;
+  std::vector<std::vector<size_t>> leafPoints;
+  for (size_t i = 0; i < indices.size(); ++i)
+  {
+    std::unordered_map<HoeffdingTree*, size_t>::const_iterator it =
+        leafIndices.find(pointLeaves[i]);
+    if (it == leafIndices.end())
+    {
+      it = leafIndices.insert(std::make_pair(pointLeaves[i],
+          leaves.size())).first;
+      leaves.push_back(pointLeaves[i]);
+      leafPoints.push_back(std::vector<size_t>());
+    }
+
+    leafPoints[it->second].push_back(indices[i]);
+  }
+
+  // Now train the leaves.  They share no statistics, so this can be done in
+  // parallel.  If there is only one leaf, the parallelism is used inside the
+  // leaf instead.
+  #pragma omp parallel for schedule(dynamic) \
+      if (leaves.size() > 1 && !omp_in_parallel())
+  for (omp_size_t i = 0; i < (omp_size_t) leaves.size(); ++i)
+    leaves[i]->TrainLeaf(data, labels, leafPoints[i]);
+}
+
+//! Train a leaf on a set of points in streaming mode.
+template<typename FitnessFunction,
+         template<typename> class NumericSplitType,
+         template<typename> class CategoricalSplitType>
+template<typename MatType>
+void HoeffdingTree<
+    FitnessFunction,
+    NumericSplitType,
+    CategoricalSplitType
+>::TrainLeaf(const MatType& data,
+             const arma::Row<size_t>& labels,
+             const std::vector<size_t>& indices)
+{
+  size_t start = 0;
+  while (start < indices.size() && splitDimension == size_t(-1))
+  {
+    // Take all the points up to the next split check.
+    const size_t end = std::min(indices.size(),
+        start + checkInterval - (numSamples % checkInterval));
+
+    // The statistics of each dimension only depend on the values in that
+    // dimension, so the dimensions can be updated independently.
+    #pragma omp parallel for if (!omp_in_parallel())
+    for (omp_size_t d = 0; d < (omp_size_t) data.n_rows; ++d)
+    {
+      const std::pair<size_t, size_t>& mapping = dimensionMappings->at(d);
+      for (size_t i = start; i < end; ++i)
+      {
+        if (mapping.first == data::Datatype::categorical)
+        {
+          categoricalSplits[mapping.second].Train(data(d, indices[i]),
+              labels[indices[i]]);
+        }
+        else
+        {
+          numericSplits[mapping.second].Train(data(d, indices[i]),
+              labels[indices[i]]);
+        }
+      }
+    }
+    numSamples += end - start;
+    start = end;
+
+    // Grab majority class from splits.
+    if (categoricalSplits.size() > 0)
+    {
+      majorityClass = categoricalSplits[0].MajorityClass();
+      majorityProbability = categoricalSplits[0].MajorityProbability();
+    }
+    else
+    {
+      majorityClass = numericSplits[0].MajorityClass();
+      majorityProbability = numericSplits[0].MajorityProbability();
+    }
+
+    // Check for a split, if we should.
+    if (numSamples % checkInterval == 0)
+    {
+      const size_t numChildren = SplitCheck();
+      if (numChildren > 0)
+      {
+        children.clear();
+        CreateChildren();
+      }
+    }
+  }
+
+  // If we split, the rest of the points go to the new children.
+  if (start < indices.size())
+  {
+    TrainStream(data, labels, std::vector<size_t>(indices.begin() + start,
+        indices.end()));
+  }
+}
+
 template<typename FitnessFunction,
          template<typename> class NumericSplitType,
          template<typename> class CategoricalSplitType>
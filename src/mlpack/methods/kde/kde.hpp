@@ -347,6 +347,30 @@ class KDE
   //! Rearrange estimations vector if required.
   static void RearrangeEstimations(const std::vector<size_t>& oldFromNew,
                                    arma::vec& estimations);
+
+  /**
+   * Run the dual-tree traversal of the given query tree against the reference
+   * tree with the given rules.  If OpenMP is available, the upper levels of the
+   * query tree are split into disjoint subtrees that are traversed in parallel,
+   * each with its own rules object.
+   *
+   * @param queryTree Query tree to traverse.
+   * @param rules Rules to use for the traversal.
+   */
+  template<typename RuleType>
+  void DualTreeTraversal(Tree& queryTree, RuleType& rules);
+
+  /**
+   * Run the single-tree traversal of the reference tree for each of the given
+   * number of query points with the given rules.  If OpenMP is available, the
+   * query points are split into blocks that are traversed in parallel, each
+   * with its own rules object.
+   *
+   * @param numQueries Number of query points.
+   * @param rules Rules to use for the traversal.
+   */
+  template<typename RuleType>
+  void SingleTreeTraversal(const size_t numQueries, RuleType& rules);
 };
 
 } // namespace kde
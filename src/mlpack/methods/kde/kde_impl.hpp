@@ -13,6 +13,8 @@
 #include "kde.hpp"
 #include "kde_rules.hpp"
 
+#include <mlpack/core/tree/query_subtrees.hpp>
+
 namespace mlpack {
 namespace kde {
 
@@ -381,26 +383,22 @@ Evaluate(MatType querySet, arma::vec& estimations)
 
     // Evaluate.
     typedef KDERules<MetricType, KernelType, Tree> RuleType;
-    RuleType rules = RuleType(referenceTree->Dataset(),
-                              querySet,
-                              estimations,
-                              relError,
-                              absError,
-                              mcProb,
-                              initialSampleSize,
-                              mcEntryCoef,
-                              mcBreakCoef,
-                              metric,
-                              kernel,
-                              monteCarlo,
-                              false);
-
-    // Create traverser.
-    SingleTreeTraversalType<RuleType> traverser(rules);
+    RuleType rules(referenceTree->Dataset(),
+                   querySet,
+                   estimations,
+                   relError,
+                   absError,
+                   mcProb,
+                   initialSampleSize,
+                   mcEntryCoef,
+                   mcBreakCoef,
+                   metric,
+                   kernel,
+                   monteCarlo,
+                   false);
 
     // Traverse for each point.
-    for (size_t i = 0; i < querySet.n_cols; ++i)
-      traverser.Traverse(i, *referenceTree);
+    SingleTreeTraversal(querySet.n_cols, rules);
 
     estimations /= referenceTree->Dataset().n_cols;
     Timer::Stop("computing_kde");
@@ -479,23 +477,21 @@ Evaluate(Tree* queryTree,
 
   // Evaluate.
   typedef KDERules<MetricType, KernelType, Tree> RuleType;
-  RuleType rules = RuleType(referenceTree->Dataset(),
-                            queryTree->Dataset(),
-                            estimations,
-                            relError,
-                            absError,
-                            mcProb,
-                            initialSampleSize,
-                            mcEntryCoef,
-                            mcBreakCoef,
-                            metric,
-                            kernel,
-                            monteCarlo,
-                            false);
-
-  // Create traverser.
-  DualTreeTraversalType<RuleType> traverser(rules);
-  traverser.Traverse(*queryTree, *referenceTree);
+  RuleType rules(referenceTree->Dataset(),
+                 queryTree->Dataset(),
+                 estimations,
+                 relError,
+                 absError,
+                 mcProb,
+                 initialSampleSize,
+                 mcEntryCoef,
+                 mcBreakCoef,
+                 metric,
+                 kernel,
+                 monteCarlo,
+                 false);
+
+  DualTreeTraversal(*queryTree, rules);
   estimations /= referenceTree->Dataset().n_cols;
   Timer::Stop("computing_kde");
 
@@ -548,32 +544,24 @@ Evaluate(arma::vec& estimations)
 
   // Evaluate.
   typedef KDERules<MetricType, KernelType, Tree> RuleType;
-  RuleType rules = RuleType(referenceTree->Dataset(),
-                            referenceTree->Dataset(),
-                            estimations,
-                            relError,
-                            absError,
-                            mcProb,
-                            initialSampleSize,
-                            mcEntryCoef,
-                            mcBreakCoef,
-                            metric,
-                            kernel,
-                            monteCarlo,
-                            true);
+  RuleType rules(referenceTree->Dataset(),
+                 referenceTree->Dataset(),
+                 estimations,
+                 relError,
+                 absError,
+                 mcProb,
+                 initialSampleSize,
+                 mcEntryCoef,
+                 mcBreakCoef,
+                 metric,
+                 kernel,
+                 monteCarlo,
+                 true);
 
   if (mode == DUAL_TREE_MODE)
-  {
-    // Create traverser.
-    DualTreeTraversalType<RuleType> traverser(rules);
-    traverser.Traverse(*referenceTree, *referenceTree);
-  }
+    DualTreeTraversal(*referenceTree, rules);
   else if (mode == SINGLE_TREE_MODE)
-  {
-    SingleTreeTraversalType<RuleType> traverser(rules);
-    for (size_t i = 0; i < referenceTree->Dataset().n_cols; ++i)
-      traverser.Traverse(i, *referenceTree);
-  }
+    SingleTreeTraversal(referenceTree->Dataset().n_cols, rules);
 
   estimations /= referenceTree->Dataset().n_cols;
   // Rearrange if necessary.
@@ -816,5 +804,144 @@ RearrangeEstimations(const std::vector<size_t>& oldFromNew,
   }
 }
 
+template<typename KernelType,
+         typename MetricType,
+         typename MatType,
+         template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType,
+         template<typename> class DualTreeTraversalType,
+         template<typename> class SingleTreeTraversalType>
+template<typename RuleType>
+void KDE<KernelType,
+         MetricType,
+         MatType,
+         TreeType,
+         DualTreeTraversalType,
+         SingleTreeTraversalType>::
+DualTreeTraversal(Tree& queryTree, RuleType& rules)
+{
+  size_t numThreads = 1;
+  #ifdef HAS_OPENMP
+    numThreads = omp_get_max_threads();
+  #endif
+
+  // Query subtrees can only be traversed independently if each query point
+  // belongs to exactly one subtree.
+  if (numThreads == 1 || !tree::HasIndependentSubtrees<Tree>::value)
+  {
+    DualTreeTraversalType<RuleType> traverser(rules);
+    traverser.Traverse(queryTree, *referenceTree);
+    return;
+  }
+
+  // Split the query tree into enough subtrees to balance the work between all
+  // threads.
+  std::vector<Tree*> subtrees;
+  tree::SplitQuerySubtrees(queryTree, 8 * numThreads, subtrees);
+
+  // All threads read the Monte Carlo alpha of the reference nodes, so it is
+  // calculated beforehand.
+  if (monteCarlo && std::is_same<KernelType, kernel::GaussianKernel>::value)
+    rules.CalculateTreeAlpha(*referenceTree);
+
+  // Each subtree draws its Monte Carlo samples from its own generator.  The
+  // seeds are taken from the mlpack generator, so the results still only
+  // depend on the mlpack random seed (and the number of threads).
+  std::vector<std::mt19937::result_type> seeds(subtrees.size());
+  for (size_t i = 0; i < subtrees.size(); ++i)
+    seeds[i] = math::randGen();
+
+  // Every subtree is traversed against the whole reference tree with its own
+  // rules object, which shares the densities with the other rules objects.
+  // The error tolerance and Monte Carlo alpha are accumulated in the
+  // statistics of the query nodes, which belong to exactly one subtree, so
+  // each subtree keeps the error guarantees for its points.  Subtrees vary a
+  // lot in cost, so they are handed out dynamically.
+  size_t subtreeBaseCases = 0;
+  size_t subtreeScores = 0;
+  #pragma omp parallel for schedule(dynamic) \
+      reduction(+:subtreeBaseCases, subtreeScores)
+  for (omp_size_t i = 0; i < (omp_size_t) subtrees.size(); ++i)
+  {
+    std::mt19937 generator(seeds[i]);
+    RuleType subtreeRules(rules, generator);
+    DualTreeTraversalType<RuleType> traverser(subtreeRules);
+    traverser.Traverse(*subtrees[i], *referenceTree);
+
+    subtreeBaseCases += subtreeRules.BaseCases();
+    subtreeScores += subtreeRules.Scores();
+  }
+
+  rules.BaseCases() += subtreeBaseCases;
+  rules.Scores() += subtreeScores;
+}
+
+template<typename KernelType,
+         typename MetricType,
+         typename MatType,
+         template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType,
+         template<typename> class DualTreeTraversalType,
+         template<typename> class SingleTreeTraversalType>
+template<typename RuleType>
+void KDE<KernelType,
+         MetricType,
+         MatType,
+         TreeType,
+         DualTreeTraversalType,
+         SingleTreeTraversalType>::
+SingleTreeTraversal(const size_t numQueries, RuleType& rules)
+{
+  size_t numThreads = 1;
+  #ifdef HAS_OPENMP
+    numThreads = omp_get_max_threads();
+  #endif
+
+  if (numThreads == 1 || numQueries < 2)
+  {
+    SingleTreeTraversalType<RuleType> traverser(rules);
+    for (size_t i = 0; i < numQueries; ++i)
+      traverser.Traverse(i, *referenceTree);
+    return;
+  }
+
+  // All threads read the Monte Carlo alpha of the reference nodes, so it is
+  // calculated beforehand.
+  if (monteCarlo && std::is_same<KernelType, kernel::GaussianKernel>::value)
+    rules.CalculateTreeAlpha(*referenceTree);
+
+  // The traversal of each query point is independent of the others, so the
+  // query points are split into contiguous blocks, each with its own rules
+  // object and Monte Carlo generator (see DualTreeTraversal()).
+  const size_t numBlocks = std::min(8 * numThreads, numQueries);
+  std::vector<std::mt19937::result_type> seeds(numBlocks);
+  for (size_t i = 0; i < numBlocks; ++i)
+    seeds[i] = math::randGen();
+
+  size_t blockBaseCases = 0;
+  size_t blockScores = 0;
+  #pragma omp parallel for schedule(dynamic) \
+      reduction(+:blockBaseCases, blockScores)
+  for (omp_size_t b = 0; b < (omp_size_t) numBlocks; ++b)
+  {
+    std::mt19937 generator(seeds[b]);
+    RuleType blockRules(rules, generator);
+    SingleTreeTraversalType<RuleType> traverser(blockRules);
+
+    const size_t begin = b * numQueries / numBlocks;
+    const size_t end = (b + 1) * numQueries / numBlocks;
+    for (size_t i = begin; i < end; ++i)
+      traverser.Traverse(i, *referenceTree);
+
+    blockBaseCases += blockRules.BaseCases();
+    blockScores += blockRules.Scores();
+  }
+
+  rules.BaseCases() += blockBaseCases;
+  rules.Scores() += blockScores;
+}
+
 } // namespace kde
 } // namespace mlpack
@@ -14,6 +14,7 @@
 #define MLPACK_METHODS_KDE_RULES_HPP
 
 #include <mlpack/core/tree/traversal_info.hpp>
+#include <mlpack/core/metrics/batch_distances.hpp>
 
 namespace mlpack {
 namespace kde {
@@ -60,9 +61,47 @@ class KDERules
            const bool monteCarlo,
            const bool sameSet);
 
+  /**
+   * Construct KDERules for a part of the query points of the given KDERules
+   * object.  The densities and the accumulated error tolerance and Monte Carlo
+   * alpha of each query point are shared with the other object, not copied, so
+   * several KDERules objects can work on the same query set, as long as each
+   * query point (or query node) is only ever handled by one of them.  This is
+   * used by the parallel evaluation, where each thread handles its own part of
+   * the query set.
+   *
+   * @param other KDERules object to share the query point state with.
+   * @param generator Random number generator to use for Monte Carlo
+   *                  estimations, instead of the global mlpack generator.
+   */
+  KDERules(KDERules& other, std::mt19937& generator);
+
+  /**
+   * Calculate the Monte Carlo alpha of the given node and all its descendants.
+   * After this, the traversal only reads the alpha of the reference nodes, so
+   * several threads can traverse the same reference tree.
+   *
+   * @param node Root of the tree to calculate the alpha of.
+   */
+  void CalculateTreeAlpha(TreeType& node);
+
   //! Base Case.
   double BaseCase(const size_t queryIndex, const size_t referenceIndex);
 
+  /**
+   * Perform the base cases between the query point and each of the given
+   * consecutive reference points, like calling BaseCase() for each of them.
+   * If the metric is an LMetric, all the distances are computed in one batch
+   * with LMetric::BatchEvaluate().
+   *
+   * @param queryIndex Index of query point.
+   * @param referenceBegin Index of the first reference point.
+   * @param referenceCount Number of reference points.
+   */
+  void BatchBaseCase(const size_t queryIndex,
+                     const size_t referenceBegin,
+                     const size_t referenceCount);
+
   //! SingleTree Rescore.
   double Score(const size_t queryIndex, TreeType& referenceNode);
 
@@ -89,11 +128,18 @@ class KDERules
 
   //! Get the number of base cases.
   size_t BaseCases() const { return baseCases; }
+  //! Modify the number of base cases.
+  size_t& BaseCases() { return baseCases; }
 
   //! Get the number of scores.
   size_t Scores() const { return scores; }
+  //! Modify the number of scores.
+  size_t& Scores() { return scores; }
 
  private:
+  //! Return a random index in [lo, hiExclusive) for Monte Carlo sampling.
+  size_t RandomIndex(const size_t lo, const size_t hiExclusive);
+
   //! Evaluate kernel value of 2 points given their indexes.
   double EvaluateKernel(const size_t queryIndex,
                         const size_t referenceIndex) const;
@@ -145,11 +191,19 @@ class KDERules
   //! Whether Monte Carlo estimations are going to be applied.
   const bool monteCarlo;
 
+  //! Storage for the accumulated Monte Carlo alpha values of each query point,
+  //! if they are not shared with another KDERules object.
+  arma::vec accumMCAlphaStorage;
+
   //! Accumulated not used MC alpha values for each query point.
-  arma::vec accumMCAlpha;
+  arma::vec& accumMCAlpha;
+
+  //! Storage for the accumulated error tolerance of each query point, if it is
+  //! not shared with another KDERules object.
+  arma::vec accumErrorStorage;
 
   //! Accumulated not used error tolerance for each query point.
-  arma::vec accumError;
+  arma::vec& accumError;
 
   //! Whether reference and query sets are the same.
   const bool sameSet;
@@ -167,6 +221,13 @@ class KDERules
   //! The last reference index.
   size_t lastReferenceIndex;
 
+  //! The distances computed by the last call to BatchBaseCase().
+  arma::vec batchDistances;
+
+  //! Random number generator for Monte Carlo estimations (if NULL, the global
+  //! mlpack generator is used).
+  std::mt19937* generator;
+
   //! Traversal information.
   TraversalInfoType traversalInfo;
 
@@ -49,10 +49,13 @@ KDERules<MetricType, KernelType, TreeType>::KDERules(
     metric(metric),
     kernel(kernel),
     monteCarlo(monteCarlo),
+    accumMCAlpha(accumMCAlphaStorage),
+    accumError(accumErrorStorage),
     sameSet(sameSet),
     absErrorTol(absError / referenceSet.n_cols),
     lastQueryIndex(querySet.n_cols),
     lastReferenceIndex(referenceSet.n_cols),
+    generator(NULL),
     baseCases(0),
     scores(0)
 {
@@ -64,6 +67,44 @@ KDERules<MetricType, KernelType, TreeType>::KDERules(
     accumMCAlpha = arma::vec(querySet.n_cols, arma::fill::zeros);
 }
 
+template<typename MetricType, typename KernelType, typename TreeType>
+KDERules<MetricType, KernelType, TreeType>::KDERules(
+    KDERules& other,
+    std::mt19937& generator) :
+    referenceSet(other.referenceSet),
+    querySet(other.querySet),
+    densities(other.densities),
+    absError(other.absError),
+    relError(other.relError),
+    mcBeta(other.mcBeta),
+    initialSampleSize(other.initialSampleSize),
+    mcAccessCoef(other.mcAccessCoef),
+    mcBreakCoef(other.mcBreakCoef),
+    metric(other.metric),
+    kernel(other.kernel),
+    monteCarlo(other.monteCarlo),
+    accumMCAlpha(other.accumMCAlpha),
+    accumError(other.accumError),
+    sameSet(other.sameSet),
+    absErrorTol(other.absErrorTol),
+    lastQueryIndex(querySet.n_cols),
+    lastReferenceIndex(referenceSet.n_cols),
+    generator(&generator),
+    baseCases(0),
+    scores(0)
+{
+  // Nothing to do.
+}
+
+template<typename MetricType, typename KernelType, typename TreeType>
+void KDERules<MetricType, KernelType, TreeType>::CalculateTreeAlpha(
+    TreeType& node)
+{
+  CalculateAlpha(&node);
+  for (size_t i = 0; i < node.NumChildren(); ++i)
+    CalculateTreeAlpha(node.Child(i));
+}
+
 //! The base case.
 template<typename MetricType, typename KernelType, typename TreeType>
 inline force_inline
@@ -96,6 +137,41 @@ double KDERules<MetricType, KernelType, TreeType>::BaseCase(
   return distance;
 }
 
+template<typename MetricType, typename KernelType, typename TreeType>
+void KDERules<MetricType, KernelType, TreeType>::BatchBaseCase(
+    const size_t queryIndex,
+    const size_t referenceBegin,
+    const size_t referenceCount)
+{
+  if (referenceCount == 0)
+    return;
+
+  metric::BatchDistances(metric, querySet, referenceSet, queryIndex,
+      referenceBegin, referenceCount, batchDistances);
+
+  for (size_t i = 0; i < referenceCount; ++i)
+  {
+    const size_t referenceIndex = referenceBegin + i;
+    if (sameSet && (queryIndex == referenceIndex))
+      continue;
+
+    // Avoid duplicated calculations.
+    if ((lastQueryIndex == queryIndex) &&
+        (lastReferenceIndex == referenceIndex))
+      continue;
+
+    const double kernelValue = kernel.Evaluate(batchDistances[i]);
+    densities(queryIndex) += kernelValue;
+    accumError(queryIndex) += 2 * relError * kernelValue;
+    ++baseCases;
+  }
+
+  // Cache the last base case, as BaseCase() would.
+  lastQueryIndex = queryIndex;
+  lastReferenceIndex = referenceBegin + referenceCount - 1;
+  traversalInfo.LastBaseCase() = batchDistances[referenceCount - 1];
+}
+
 //! Single-tree scoring function.
 template<typename MetricType, typename KernelType, typename TreeType>
 inline double KDERules<MetricType, KernelType, TreeType>::
@@ -222,9 +298,9 @@ Score(const size_t queryIndex, TreeType& referenceNode)
         // Sample and evaluate random points from the reference node.
         size_t randomPoint;
         if (alreadyDidRefPoint0)
-          randomPoint = math::RandInt(1, refNumDesc);
+          randomPoint = RandomIndex(1, refNumDesc);
         else
-          randomPoint = math::RandInt(0, refNumDesc);
+          randomPoint = RandomIndex(0, refNumDesc);
 
         sample(oldSize + i) =
             EvaluateKernel(queryIndex, referenceNode.Descendant(randomPoint));
@@ -439,9 +515,9 @@ Score(TreeType& queryNode, TreeType& referenceNode)
           // Sample and evaluate random points from the reference node.
           size_t randomPoint;
           if (alreadyDidRefPoint0)
-            randomPoint = math::RandInt(1, refNumDesc);
+            randomPoint = RandomIndex(1, refNumDesc);
           else
-            randomPoint = math::RandInt(0, refNumDesc);
+            randomPoint = RandomIndex(0, refNumDesc);
 
           sample(oldSize + i) =
               EvaluateKernel(queryIndex, referenceNode.Descendant(randomPoint));
@@ -573,6 +649,17 @@ CalculateAlpha(TreeType* node)
   return stat.MCAlpha();
 }
 
+template<typename MetricType, typename KernelType, typename TreeType>
+inline force_inline size_t KDERules<MetricType, KernelType, TreeType>::
+RandomIndex(const size_t lo, const size_t hiExclusive)
+{
+  if (generator == NULL)
+    return math::RandInt(lo, hiExclusive);
+
+  std::uniform_int_distribution<size_t> distribution(lo, hiExclusive - 1);
+  return distribution(*generator);
+}
+
 //! Clean rules base case.
 template<typename TreeType>
 inline force_inline
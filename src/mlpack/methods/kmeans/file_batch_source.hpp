@@ -0,0 +1,76 @@
+/**
+ * @file file_batch_source.hpp
+ *
+ * A batch source for mini-batch k-means that loads one file at a time.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_KMEANS_FILE_BATCH_SOURCE_HPP
+#define MLPACK_METHODS_KMEANS_FILE_BATCH_SOURCE_HPP
+
+#include <mlpack/prereqs.hpp>
+#include <mlpack/core/data/load.hpp>
+
+namespace mlpack {
+namespace kmeans {
+
+/**
+ * FileBatchSource gives the points of a dataset that is split over several
+ * files to KMeans::MiniBatchCluster(), one file per batch.  Each file is loaded
+ * with data::Load() when its batch is needed, so only one file is in memory at
+ * a time.  A file that can't be loaded gives an exception.
+ */
+class FileBatchSource
+{
+ public:
+  /**
+   * Create the batch source on the given files.
+   *
+   * @param filenames Names of the files to load, in order.
+   * @param transpose If true, transpose the matrices after loading (see
+   *     data::Load()).
+   */
+  FileBatchSource(const std::vector<std::string>& filenames,
+                  const bool transpose = true) :
+      filenames(filenames),
+      transpose(transpose),
+      position(0)
+  { }
+
+  /**
+   * Load the next file into the given matrix.  Returns false if there are no
+   * more files.
+   *
+   * @param batch Matrix to load the file into.
+   */
+  bool operator()(arma::mat& batch)
+  {
+    if (position >= filenames.size())
+      return false;
+
+    data::Load(filenames[position++], batch, true, transpose);
+    return true;
+  }
+
+  //! Start again from the first file.
+  void Reset() { position = 0; }
+
+  //! Get the names of the files.
+  const std::vector<std::string>& Filenames() const { return filenames; }
+
+ private:
+  //! The names of the files.
+  std::vector<std::string> filenames;
+  //! Whether to transpose the matrices after loading.
+  bool transpose;
+  //! The index of the next file.
+  size_t position;
+};
+
+} // namespace kmeans
+} // namespace mlpack
+
+#endif
@@ -18,6 +18,8 @@
 #include "sample_initialization.hpp"
 #include "max_variance_new_cluster.hpp"
 #include "naive_kmeans.hpp"
+#include "matrix_batch_source.hpp"
+#include "file_batch_source.hpp"
 
 #include <mlpack/core/tree/binary_space_tree.hpp>
 
@@ -155,6 +157,39 @@ class KMeans
                const bool initialAssignmentGuess = false,
                const bool initialCentroidGuess = false);
 
+  /**
+   * Perform mini-batch k-means clustering on data that is given in batches,
+   * returning the centroids of each cluster in the centroids matrix.  Only one
+   * batch is held in memory at a time, so this can cluster datasets that don't
+   * fit in memory.
+   *
+   * The batches are taken from the given source until it has no more points,
+   * or until MaxIterations() batches have been used (0 means no limit).  The
+   * source must be callable as bool source(arma::mat& batch); it stores the
+   * next batch (one point per column) in the given matrix, and returns false
+   * if there are no more points.  MatrixBatchSource and FileBatchSource can be
+   * used for matrices and lists of files; a lambda works too.
+   *
+   * The points of each batch are assigned to their closest centroid with one
+   * step of LloydStepType.  Each centroid then moves towards the points
+   * assigned to it with its own learning rate of 1 / (number of points
+   * assigned to it so far), so that it is the mean of all these points.  The
+   * InitialPartitionPolicy is used on the first batch (unless initialGuess is
+   * true), and the EmptyClusterPolicy is used on clusters that have not been
+   * assigned any points yet after a batch.
+   *
+   * @param source Source of the batches.
+   * @param clusters Number of clusters to compute.
+   * @param centroids Matrix in which centroids are stored.
+   * @param initialGuess If true, then it is assumed that centroids contains the
+   *      initial cluster centroids.
+   */
+  template<typename BatchSourceType>
+  void MiniBatchCluster(BatchSourceType&& source,
+                        const size_t clusters,
+                        arma::mat& centroids,
+                        const bool initialGuess = false);
+
   //! Get the maximum number of iterations.
   size_t MaxIterations() const { return maxIterations; }
   //! Set the maximum number of iterations.
@@ -337,6 +337,138 @@ Cluster(const MatType& data,
   }
 }
 
+/**
+ * Perform mini-batch k-means clustering on data that is given in batches,
+ * returning the centroids of each cluster.
+ */
+template<typename MetricType,
+         typename InitialPartitionPolicy,
+         typename EmptyClusterPolicy,
+         template<class, class> class LloydStepType,
+         typename MatType>
+template<typename BatchSourceType>
+void KMeans<
+    MetricType,
+    InitialPartitionPolicy,
+    EmptyClusterPolicy,
+    LloydStepType,
+    MatType>::
+MiniBatchCluster(BatchSourceType&& source,
+                 const size_t clusters,
+                 arma::mat& centroids,
+                 const bool initialGuess)
+{
+  if (clusters == 0)
+    Log::Warn << "KMeans::MiniBatchCluster(): zero clusters requested.  This "
+        << "probably isn't going to work.  Brace for crash." << std::endl;
+
+  arma::mat batch;
+  if (!source(batch))
+  {
+    if (!initialGuess)
+      Log::Fatal << "KMeans::MiniBatchCluster(): no data given!" << std::endl;
+
+    return;
+  }
+
+  // Check validity of initial guess.
+  if (initialGuess)
+  {
+    if (centroids.n_cols != clusters)
+      Log::Fatal << "KMeans::MiniBatchCluster(): wrong number of initial "
+        << "cluster centroids (" << centroids.n_cols << ", should be "
+        << clusters << ")!" << std::endl;
+  }
+  else
+  {
+    // Use the partitioner on the first batch to come up with the initial
+    // centroids.
+    if (clusters > batch.n_cols)
+      Log::Warn << "KMeans::MiniBatchCluster(): more clusters requested than "
+          << "points in the first batch." << std::endl;
+
+    arma::Row<size_t> assignments;
+    bool gotAssignments = GetInitialAssignmentsOrCentroids(partitioner, batch,
+        clusters, assignments, centroids);
+    if (gotAssignments)
+    {
+      // The partitioner gives assignments, so we need to calculate centroids
+      // from those assignments.
+      arma::Row<size_t> counts;
+      counts.zeros(clusters);
+      centroids.zeros(batch.n_rows, clusters);
+      for (size_t i = 0; i < batch.n_cols; ++i)
+      {
+        centroids.col(assignments[i]) += batch.col(i);
+        counts[assignments[i]]++;
+      }
+
+      for (size_t i = 0; i < clusters; ++i)
+        if (counts[i] != 0)
+          centroids.col(i) /= counts[i];
+    }
+  }
+
+  // Number of points assigned to each cluster so far.
+  arma::Col<size_t> counts(clusters, arma::fill::zeros);
+
+  size_t iteration = 0;
+  size_t distanceCalculations = 0;
+  arma::mat oldCentroids, batchCentroids;
+  arma::Col<size_t> batchCounts;
+
+  do
+  {
+    if (batch.n_rows != centroids.n_rows)
+      Log::Fatal << "KMeans::MiniBatchCluster(): batch " << iteration << " has "
+          << "wrong dimensionality (" << batch.n_rows << ", should be "
+          << centroids.n_rows << ")!" << std::endl;
+
+    // Find the mean of the points of the batch that are closest to each
+    // centroid.
+    oldCentroids = centroids;
+    LloydStepType<MetricType, arma::mat> lloydStep(batch, metric);
+    lloydStep.Iterate(oldCentroids, batchCentroids, batchCounts);
+    distanceCalculations += lloydStep.DistanceCalculations();
+
+    // Move each centroid towards the mean of its points in the batch, with a
+    // learning rate of 1 / (number of points assigned to it so far).  This is
+    // the same as moving it towards each point in turn with that rate.
+    double cNorm = 0.0;
+    for (size_t i = 0; i < centroids.n_cols; ++i)
+    {
+      if (batchCounts[i] == 0)
+        continue;
+
+      counts[i] += batchCounts[i];
+      const double rate = double(batchCounts[i]) / double(counts[i]);
+      centroids.col(i) += rate * (batchCentroids.col(i) - centroids.col(i));
+      cNorm += std::pow(metric.Evaluate(oldCentroids.col(i),
+          centroids.col(i)), 2.0);
+    }
+
+    // Clusters that have not had any points yet are handled by the empty
+    // cluster policy, using the points of this batch.
+    for (size_t i = 0; i < counts.n_elem; i++)
+    {
+      if (counts[i] == 0)
+      {
+        Log::Info << "Cluster " << i << " is empty.\n";
+        emptyClusterAction.EmptyCluster(batch, i, oldCentroids, centroids,
+            counts, metric, iteration);
+      }
+    }
+
+    iteration++;
+    Log::Info << "KMeans::MiniBatchCluster(): batch " << iteration << " ("
+        << batch.n_cols << " points), residual " << std::sqrt(cNorm) << ".\n";
+  } while (iteration != maxIterations && source(batch));
+
+  Log::Info << "KMeans::MiniBatchCluster(): used " << iteration << " batches."
+      << std::endl;
+  Log::Info << distanceCalculations << " distance calculations." << std::endl;
+}
+
 template<typename MetricType,
          typename InitialPartitionPolicy,
          typename EmptyClusterPolicy,
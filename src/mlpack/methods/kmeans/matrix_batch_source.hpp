@@ -0,0 +1,96 @@
+/**
+ * @file matrix_batch_source.hpp
+ *
+ * A batch source for mini-batch k-means that returns consecutive blocks of
+ * columns of a matrix.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_KMEANS_MATRIX_BATCH_SOURCE_HPP
+#define MLPACK_METHODS_KMEANS_MATRIX_BATCH_SOURCE_HPP
+
+#include <mlpack/prereqs.hpp>
+
+namespace mlpack {
+namespace kmeans {
+
+/**
+ * MatrixBatchSource gives the points of a matrix to KMeans::MiniBatchCluster()
+ * in batches of consecutive columns.  Only one batch is copied at a time, so
+ * if the matrix is the Matrix() of a data::MappedMatrix, the dataset is never
+ * read into memory as a whole:
+ *
+ * @code
+ * data::MappedMatrix<double> dataset;
+ * data::Load("dataset.mmb", dataset, true);
+ *
+ * KMeans<> k;
+ * arma::mat centroids;
+ * k.MiniBatchCluster(MatrixBatchSource<>(dataset.Matrix(), 1000), 10,
+ *     centroids);
+ * @endcode
+ *
+ * @tparam MatType Type of matrix (arma::mat or arma::sp_mat).
+ */
+template<typename MatType = arma::mat>
+class MatrixBatchSource
+{
+ public:
+  /**
+   * Create the batch source on the given matrix.  The matrix is not copied,
+   * so it must stay valid while the batch source is used.
+   *
+   * @param data Matrix to take the batches from.
+   * @param batchSize Number of points in each batch.
+   */
+  MatrixBatchSource(const MatType& data, const size_t batchSize) :
+      data(data),
+      batchSize(batchSize),
+      position(0)
+  {
+    if (batchSize == 0)
+    {
+      throw std::invalid_argument("MatrixBatchSource: batch size must be "
+          "positive");
+    }
+  }
+
+  /**
+   * Store the next batch in the given matrix.  Returns false if there are no
+   * more points.
+   *
+   * @param batch Matrix to store the batch in.
+   */
+  bool operator()(arma::mat& batch)
+  {
+    if (position >= data.n_cols)
+      return false;
+
+    const size_t end = std::min(position + batchSize, (size_t) data.n_cols);
+    batch = arma::mat(data.cols(position, end - 1));
+    position = end;
+    return true;
+  }
+
+  //! Start again from the first point.
+  void Reset() { position = 0; }
+
+  //! Get the number of points in each batch.
+  size_t BatchSize() const { return batchSize; }
+
+ private:
+  //! The matrix to take the batches from.
+  const MatType& data;
+  //! The number of points in each batch.
+  size_t batchSize;
+  //! The first point of the next batch.
+  size_t position;
+};
+
+} // namespace kmeans
+} // namespace mlpack
+
+#endif
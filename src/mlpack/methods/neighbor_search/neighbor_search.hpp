@@ -325,6 +325,11 @@ class NeighborSearch
   //! Access the reference dataset.
   const MatType& ReferenceSet() const { return *referenceSet; }
 
+  //! Access the original index of each point of the reference set (empty if
+  //! the reference points were not reordered).
+  const std::vector<size_t>& OldFromNewReferences() const
+  { return oldFromNewReferences; }
+
   //! Access the reference tree.
   const Tree& ReferenceTree() const { return *referenceTree; }
   //! Modify the reference tree.
@@ -359,6 +364,26 @@ class NeighborSearch
   //! Search() without a query set.
   bool treeNeedsReset;
 
+  /**
+   * Traverse the given query tree against the reference tree with the dual-tree
+   * traverser.  If OpenMP is enabled and the tree type allows it, the upper
+   * levels of the query tree are split into disjoint subtrees that are
+   * traversed in parallel.  Each subtree gets its own rules object, but all of
+   * them share the candidate lists held by the given rules, so the results are
+   * the same as the results of a serial traversal.
+   *
+   * @param queryTree Tree built on query points.
+   * @param k Number of neighbors to search for.
+   * @param rules Rules object holding the candidate lists of all query points.
+   * @param sameSet Denotes whether or not the reference and query sets are the
+   *      same.
+   */
+  void DualTreeTraversal(Tree& queryTree,
+                         const size_t k,
+                         NeighborSearchRules<SortPolicy, MetricType, Tree>&
+                             rules,
+                         const bool sameSet = false);
+
   //! The NSModel class should have access to internal members.
   template<typename SortPol>
   friend class TrainVisitor;
@@ -15,6 +15,7 @@
 
 #include <mlpack/prereqs.hpp>
 #include <mlpack/core/tree/greedy_single_tree_traverser.hpp>
+#include <mlpack/core/tree/query_subtrees.hpp>
 #include "neighbor_search_rules.hpp"
 #include <mlpack/core/tree/spill_tree/is_spill_tree.hpp>
 
@@ -442,8 +443,7 @@ DualTreeTraversalType, SingleTreeTraversalType>::Search(
 
       // The naive brute-force traversal.
       for (size_t i = 0; i < querySet.n_cols; ++i)
-        for (size_t j = 0; j < referenceSet->n_cols; ++j)
-          rules.BaseCase(i, j);
+        rules.BatchBaseCase(i, 0, referenceSet->n_cols);
 
       baseCases += querySet.n_cols * referenceSet->n_cols;
 
@@ -485,10 +485,7 @@ DualTreeTraversalType, SingleTreeTraversalType>::Search(
       // Create the helper object for the tree traversal.
       RuleType rules(*referenceSet, queryTree->Dataset(), k, metric, epsilon);
 
-      // Create the traverser.
-      DualTreeTraversalType<RuleType> traverser(rules);
-
-      traverser.Traverse(*queryTree, *referenceTree);
+      DualTreeTraversal(*queryTree, k, rules);
 
       scores += rules.Scores();
       baseCases += rules.BaseCases();
@@ -644,9 +641,7 @@ DualTreeTraversalType, SingleTreeTraversalType>::Search(
   typedef NeighborSearchRules<SortPolicy, MetricType, Tree> RuleType;
   RuleType rules(*referenceSet, querySet, k, metric, epsilon, sameSet);
 
-  // Create the traverser.
-  DualTreeTraversalType<RuleType> traverser(rules);
-  traverser.Traverse(queryTree, *referenceTree);
+  DualTreeTraversal(queryTree, k, rules, sameSet);
 
   scores += rules.Scores();
   baseCases += rules.BaseCases();
@@ -739,8 +734,7 @@ DualTreeTraversalType, SingleTreeTraversalType>::Search(
     {
       // The naive brute-force solution.
       for (size_t i = 0; i < referenceSet->n_cols; ++i)
-        for (size_t j = 0; j < referenceSet->n_cols; ++j)
-          rules.BaseCase(i, j);
+        rules.BatchBaseCase(i, 0, referenceSet->n_cols);
 
       baseCases += referenceSet->n_cols * referenceSet->n_cols;
       break;
@@ -785,19 +779,16 @@ DualTreeTraversalType, SingleTreeTraversalType>::Search(
         }
       }
 
-      // Create the traverser.
-      DualTreeTraversalType<RuleType> traverser(rules);
-
       if (tree::IsSpillTree<Tree>::value)
       {
         // For Dual Tree Search on SpillTree, the queryTree must be built with
         // non overlapping (tau = 0).
         Tree queryTree(*referenceSet);
-        traverser.Traverse(queryTree, *referenceTree);
+        DualTreeTraversal(queryTree, k, rules, true);
       }
       else
       {
-        traverser.Traverse(*referenceTree, *referenceTree);
+        DualTreeTraversal(*referenceTree, k, rules, true);
         // Next time we perform this search, we'll need to reset the tree.
         treeNeedsReset = true;
       }
@@ -865,6 +856,70 @@ DualTreeTraversalType, SingleTreeTraversalType>::Search(
   }
 }
 
+//! Run the dual-tree traversal, in parallel if possible.
+template<typename SortPolicy,
+         typename MetricType,
+         typename MatType,
+         template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType,
+         template<typename> class DualTreeTraversalType,
+         template<typename> class SingleTreeTraversalType>
+void NeighborSearch<SortPolicy, MetricType, MatType, TreeType,
+DualTreeTraversalType, SingleTreeTraversalType>::DualTreeTraversal(
+    Tree& queryTree,
+    const size_t k,
+    NeighborSearchRules<SortPolicy, MetricType, Tree>& rules,
+    const bool sameSet)
+{
+  typedef NeighborSearchRules<SortPolicy, MetricType, Tree> RuleType;
+
+  size_t numThreads = 1;
+  #ifdef HAS_OPENMP
+    numThreads = omp_get_max_threads();
+  #endif
+
+  // Query subtrees can only be traversed independently if each query point
+  // belongs to exactly one subtree, and if Score() never modifies the
+  // statistics of reference nodes (which is not the case for trees with
+  // self-children, like the cover tree).
+  if (numThreads == 1 || !tree::HasIndependentSubtrees<Tree>::value)
+  {
+    DualTreeTraversalType<RuleType> traverser(rules);
+    traverser.Traverse(queryTree, *referenceTree);
+    return;
+  }
+
+  // Split the query tree into enough subtrees to balance the work between all
+  // threads.
+  std::vector<Tree*> subtrees;
+  tree::SplitQuerySubtrees(queryTree, 8 * numThreads, subtrees);
+
+  // Every subtree is traversed against the whole reference tree with its own
+  // rules object, so the base case cache, the traversal information and the
+  // counters are local to the thread.  Only the statistics of nodes inside the
+  // subtree and the candidate lists of its points are modified, and those
+  // belong to exactly one subtree.  Subtrees vary a lot in cost, so they are
+  // handed out dynamically.
+  size_t subtreeBaseCases = 0;
+  size_t subtreeScores = 0;
+  #pragma omp parallel for schedule(dynamic) \
+      reduction(+:subtreeBaseCases, subtreeScores)
+  for (omp_size_t i = 0; i < (omp_size_t) subtrees.size(); ++i)
+  {
+    RuleType subtreeRules(*referenceSet, queryTree.Dataset(), k, metric,
+        rules.Candidates(), epsilon, sameSet);
+    DualTreeTraversalType<RuleType> traverser(subtreeRules);
+    traverser.Traverse(*subtrees[i], *referenceTree);
+
+    subtreeBaseCases += subtreeRules.BaseCases();
+    subtreeScores += subtreeRules.Scores();
+  }
+
+  rules.BaseCases() += subtreeBaseCases;
+  rules.Scores() += subtreeScores;
+}
+
 //! Calculate the average relative error.
 template<typename SortPolicy,
          typename MetricType,
@@ -14,6 +14,7 @@
 #define MLPACK_METHODS_NEIGHBOR_SEARCH_NEIGHBOR_SEARCH_RULES_HPP
 
 #include <mlpack/core/tree/traversal_info.hpp>
+#include <mlpack/core/metrics/batch_distances.hpp>
 
 #include <queue>
 
@@ -35,6 +36,21 @@ template<typename SortPolicy, typename MetricType, typename TreeType>
 class NeighborSearchRules
 {
  public:
+  //! Candidate represents a possible candidate neighbor (distance, index).
+  typedef std::pair<double, size_t> Candidate;
+
+  //! Compare two candidates based on the distance.
+  struct CandidateCmp {
+    bool operator()(const Candidate& c1, const Candidate& c2)
+    {
+      return !SortPolicy::IsBetter(c2.first, c1.first);
+    };
+  };
+
+  //! Use a priority queue to represent the list of candidate neighbors.
+  typedef std::priority_queue<Candidate, std::vector<Candidate>, CandidateCmp>
+      CandidateList;
+
   /**
    * Construct the NeighborSearchRules object.  This is usually done from within
    * the NeighborSearch class at search time.
@@ -54,6 +70,37 @@ class NeighborSearchRules
                       const double epsilon = 0,
                       const bool sameSet = false);
 
+  /**
+   * Construct the NeighborSearchRules object, using the given candidate lists
+   * instead of allocating new ones.  The candidate lists are not copied, so
+   * several NeighborSearchRules objects can work on the same set of
+   * candidates, as long as each query point is only ever handled by one of
+   * them at a time.  This is used by the parallel dual-tree search, where each
+   * thread traverses a disjoint query subtree with its own rules object.
+   *
+   * @param referenceSet Set of reference data.
+   * @param querySet Set of query data.
+   * @param k Number of neighbors to search for.
+   * @param metric Instantiated metric.
+   * @param candidates Candidate lists for each query point; these must already
+   *      be initialized (see Candidates()).
+   * @param epsilon Relative approximate error.
+   * @param sameSet If true, the query and reference set are taken to be the
+   *      same, and a query point will not return itself in the results.
+   */
+  NeighborSearchRules(const typename TreeType::Mat& referenceSet,
+                      const typename TreeType::Mat& querySet,
+                      const size_t k,
+                      MetricType& metric,
+                      std::vector<CandidateList>& candidates,
+                      const double epsilon = 0,
+                      const bool sameSet = false);
+
+  //! A copy would refer to the candidate lists of the original object.
+  NeighborSearchRules(const NeighborSearchRules& other) = delete;
+  //! A copy would refer to the candidate lists of the original object.
+  NeighborSearchRules& operator=(const NeighborSearchRules& other) = delete;
+
   /**
    * Store the list of candidates for each query point in the given matrices.
    *
@@ -73,6 +120,20 @@ class NeighborSearchRules
    */
   double BaseCase(const size_t queryIndex, const size_t referenceIndex);
 
+  /**
+   * Perform the base cases between the query point and each of the given
+   * consecutive reference points, like calling BaseCase() for each of them.
+   * If the metric is an LMetric and the data is dense, all the distances are
+   * computed in one batch with LMetric::BatchEvaluate().
+   *
+   * @param queryIndex Index of query point.
+   * @param referenceBegin Index of the first reference point.
+   * @param referenceCount Number of reference points.
+   */
+  void BatchBaseCase(const size_t queryIndex,
+                     const size_t referenceBegin,
+                     const size_t referenceCount);
+
   /**
    * Get the score for recursion order.  A low score indicates priority for
    * recursion, while DBL_MAX indicates that the node should not be recursed
@@ -149,6 +210,11 @@ class NeighborSearchRules
   //! Modify the number of scores that have been performed.
   size_t& Scores() { return scores; }
 
+  //! Get the candidate lists for each query point.
+  const std::vector<CandidateList>& Candidates() const { return candidates; }
+  //! Modify the candidate lists for each query point.
+  std::vector<CandidateList>& Candidates() { return candidates; }
+
   //! Convenience typedef.
   typedef typename tree::TraversalInfo<TreeType> TraversalInfoType;
 
@@ -164,23 +230,12 @@ class NeighborSearchRules
   //! The query set.
   const typename TreeType::Mat& querySet;
 
-  //! Candidate represents a possible candidate neighbor (distance, index).
-  typedef std::pair<double, size_t> Candidate;
-
-  //! Compare two candidates based on the distance.
-  struct CandidateCmp {
-    bool operator()(const Candidate& c1, const Candidate& c2)
-    {
-      return !SortPolicy::IsBetter(c2.first, c1.first);
-    };
-  };
-
-  //! Use a priority queue to represent the list of candidate neighbors.
-  typedef std::priority_queue<Candidate, std::vector<Candidate>, CandidateCmp>
-      CandidateList;
+  //! Storage for the candidate neighbors of each point, if they are not shared
+  //! with another NeighborSearchRules object.
+  std::vector<CandidateList> candidateStorage;
 
   //! Set of candidate neighbors for each point.
-  std::vector<CandidateList> candidates;
+  std::vector<CandidateList>& candidates;
 
   //! Number of neighbors to search for.
   const size_t k;
@@ -201,6 +256,9 @@ class NeighborSearchRules
   //! The last base case result.
   double lastBaseCase;
 
+  //! The distances computed by the last call to BatchBaseCase().
+  arma::Col<typename TreeType::ElemType> batchDistances;
+
   //! The number of base cases that have been performed.
   size_t baseCases;
   //! The number of scores that have been performed.
@@ -29,6 +29,7 @@ NeighborSearchRules<SortPolicy, MetricType, TreeType>::NeighborSearchRules(
     const bool sameSet) :
     referenceSet(referenceSet),
     querySet(querySet),
+    candidates(candidateStorage),
     k(k),
     metric(metric),
     sameSet(sameSet),
@@ -59,6 +60,36 @@ NeighborSearchRules<SortPolicy, MetricType, TreeType>::NeighborSearchRules(
     candidates.push_back(pqueue);
 }
 
+template<typename SortPolicy, typename MetricType, typename TreeType>
+NeighborSearchRules<SortPolicy, MetricType, TreeType>::NeighborSearchRules(
+    const typename TreeType::Mat& referenceSet,
+    const typename TreeType::Mat& querySet,
+    const size_t k,
+    MetricType& metric,
+    std::vector<CandidateList>& candidates,
+    const double epsilon,
+    const bool sameSet) :
+    referenceSet(referenceSet),
+    querySet(querySet),
+    candidates(candidates),
+    k(k),
+    metric(metric),
+    sameSet(sameSet),
+    epsilon(epsilon),
+    lastQueryIndex(querySet.n_cols),
+    lastReferenceIndex(referenceSet.n_cols),
+    baseCases(0),
+    scores(0)
+{
+  // See the other constructor for why we use the this pointer here.
+  traversalInfo.LastQueryNode() = (TreeType*) this;
+  traversalInfo.LastReferenceNode() = (TreeType*) this;
+
+  if (candidates.size() != querySet.n_cols)
+    throw std::invalid_argument("NeighborSearchRules: number of candidate "
+        "lists must be equal to the number of query points");
+}
+
 template<typename SortPolicy, typename MetricType, typename TreeType>
 void NeighborSearchRules<SortPolicy, MetricType, TreeType>::GetResults(
     arma::Mat<size_t>& neighbors,
@@ -107,6 +138,40 @@ BaseCase(const size_t queryIndex, const size_t referenceIndex)
   return distance;
 }
 
+template<typename SortPolicy, typename MetricType, typename TreeType>
+void NeighborSearchRules<SortPolicy, MetricType, TreeType>::BatchBaseCase(
+    const size_t queryIndex,
+    const size_t referenceBegin,
+    const size_t referenceCount)
+{
+  if (referenceCount == 0)
+    return;
+
+  metric::BatchDistances(metric, querySet, referenceSet, queryIndex,
+      referenceBegin, referenceCount, batchDistances);
+
+  for (size_t i = 0; i < referenceCount; ++i)
+  {
+    const size_t referenceIndex = referenceBegin + i;
+    if (sameSet && (queryIndex == referenceIndex))
+      continue;
+
+    // If we have already performed this base case, then do not perform it
+    // again.
+    if ((lastQueryIndex == queryIndex) &&
+        (lastReferenceIndex == referenceIndex))
+      continue;
+
+    InsertNeighbor(queryIndex, referenceIndex, batchDistances[i]);
+    ++baseCases;
+  }
+
+  // Cache the last base case, as BaseCase() would.
+  lastQueryIndex = queryIndex;
+  lastReferenceIndex = referenceBegin + referenceCount - 1;
+  lastBaseCase = batchDistances[referenceCount - 1];
+}
+
 template<typename SortPolicy, typename MetricType, typename TreeType>
 inline double NeighborSearchRules<SortPolicy, MetricType, TreeType>::Score(
     const size_t queryIndex,
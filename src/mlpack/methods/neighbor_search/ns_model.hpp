@@ -223,6 +223,19 @@ class ReferenceSetVisitor : public boost::static_visitor<const arma::mat&>
   const arma::mat& operator()(NSType *ns) const;
 };
 
+/**
+ * OldFromNewVisitor exposes the original index of each reference point of the
+ * given NSType.
+ */
+class OldFromNewVisitor :
+    public boost::static_visitor<const std::vector<size_t>&>
+{
+ public:
+  //! Return the mappings of the reference set.
+  template<typename NSType>
+  const std::vector<size_t>& operator()(NSType *ns) const;
+};
+
 /**
  * DeleteVisitor deletes the given NSType instance.
  */
@@ -306,6 +319,25 @@ class NSModel
                  NSType<SortPolicy, tree::UBTree>*,
                  NSType<SortPolicy, tree::Octree>*> nSearch;
 
+  //! The index of each point of the reference set, in the original order of
+  //! the reference set.  This is empty if the index of each point is its
+  //! position.
+  arma::Col<size_t> referenceIndices;
+  //! Whether each point of the reference set (in the original order) has been
+  //! deleted.  This is empty if no point was deleted.
+  std::vector<bool> deleted;
+  //! The number of deleted points of the reference set.
+  size_t numDeleted;
+  //! The points inserted since the reference tree was built.
+  arma::mat insertedPoints;
+  //! The index of each inserted point.
+  arma::Col<size_t> insertedIndices;
+  //! The index of the next inserted point.
+  size_t nextIndex;
+  //! The tree is rebuilt when the number of pending changes exceeds this
+  //! fraction of the size of the reference set.
+  double rebuildFraction;
+
  public:
   /**
    * Initialize the NSModel with the given type and whether or not a random
@@ -395,13 +427,81 @@ class NSModel
               arma::Mat<size_t>& neighbors,
               arma::mat& distances);
 
-  //! Perform monochromatic neighbor search.
+  //! Perform monochromatic neighbor search.  If points were inserted or
+  //! deleted, the results are for the current points, in increasing order of
+  //! their indices.
   void Search(const size_t k,
               arma::Mat<size_t>& neighbors,
               arma::mat& distances);
 
+  /**
+   * Insert the given points into the model.  The reference tree is not
+   * modified: the inserted points are searched by brute force until the next
+   * call to Rebuild().  The points are given the next unused indices, which
+   * do not change when the tree is rebuilt.
+   *
+   * @param points Points to insert.
+   */
+  void Insert(const arma::mat& points);
+
+  /**
+   * Delete the point with the given index from the model.  A point of the
+   * reference tree is only marked as deleted and skipped by searches, so the
+   * bounds of the tree are only tightened by the next call to Rebuild().  An
+   * exception is thrown if there is no point with the given index.
+   *
+   * @param index Index of the point to delete.
+   */
+  void Delete(const size_t index);
+
+  /**
+   * Rebuild the reference tree on the current points: the deleted points are
+   * removed and the inserted points are added.  The indices of the points do
+   * not change.  This is called by Insert() and Delete() when the number of
+   * pending changes exceeds RebuildFraction() times the size of the reference
+   * set.
+   */
+  void Rebuild();
+
+  //! Get the number of insertions and deletions since the tree was built.
+  size_t PendingChanges() const { return insertedPoints.n_cols + numDeleted; }
+
+  //! Get the fraction of the reference set size above which the number of
+  //! pending changes triggers a rebuild.
+  double RebuildFraction() const { return rebuildFraction; }
+  //! Modify the fraction of the reference set size above which the number of
+  //! pending changes triggers a rebuild.
+  double& RebuildFraction() { return rebuildFraction; }
+
   //! Return a string representation of the current tree type.
   std::string TreeName() const;
+
+ private:
+  //! Return whether the indices of the results have to be mapped, because
+  //! points were inserted or deleted.
+  bool Modified() const
+  {
+    return numDeleted > 0 || insertedPoints.n_cols > 0 ||
+        referenceIndices.n_elem > 0;
+  }
+
+  //! Get the current points, in increasing order of their indices, and their
+  //! indices.
+  void CurrentPoints(arma::mat& points, arma::Col<size_t>& indices) const;
+
+  /**
+   * Search for the k neighbors of each query point among the current points.
+   * If queryIndices is not empty, it holds the index of each query point,
+   * which is never returned as its own neighbor.
+   */
+  void SearchModified(const arma::mat& querySet,
+                      const size_t k,
+                      arma::Mat<size_t>& neighbors,
+                      arma::mat& distances,
+                      const arma::Col<size_t>& queryIndices);
+
+  //! Rebuild the tree if there are too many pending changes.
+  void CheckRebuild();
 };
 
 } // namespace neighbor
@@ -409,7 +509,7 @@ class NSModel
 
 //! Set the serialization version of the NSModel class.
 BOOST_TEMPLATE_CLASS_VERSION(template<typename SortPolicy>,
-    mlpack::neighbor::NSModel<SortPolicy>, 1);
+    mlpack::neighbor::NSModel<SortPolicy>, 2);
 
 // Include implementation.
 #include "ns_model_impl.hpp"
@@ -252,6 +252,15 @@ const arma::mat& ReferenceSetVisitor::operator()(NSType* ns) const
   throw std::runtime_error("no neighbor search model initialized");
 }
 
+//! Expose the mappings of the reference set of the given NSType.
+template<typename NSType>
+const std::vector<size_t>& OldFromNewVisitor::operator()(NSType* ns) const
+{
+  if (ns)
+    return ns->OldFromNewReferences();
+  throw std::runtime_error("no neighbor search model initialized");
+}
+
 //! Clean memory, if necessary.
 template<typename NSType>
 void DeleteVisitor::operator()(NSType* ns) const
@@ -270,7 +279,10 @@ NSModel<SortPolicy>::NSModel(TreeTypes treeType, bool randomBasis) :
     leafSize(20),
     tau(0),
     rho(0.7),
-    randomBasis(randomBasis)
+    randomBasis(randomBasis),
+    numDeleted(0),
+    nextIndex(0),
+    rebuildFraction(0.1)
 {
   // Nothing to do.
 }
@@ -283,7 +295,14 @@ NSModel<SortPolicy>::NSModel(const NSModel& other) :
     rho(other.rho),
     randomBasis(other.randomBasis),
     q(other.q),
-    nSearch(other.nSearch)
+    nSearch(other.nSearch),
+    referenceIndices(other.referenceIndices),
+    deleted(other.deleted),
+    numDeleted(other.numDeleted),
+    insertedPoints(other.insertedPoints),
+    insertedIndices(other.insertedIndices),
+    nextIndex(other.nextIndex),
+    rebuildFraction(other.rebuildFraction)
 {
   // Nothing to do.
 }
@@ -296,7 +315,14 @@ NSModel<SortPolicy>::NSModel(NSModel&& other) :
     rho(other.rho),
     randomBasis(other.randomBasis),
     q(std::move(other.q)),
-    nSearch(other.nSearch)
+    nSearch(other.nSearch),
+    referenceIndices(std::move(other.referenceIndices)),
+    deleted(std::move(other.deleted)),
+    numDeleted(other.numDeleted),
+    insertedPoints(std::move(other.insertedPoints)),
+    insertedIndices(std::move(other.insertedIndices)),
+    nextIndex(other.nextIndex),
+    rebuildFraction(other.rebuildFraction)
 {
   // Reset parameters of the other model.
   other.treeType = TreeTypes::KD_TREE;
@@ -305,6 +331,9 @@ NSModel<SortPolicy>::NSModel(NSModel&& other) :
   other.rho = 0.7;
   other.randomBasis = false;
   other.nSearch = decltype(other.nSearch)();
+  other.deleted.clear();
+  other.numDeleted = 0;
+  other.nextIndex = 0;
 }
 
 template<typename SortPolicy>
@@ -319,6 +348,13 @@ NSModel<SortPolicy>& NSModel<SortPolicy>::operator=(const NSModel& other)
   randomBasis = other.randomBasis;
   q = other.q;
   nSearch = other.nSearch;
+  referenceIndices = other.referenceIndices;
+  deleted = other.deleted;
+  numDeleted = other.numDeleted;
+  insertedPoints = other.insertedPoints;
+  insertedIndices = other.insertedIndices;
+  nextIndex = other.nextIndex;
+  rebuildFraction = other.rebuildFraction;
 
   return *this;
 }
@@ -336,6 +372,13 @@ NSModel<SortPolicy>& NSModel<SortPolicy>::operator=(NSModel&& other)
   q = std::move(other.q);
   // Copy the pointer and type.
   nSearch = other.nSearch;
+  referenceIndices = std::move(other.referenceIndices);
+  deleted = std::move(other.deleted);
+  numDeleted = other.numDeleted;
+  insertedPoints = std::move(other.insertedPoints);
+  insertedIndices = std::move(other.insertedIndices);
+  nextIndex = other.nextIndex;
+  rebuildFraction = other.rebuildFraction;
 
   // Reset parameters of the other model.
   other.treeType = TreeTypes::KD_TREE;
@@ -344,6 +387,9 @@ NSModel<SortPolicy>& NSModel<SortPolicy>::operator=(NSModel&& other)
   other.rho = 0.7;
   other.randomBasis = false;
   other.nSearch = decltype(other.nSearch)();
+  other.deleted.clear();
+  other.numDeleted = 0;
+  other.nextIndex = 0;
 
   return *this;
 }
@@ -377,6 +423,28 @@ void NSModel<SortPolicy>::serialize(Archive& ar, const unsigned int version)
     boost::apply_visitor(DeleteVisitor(), nSearch);
 
   ar & BOOST_SERIALIZATION_NVP(nSearch);
+
+  // Older versions of NSModel did not support insertions and deletions.
+  if (version > 1)
+  {
+    ar & BOOST_SERIALIZATION_NVP(referenceIndices);
+    ar & BOOST_SERIALIZATION_NVP(deleted);
+    ar & BOOST_SERIALIZATION_NVP(numDeleted);
+    ar & BOOST_SERIALIZATION_NVP(insertedPoints);
+    ar & BOOST_SERIALIZATION_NVP(insertedIndices);
+    ar & BOOST_SERIALIZATION_NVP(nextIndex);
+    ar & BOOST_SERIALIZATION_NVP(rebuildFraction);
+  }
+  else if (Archive::is_loading::value)
+  {
+    referenceIndices.reset();
+    deleted.clear();
+    numDeleted = 0;
+    insertedPoints.reset();
+    insertedIndices.reset();
+    nextIndex = Dataset().n_cols;
+    rebuildFraction = 0.1;
+  }
 }
 
 //! Expose the dataset.
@@ -516,6 +584,14 @@ void NSModel<SortPolicy>::BuildModel(arma::mat&& referenceSet,
       break;
   }
 
+  // All the points are new, so there are no pending changes.
+  referenceIndices.reset();
+  deleted.clear();
+  numDeleted = 0;
+  insertedPoints.reset();
+  insertedIndices.reset();
+  nextIndex = referenceSet.n_cols;
+
   TrainVisitor<SortPolicy> tn(std::move(referenceSet), leafSize, tau, rho);
   boost::apply_visitor(tn, nSearch);
 
@@ -556,6 +632,12 @@ void NSModel<SortPolicy>::Search(arma::mat&& querySet,
       break;
   }
 
+  if (Modified())
+  {
+    SearchModified(querySet, k, neighbors, distances, arma::Col<size_t>());
+    return;
+  }
+
   BiSearchVisitor<SortPolicy> search(querySet, k, neighbors, distances,
       leafSize, tau, rho);
   boost::apply_visitor(search, nSearch);
@@ -590,10 +672,283 @@ void NSModel<SortPolicy>::Search(const size_t k,
     Log::Info << "Maximum of " << Epsilon() * 100 << "% relative error."
         << std::endl;
 
+  if (Modified())
+  {
+    // Search for the current points among themselves.
+    arma::mat points;
+    arma::Col<size_t> indices;
+    CurrentPoints(points, indices);
+    SearchModified(points, k, neighbors, distances, indices);
+    return;
+  }
+
   MonoSearchVisitor search(k, neighbors, distances);
   boost::apply_visitor(search, nSearch);
 }
 
+//! Insert points into the model.
+template<typename SortPolicy>
+void NSModel<SortPolicy>::Insert(const arma::mat& points)
+{
+  if (points.n_rows != Dataset().n_rows)
+  {
+    std::ostringstream oss;
+    oss << "NSModel::Insert(): dimensionality of points (" << points.n_rows
+        << ") does not match dimensionality of model (" << Dataset().n_rows
+        << ")!";
+    throw std::invalid_argument(oss.str());
+  }
+
+  // The inserted points are projected like the reference set.
+  if (insertedPoints.n_cols == 0)
+    insertedPoints = randomBasis ? arma::mat(q * points) : points;
+  else if (randomBasis)
+    insertedPoints.insert_cols(insertedPoints.n_cols, q * points);
+  else
+    insertedPoints.insert_cols(insertedPoints.n_cols, points);
+
+  insertedIndices.resize(insertedPoints.n_cols);
+  for (size_t i = insertedPoints.n_cols - points.n_cols;
+       i < insertedPoints.n_cols; ++i)
+    insertedIndices[i] = nextIndex++;
+
+  CheckRebuild();
+}
+
+//! Delete a point from the model.
+template<typename SortPolicy>
+void NSModel<SortPolicy>::Delete(const size_t index)
+{
+  // The indices of the inserted points and of the reference points are both
+  // sorted, so we can use binary search.
+  const size_t* insertedEnd = insertedIndices.memptr() + insertedIndices.n_elem;
+  const size_t* inserted = std::lower_bound(insertedIndices.memptr(),
+      insertedEnd, index);
+  if (inserted != insertedEnd && *inserted == index)
+  {
+    // Inserted points are not in the tree, so they can be removed directly.
+    const size_t i = inserted - insertedIndices.memptr();
+    insertedPoints.shed_col(i);
+    insertedIndices.shed_row(i);
+    return;
+  }
+
+  const size_t numPoints = Dataset().n_cols;
+  size_t point = index;
+  if (referenceIndices.n_elem > 0)
+  {
+    point = std::lower_bound(referenceIndices.memptr(),
+        referenceIndices.memptr() + numPoints, index) -
+        referenceIndices.memptr();
+    if (point < numPoints && referenceIndices[point] != index)
+      point = numPoints;
+  }
+
+  if (point >= numPoints || (!deleted.empty() && deleted[point]))
+  {
+    std::ostringstream oss;
+    oss << "NSModel::Delete(): there is no point with index " << index << "!";
+    throw std::invalid_argument(oss.str());
+  }
+
+  if (deleted.empty())
+    deleted.resize(numPoints, false);
+  deleted[point] = true;
+  ++numDeleted;
+
+  CheckRebuild();
+}
+
+//! Rebuild the reference tree on the current points.
+template<typename SortPolicy>
+void NSModel<SortPolicy>::Rebuild()
+{
+  arma::mat points;
+  arma::Col<size_t> indices;
+  CurrentPoints(points, indices);
+
+  if (SearchMode() != NAIVE_MODE)
+  {
+    Timer::Start("tree_building");
+    Log::Info << "Rebuilding reference tree with " << points.n_cols
+        << " points..." << std::endl;
+  }
+
+  // The points are already projected onto the random basis, if necessary.
+  TrainVisitor<SortPolicy> tn(std::move(points), leafSize, tau, rho);
+  boost::apply_visitor(tn, nSearch);
+
+  // The indices are sorted, so they are the positions of the points if the
+  // last one is.
+  if (indices.n_elem > 0 && indices[indices.n_elem - 1] == indices.n_elem - 1)
+    referenceIndices.reset();
+  else
+    referenceIndices = std::move(indices);
+
+  deleted.clear();
+  numDeleted = 0;
+  insertedPoints.reset();
+  insertedIndices.reset();
+
+  if (SearchMode() != NAIVE_MODE)
+  {
+    Timer::Stop("tree_building");
+    Log::Info << "Tree rebuilt." << std::endl;
+  }
+}
+
+//! Get the current points and their indices.
+template<typename SortPolicy>
+void NSModel<SortPolicy>::CurrentPoints(arma::mat& points,
+                                        arma::Col<size_t>& indices) const
+{
+  const arma::mat& dataset = Dataset();
+  const std::vector<size_t>& oldFromNew =
+      boost::apply_visitor(OldFromNewVisitor(), nSearch);
+
+  // Find where each reference point is in the (possibly reordered) dataset.
+  std::vector<size_t> newFromOld(oldFromNew.size());
+  for (size_t i = 0; i < oldFromNew.size(); ++i)
+    newFromOld[oldFromNew[i]] = i;
+
+  points.set_size(dataset.n_rows,
+      dataset.n_cols - numDeleted + insertedPoints.n_cols);
+  indices.set_size(points.n_cols);
+  size_t col = 0;
+  for (size_t i = 0; i < dataset.n_cols; ++i)
+  {
+    if (!deleted.empty() && deleted[i])
+      continue;
+
+    points.col(col) = dataset.col(newFromOld.empty() ? i : newFromOld[i]);
+    indices[col] = (referenceIndices.n_elem == 0) ? i : referenceIndices[i];
+    ++col;
+  }
+
+  // The inserted points have the largest indices.
+  for (size_t i = 0; i < insertedPoints.n_cols; ++i, ++col)
+  {
+    points.col(col) = insertedPoints.col(i);
+    indices[col] = insertedIndices[i];
+  }
+}
+
+//! Search among the current points.
+template<typename SortPolicy>
+void NSModel<SortPolicy>::SearchModified(
+    const arma::mat& querySet,
+    const size_t k,
+    arma::Mat<size_t>& neighbors,
+    arma::mat& distances,
+    const arma::Col<size_t>& queryIndices)
+{
+  const bool excludeSelf = (queryIndices.n_elem > 0);
+  const size_t numTreePoints = Dataset().n_cols;
+  const size_t numPoints = numTreePoints - numDeleted + insertedPoints.n_cols;
+  if (k + (excludeSelf ? 1 : 0) > numPoints)
+  {
+    std::ostringstream oss;
+    oss << "NSModel::Search(): requested value of k (" << k << ") is greater "
+        << "than the number of points in the reference set (" << numPoints
+        << ")!";
+    throw std::invalid_argument(oss.str());
+  }
+
+  typedef std::pair<double, size_t> Candidate;
+  std::vector<std::vector<Candidate>> candidates(querySet.n_cols);
+
+  // Search the tree first.  The deleted points (and the query point itself)
+  // are dropped from the results, so the queries that are left with too few
+  // neighbors are searched again with twice as many neighbors, until all the
+  // points of the tree have been returned.
+  size_t searchK = std::min(k + (excludeSelf ? 1 : 0), numTreePoints);
+  std::vector<size_t> pending(querySet.n_cols);
+  for (size_t i = 0; i < pending.size(); ++i)
+    pending[i] = i;
+
+  while (searchK > 0 && !pending.empty())
+  {
+    arma::mat pendingQueries(querySet.n_rows, pending.size());
+    for (size_t i = 0; i < pending.size(); ++i)
+      pendingQueries.col(i) = querySet.col(pending[i]);
+
+    arma::Mat<size_t> treeNeighbors;
+    arma::mat treeDistances;
+    BiSearchVisitor<SortPolicy> search(pendingQueries, searchK, treeNeighbors,
+        treeDistances, leafSize, tau, rho);
+    boost::apply_visitor(search, nSearch);
+
+    std::vector<size_t> stillPending;
+    for (size_t i = 0; i < pending.size(); ++i)
+    {
+      std::vector<Candidate>& queryCandidates = candidates[pending[i]];
+      queryCandidates.clear();
+      for (size_t j = 0; j < searchK; ++j)
+      {
+        const size_t point = treeNeighbors(j, i);
+        if (!deleted.empty() && deleted[point])
+          continue;
+
+        const size_t index = (referenceIndices.n_elem == 0) ? point :
+            referenceIndices[point];
+        if (excludeSelf && index == queryIndices[pending[i]])
+          continue;
+
+        queryCandidates.push_back(Candidate(treeDistances(j, i), index));
+      }
+
+      if (queryCandidates.size() < k)
+        stillPending.push_back(pending[i]);
+    }
+
+    if (searchK == numTreePoints)
+      break;
+
+    pending.swap(stillPending);
+    searchK = std::min(2 * searchK, numTreePoints);
+  }
+
+  // Now add the inserted points by brute force, and keep the k best
+  // candidates.  At equal distances, the candidates from the tree come first.
+  neighbors.set_size(k, querySet.n_cols);
+  distances.set_size(k, querySet.n_cols);
+
+  #pragma omp parallel for schedule(static)
+  for (omp_size_t i = 0; i < (omp_size_t) querySet.n_cols; ++i)
+  {
+    std::vector<Candidate>& queryCandidates = candidates[i];
+    for (size_t j = 0; j < insertedPoints.n_cols; ++j)
+    {
+      if (excludeSelf && insertedIndices[j] == queryIndices[i])
+        continue;
+
+      const double distance = metric::EuclideanDistance::Evaluate(
+          querySet.col(i), insertedPoints.col(j));
+      queryCandidates.push_back(Candidate(distance, insertedIndices[j]));
+    }
+
+    std::stable_sort(queryCandidates.begin(), queryCandidates.end(),
+        [](const Candidate& a, const Candidate& b)
+        {
+          return SortPolicy::IsBetter(a.first, b.first);
+        });
+
+    for (size_t j = 0; j < k; ++j)
+    {
+      neighbors(j, i) = queryCandidates[j].second;
+      distances(j, i) = queryCandidates[j].first;
+    }
+  }
+}
+
+//! Rebuild the reference tree if there are too many pending changes.
+template<typename SortPolicy>
+void NSModel<SortPolicy>::CheckRebuild()
+{
+  if (PendingChanges() > rebuildFraction * Dataset().n_cols)
+    Rebuild();
+}
+
 //! Get the name of the tree type.
 template<typename SortPolicy>
 std::string NSModel<SortPolicy>::TreeName() const
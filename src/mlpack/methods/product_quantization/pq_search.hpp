@@ -0,0 +1,177 @@
+/**
+ * @file pq_search.hpp
+ *
+ * Definition of the PQSearch class, which performs approximate nearest
+ * neighbor search on a reference set compressed with product quantization.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_PRODUCT_QUANTIZATION_PQ_SEARCH_HPP
+#define MLPACK_METHODS_PRODUCT_QUANTIZATION_PQ_SEARCH_HPP
+
+#include <mlpack/prereqs.hpp>
+#include <mlpack/core/metrics/lmetric.hpp>
+#include "product_quantizer.hpp"
+
+namespace mlpack {
+namespace neighbor {
+
+/**
+ * PQSearch stores a reference set as product quantization codes (one byte per
+ * subspace for each point; see ProductQuantizer) instead of the points
+ * themselves, and searches for the approximate Euclidean nearest neighbors of
+ * query points.  For each query, a table of the distances to all centroids is
+ * computed once, and the approximate distance to each reference point is then
+ * a sum of table lookups, so the reference points are never decoded.
+ *
+ * The reference set does not need to be in memory at once: the quantizer can
+ * be trained on a sample, and the points can be added in batches with Add().
+ * If the original points are available (for instance, in a memory-mapped
+ * file), the approximate results can be re-ranked with the exact distances by
+ * passing the points to Search().
+ *
+ * @code
+ * PQSearch<> pq(referenceSet, 16);
+ * // Find the 100 best candidates with the codes, and keep the 10 best with
+ * // exact distances.
+ * pq.Search(querySet, 10, neighbors, distances, referenceSet, 100);
+ * @endcode
+ *
+ * @tparam MatType Type of (dense) matrix of the points.
+ */
+template<typename MatType = arma::mat>
+class PQSearch
+{
+ public:
+  //! Create an empty model.  Call Train() before using it.
+  PQSearch() { }
+
+  /**
+   * Train the quantizer on the given reference set, and store the codes of the
+   * reference set.
+   *
+   * @param referenceSet Set of reference points.
+   * @param numSubspaces Number of subspaces (and bytes of each code).
+   * @param numCentroids Number of centroids in each subspace (at most 256).
+   * @param maxIterations Maximum number of k-means iterations.
+   */
+  PQSearch(const MatType& referenceSet,
+           const size_t numSubspaces,
+           const size_t numCentroids = 256,
+           const size_t maxIterations = 100);
+
+  /**
+   * Create an empty reference set with the given trained quantizer.  Add the
+   * reference points with Add().
+   *
+   * @param quantizer Trained quantizer.
+   */
+  PQSearch(ProductQuantizer<MatType> quantizer);
+
+  /**
+   * Train the quantizer on the given reference set, and store the codes of the
+   * reference set, replacing any existing model.
+   *
+   * @param referenceSet Set of reference points.
+   * @param numSubspaces Number of subspaces (and bytes of each code).
+   * @param numCentroids Number of centroids in each subspace (at most 256).
+   * @param maxIterations Maximum number of k-means iterations.
+   */
+  void Train(const MatType& referenceSet,
+             const size_t numSubspaces,
+             const size_t numCentroids = 256,
+             const size_t maxIterations = 100);
+
+  /**
+   * Encode the given points and add them to the reference set.  Their indices
+   * follow the indices of the points already in the reference set.
+   *
+   * @param points Points to add.
+   */
+  void Add(const MatType& points);
+
+  /**
+   * Search for the approximate nearest neighbors of the given query points.
+   * The distances are the Euclidean distances between the queries and the
+   * decoded reference points.  The matrices will be set to k rows by n columns,
+   * where n is the number of query points.
+   *
+   * @param querySet Set of query points.
+   * @param k Number of neighbors to search for.
+   * @param neighbors Matrix storing lists of neighbors for each query point.
+   * @param distances Matrix storing distances of neighbors for each query
+   *     point.
+   */
+  void Search(const MatType& querySet,
+              const size_t k,
+              arma::Mat<size_t>& neighbors,
+              arma::mat& distances) const;
+
+  /**
+   * Search for the approximate nearest neighbors of the given query points,
+   * and re-rank the best candidates with their exact distances.  The given
+   * reference set must hold the original points, in the order they were
+   * added; only the columns of the candidates are accessed.
+   *
+   * @param querySet Set of query points.
+   * @param k Number of neighbors to search for.
+   * @param neighbors Matrix storing lists of neighbors for each query point.
+   * @param distances Matrix storing exact distances of neighbors for each
+   *     query point.
+   * @param referenceSet Original reference points.
+   * @param numCandidates Number of candidates to re-rank for each query; if
+   *     less than k, k is used.
+   */
+  void Search(const MatType& querySet,
+              const size_t k,
+              arma::Mat<size_t>& neighbors,
+              arma::mat& distances,
+              const MatType& referenceSet,
+              const size_t numCandidates) const;
+
+  //! Get the number of reference points.
+  size_t NumPoints() const { return codes.n_cols; }
+  //! Get the codes of the reference points (one column per point).
+  const arma::Mat<unsigned char>& Codes() const { return codes; }
+  //! Get the quantizer.
+  const ProductQuantizer<MatType>& Quantizer() const { return quantizer; }
+
+  /**
+   * Serialize the model.
+   */
+  template<typename Archive>
+  void serialize(Archive& ar, const unsigned int /* version */);
+
+ private:
+  //! A candidate neighbor: (squared distance, index).
+  typedef std::pair<double, size_t> Candidate;
+
+  /**
+   * Find the numCandidates reference points with the smallest approximate
+   * squared distances to the given query, sorted by distance.
+   */
+  template<typename VecType>
+  void Candidates(const VecType& query,
+                  const size_t numCandidates,
+                  arma::mat& table,
+                  std::vector<Candidate>& candidates) const;
+
+  //! Check that a search for k neighbors of the given queries is valid.
+  void CheckSearch(const MatType& querySet, const size_t k) const;
+
+  //! The quantizer.
+  ProductQuantizer<MatType> quantizer;
+  //! The codes of the reference points.
+  arma::Mat<unsigned char> codes;
+};
+
+} // namespace neighbor
+} // namespace mlpack
+
+// Include implementation.
+#include "pq_search_impl.hpp"
+
+#endif
@@ -0,0 +1,228 @@
+/**
+ * @file pq_search_impl.hpp
+ *
+ * Implementation of the PQSearch class.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_PRODUCT_QUANTIZATION_PQ_SEARCH_IMPL_HPP
+#define MLPACK_METHODS_PRODUCT_QUANTIZATION_PQ_SEARCH_IMPL_HPP
+
+// In case it hasn't been included yet.
+#include "pq_search.hpp"
+
+#include <queue>
+
+namespace mlpack {
+namespace neighbor {
+
+template<typename MatType>
+PQSearch<MatType>::PQSearch(const MatType& referenceSet,
+                            const size_t numSubspaces,
+                            const size_t numCentroids,
+                            const size_t maxIterations)
+{
+  Train(referenceSet, numSubspaces, numCentroids, maxIterations);
+}
+
+template<typename MatType>
+PQSearch<MatType>::PQSearch(ProductQuantizer<MatType> quantizer) :
+    quantizer(std::move(quantizer))
+{
+  // Nothing to do.
+}
+
+template<typename MatType>
+void PQSearch<MatType>::Train(const MatType& referenceSet,
+                              const size_t numSubspaces,
+                              const size_t numCentroids,
+                              const size_t maxIterations)
+{
+  quantizer.Train(referenceSet, numSubspaces, numCentroids, maxIterations);
+  quantizer.Encode(referenceSet, codes);
+}
+
+template<typename MatType>
+void PQSearch<MatType>::Add(const MatType& points)
+{
+  arma::Mat<unsigned char> newCodes;
+  quantizer.Encode(points, newCodes);
+
+  if (codes.n_cols == 0)
+    codes = std::move(newCodes);
+  else
+    codes.insert_cols(codes.n_cols, newCodes);
+}
+
+template<typename MatType>
+void PQSearch<MatType>::CheckSearch(const MatType& querySet,
+                                    const size_t k) const
+{
+  if (querySet.n_rows != quantizer.Dimensionality())
+  {
+    std::ostringstream oss;
+    oss << "PQSearch::Search(): dimensionality of query set ("
+        << querySet.n_rows << ") is not equal to the dimensionality the model "
+        << "was trained on (" << quantizer.Dimensionality() << ")!";
+    throw std::invalid_argument(oss.str());
+  }
+
+  if (k > codes.n_cols)
+  {
+    std::ostringstream oss;
+    oss << "PQSearch::Search(): requested " << k << " approximate nearest "
+        << "neighbors, but reference set has " << codes.n_cols << " points!";
+    throw std::invalid_argument(oss.str());
+  }
+}
+
+template<typename MatType>
+template<typename VecType>
+void PQSearch<MatType>::Candidates(const VecType& query,
+                                   const size_t numCandidates,
+                                   arma::mat& table,
+                                   std::vector<Candidate>& candidates) const
+{
+  quantizer.DistanceTable(query, table);
+
+  // The approximate squared distance to each point is the sum of one table
+  // entry for each subspace.  The codes and the table are scanned directly, so
+  // that the inner loop is only loads and additions.
+  const size_t numSubspaces = codes.n_rows;
+  const size_t numCentroids = table.n_rows;
+  const double* tableMem = table.memptr();
+  const unsigned char* code = codes.memptr();
+
+  std::priority_queue<Candidate> best;
+  for (size_t i = 0; i < codes.n_cols; ++i, code += numSubspaces)
+  {
+    double distance = 0.0;
+    for (size_t j = 0; j < numSubspaces; ++j)
+      distance += tableMem[j * numCentroids + code[j]];
+
+    if (best.size() < numCandidates)
+    {
+      best.push(Candidate(distance, i));
+    }
+    else if (distance < best.top().first)
+    {
+      best.pop();
+      best.push(Candidate(distance, i));
+    }
+  }
+
+  candidates.resize(best.size());
+  for (size_t i = best.size(); i > 0; --i)
+  {
+    candidates[i - 1] = best.top();
+    best.pop();
+  }
+}
+
+template<typename MatType>
+void PQSearch<MatType>::Search(const MatType& querySet,
+                               const size_t k,
+                               arma::Mat<size_t>& neighbors,
+                               arma::mat& distances) const
+{
+  CheckSearch(querySet, k);
+
+  neighbors.set_size(k, querySet.n_cols);
+  distances.set_size(k, querySet.n_cols);
+
+  // If the user asked for 0 nearest neighbors... we're done.
+  if (k == 0)
+    return;
+
+  #pragma omp parallel
+  {
+    arma::mat table;
+    std::vector<Candidate> candidates;
+
+    #pragma omp for schedule(dynamic)
+    for (omp_size_t i = 0; i < (omp_size_t) querySet.n_cols; ++i)
+    {
+      Candidates(querySet.col(i), k, table, candidates);
+      for (size_t j = 0; j < k; ++j)
+      {
+        neighbors(j, i) = candidates[j].second;
+        distances(j, i) = std::sqrt(candidates[j].first);
+      }
+    }
+  }
+}
+
+template<typename MatType>
+void PQSearch<MatType>::Search(const MatType& querySet,
+                               const size_t k,
+                               arma::Mat<size_t>& neighbors,
+                               arma::mat& distances,
+                               const MatType& referenceSet,
+                               const size_t numCandidates) const
+{
+  CheckSearch(querySet, k);
+
+  if (referenceSet.n_rows != quantizer.Dimensionality() ||
+      referenceSet.n_cols != codes.n_cols)
+  {
+    std::ostringstream oss;
+    oss << "PQSearch::Search(): reference set (" << referenceSet.n_rows << "x"
+        << referenceSet.n_cols << ") does not match the model ("
+        << quantizer.Dimensionality() << "x" << codes.n_cols << ")!";
+    throw std::invalid_argument(oss.str());
+  }
+
+  neighbors.set_size(k, querySet.n_cols);
+  distances.set_size(k, querySet.n_cols);
+
+  // If the user asked for 0 nearest neighbors... we're done.
+  if (k == 0)
+    return;
+
+  const size_t effectiveCandidates = std::min(std::max(numCandidates, k),
+      (size_t) codes.n_cols);
+
+  #pragma omp parallel
+  {
+    arma::mat table;
+    std::vector<Candidate> candidates;
+
+    #pragma omp for schedule(dynamic)
+    for (omp_size_t i = 0; i < (omp_size_t) querySet.n_cols; ++i)
+    {
+      Candidates(querySet.col(i), effectiveCandidates, table, candidates);
+
+      // Replace the approximate distances by the exact ones.
+      for (size_t j = 0; j < candidates.size(); ++j)
+      {
+        candidates[j].first = metric::EuclideanDistance::Evaluate(
+            querySet.col(i), referenceSet.col(candidates[j].second));
+      }
+      std::partial_sort(candidates.begin(), candidates.begin() + k,
+          candidates.end());
+
+      for (size_t j = 0; j < k; ++j)
+      {
+        neighbors(j, i) = candidates[j].second;
+        distances(j, i) = candidates[j].first;
+      }
+    }
+  }
+}
+
+template<typename MatType>
+template<typename Archive>
+void PQSearch<MatType>::serialize(Archive& ar,
+                                  const unsigned int /* version */)
+{
+  ar & BOOST_SERIALIZATION_NVP(quantizer);
+  ar & BOOST_SERIALIZATION_NVP(codes);
+}
+
+} // namespace neighbor
+} // namespace mlpack
+
+#endif
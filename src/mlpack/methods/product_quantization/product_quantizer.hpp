@@ -0,0 +1,150 @@
+/**
+ * @file product_quantizer.hpp
+ *
+ * Definition of the ProductQuantizer class, which compresses points into short
+ * codes by quantizing subspaces separately, as described in the following
+ * paper:
+ *
+ * @code
+ * @article{jegou2011product,
+ *   title={Product quantization for nearest neighbor search},
+ *   author={J{\'e}gou, H. and Douze, M. and Schmid, C.},
+ *   journal={IEEE Transactions on Pattern Analysis and Machine Intelligence},
+ *   volume={33},
+ *   number={1},
+ *   pages={117--128},
+ *   year={2011}
+ * }
+ * @endcode
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_PRODUCT_QUANTIZATION_PRODUCT_QUANTIZER_HPP
+#define MLPACK_METHODS_PRODUCT_QUANTIZATION_PRODUCT_QUANTIZER_HPP
+
+#include <mlpack/prereqs.hpp>
+#include <mlpack/methods/kmeans/kmeans.hpp>
+
+namespace mlpack {
+namespace neighbor {
+
+/**
+ * A ProductQuantizer splits the dimensions of the points into a number of
+ * contiguous subspaces, and clusters each subspace separately with k-means
+ * (with at most 256 centroids).  A point is then encoded as the index of the
+ * closest centroid in each subspace, taking one byte per subspace.  For
+ * instance, 96-dimensional float points encoded with 24 subspaces take 24 bytes
+ * instead of 384.
+ *
+ * The squared Euclidean distance between a query and an encoded point is
+ * approximated by the sum over all subspaces of the squared distance between
+ * the query and the centroid of the point in that subspace.  DistanceTable()
+ * computes all these distances for a query, so that the approximate distance
+ * to each encoded point only takes one table lookup per subspace.
+ *
+ * @tparam MatType Type of (dense) matrix of the points.
+ */
+template<typename MatType = arma::mat>
+class ProductQuantizer
+{
+ public:
+  //! Create an untrained quantizer.  Call Train() before using it.
+  ProductQuantizer();
+
+  /**
+   * Train the quantizer on the given data.
+   *
+   * @param data Points to learn the codebooks from.
+   * @param numSubspaces Number of subspaces (and bytes of each code).
+   * @param numCentroids Number of centroids in each subspace (at most 256).
+   * @param maxIterations Maximum number of k-means iterations.
+   */
+  ProductQuantizer(const MatType& data,
+                   const size_t numSubspaces,
+                   const size_t numCentroids = 256,
+                   const size_t maxIterations = 100);
+
+  /**
+   * Train the quantizer on the given data.  The dimensions are split into
+   * numSubspaces contiguous subspaces of (nearly) equal size, and the
+   * codebook of each subspace is learned with k-means.
+   *
+   * @param data Points to learn the codebooks from.
+   * @param numSubspaces Number of subspaces (and bytes of each code).
+   * @param numCentroids Number of centroids in each subspace (at most 256).
+   * @param maxIterations Maximum number of k-means iterations.
+   */
+  void Train(const MatType& data,
+             const size_t numSubspaces,
+             const size_t numCentroids = 256,
+             const size_t maxIterations = 100);
+
+  /**
+   * Encode the given points.  The codes will be a matrix with one row for each
+   * subspace and one column for each point.
+   *
+   * @param data Points to encode.
+   * @param codes Output codes of the points.
+   */
+  void Encode(const MatType& data, arma::Mat<unsigned char>& codes) const;
+
+  /**
+   * Decode the given codes: each point is replaced by the centroids of its
+   * code.
+   *
+   * @param codes Codes to decode.
+   * @param data Output decoded points.
+   */
+  void Decode(const arma::Mat<unsigned char>& codes, MatType& data) const;
+
+  /**
+   * Compute the squared Euclidean distance between the given query and each
+   * centroid of each subspace.  The table has one row for each centroid and
+   * one column for each subspace, so the approximate squared distance to a
+   * point with code c is the sum of table(c[j], j) over all subspaces j.
+   *
+   * @param query Query point.
+   * @param table Output table of squared distances.
+   */
+  template<typename VecType>
+  void DistanceTable(const VecType& query, arma::mat& table) const;
+
+  //! Get the dimensionality of the points.
+  size_t Dimensionality() const { return subspaceBegin.back(); }
+  //! Get the number of subspaces.
+  size_t NumSubspaces() const { return codebooks.size(); }
+  //! Get the number of centroids in each subspace.
+  size_t NumCentroids() const { return numCentroids; }
+  //! Get the first dimension of the given subspace.
+  size_t SubspaceBegin(const size_t j) const { return subspaceBegin[j]; }
+  //! Get the centroids of the given subspace (one centroid per column).
+  const arma::mat& Codebook(const size_t j) const { return codebooks[j]; }
+
+  /**
+   * Serialize the quantizer.
+   */
+  template<typename Archive>
+  void serialize(Archive& ar, const unsigned int /* version */);
+
+ private:
+  //! The number of points encoded together.
+  static const size_t BlockSize = 1024;
+
+  //! The number of centroids in each subspace.
+  size_t numCentroids;
+  //! The first dimension of each subspace, followed by the dimensionality.
+  std::vector<size_t> subspaceBegin;
+  //! The centroids of each subspace.
+  std::vector<arma::mat> codebooks;
+};
+
+} // namespace neighbor
+} // namespace mlpack
+
+// Include implementation.
+#include "product_quantizer_impl.hpp"
+
+#endif
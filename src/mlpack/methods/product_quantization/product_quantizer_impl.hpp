@@ -0,0 +1,202 @@
+/**
+ * @file product_quantizer_impl.hpp
+ *
+ * Implementation of the ProductQuantizer class.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_PRODUCT_QUANTIZATION_PRODUCT_QUANTIZER_IMPL_HPP
+#define MLPACK_METHODS_PRODUCT_QUANTIZATION_PRODUCT_QUANTIZER_IMPL_HPP
+
+// In case it hasn't been included yet.
+#include "product_quantizer.hpp"
+
+namespace mlpack {
+namespace neighbor {
+
+template<typename MatType>
+ProductQuantizer<MatType>::ProductQuantizer() :
+    numCentroids(0),
+    subspaceBegin(1, 0)
+{
+  // Nothing to do.
+}
+
+template<typename MatType>
+ProductQuantizer<MatType>::ProductQuantizer(const MatType& data,
+                                            const size_t numSubspaces,
+                                            const size_t numCentroids,
+                                            const size_t maxIterations) :
+    numCentroids(0),
+    subspaceBegin(1, 0)
+{
+  Train(data, numSubspaces, numCentroids, maxIterations);
+}
+
+template<typename MatType>
+void ProductQuantizer<MatType>::Train(const MatType& data,
+                                      const size_t numSubspaces,
+                                      const size_t numCentroids,
+                                      const size_t maxIterations)
+{
+  if (numSubspaces == 0 || numSubspaces > data.n_rows)
+  {
+    std::ostringstream oss;
+    oss << "ProductQuantizer::Train(): number of subspaces (" << numSubspaces
+        << ") must be between 1 and the dimensionality of the data ("
+        << data.n_rows << ")!";
+    throw std::invalid_argument(oss.str());
+  }
+
+  if (numCentroids == 0 || numCentroids > 256)
+  {
+    std::ostringstream oss;
+    oss << "ProductQuantizer::Train(): number of centroids (" << numCentroids
+        << ") must be between 1 and 256!";
+    throw std::invalid_argument(oss.str());
+  }
+
+  if (numCentroids > data.n_cols)
+  {
+    std::ostringstream oss;
+    oss << "ProductQuantizer::Train(): number of centroids (" << numCentroids
+        << ") is greater than the number of points (" << data.n_cols << ")!";
+    throw std::invalid_argument(oss.str());
+  }
+
+  this->numCentroids = numCentroids;
+
+  // Split the dimensions as evenly as possible; the first subspaces get one
+  // extra dimension if needed.
+  const size_t baseSize = data.n_rows / numSubspaces;
+  const size_t extra = data.n_rows % numSubspaces;
+  subspaceBegin.resize(numSubspaces + 1);
+  subspaceBegin[0] = 0;
+  for (size_t j = 0; j < numSubspaces; ++j)
+    subspaceBegin[j + 1] = subspaceBegin[j] + baseSize + ((j < extra) ? 1 : 0);
+
+  // Learn the codebook of each subspace.
+  kmeans::KMeans<> kmeans(maxIterations);
+  codebooks.resize(numSubspaces);
+  for (size_t j = 0; j < numSubspaces; ++j)
+  {
+    const arma::mat subspaceData = arma::conv_to<arma::mat>::from(
+        data.rows(subspaceBegin[j], subspaceBegin[j + 1] - 1));
+    kmeans.Cluster(subspaceData, numCentroids, codebooks[j]);
+  }
+}
+
+template<typename MatType>
+void ProductQuantizer<MatType>::Encode(const MatType& data,
+                                       arma::Mat<unsigned char>& codes) const
+{
+  if (data.n_rows != Dimensionality())
+  {
+    std::ostringstream oss;
+    oss << "ProductQuantizer::Encode(): dimensionality of data (" << data.n_rows
+        << ") is not equal to the dimensionality of the quantizer ("
+        << Dimensionality() << ")!";
+    throw std::invalid_argument(oss.str());
+  }
+
+  codes.set_size(NumSubspaces(), data.n_cols);
+
+  // The squared distance to a centroid c is ||x||^2 - 2 c^T x + ||c||^2, and
+  // ||x||^2 does not change which centroid is the closest.
+  std::vector<arma::vec> centroidNorms(NumSubspaces());
+  for (size_t j = 0; j < NumSubspaces(); ++j)
+    centroidNorms[j] = arma::sum(arma::square(codebooks[j]), 0).t();
+
+  // Encode blocks of points in parallel; the distances from each block to all
+  // centroids of a subspace are computed with one matrix product.
+  const size_t numBlocks = (data.n_cols + BlockSize - 1) / BlockSize;
+  #pragma omp parallel for schedule(static)
+  for (omp_size_t b = 0; b < (omp_size_t) numBlocks; ++b)
+  {
+    const size_t begin = b * BlockSize;
+    const size_t end = std::min(begin + BlockSize, (size_t) data.n_cols);
+
+    arma::mat distances;
+    for (size_t j = 0; j < NumSubspaces(); ++j)
+    {
+      const arma::mat block = arma::conv_to<arma::mat>::from(data.submat(
+          subspaceBegin[j], begin, subspaceBegin[j + 1] - 1, end - 1));
+
+      distances = -2.0 * codebooks[j].t() * block;
+      distances.each_col() += centroidNorms[j];
+
+      for (size_t i = 0; i < block.n_cols; ++i)
+      {
+        arma::uword index = 0;
+        distances.col(i).min(index);
+        codes(j, begin + i) = (unsigned char) index;
+      }
+    }
+  }
+}
+
+template<typename MatType>
+void ProductQuantizer<MatType>::Decode(const arma::Mat<unsigned char>& codes,
+                                       MatType& data) const
+{
+  if (codes.n_rows != NumSubspaces())
+  {
+    std::ostringstream oss;
+    oss << "ProductQuantizer::Decode(): number of rows of codes ("
+        << codes.n_rows << ") is not equal to the number of subspaces ("
+        << NumSubspaces() << ")!";
+    throw std::invalid_argument(oss.str());
+  }
+
+  data.set_size(Dimensionality(), codes.n_cols);
+  for (size_t i = 0; i < codes.n_cols; ++i)
+  {
+    for (size_t j = 0; j < NumSubspaces(); ++j)
+    {
+      const double* centroid = codebooks[j].colptr(codes(j, i));
+      for (size_t r = subspaceBegin[j]; r < subspaceBegin[j + 1]; ++r)
+        data(r, i) = centroid[r - subspaceBegin[j]];
+    }
+  }
+}
+
+template<typename MatType>
+template<typename VecType>
+void ProductQuantizer<MatType>::DistanceTable(const VecType& query,
+                                              arma::mat& table) const
+{
+  table.set_size(numCentroids, NumSubspaces());
+  for (size_t j = 0; j < NumSubspaces(); ++j)
+  {
+    for (size_t c = 0; c < numCentroids; ++c)
+    {
+      const double* centroid = codebooks[j].colptr(c);
+      double distance = 0.0;
+      for (size_t r = subspaceBegin[j]; r < subspaceBegin[j + 1]; ++r)
+      {
+        const double diff = query[r] - centroid[r - subspaceBegin[j]];
+        distance += diff * diff;
+      }
+
+      table(c, j) = distance;
+    }
+  }
+}
+
+template<typename MatType>
+template<typename Archive>
+void ProductQuantizer<MatType>::serialize(Archive& ar,
+                                          const unsigned int /* version */)
+{
+  ar & BOOST_SERIALIZATION_NVP(numCentroids);
+  ar & BOOST_SERIALIZATION_NVP(subspaceBegin);
+  ar & BOOST_SERIALIZATION_NVP(codebooks);
+}
+
+} // namespace neighbor
+} // namespace mlpack
+
+#endif
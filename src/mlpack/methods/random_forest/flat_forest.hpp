@@ -0,0 +1,210 @@
+/**
+ * @file flat_forest.hpp
+ *
+ * Definition of the FlatForest class, a compiled form of a trained random
+ * forest or decision tree for fast prediction.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_RANDOM_FOREST_FLAT_FOREST_HPP
+#define MLPACK_METHODS_RANDOM_FOREST_FLAT_FOREST_HPP
+
+#include <mlpack/prereqs.hpp>
+#include "random_forest.hpp"
+
+namespace mlpack {
+namespace tree {
+
+/**
+ * Whether or not a numeric split type sends a point to the left child exactly
+ * when its value is at most the first element of the split information, like
+ * BestBinaryNumericSplit.  Only trees with such numeric splits can be compiled
+ * into a FlatForest.
+ */
+template<typename SplitType>
+struct IsThresholdSplit
+{
+  static const bool value = false;
+};
+
+template<typename FitnessFunction>
+struct IsThresholdSplit<BestBinaryNumericSplit<FitnessFunction>>
+{
+  static const bool value = true;
+};
+
+template<typename FitnessFunction>
+struct IsThresholdSplit<HistogramNumericSplit<FitnessFunction>>
+{
+  static const bool value = true;
+};
+
+/**
+ * Whether or not a categorical split type sends a point to the child with the
+ * index of its category, like AllCategoricalSplit.  Only trees with such
+ * categorical splits can be compiled into a FlatForest.
+ */
+template<typename SplitType>
+struct IsCategoryIndexSplit
+{
+  static const bool value = false;
+};
+
+template<typename FitnessFunction>
+struct IsCategoryIndexSplit<AllCategoricalSplit<FitnessFunction>>
+{
+  static const bool value = true;
+};
+
+/**
+ * A FlatForest is a compiled, read-only form of a trained RandomForest or
+ * DecisionTree that classifies points faster.  The nodes of all trees are
+ * stored in flat arrays (the split dimension, the split value, and the index of
+ * the first child of each node, with the children of a node stored next to each
+ * other), and the class probabilities of all leaves are stored in one matrix.
+ * Points are classified in blocks: each tree is walked by all points of the
+ * block before moving to the next tree, so the nodes of a tree stay in cache.
+ *
+ * A FlatForest gives exactly the same predictions and probabilities as the
+ * forest (or tree) it was compiled from.  It can only be built from trees with
+ * BestBinaryNumericSplit (or HistogramNumericSplit) numeric splits and
+ * AllCategoricalSplit categorical splits.
+ *
+ * @code
+ * RandomForest<> rf(data, labels, numClasses, 500);
+ * FlatForest flat(rf);
+ * flat.Classify(testData, predictions, probabilities);
+ * @endcode
+ */
+class FlatForest
+{
+ public:
+  //! Create an empty FlatForest.
+  FlatForest() : numClasses(0) { }
+
+  /**
+   * Compile the given trained random forest.
+   *
+   * @param forest Random forest to compile.
+   */
+  template<typename FitnessFunction,
+           typename DimensionSelectionType,
+           template<typename> class NumericSplitType,
+           template<typename> class CategoricalSplitType,
+           typename ElemType>
+  FlatForest(const RandomForest<FitnessFunction,
+                                DimensionSelectionType,
+                                NumericSplitType,
+                                CategoricalSplitType,
+                                ElemType>& forest);
+
+  /**
+   * Compile the given trained decision tree, as a forest of one tree.
+   *
+   * @param tree Decision tree to compile.
+   */
+  template<typename FitnessFunction,
+           template<typename> class NumericSplitType,
+           template<typename> class CategoricalSplitType,
+           typename DimensionSelectionType,
+           typename ElemType,
+           bool NoRecursion>
+  FlatForest(const DecisionTree<FitnessFunction,
+                                NumericSplitType,
+                                CategoricalSplitType,
+                                DimensionSelectionType,
+                                ElemType,
+                                NoRecursion>& tree);
+
+  /**
+   * Add the given trained decision tree to the forest.  All trees must have
+   * the same number of classes.
+   *
+   * @param tree Decision tree to add.
+   */
+  template<typename TreeType>
+  void AddTree(const TreeType& tree);
+
+  /**
+   * Predict the classes of the given points.  The prediction is the class
+   * with the highest average probability over all trees.
+   *
+   * @param data Points to classify.
+   * @param predictions Output predictions for each point.
+   */
+  template<typename MatType>
+  void Classify(const MatType& data, arma::Row<size_t>& predictions) const;
+
+  /**
+   * Predict the classes of the given points, and the average class
+   * probabilities over all trees.
+   *
+   * @param data Points to classify.
+   * @param predictions Output predictions for each point.
+   * @param probabilities Output matrix of class probabilities for each point.
+   */
+  template<typename MatType>
+  void Classify(const MatType& data,
+                arma::Row<size_t>& predictions,
+                arma::mat& probabilities) const;
+
+  //! Get the number of trees in the forest.
+  size_t NumTrees() const { return roots.size(); }
+  //! Get the total number of nodes of all trees.
+  size_t NumNodes() const { return children.size(); }
+  //! Get the number of classes.
+  size_t NumClasses() const { return numClasses; }
+
+  /**
+   * Serialize the forest.
+   */
+  template<typename Archive>
+  void serialize(Archive& ar, const unsigned int /* version */);
+
+ private:
+  //! The number of points classified together in a block.
+  static const size_t BlockSize = 64;
+
+  //! The index of the root node of each tree.
+  std::vector<size_t> roots;
+  //! For each node: the split dimension, or for a leaf, the column of its
+  //! class probabilities in leafProbabilities.
+  std::vector<size_t> dimensions;
+  //! For each node: the split value of a numeric split.
+  std::vector<double> thresholds;
+  //! For each node: the index of the first child, or 0 for a leaf.
+  std::vector<size_t> children;
+  //! For each node: whether the split is categorical.
+  std::vector<char> categorical;
+  //! The class probabilities of each leaf.
+  arma::mat leafProbabilities;
+  //! The number of classes.
+  size_t numClasses;
+
+  /**
+   * Store the given node (and all nodes below it) at the given index.  The
+   * class probabilities of the leaves are appended to the given vector.
+   */
+  template<typename TreeType>
+  void AddNode(const TreeType& node,
+               const size_t index,
+               std::vector<const arma::vec*>& leaves);
+
+  /**
+   * Return the column of leafProbabilities of the leaf that the given point
+   * reaches in the tree with the given root.
+   */
+  template<typename ElemType>
+  size_t Leaf(const ElemType* point, const size_t root) const;
+};
+
+} // namespace tree
+} // namespace mlpack
+
+// Include implementation.
+#include "flat_forest_impl.hpp"
+
+#endif
@@ -0,0 +1,209 @@
+/**
+ * @file flat_forest_impl.hpp
+ *
+ * Implementation of the FlatForest class.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_RANDOM_FOREST_FLAT_FOREST_IMPL_HPP
+#define MLPACK_METHODS_RANDOM_FOREST_FLAT_FOREST_IMPL_HPP
+
+// In case it hasn't been included yet.
+#include "flat_forest.hpp"
+
+namespace mlpack {
+namespace tree {
+
+template<typename FitnessFunction,
+         typename DimensionSelectionType,
+         template<typename> class NumericSplitType,
+         template<typename> class CategoricalSplitType,
+         typename ElemType>
+FlatForest::FlatForest(const RandomForest<FitnessFunction,
+                                          DimensionSelectionType,
+                                          NumericSplitType,
+                                          CategoricalSplitType,
+                                          ElemType>& forest) :
+    numClasses(0)
+{
+  for (size_t i = 0; i < forest.NumTrees(); ++i)
+    AddTree(forest.Tree(i));
+}
+
+template<typename FitnessFunction,
+         template<typename> class NumericSplitType,
+         template<typename> class CategoricalSplitType,
+         typename DimensionSelectionType,
+         typename ElemType,
+         bool NoRecursion>
+FlatForest::FlatForest(const DecisionTree<FitnessFunction,
+                                          NumericSplitType,
+                                          CategoricalSplitType,
+                                          DimensionSelectionType,
+                                          ElemType,
+                                          NoRecursion>& tree) :
+    numClasses(0)
+{
+  AddTree(tree);
+}
+
+template<typename TreeType>
+void FlatForest::AddTree(const TreeType& tree)
+{
+  static_assert(IsThresholdSplit<typename TreeType::NumericSplit>::value,
+      "FlatForest: the numeric split type of the tree is not supported");
+  static_assert(
+      IsCategoryIndexSplit<typename TreeType::CategoricalSplit>::value,
+      "FlatForest: the categorical split type of the tree is not supported");
+
+  if (roots.empty())
+  {
+    numClasses = tree.NumClasses();
+  }
+  else if (tree.NumClasses() != numClasses)
+  {
+    std::ostringstream oss;
+    oss << "FlatForest::AddTree(): tree has " << tree.NumClasses()
+        << " classes, but the forest has " << numClasses << " classes!";
+    throw std::invalid_argument(oss.str());
+  }
+
+  // Store the root, and then all the other nodes below it.
+  const size_t root = dimensions.size();
+  dimensions.push_back(0);
+  thresholds.push_back(0.0);
+  children.push_back(0);
+  categorical.push_back(false);
+
+  std::vector<const arma::vec*> leaves;
+  AddNode(tree, root, leaves);
+  roots.push_back(root);
+
+  const size_t firstLeaf = leafProbabilities.n_cols;
+  leafProbabilities.resize(numClasses, firstLeaf + leaves.size());
+  for (size_t i = 0; i < leaves.size(); ++i)
+    leafProbabilities.col(firstLeaf + i) = *leaves[i];
+}
+
+template<typename TreeType>
+void FlatForest::AddNode(const TreeType& node,
+                         const size_t index,
+                         std::vector<const arma::vec*>& leaves)
+{
+  if (node.NumChildren() == 0)
+  {
+    dimensions[index] = leafProbabilities.n_cols + leaves.size();
+    leaves.push_back(&node.ClassProbabilities());
+    return;
+  }
+
+  dimensions[index] = node.SplitDimension();
+  categorical[index] =
+      (node.SplitDimensionType() == data::Datatype::categorical);
+  if (!categorical[index])
+    thresholds[index] = node.ClassProbabilities()[0];
+
+  // The children are stored next to each other.
+  const size_t firstChild = dimensions.size();
+  children[index] = firstChild;
+  dimensions.resize(firstChild + node.NumChildren(), 0);
+  thresholds.resize(firstChild + node.NumChildren(), 0.0);
+  children.resize(firstChild + node.NumChildren(), 0);
+  categorical.resize(firstChild + node.NumChildren(), false);
+
+  for (size_t i = 0; i < node.NumChildren(); ++i)
+    AddNode(node.Child(i), firstChild + i, leaves);
+}
+
+template<typename MatType>
+void FlatForest::Classify(const MatType& data,
+                          arma::Row<size_t>& predictions) const
+{
+  arma::mat probabilities;
+  Classify(data, predictions, probabilities);
+}
+
+template<typename MatType>
+void FlatForest::Classify(const MatType& data,
+                          arma::Row<size_t>& predictions,
+                          arma::mat& probabilities) const
+{
+  if (roots.empty())
+  {
+    predictions.clear();
+    probabilities.clear();
+
+    throw std::invalid_argument("FlatForest::Classify(): no trees in the "
+        "forest!");
+  }
+
+  probabilities.zeros(numClasses, data.n_cols);
+  predictions.set_size(data.n_cols);
+
+  // Each block of points walks all the trees, one tree at a time.  The sums
+  // are made in the same order as in RandomForest::Classify(), so the results
+  // are the same.
+  const size_t numBlocks = (data.n_cols + BlockSize - 1) / BlockSize;
+  #pragma omp parallel for schedule(static)
+  for (omp_size_t b = 0; b < (omp_size_t) numBlocks; ++b)
+  {
+    const size_t begin = b * BlockSize;
+    const size_t end = std::min(begin + BlockSize, (size_t) data.n_cols);
+
+    for (size_t t = 0; t < roots.size(); ++t)
+    {
+      for (size_t i = begin; i < end; ++i)
+      {
+        const double* leafProbs = leafProbabilities.colptr(
+            Leaf(data.colptr(i), roots[t]));
+        double* probs = probabilities.colptr(i);
+        for (size_t c = 0; c < numClasses; ++c)
+          probs[c] += leafProbs[c];
+      }
+    }
+
+    for (size_t i = begin; i < end; ++i)
+    {
+      probabilities.col(i) /= roots.size();
+      arma::uword maxIndex = 0;
+      probabilities.col(i).max(maxIndex);
+      predictions[i] = (size_t) maxIndex;
+    }
+  }
+}
+
+template<typename ElemType>
+size_t FlatForest::Leaf(const ElemType* point, const size_t root) const
+{
+  size_t node = root;
+  while (children[node] != 0)
+  {
+    const ElemType value = point[dimensions[node]];
+    if (categorical[node])
+      node = children[node] + (size_t) value;
+    else
+      node = children[node] + ((value <= thresholds[node]) ? 0 : 1);
+  }
+
+  return dimensions[node];
+}
+
+template<typename Archive>
+void FlatForest::serialize(Archive& ar, const unsigned int /* version */)
+{
+  ar & BOOST_SERIALIZATION_NVP(roots);
+  ar & BOOST_SERIALIZATION_NVP(dimensions);
+  ar & BOOST_SERIALIZATION_NVP(thresholds);
+  ar & BOOST_SERIALIZATION_NVP(children);
+  ar & BOOST_SERIALIZATION_NVP(categorical);
+  ar & BOOST_SERIALIZATION_NVP(leafProbabilities);
+  ar & BOOST_SERIALIZATION_NVP(numClasses);
+}
+
+} // namespace tree
+} // namespace mlpack
+
+#endif
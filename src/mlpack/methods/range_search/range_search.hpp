@@ -262,6 +262,60 @@ class RangeSearch
               std::vector<std::vector<size_t>>& neighbors,
               std::vector<std::vector<double>>& distances);
 
+  /**
+   * Search for all reference points in the given range for each point in the
+   * query set, returning the results in compressed sparse row (CSR) form
+   * instead of as one vector per query point.  That is:
+   *
+   * - offsets has one more element than the number of query points, with
+   *   offsets[0] = 0.
+   *
+   * - neighbors[offsets[i]] through neighbors[offsets[i + 1] - 1] are the
+   *   indices of all the points in the reference set which have distances
+   *   inside the given range to query point i.
+   *
+   * - distances holds the distances corresponding to each entry of neighbors.
+   *
+   * - The neighbors of each query point are not sorted in any particular
+   *   order.
+   *
+   * In naive and single-tree mode, the query points are split between threads
+   * if OpenMP is available, and the results are collected in a few flat
+   * buffers, so no memory is allocated for each individual query point.  In
+   * dual-tree mode, the regular search is performed and its results are
+   * flattened.
+   *
+   * @param querySet Set of query points to search with.
+   * @param range Range of distances in which to search.
+   * @param offsets Object which will hold the offset of the results of each
+   *      query point in neighbors and distances.
+   * @param neighbors Object which will hold the neighbors of all query points.
+   * @param distances Object which will hold the distances of all query points.
+   */
+  void Search(const MatType& querySet,
+              const math::Range& range,
+              arma::Col<size_t>& offsets,
+              arma::Col<size_t>& neighbors,
+              arma::vec& distances);
+
+  /**
+   * Search for all points in the given range for each point in the reference
+   * set, returning the results in compressed sparse row (CSR) form.  This means
+   * that the query set and the reference set are the same, and a point is
+   * never returned in its own range.  See the overload of Search() above for
+   * the output format.
+   *
+   * @param range Range of distances in which to search.
+   * @param offsets Object which will hold the offset of the results of each
+   *      query point in neighbors and distances.
+   * @param neighbors Object which will hold the neighbors of all query points.
+   * @param distances Object which will hold the distances of all query points.
+   */
+  void Search(const math::Range& range,
+              arma::Col<size_t>& offsets,
+              arma::Col<size_t>& neighbors,
+              arma::vec& distances);
+
   //! Get whether single-tree search is being used.
   bool SingleMode() const { return singleMode; }
   //! Modify whether single-tree search is being used.
@@ -284,6 +338,11 @@ class RangeSearch
   //! Return the reference set.
   const MatType& ReferenceSet() const { return *referenceSet; }
 
+  //! Access the original index of each point of the reference set (empty if
+  //! the reference points were not reordered).
+  const std::vector<size_t>& OldFromNewReferences() const
+  { return oldFromNewReferences; }
+
   //! Return the reference tree (or NULL if in naive mode).
   Tree* ReferenceTree() { return referenceTree; }
 
@@ -312,6 +371,26 @@ class RangeSearch
   //! The total number of scores during the last search.
   size_t scores;
 
+  /**
+   * Perform a naive or single-tree search for each point in the given query
+   * set, one query point at a time, and store the results in CSR form.  This
+   * is the implementation of the CSR overloads of Search().
+   *
+   * @param querySet Set of query points to search with.
+   * @param range Range of distances in which to search.
+   * @param sameSet Whether the query set is the reference set.
+   * @param offsets Object which will hold the offset of the results of each
+   *      query point in neighbors and distances.
+   * @param neighbors Object which will hold the neighbors of all query points.
+   * @param distances Object which will hold the distances of all query points.
+   */
+  void SearchCSR(const MatType& querySet,
+                 const math::Range& range,
+                 const bool sameSet,
+                 arma::Col<size_t>& offsets,
+                 arma::Col<size_t>& neighbors,
+                 arma::vec& distances);
+
   //! For access to mappings when building models.
   friend class TrainVisitor;
 };
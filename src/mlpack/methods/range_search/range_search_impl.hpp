@@ -330,29 +330,48 @@ void RangeSearch<MetricType, MatType, TreeType>::Search(
 
   if (naive)
   {
-    RuleType rules(*referenceSet, querySet, range, *neighborPtr, *distancePtr,
-        metric);
+    // The naive brute-force solution.  Each query point only adds to its own
+    // result vectors, so the query points can be split between threads, as
+    // long as each thread has its own rules.
+    #pragma omp parallel
+    {
+      RuleType rules(*referenceSet, querySet, range, *neighborPtr,
+          *distancePtr, metric);
 
-    // The naive brute-force solution.
-    for (size_t i = 0; i < querySet.n_cols; ++i)
-      for (size_t j = 0; j < referenceSet->n_cols; ++j)
-        rules.BaseCase(i, j);
+      #pragma omp for schedule(dynamic, 16)
+      for (omp_size_t i = 0; i < (omp_size_t) querySet.n_cols; ++i)
+        for (size_t j = 0; j < referenceSet->n_cols; ++j)
+          rules.BaseCase(i, j);
+    }
 
     baseCases += (querySet.n_cols * referenceSet->n_cols);
   }
   else if (singleMode)
   {
-    // Create the traverser.
-    RuleType rules(*referenceSet, querySet, range, *neighborPtr, *distancePtr,
-        metric);
-    typename Tree::template SingleTreeTraverser<RuleType> traverser(rules);
-
-    // Now have it traverse for each point.
-    for (size_t i = 0; i < querySet.n_cols; ++i)
-      traverser.Traverse(i, *referenceTree);
+    // Trees whose first point is the centroid cache base cases in the
+    // statistics of reference nodes, so the reference tree can only be shared
+    // between threads for other tree types.
+    size_t threadBaseCases = 0;
+    size_t threadScores = 0;
+    #pragma omp parallel if (!tree::TreeTraits<Tree>::FirstPointIsCentroid) \
+        reduction(+:threadBaseCases, threadScores)
+    {
+      // Create the traverser.
+      RuleType rules(*referenceSet, querySet, range, *neighborPtr,
+          *distancePtr, metric);
+      typename Tree::template SingleTreeTraverser<RuleType> traverser(rules);
+
+      // Now have it traverse for each point.
+      #pragma omp for schedule(dynamic, 16)
+      for (omp_size_t i = 0; i < (omp_size_t) querySet.n_cols; ++i)
+        traverser.Traverse(i, *referenceTree);
+
+      threadBaseCases += rules.BaseCases();
+      threadScores += rules.Scores();
+    }
 
-    baseCases += rules.BaseCases();
-    scores += rules.Scores();
+    baseCases += threadBaseCases;
+    scores += threadScores;
   }
   else // Dual-tree recursion.
   {
@@ -552,33 +571,54 @@ void RangeSearch<MetricType, MatType, TreeType>::Search(
 
   // Create the helper object for the traversal.
   typedef RangeSearchRules<MetricType, Tree> RuleType;
-  RuleType rules(*referenceSet, *referenceSet, range, *neighborPtr,
-      *distancePtr, metric, true /* don't return the query in the results */);
 
   if (naive)
   {
-    // The naive brute-force solution.
-    for (size_t i = 0; i < referenceSet->n_cols; ++i)
-      for (size_t j = 0; j < referenceSet->n_cols; ++j)
-        rules.BaseCase(i, j);
+    // The naive brute-force solution, split between threads as in the
+    // bichromatic case.
+    #pragma omp parallel
+    {
+      RuleType rules(*referenceSet, *referenceSet, range, *neighborPtr,
+          *distancePtr, metric, true /* don't return the query */);
+
+      #pragma omp for schedule(dynamic, 16)
+      for (omp_size_t i = 0; i < (omp_size_t) referenceSet->n_cols; ++i)
+        for (size_t j = 0; j < referenceSet->n_cols; ++j)
+          rules.BaseCase(i, j);
+    }
 
     baseCases = (referenceSet->n_cols * referenceSet->n_cols);
     scores = 0;
   }
   else if (singleMode)
   {
-    // Create the traverser.
-    typename Tree::template SingleTreeTraverser<RuleType> traverser(rules);
-
-    // Now have it traverse for each point.
-    for (size_t i = 0; i < referenceSet->n_cols; ++i)
-      traverser.Traverse(i, *referenceTree);
+    size_t threadBaseCases = 0;
+    size_t threadScores = 0;
+    #pragma omp parallel if (!tree::TreeTraits<Tree>::FirstPointIsCentroid) \
+        reduction(+:threadBaseCases, threadScores)
+    {
+      // Create the traverser.
+      RuleType rules(*referenceSet, *referenceSet, range, *neighborPtr,
+          *distancePtr, metric, true /* don't return the query */);
+      typename Tree::template SingleTreeTraverser<RuleType> traverser(rules);
+
+      // Now have it traverse for each point.
+      #pragma omp for schedule(dynamic, 16)
+      for (omp_size_t i = 0; i < (omp_size_t) referenceSet->n_cols; ++i)
+        traverser.Traverse(i, *referenceTree);
+
+      threadBaseCases += rules.BaseCases();
+      threadScores += rules.Scores();
+    }
 
-    baseCases = rules.BaseCases();
-    scores = rules.Scores();
+    baseCases = threadBaseCases;
+    scores = threadScores;
   }
   else // Dual-tree recursion.
   {
+    RuleType rules(*referenceSet, *referenceSet, range, *neighborPtr,
+        *distancePtr, metric, true /* don't return the query in the results */);
+
     // Create the traverser.
     typename Tree::template DualTreeTraverser<RuleType> traverser(rules);
 
@@ -618,6 +658,210 @@ void RangeSearch<MetricType, MatType, TreeType>::Search(
   }
 }
 
+template<typename MetricType,
+         typename MatType,
+         template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType>
+void RangeSearch<MetricType, MatType, TreeType>::Search(
+    const MatType& querySet,
+    const math::Range& range,
+    arma::Col<size_t>& offsets,
+    arma::Col<size_t>& neighbors,
+    arma::vec& distances)
+{
+  if (querySet.n_rows != referenceSet->n_rows)
+  {
+    std::ostringstream oss;
+    oss << "RangeSearch::Search(): dimensionalities of query set ("
+        << querySet.n_rows << ") and reference set (" << referenceSet->n_rows
+        << ") do not match!";
+    throw std::invalid_argument(oss.str());
+  }
+
+  SearchCSR(querySet, range, false, offsets, neighbors, distances);
+}
+
+template<typename MetricType,
+         typename MatType,
+         template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType>
+void RangeSearch<MetricType, MatType, TreeType>::Search(
+    const math::Range& range,
+    arma::Col<size_t>& offsets,
+    arma::Col<size_t>& neighbors,
+    arma::vec& distances)
+{
+  SearchCSR(*referenceSet, range, true, offsets, neighbors, distances);
+}
+
+template<typename MetricType,
+         typename MatType,
+         template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType>
+void RangeSearch<MetricType, MatType, TreeType>::SearchCSR(
+    const MatType& querySet,
+    const math::Range& range,
+    const bool sameSet,
+    arma::Col<size_t>& offsets,
+    arma::Col<size_t>& neighbors,
+    arma::vec& distances)
+{
+  const size_t numQueries = querySet.n_cols;
+  offsets.zeros(numQueries + 1);
+
+  // If there are no points, there is no search to be done.
+  if (referenceSet->n_cols == 0 || numQueries == 0)
+  {
+    neighbors.reset();
+    distances.reset();
+    return;
+  }
+
+  // Dual-tree search traverses a query tree instead of single query points,
+  // so in that case we run the regular search and flatten its results.
+  if (!naive && !singleMode)
+  {
+    std::vector<std::vector<size_t>> neighborLists;
+    std::vector<std::vector<double>> distanceLists;
+    if (sameSet)
+      Search(range, neighborLists, distanceLists);
+    else
+      Search(querySet, range, neighborLists, distanceLists);
+
+    for (size_t i = 0; i < numQueries; ++i)
+      offsets[i + 1] = offsets[i] + neighborLists[i].size();
+
+    neighbors.set_size(offsets[numQueries]);
+    distances.set_size(offsets[numQueries]);
+    for (size_t i = 0; i < numQueries; ++i)
+    {
+      std::copy(neighborLists[i].begin(), neighborLists[i].end(),
+          neighbors.memptr() + offsets[i]);
+      std::copy(distanceLists[i].begin(), distanceLists[i].end(),
+          distances.memptr() + offsets[i]);
+    }
+
+    return;
+  }
+
+  Timer::Start("range_search/computing_neighbors");
+
+  // Reference indices must be mapped back if we built the tree ourselves.  In
+  // the monochromatic case, the query points are the (rearranged) reference
+  // points, but the results must be ordered by original index.
+  const bool mapReferences = treeOwner &&
+      tree::TreeTraits<Tree>::RearrangesDataset;
+  std::vector<size_t> newFromOld;
+  if (sameSet && mapReferences)
+  {
+    newFromOld.resize(oldFromNewReferences.size());
+    for (size_t i = 0; i < oldFromNewReferences.size(); ++i)
+      newFromOld[oldFromNewReferences[i]] = i;
+  }
+
+  size_t numThreads = 1;
+  #ifdef HAS_OPENMP
+    numThreads = omp_get_max_threads();
+  #endif
+
+  // The query points are split into contiguous blocks, and each block collects
+  // its results in its own flat buffers.  There are more blocks than threads so
+  // that the work can be balanced dynamically.
+  const size_t numBlocks = std::min(numQueries, 16 * numThreads);
+  std::vector<std::vector<size_t>> blockNeighbors(numBlocks);
+  std::vector<std::vector<double>> blockDistances(numBlocks);
+
+  typedef RangeSearchRules<MetricType, Tree> RuleType;
+
+  // Trees whose first point is the centroid cache base cases in the statistics
+  // of reference nodes, so the reference tree can't be shared between threads.
+  const bool parallel = naive ||
+      !tree::TreeTraits<Tree>::FirstPointIsCentroid;
+
+  size_t blockBaseCases = 0;
+  size_t blockScores = 0;
+  #pragma omp parallel for schedule(dynamic) if (parallel) \
+      reduction(+:blockBaseCases, blockScores)
+  for (omp_size_t b = 0; b < (omp_size_t) numBlocks; ++b)
+  {
+    const size_t begin = b * numQueries / numBlocks;
+    const size_t end = (b + 1) * numQueries / numBlocks;
+
+    // Each query point is searched on its own, as a one-point query set, so
+    // the rules only need result vectors for one point.  These keep their
+    // capacity between query points.
+    arma::mat query(querySet.n_rows, 1);
+    std::vector<std::vector<size_t>> queryNeighbors(1);
+    std::vector<std::vector<double>> queryDistances(1);
+
+    for (size_t i = begin; i < end; ++i)
+    {
+      const size_t queryIndex = newFromOld.empty() ? i : newFromOld[i];
+      query.col(0) = querySet.col(queryIndex);
+      queryNeighbors[0].clear();
+      queryDistances[0].clear();
+
+      RuleType rules(*referenceSet, query, range, queryNeighbors,
+          queryDistances, metric);
+
+      if (naive)
+      {
+        for (size_t j = 0; j < referenceSet->n_cols; ++j)
+          rules.BaseCase(0, j);
+      }
+      else
+      {
+        typename Tree::template SingleTreeTraverser<RuleType> traverser(rules);
+        traverser.Traverse(0, *referenceTree);
+      }
+
+      blockBaseCases += rules.BaseCases();
+      blockScores += rules.Scores();
+
+      const size_t oldSize = blockNeighbors[b].size();
+      for (size_t j = 0; j < queryNeighbors[0].size(); ++j)
+      {
+        // In the monochromatic case, a point is not in its own range.
+        if (sameSet && queryNeighbors[0][j] == queryIndex)
+          continue;
+
+        blockNeighbors[b].push_back(mapReferences ?
+            oldFromNewReferences[queryNeighbors[0][j]] :
+            queryNeighbors[0][j]);
+        blockDistances[b].push_back(queryDistances[0][j]);
+      }
+
+      // For now, just store the number of results of this query point.
+      offsets[i + 1] = blockNeighbors[b].size() - oldSize;
+    }
+  }
+
+  baseCases = blockBaseCases;
+  scores = blockScores;
+
+  // Turn the counts into offsets, and then copy each block to its place.
+  for (size_t i = 0; i < numQueries; ++i)
+    offsets[i + 1] += offsets[i];
+
+  neighbors.set_size(offsets[numQueries]);
+  distances.set_size(offsets[numQueries]);
+
+  #pragma omp parallel for
+  for (omp_size_t b = 0; b < (omp_size_t) numBlocks; ++b)
+  {
+    const size_t begin = offsets[b * numQueries / numBlocks];
+    std::copy(blockNeighbors[b].begin(), blockNeighbors[b].end(),
+        neighbors.memptr() + begin);
+    std::copy(blockDistances[b].begin(), blockDistances[b].end(),
+        distances.memptr() + begin);
+  }
+
+  Timer::Stop("range_search/computing_neighbors");
+}
+
 template<typename MetricType,
          typename MatType,
          template<typename TreeMetricType,
@@ -13,6 +13,7 @@
 #define MLPACK_METHODS_RANGE_SEARCH_RANGE_SEARCH_RULES_HPP
 
 #include <mlpack/core/tree/traversal_info.hpp>
+#include <mlpack/core/metrics/batch_distances.hpp>
 
 namespace mlpack {
 namespace range {
@@ -57,6 +58,20 @@ class RangeSearchRules
    */
   double BaseCase(const size_t queryIndex, const size_t referenceIndex);
 
+  /**
+   * Perform the base cases between the query point and each of the given
+   * consecutive reference points, like calling BaseCase() for each of them.
+   * If the metric is an LMetric, all the distances are computed in one batch
+   * with LMetric::BatchEvaluate().
+   *
+   * @param queryIndex Index of query point.
+   * @param referenceBegin Index of the first reference point.
+   * @param referenceCount Number of reference points.
+   */
+  void BatchBaseCase(const size_t queryIndex,
+                     const size_t referenceBegin,
+                     const size_t referenceCount);
+
   /**
    * Get the score for recursion order.  A low score indicates priority for
    * recursion, while DBL_MAX indicates that the node should not be recursed
@@ -144,6 +159,9 @@ class RangeSearchRules
   //! The last reference index.
   size_t lastReferenceIndex;
 
+  //! The distances computed by the last call to BatchBaseCase().
+  arma::vec batchDistances;
+
   //! Add all the points in the given node to the results for the given query
   //! point.  If the base case has already been calculated, we make sure to not
   //! add that to the results twice.
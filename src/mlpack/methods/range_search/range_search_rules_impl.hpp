@@ -75,6 +75,42 @@ double RangeSearchRules<MetricType, TreeType>::BaseCase(
   return distance;
 }
 
+template<typename MetricType, typename TreeType>
+void RangeSearchRules<MetricType, TreeType>::BatchBaseCase(
+    const size_t queryIndex,
+    const size_t referenceBegin,
+    const size_t referenceCount)
+{
+  if (referenceCount == 0)
+    return;
+
+  metric::BatchDistances(metric, querySet, referenceSet, queryIndex,
+      referenceBegin, referenceCount, batchDistances);
+
+  for (size_t i = 0; i < referenceCount; ++i)
+  {
+    const size_t referenceIndex = referenceBegin + i;
+    if (sameSet && (queryIndex == referenceIndex))
+      continue;
+
+    // If we have just performed this base case, don't do it again.
+    if ((lastQueryIndex == queryIndex) &&
+        (lastReferenceIndex == referenceIndex))
+      continue;
+
+    ++baseCases;
+    if (range.Contains(batchDistances[i]))
+    {
+      neighbors[queryIndex].push_back(referenceIndex);
+      distances[queryIndex].push_back(batchDistances[i]);
+    }
+  }
+
+  // Update last indices, as BaseCase() would.
+  lastQueryIndex = queryIndex;
+  lastReferenceIndex = referenceBegin + referenceCount - 1;
+}
+
 //! Single-tree scoring function.
 template<typename MetricType, typename TreeType>
 double RangeSearchRules<MetricType, TreeType>::Score(const size_t queryIndex,
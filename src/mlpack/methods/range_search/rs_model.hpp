@@ -171,6 +171,19 @@ class ReferenceSetVisitor : public boost::static_visitor<const arma::mat&>
   const arma::mat& operator()(RSType* rs) const;
 };
 
+/**
+ * OldFromNewVisitor exposes the original index of each reference point of the
+ * given RSType.
+ */
+class OldFromNewVisitor :
+    public boost::static_visitor<const std::vector<size_t>&>
+{
+ public:
+  //! Return the mappings of the reference set.
+  template<typename RSType>
+  const std::vector<size_t>& operator()(RSType* rs) const;
+};
+
 /**
  * DeleteVisitor deletes the given RSType instance.
  */
@@ -259,6 +272,25 @@ class RSModel
                  RSType<tree::UBTree>*,
                  RSType<tree::Octree>*> rSearch;
 
+  //! The index of each point of the reference set, in the original order of
+  //! the reference set.  This is empty if the index of each point is its
+  //! position.
+  arma::Col<size_t> referenceIndices;
+  //! Whether each point of the reference set (in the original order) has been
+  //! deleted.  This is empty if no point was deleted.
+  std::vector<bool> deleted;
+  //! The number of deleted points of the reference set.
+  size_t numDeleted;
+  //! The points inserted since the reference tree was built.
+  arma::mat insertedPoints;
+  //! The index of each inserted point.
+  arma::Col<size_t> insertedIndices;
+  //! The index of the next inserted point.
+  size_t nextIndex;
+  //! The tree is rebuilt when the number of pending changes exceeds this
+  //! fraction of the size of the reference set.
+  double rebuildFraction;
+
  public:
   /**
    * Initialize the RSModel with the given type and whether or not a random
@@ -300,7 +332,7 @@ class RSModel
 
   //! Serialize the range search model.
   template<typename Archive>
-  void serialize(Archive& ar, const unsigned int /* version */);
+  void serialize(Archive& ar, const unsigned int version);
 
   //! Expose the dataset.
   const arma::mat& Dataset() const;
@@ -363,7 +395,8 @@ class RSModel
   /**
    * Perform monochromatic range search, with the reference set as the query
    * set.  For more information on the output format, see
-   * RangeSearch<>::Search().
+   * RangeSearch<>::Search().  If points were inserted or deleted, the results
+   * are for the current points, in increasing order of their indices.
    *
    * @param range Range to search for.
    * @param neighbors Output: neighbors falling within the desired range.
@@ -373,7 +406,72 @@ class RSModel
               std::vector<std::vector<size_t>>& neighbors,
               std::vector<std::vector<double>>& distances);
 
+  /**
+   * Insert the given points into the model.  The reference tree is not
+   * modified: the inserted points are searched by brute force until the next
+   * call to Rebuild().  The points are given the next unused indices, which
+   * do not change when the tree is rebuilt.
+   *
+   * @param points Points to insert.
+   */
+  void Insert(const arma::mat& points);
+
+  /**
+   * Delete the point with the given index from the model.  A point of the
+   * reference tree is only marked as deleted and skipped by searches, so the
+   * bounds of the tree are only tightened by the next call to Rebuild().  An
+   * exception is thrown if there is no point with the given index.
+   *
+   * @param index Index of the point to delete.
+   */
+  void Delete(const size_t index);
+
+  /**
+   * Rebuild the reference tree on the current points: the deleted points are
+   * removed and the inserted points are added.  The indices of the points do
+   * not change.  This is called by Insert() and Delete() when the number of
+   * pending changes exceeds RebuildFraction() times the size of the reference
+   * set.
+   */
+  void Rebuild();
+
+  //! Get the number of insertions and deletions since the tree was built.
+  size_t PendingChanges() const { return insertedPoints.n_cols + numDeleted; }
+
+  //! Get the fraction of the reference set size above which the number of
+  //! pending changes triggers a rebuild.
+  double RebuildFraction() const { return rebuildFraction; }
+  //! Modify the fraction of the reference set size above which the number of
+  //! pending changes triggers a rebuild.
+  double& RebuildFraction() { return rebuildFraction; }
+
  private:
+  //! Return whether the indices of the results have to be mapped, because
+  //! points were inserted or deleted.
+  bool Modified() const
+  {
+    return numDeleted > 0 || insertedPoints.n_cols > 0 ||
+        referenceIndices.n_elem > 0;
+  }
+
+  //! Get the current points, in increasing order of their indices, and their
+  //! indices.
+  void CurrentPoints(arma::mat& points, arma::Col<size_t>& indices) const;
+
+  /**
+   * Search for the current points in the given range of each query point.  If
+   * queryIndices is not empty, it holds the index of each query point, which
+   * is never returned as its own neighbor.
+   */
+  void SearchModified(const arma::mat& querySet,
+                      const math::Range& range,
+                      std::vector<std::vector<size_t>>& neighbors,
+                      std::vector<std::vector<double>>& distances,
+                      const arma::Col<size_t>& queryIndices);
+
+  //! Rebuild the tree if there are too many pending changes.
+  void CheckRebuild();
+
   /**
    * Return a string representing the name of the tree.  This is used for
    * logging output.
@@ -389,6 +487,9 @@ class RSModel
 } // namespace range
 } // namespace mlpack
 
+//! Set the serialization version of the RSModel class.
+BOOST_CLASS_VERSION(mlpack::range::RSModel, 1);
+
 // Include implementation (of serialize() and inline functions).
 #include "rs_model_impl.hpp"
 
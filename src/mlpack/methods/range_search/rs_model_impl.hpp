@@ -28,7 +28,10 @@ namespace range {
 inline RSModel::RSModel(TreeTypes treeType, bool randomBasis) :
     treeType(treeType),
     leafSize(0),
-    randomBasis(randomBasis)
+    randomBasis(randomBasis),
+    numDeleted(0),
+    nextIndex(0),
+    rebuildFraction(0.1)
 {
   // Nothing to do.
 }
@@ -39,7 +42,14 @@ inline RSModel::RSModel(const RSModel& other) :
     leafSize(other.leafSize),
     randomBasis(other.randomBasis),
     q(other.q),
-    rSearch(other.rSearch)
+    rSearch(other.rSearch),
+    referenceIndices(other.referenceIndices),
+    deleted(other.deleted),
+    numDeleted(other.numDeleted),
+    insertedPoints(other.insertedPoints),
+    insertedIndices(other.insertedIndices),
+    nextIndex(other.nextIndex),
+    rebuildFraction(other.rebuildFraction)
 {
   // Nothing to do.
 }
@@ -50,13 +60,23 @@ inline RSModel::RSModel(RSModel&& other) :
     leafSize(other.leafSize),
     randomBasis(other.randomBasis),
     q(std::move(other.q)),
-    rSearch(std::move(other.rSearch))
+    rSearch(std::move(other.rSearch)),
+    referenceIndices(std::move(other.referenceIndices)),
+    deleted(std::move(other.deleted)),
+    numDeleted(other.numDeleted),
+    insertedPoints(std::move(other.insertedPoints)),
+    insertedIndices(std::move(other.insertedIndices)),
+    nextIndex(other.nextIndex),
+    rebuildFraction(other.rebuildFraction)
 {
   // Reset other model.
   other.treeType = TreeTypes::KD_TREE;
   other.leafSize = 0;
   other.randomBasis = false;
   other.rSearch = decltype(other.rSearch)();
+  other.deleted.clear();
+  other.numDeleted = 0;
+  other.nextIndex = 0;
 }
 
 inline RSModel& RSModel::operator=(RSModel other)
@@ -68,6 +88,13 @@ inline RSModel& RSModel::operator=(RSModel other)
   randomBasis = other.randomBasis;
   q = std::move(other.q);
   rSearch = std::move(other.rSearch);
+  referenceIndices = std::move(other.referenceIndices);
+  deleted = std::move(other.deleted);
+  numDeleted = other.numDeleted;
+  insertedPoints = std::move(other.insertedPoints);
+  insertedIndices = std::move(other.insertedIndices);
+  nextIndex = other.nextIndex;
+  rebuildFraction = other.rebuildFraction;
 
   return *this;
 }
@@ -164,6 +191,14 @@ inline void RSModel::BuildModel(arma::mat&& referenceSet,
       break;
   }
 
+  // All the points are new, so there are no pending changes.
+  referenceIndices.reset();
+  deleted.clear();
+  numDeleted = 0;
+  insertedPoints.reset();
+  insertedIndices.reset();
+  nextIndex = referenceSet.n_cols;
+
   TrainVisitor tn(std::move(referenceSet), leafSize);
   boost::apply_visitor(tn, rSearch);
 
@@ -194,6 +229,13 @@ inline void RSModel::Search(arma::mat&& querySet,
     Log::Info << "brute-force (naive) search..." << std::endl;
 
 
+  if (Modified())
+  {
+    SearchModified(querySet, range, neighbors, distances,
+        arma::Col<size_t>());
+    return;
+  }
+
   BiSearchVisitor search(querySet, range, neighbors, distances,
       leafSize);
   boost::apply_visitor(search, rSearch);
@@ -213,10 +255,228 @@ inline void RSModel::Search(const math::Range& range,
   else
     Log::Info << "brute-force (naive) search..." << std::endl;
 
+  if (Modified())
+  {
+    // Search for the current points among themselves.
+    arma::mat points;
+    arma::Col<size_t> indices;
+    CurrentPoints(points, indices);
+    SearchModified(points, range, neighbors, distances, indices);
+    return;
+  }
+
   MonoSearchVisitor search(range, neighbors, distances);
   boost::apply_visitor(search, rSearch);
 }
 
+// Insert points into the model.
+inline void RSModel::Insert(const arma::mat& points)
+{
+  if (points.n_rows != Dataset().n_rows)
+  {
+    std::ostringstream oss;
+    oss << "RSModel::Insert(): dimensionality of points (" << points.n_rows
+        << ") does not match dimensionality of model (" << Dataset().n_rows
+        << ")!";
+    throw std::invalid_argument(oss.str());
+  }
+
+  // The inserted points are projected like the reference set.
+  if (insertedPoints.n_cols == 0)
+    insertedPoints = randomBasis ? arma::mat(q * points) : points;
+  else if (randomBasis)
+    insertedPoints.insert_cols(insertedPoints.n_cols, q * points);
+  else
+    insertedPoints.insert_cols(insertedPoints.n_cols, points);
+
+  insertedIndices.resize(insertedPoints.n_cols);
+  for (size_t i = insertedPoints.n_cols - points.n_cols;
+       i < insertedPoints.n_cols; ++i)
+    insertedIndices[i] = nextIndex++;
+
+  CheckRebuild();
+}
+
+// Delete a point from the model.
+inline void RSModel::Delete(const size_t index)
+{
+  // The indices of the inserted points and of the reference points are both
+  // sorted, so we can use binary search.
+  const size_t* insertedEnd = insertedIndices.memptr() + insertedIndices.n_elem;
+  const size_t* inserted = std::lower_bound(insertedIndices.memptr(),
+      insertedEnd, index);
+  if (inserted != insertedEnd && *inserted == index)
+  {
+    // Inserted points are not in the tree, so they can be removed directly.
+    const size_t i = inserted - insertedIndices.memptr();
+    insertedPoints.shed_col(i);
+    insertedIndices.shed_row(i);
+    return;
+  }
+
+  const size_t numPoints = Dataset().n_cols;
+  size_t point = index;
+  if (referenceIndices.n_elem > 0)
+  {
+    point = std::lower_bound(referenceIndices.memptr(),
+        referenceIndices.memptr() + numPoints, index) -
+        referenceIndices.memptr();
+    if (point < numPoints && referenceIndices[point] != index)
+      point = numPoints;
+  }
+
+  if (point >= numPoints || (!deleted.empty() && deleted[point]))
+  {
+    std::ostringstream oss;
+    oss << "RSModel::Delete(): there is no point with index " << index << "!";
+    throw std::invalid_argument(oss.str());
+  }
+
+  if (deleted.empty())
+    deleted.resize(numPoints, false);
+  deleted[point] = true;
+  ++numDeleted;
+
+  CheckRebuild();
+}
+
+// Rebuild the reference tree on the current points.
+inline void RSModel::Rebuild()
+{
+  arma::mat points;
+  arma::Col<size_t> indices;
+  CurrentPoints(points, indices);
+
+  if (!Naive())
+  {
+    Timer::Start("tree_building");
+    Log::Info << "Rebuilding reference tree with " << points.n_cols
+        << " points..." << std::endl;
+  }
+
+  // The points are already projected onto the random basis, if necessary.
+  TrainVisitor tn(std::move(points), leafSize);
+  boost::apply_visitor(tn, rSearch);
+
+  // The indices are sorted, so they are the positions of the points if the
+  // last one is.
+  if (indices.n_elem > 0 && indices[indices.n_elem - 1] == indices.n_elem - 1)
+    referenceIndices.reset();
+  else
+    referenceIndices = std::move(indices);
+
+  deleted.clear();
+  numDeleted = 0;
+  insertedPoints.reset();
+  insertedIndices.reset();
+
+  if (!Naive())
+  {
+    Timer::Stop("tree_building");
+    Log::Info << "Tree rebuilt." << std::endl;
+  }
+}
+
+// Get the current points and their indices.
+inline void RSModel::CurrentPoints(arma::mat& points,
+                                   arma::Col<size_t>& indices) const
+{
+  const arma::mat& dataset = Dataset();
+  const std::vector<size_t>& oldFromNew =
+      boost::apply_visitor(OldFromNewVisitor(), rSearch);
+
+  // Find where each reference point is in the (possibly reordered) dataset.
+  std::vector<size_t> newFromOld(oldFromNew.size());
+  for (size_t i = 0; i < oldFromNew.size(); ++i)
+    newFromOld[oldFromNew[i]] = i;
+
+  points.set_size(dataset.n_rows,
+      dataset.n_cols - numDeleted + insertedPoints.n_cols);
+  indices.set_size(points.n_cols);
+  size_t col = 0;
+  for (size_t i = 0; i < dataset.n_cols; ++i)
+  {
+    if (!deleted.empty() && deleted[i])
+      continue;
+
+    points.col(col) = dataset.col(newFromOld.empty() ? i : newFromOld[i]);
+    indices[col] = (referenceIndices.n_elem == 0) ? i : referenceIndices[i];
+    ++col;
+  }
+
+  // The inserted points have the largest indices.
+  for (size_t i = 0; i < insertedPoints.n_cols; ++i, ++col)
+  {
+    points.col(col) = insertedPoints.col(i);
+    indices[col] = insertedIndices[i];
+  }
+}
+
+// Search among the current points.
+inline void RSModel::SearchModified(
+    const arma::mat& querySet,
+    const math::Range& range,
+    std::vector<std::vector<size_t>>& neighbors,
+    std::vector<std::vector<double>>& distances,
+    const arma::Col<size_t>& queryIndices)
+{
+  const bool excludeSelf = (queryIndices.n_elem > 0);
+
+  // Search the tree, then drop the deleted points (and the query point
+  // itself) from the results.
+  std::vector<std::vector<size_t>> treeNeighbors;
+  std::vector<std::vector<double>> treeDistances;
+  BiSearchVisitor search(querySet, range, treeNeighbors, treeDistances,
+      leafSize);
+  boost::apply_visitor(search, rSearch);
+
+  neighbors.clear();
+  neighbors.resize(querySet.n_cols);
+  distances.clear();
+  distances.resize(querySet.n_cols);
+
+  #pragma omp parallel for schedule(static)
+  for (omp_size_t i = 0; i < (omp_size_t) querySet.n_cols; ++i)
+  {
+    for (size_t j = 0; j < treeNeighbors[i].size(); ++j)
+    {
+      const size_t point = treeNeighbors[i][j];
+      if (!deleted.empty() && deleted[point])
+        continue;
+
+      const size_t index = (referenceIndices.n_elem == 0) ? point :
+          referenceIndices[point];
+      if (excludeSelf && index == queryIndices[i])
+        continue;
+
+      neighbors[i].push_back(index);
+      distances[i].push_back(treeDistances[i][j]);
+    }
+
+    // Now add the inserted points by brute force.
+    for (size_t j = 0; j < insertedPoints.n_cols; ++j)
+    {
+      if (excludeSelf && insertedIndices[j] == queryIndices[i])
+        continue;
+
+      const double distance = metric::EuclideanDistance::Evaluate(
+          querySet.col(i), insertedPoints.col(j));
+      if (range.Contains(distance))
+      {
+        neighbors[i].push_back(insertedIndices[j]);
+        distances[i].push_back(distance);
+      }
+    }
+  }
+}
+
+// Rebuild the reference tree if there are too many pending changes.
+inline void RSModel::CheckRebuild()
+{
+  if (PendingChanges() > rebuildFraction * Dataset().n_cols)
+    Rebuild();
+}
+
 // Get the name of the tree type.
 inline std::string RSModel::TreeName() const
 {
@@ -422,6 +682,15 @@ const arma::mat& ReferenceSetVisitor::operator()(RSType* rs) const
   throw std::runtime_error("no range search model initialized");
 }
 
+//! Expose the mappings of the reference set of the given RSType.
+template<typename RSType>
+const std::vector<size_t>& OldFromNewVisitor::operator()(RSType* rs) const
+{
+  if (rs)
+    return rs->OldFromNewReferences();
+  throw std::runtime_error("no range search model initialized");
+}
+
 //! For cleaning memory
 template<typename RSType>
 void DeleteVisitor::operator()(RSType* rs) const
@@ -450,9 +719,12 @@ bool& NaiveVisitor::operator()(RSType* rs) const
 
 // Serialize the model.
 template<typename Archive>
-void RSModel::serialize(Archive& ar, const unsigned int /* version */)
+void RSModel::serialize(Archive& ar, const unsigned int version)
 {
   ar & BOOST_SERIALIZATION_NVP(treeType);
+  // Older versions of RSModel did not save the leaf size.
+  if (version > 0)
+    ar & BOOST_SERIALIZATION_NVP(leafSize);
   ar & BOOST_SERIALIZATION_NVP(randomBasis);
   ar & BOOST_SERIALIZATION_NVP(q);
 
@@ -462,6 +734,30 @@ void RSModel::serialize(Archive& ar, const unsigned int /* version */)
 
   // We'll only need to serialize one of the model objects, based on the type.
   ar & BOOST_SERIALIZATION_NVP(rSearch);
+
+  // Older versions of RSModel did not support insertions and deletions.
+  if (version > 0)
+  {
+    ar & BOOST_SERIALIZATION_NVP(referenceIndices);
+    ar & BOOST_SERIALIZATION_NVP(deleted);
+    ar & BOOST_SERIALIZATION_NVP(numDeleted);
+    ar & BOOST_SERIALIZATION_NVP(insertedPoints);
+    ar & BOOST_SERIALIZATION_NVP(insertedIndices);
+    ar & BOOST_SERIALIZATION_NVP(nextIndex);
+    ar & BOOST_SERIALIZATION_NVP(rebuildFraction);
+  }
+  else if (Archive::is_loading::value)
+  {
+    // The leaf size was not saved, so the default is used for rebuilding.
+    leafSize = 20;
+    referenceIndices.reset();
+    deleted.clear();
+    numDeleted = 0;
+    insertedPoints.reset();
+    insertedIndices.reset();
+    nextIndex = Dataset().n_cols;
+    rebuildFraction = 0.1;
+  }
 }
 
 inline const arma::mat& RSModel::Dataset() const
@@ -3208,6 +3208,91 @@ BOOST_AUTO_TEST_CASE(ConvolutionLayerPaddingTest)
   module2.Backward(input, output, delta);
 }
 
+/**
+ * Test that the Convolution layer gives the same results with the im2col
+ * convolution rules as with the naive convolution rules, and that the im2col
+ * gradients match numerical gradients for strides larger than one.
+ */
+BOOST_AUTO_TEST_CASE(Im2ColConvolutionLayerTest)
+{
+  typedef Convolution<Im2ColConvolution<ValidConvolution>,
+                      Im2ColConvolution<FullConvolution>,
+                      Im2ColConvolution<ValidConvolution> > Im2ColLayer;
+
+  // Three 7x6 input maps, four output maps, a 3x2 kernel, uneven padding, and
+  // a batch of five samples.
+  Convolution<> naive(3, 4, 3, 2, 1, 1, std::tuple<size_t, size_t>(1, 2),
+      std::tuple<size_t, size_t>(0, 1), 7, 6);
+  Im2ColLayer im2col(3, 4, 3, 2, 1, 1, std::tuple<size_t, size_t>(1, 2),
+      std::tuple<size_t, size_t>(0, 1), 7, 6);
+  naive.Parameters().randn();
+  im2col.Parameters() = naive.Parameters();
+  naive.Reset();
+  im2col.Reset();
+
+  arma::mat input = arma::randu<arma::mat>(7 * 6 * 3, 5);
+  arma::mat naiveOutput, im2colOutput;
+  naive.Forward(input, naiveOutput);
+  im2col.Forward(input, im2colOutput);
+  CheckMatrices(naiveOutput, im2colOutput);
+
+  arma::mat gy = arma::randu<arma::mat>(naiveOutput.n_rows, 5);
+  arma::mat naiveDelta, im2colDelta;
+  naive.Backward(input, gy, naiveDelta);
+  im2col.Backward(input, gy, im2colDelta);
+  CheckMatrices(naiveDelta, im2colDelta);
+
+  arma::mat naiveGradient, im2colGradient;
+  naive.Gradient(input, gy, naiveGradient);
+  im2col.Gradient(input, gy, im2colGradient);
+  CheckMatrices(naiveGradient, im2colGradient);
+
+  // With a stride of two, compare the gradients of accu(output % gy) with
+  // numerical gradients.
+  Im2ColLayer strided(2, 3, 3, 3, 2, 2, std::tuple<size_t, size_t>(1, 1),
+      std::tuple<size_t, size_t>(1, 0), 7, 6);
+  strided.Parameters().randn();
+  strided.Reset();
+
+  input = arma::randu<arma::mat>(7 * 6 * 2, 2);
+  arma::mat output;
+  strided.Forward(input, output);
+  gy = arma::randu<arma::mat>(output.n_rows, 2);
+
+  arma::mat delta, gradient;
+  strided.Backward(input, gy, delta);
+  strided.Gradient(input, gy, gradient);
+
+  const double eps = 1e-6;
+  for (size_t i = 0; i < input.n_elem; ++i)
+  {
+    const double value = input(i);
+    input(i) = value + eps;
+    strided.Forward(input, output);
+    const double plus = arma::accu(output % gy);
+    input(i) = value - eps;
+    strided.Forward(input, output);
+    const double minus = arma::accu(output % gy);
+    input(i) = value;
+
+    BOOST_REQUIRE_SMALL(delta(i) - (plus - minus) / (2 * eps), 1e-5);
+  }
+
+  for (size_t i = 0; i < strided.Parameters().n_elem; ++i)
+  {
+    const double value = strided.Parameters()(i);
+    strided.Parameters()(i) = value + eps;
+    strided.Forward(input, output);
+    const double plus = arma::accu(output % gy);
+    strided.Parameters()(i) = value - eps;
+    strided.Forward(input, output);
+    const double minus = arma::accu(output % gy);
+    strided.Parameters()(i) = value;
+
+    BOOST_REQUIRE_SMALL(gradient(i) - (plus - minus) / (2 * eps), 1e-5);
+  }
+}
+
 /**
  * Test that the padding options in Transposed Convolution layer.
  */
@@ -652,6 +652,120 @@ BOOST_AUTO_TEST_CASE(CFGetRecommendationsQueriedUserSVDPPTest)
   GetRecommendationsQueriedUser<SVDPlusPlusPolicy>();
 }
 
+/**
+ * Make sure that the batched ratings of a decomposition policy match the
+ * ratings of each user, and that the recommendations (which are computed in
+ * parallel blocks) are the unrated items with the highest predicted ratings.
+ */
+template<typename DecompositionPolicy>
+void CheckBatchRecommendations()
+{
+  const size_t numRecs = 5;
+
+  arma::mat dataset;
+  data::Load("GroupLensSmall.csv", dataset);
+
+  CFType<DecompositionPolicy> c(dataset, DecompositionPolicy(), 5, 5, 30);
+
+  const arma::sp_mat& cleanedData = c.CleanedData();
+  const size_t numUsers = cleanedData.n_cols;
+  const size_t numItems = cleanedData.n_rows;
+
+  arma::Col<size_t> users = arma::linspace<arma::Col<size_t>>(0,
+      numUsers - 1, numUsers);
+  arma::mat ratings;
+  c.Decomposition().GetRatingOfUsers(users, ratings);
+
+  BOOST_REQUIRE_EQUAL(ratings.n_rows, numItems);
+  BOOST_REQUIRE_EQUAL(ratings.n_cols, numUsers);
+  for (size_t i = 0; i < numUsers; ++i)
+  {
+    arma::vec userRatings;
+    c.Decomposition().GetRatingOfUser(i, userRatings);
+    CheckMatrices(ratings.col(i), userRatings);
+  }
+
+  arma::Mat<size_t> recommendations;
+  c.GetRecommendations(numRecs, recommendations);
+
+  BOOST_REQUIRE_EQUAL(recommendations.n_rows, numRecs);
+  BOOST_REQUIRE_EQUAL(recommendations.n_cols, numUsers);
+
+  // Predict the rating of every unrated item for every user.
+  size_t numUnrated = 0;
+  arma::Mat<size_t> combinations(2,
+      numItems * numUsers - cleanedData.n_nonzero);
+  for (size_t i = 0; i < numUsers; ++i)
+  {
+    for (size_t j = 0; j < numItems; ++j)
+    {
+      if (cleanedData(j, i) != 0.0)
+        continue;
+
+      combinations(0, numUnrated) = i;
+      combinations(1, numUnrated) = j;
+      ++numUnrated;
+    }
+  }
+
+  arma::vec predictions;
+  c.Predict(combinations, predictions);
+
+  arma::mat predicted(numItems, numUsers);
+  predicted.fill(-DBL_MAX);
+  for (size_t k = 0; k < combinations.n_cols; ++k)
+    predicted(combinations(1, k), combinations(0, k)) = predictions[k];
+
+  for (size_t i = 0; i < numUsers; ++i)
+  {
+    for (size_t r = 0; r < numRecs; ++r)
+    {
+      // Each recommendation must be an unrated item, and they must be sorted.
+      BOOST_REQUIRE_LT(recommendations(r, i), numItems);
+      BOOST_REQUIRE_EQUAL(cleanedData(recommendations(r, i), i), 0.0);
+      if (r > 0)
+      {
+        BOOST_REQUIRE_LE(predicted(recommendations(r, i), i),
+            predicted(recommendations(r - 1, i), i) + 1e-8);
+      }
+    }
+
+    // No other unrated item may have a higher predicted rating.
+    const double worst = predicted(recommendations(numRecs - 1, i), i);
+    for (size_t j = 0; j < numItems; ++j)
+    {
+      if (arma::any(recommendations.col(i) == j))
+        continue;
+
+      BOOST_REQUIRE_LE(predicted(j, i), worst + 1e-8);
+    }
+  }
+}
+
+/**
+ * Check the batched recommendations of the NMF method.
+ */
+BOOST_AUTO_TEST_CASE(CFBatchRecommendationsNMFTest)
+{
+  CheckBatchRecommendations<NMFPolicy>();
+}
+
+/**
+ * Check the batched recommendations of the BiasSVD method.
+ */
+BOOST_AUTO_TEST_CASE(CFBatchRecommendationsBiasSVDTest)
+{
+  CheckBatchRecommendations<BiasSVDPolicy>();
+}
+
+/**
+ * Check the batched recommendations of the SVDPlusPlus method.
+ */
+BOOST_AUTO_TEST_CASE(CFBatchRecommendationsSVDPPTest)
+{
+  CheckBatchRecommendations<SVDPlusPlusPolicy>();
+}
+
 /**
  * Make sure recommendations that are generated are reasonably accurate
  * for randomized SVD.
@@ -0,0 +1,129 @@
+/**
+ * @file cover_tree_build_benchmark.cpp
+ *
+ * A standalone program that times the construction of cover trees with one
+ * thread and with all threads, so that the speedup of the parallel
+ * construction can be checked on large datasets.  It is not part of the test
+ * suite; build it with `make cover_tree_build_benchmark` and run
+ *
+ *   cover_tree_build_benchmark [points] [dimensions] [trials]
+ *
+ * The defaults are 1000000 uniformly random points in 3 dimensions, and 3
+ * trials.  The program also checks that the tree is a valid cover tree, and
+ * that both builds give the same tree.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#include <mlpack/core.hpp>
+#include <mlpack/core/tree/cover_tree.hpp>
+
+#include <chrono>
+
+using namespace mlpack;
+using namespace mlpack::tree;
+
+typedef StandardCoverTree<metric::EuclideanDistance, EmptyStatistic, arma::mat>
+    TreeType;
+
+// Return whether the two trees have the same structure.
+static bool SameTree(const TreeType& a, const TreeType& b)
+{
+  if (a.Point() != b.Point() || a.Scale() != b.Scale() ||
+      a.NumChildren() != b.NumChildren() ||
+      a.NumDescendants() != b.NumDescendants())
+    return false;
+
+  for (size_t i = 0; i < a.NumChildren(); ++i)
+    if (!SameTree(a.Child(i), b.Child(i)))
+      return false;
+
+  return true;
+}
+
+// Return whether each non-leaf node has a self-child, and whether the children
+// of each node are within the covering distance of the node.
+static bool ValidTree(const TreeType& node)
+{
+  if (node.NumChildren() == 0)
+    return true;
+
+  if (node.Child(0).Point() != node.Point())
+    return false;
+
+  const double maxDistance = std::pow(node.Base(), node.Scale());
+  for (size_t i = 0; i < node.NumChildren(); ++i)
+  {
+    const double distance = metric::EuclideanDistance::Evaluate(
+        node.Dataset().col(node.Point()),
+        node.Dataset().col(node.Child(i).Point()));
+    if (distance > maxDistance || !ValidTree(node.Child(i)))
+      return false;
+  }
+
+  return true;
+}
+
+// Build the tree the given number of times, and return the fastest build time
+// in seconds.  The last tree that was built is stored in the given pointer.
+static double TimeBuild(const arma::mat& dataset,
+                        const size_t trials,
+                        TreeType*& tree)
+{
+  double best = DBL_MAX;
+  for (size_t t = 0; t < trials; ++t)
+  {
+    delete tree;
+    const auto start = std::chrono::steady_clock::now();
+    tree = new TreeType(dataset);
+    const auto end = std::chrono::steady_clock::now();
+    best = std::min(best, std::chrono::duration<double>(end - start).count());
+  }
+
+  return best;
+}
+
+int main(int argc, char** argv)
+{
+  const size_t points = (argc > 1) ? std::stoul(argv[1]) : 1000000;
+  const size_t dimensions = (argc > 2) ? std::stoul(argv[2]) : 3;
+  const size_t trials = (argc > 3) ? std::stoul(argv[3]) : 3;
+
+  math::RandomSeed(42);
+  const arma::mat dataset = arma::randu<arma::mat>(dimensions, points);
+
+  size_t threads = 1;
+  #ifdef HAS_OPENMP
+    threads = omp_get_max_threads();
+    omp_set_num_threads(1);
+  #endif
+
+  TreeType* serialTree = NULL;
+  const double serialTime = TimeBuild(dataset, trials, serialTree);
+
+  #ifdef HAS_OPENMP
+    omp_set_num_threads(threads);
+  #endif
+
+  TreeType* parallelTree = NULL;
+  const double parallelTime = TimeBuild(dataset, trials, parallelTree);
+
+  const bool valid = ValidTree(*parallelTree) &&
+      parallelTree->NumDescendants() == points;
+  const bool same = SameTree(*serialTree, *parallelTree);
+
+  std::cout << "Cover tree construction, " << points << " points in "
+      << dimensions << " dimensions (best of " << trials << "):" << std::endl;
+  std::cout << "  1 thread:  " << serialTime << "s" << std::endl;
+  std::cout << "  " << threads << " threads: " << parallelTime << "s ("
+      << serialTime / parallelTime << "x)" << std::endl;
+  std::cout << "  valid tree: " << (valid ? "yes" : "no") << std::endl;
+  std::cout << "  same tree: " << (same ? "yes" : "no") << std::endl;
+
+  delete serialTree;
+  delete parallelTree;
+
+  return (valid && same) ? 0 : 1;
+}
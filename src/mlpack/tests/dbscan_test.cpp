@@ -309,4 +309,77 @@ BOOST_AUTO_TEST_CASE(RandomPointSelectionTest)
   BOOST_REQUIRE_EQUAL(assignments.n_elem, points.n_cols);
 }
 
+/**
+ * Make sure that two clusterings are the same, up to the numbering of the
+ * clusters.
+ */
+void CheckSameClustering(const arma::Row<size_t>& assignments,
+                         const arma::Row<size_t>& otherAssignments,
+                         const size_t clusters)
+{
+  BOOST_REQUIRE_EQUAL(assignments.n_elem, otherAssignments.n_elem);
+
+  arma::Col<size_t> mapping(clusters);
+  mapping.fill(SIZE_MAX);
+  for (size_t i = 0; i < assignments.n_elem; ++i)
+  {
+    if (assignments[i] == SIZE_MAX)
+    {
+      BOOST_REQUIRE_EQUAL(otherAssignments[i], SIZE_MAX);
+      continue;
+    }
+
+    BOOST_REQUIRE_LT(otherAssignments[i], clusters);
+    if (mapping[assignments[i]] == SIZE_MAX)
+      mapping[assignments[i]] = otherAssignments[i];
+    BOOST_REQUIRE_EQUAL(mapping[assignments[i]], otherAssignments[i]);
+  }
+}
+
+/**
+ * Check that GridRangeSearch gives the same clusters as tree-based range
+ * search, in one to four dimensions.
+ */
+BOOST_AUTO_TEST_CASE(GridRangeSearchTest)
+{
+  for (size_t d = 1; d <= 4; ++d)
+  {
+    // A few dense blobs and some uniform noise.
+    arma::mat points(d, 1000);
+    for (size_t i = 0; i < 800; ++i)
+      points.col(i) = 0.3 * arma::randn<arma::vec>(d) + 4.0 * (i % 4);
+    points.cols(800, 999) = 16.0 * arma::randu<arma::mat>(d, 200);
+
+    for (const double epsilon : { 0.1, 0.4, 1.5 })
+    {
+      DBSCAN<> d1(epsilon, 3);
+      DBSCAN<GridRangeSearch> d2(epsilon, 3);
+
+      arma::Row<size_t> assignments, gridAssignments;
+      const size_t clusters = d1.Cluster(points, assignments);
+      const size_t gridClusters = d2.Cluster(points, gridAssignments);
+
+      BOOST_REQUIRE_EQUAL(clusters, gridClusters);
+      CheckSameClustering(assignments, gridAssignments, clusters);
+    }
+  }
+}
+
+/**
+ * Check that GridRangeSearch rejects high-dimensional data and an epsilon that
+ * is too small for the data.
+ */
+BOOST_AUTO_TEST_CASE(GridRangeSearchInvalidTest)
+{
+  arma::mat points(5, 100, arma::fill::randu);
+  arma::Row<size_t> assignments;
+
+  DBSCAN<GridRangeSearch> d1(0.5, 2);
+  BOOST_REQUIRE_THROW(d1.Cluster(points, assignments), std::invalid_argument);
+
+  points.randu(2, 100);
+  DBSCAN<GridRangeSearch> d2(1e-50, 2);
+  BOOST_REQUIRE_THROW(d2.Cluster(points, assignments), std::invalid_argument);
+}
+
 BOOST_AUTO_TEST_SUITE_END();
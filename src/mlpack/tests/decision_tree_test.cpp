@@ -370,6 +370,111 @@ BOOST_AUTO_TEST_CASE(BestBinaryNumericSplitNoGainTest)
   BOOST_REQUIRE_EQUAL(classProbabilities.n_elem, 0);
 }
 
+/**
+ * Check that the HistogramNumericSplit finds the same split as the
+ * BestBinaryNumericSplit when there are only a few distinct values.
+ */
+BOOST_AUTO_TEST_CASE(HistogramNumericSplitSimpleSplitTest)
+{
+  arma::vec values("0.0 0.1 0.2 0.3 0.4 0.5 0.6 0.7 0.8 0.9 1.0");
+  arma::Row<size_t> labels("0 0 0 0 0 1 1 1 1 1 1");
+  arma::rowvec weights(labels.n_elem);
+  weights.ones();
+
+  arma::vec classProbabilities;
+  HistogramNumericSplit<GiniGain>::template AuxiliarySplitInfo<double> aux;
+
+  // Call the method to do the splitting.
+  const double bestGain = GiniGain::Evaluate<false>(labels, 2, weights);
+  const double gain = HistogramNumericSplit<GiniGain>::SplitIfBetter<false>(
+      bestGain, values, labels, 2, weights, 3, 1e-7, classProbabilities,
+      aux);
+  const double weightedGain =
+      HistogramNumericSplit<GiniGain>::SplitIfBetter<true>(bestGain, values,
+      labels, 2, weights, 3, 1e-7, classProbabilities, aux);
+
+  // Make sure that a split was made, and that it is perfect.
+  BOOST_REQUIRE_GT(gain, bestGain);
+  BOOST_REQUIRE_EQUAL(gain, weightedGain);
+  BOOST_REQUIRE_SMALL(gain, 1e-5);
+
+  // The points up to 0.4 go left.
+  BOOST_REQUIRE_EQUAL(classProbabilities.n_elem, 1);
+  BOOST_REQUIRE_GE(classProbabilities[0], 0.4);
+  BOOST_REQUIRE_LT(classProbabilities[0], 0.5);
+
+  // Not enough points for the minimum leaf size.
+  classProbabilities.clear();
+  BOOST_REQUIRE_EQUAL(HistogramNumericSplit<GiniGain>::SplitIfBetter<false>(
+      bestGain, values, labels, 2, weights, 8, 1e-7, classProbabilities,
+      aux), DBL_MAX);
+  BOOST_REQUIRE_EQUAL(classProbabilities.n_elem, 0);
+}
+
+/**
+ * Check that the HistogramNumericSplit finds a good split when there are many
+ * more distinct values than bins.
+ */
+BOOST_AUTO_TEST_CASE(HistogramNumericSplitManyPointsTest)
+{
+  arma::rowvec values(20000, arma::fill::randu);
+  arma::Row<size_t> labels(values.n_elem);
+  for (size_t i = 0; i < values.n_elem; ++i)
+    labels[i] = (values[i] > 0.3) ? 1 : 0;
+  arma::rowvec weights;
+
+  arma::vec classProbabilities;
+  HistogramNumericSplit<GiniGain>::template AuxiliarySplitInfo<double> aux;
+
+  const double bestGain = GiniGain::Evaluate<false>(labels, 2, weights);
+  const double gain = HistogramNumericSplit<GiniGain>::SplitIfBetter<false>(
+      bestGain, values, labels, 2, weights, 10, 1e-7, classProbabilities,
+      aux);
+
+  // The split should be almost perfect, and close to 0.3.
+  BOOST_REQUIRE_GT(gain, bestGain);
+  BOOST_REQUIRE_GT(gain, -0.02);
+  BOOST_REQUIRE_EQUAL(classProbabilities.n_elem, 1);
+  BOOST_REQUIRE_SMALL(classProbabilities[0] - 0.3, 0.01);
+}
+
+/**
+ * Make sure a decision tree trained with the HistogramNumericSplit generalizes
+ * well.
+ */
+BOOST_AUTO_TEST_CASE(HistogramNumericSplitTreeTest)
+{
+  arma::mat inputData;
+  if (!data::Load("vc2.csv", inputData))
+    BOOST_FAIL("Cannot load test dataset vc2.csv!");
+
+  arma::Row<size_t> labels;
+  if (!data::Load("vc2_labels.txt", labels))
+    BOOST_FAIL("Cannot load labels for vc2_labels.txt");
+
+  arma::mat testData;
+  if (!data::Load("vc2_test.csv", testData))
+    BOOST_FAIL("Cannot load test dataset vc2_test.csv!");
+
+  arma::Mat<size_t> trueTestLabels;
+  if (!data::Load("vc2_test_labels.txt", trueTestLabels))
+    BOOST_FAIL("Cannot load labels for vc2_test_labels.txt");
+
+  DecisionTree<GiniGain, HistogramNumericSplit> d(inputData, labels, 3, 10);
+
+  arma::Row<size_t> predictions;
+  d.Classify(testData, predictions);
+  BOOST_REQUIRE_EQUAL(predictions.n_elem, testData.n_cols);
+
+  double correct = 0.0;
+  for (size_t i = 0; i < predictions.n_elem; ++i)
+    if (predictions[i] == trueTestLabels[i])
+      ++correct;
+  correct /= predictions.n_elem;
+
+  BOOST_REQUIRE_GT(correct, 0.75);
+}
+
 /**
  * Check that the AllCategoricalSplit will split when the split is obviously
  * better.
@@ -1246,4 +1351,97 @@ BOOST_AUTO_TEST_CASE(DifferentMaximumDepthTest)
   BOOST_REQUIRE_EQUAL(d2.Child(1).NumChildren(), 2);
 }
 
+/**
+ * Make sure that a decision tree trained in parallel generalizes as well as
+ * one trained serially.
+ */
+BOOST_AUTO_TEST_CASE(ParallelTrainTest)
+{
+  arma::mat inputData;
+  if (!data::Load("vc2.csv", inputData))
+    BOOST_FAIL("Cannot load test dataset vc2.csv!");
+
+  arma::Row<size_t> labels;
+  if (!data::Load("vc2_labels.txt", labels))
+    BOOST_FAIL("Cannot load labels for vc2_labels.txt");
+
+  arma::mat testData;
+  if (!data::Load("vc2_test.csv", testData))
+    BOOST_FAIL("Cannot load test dataset vc2_test.csv!");
+
+  arma::Mat<size_t> trueTestLabels;
+  if (!data::Load("vc2_test_labels.txt", trueTestLabels))
+    BOOST_FAIL("Cannot load labels for vc2_test_labels.txt");
+
+  DecisionTree<> d;
+  const double entropy = d.Train(inputData, labels, 3, 10, 1e-7, 0,
+      AllDimensionSelect(), true);
+  BOOST_REQUIRE_EQUAL(std::isfinite(entropy), true);
+
+  arma::Row<size_t> predictions;
+  d.Classify(testData, predictions);
+  BOOST_REQUIRE_EQUAL(predictions.n_elem, testData.n_cols);
+
+  double correct = 0.0;
+  for (size_t i = 0; i < predictions.n_elem; ++i)
+    if (predictions[i] == trueTestLabels[i])
+      ++correct;
+  correct /= predictions.n_elem;
+
+  BOOST_REQUIRE_GT(correct, 0.75);
+
+  // Limiting the depth should work the same way.
+  DecisionTree<> d1;
+  d1.Train(inputData, labels, 3, 10, 1e-7, 2, AllDimensionSelect(), true);
+  BOOST_REQUIRE_EQUAL(d1.NumChildren(), 2);
+  BOOST_REQUIRE_EQUAL(d1.Child(0).NumChildren(), 0);
+  BOOST_REQUIRE_EQUAL(d1.Child(1).NumChildren(), 0);
+}
+
+/**
+ * Make sure that a decision tree trained in parallel on weighted categorical
+ * data generalizes well.
+ */
+BOOST_AUTO_TEST_CASE(ParallelCategoricalWeightedTrainTest)
+{
+  arma::mat d;
+  arma::Row<size_t> l;
+  data::DatasetInfo di;
+  MockCategoricalData(d, l, di);
+
+  arma::mat trainingData = d.cols(0, 1999);
+  arma::mat testData = d.cols(2000, 3999);
+  arma::Row<size_t> trainingLabels = l.subvec(0, 1999);
+  arma::Row<size_t> testLabels = l.subvec(2000, 3999);
+  arma::rowvec weights(trainingLabels.n_elem, arma::fill::ones);
+
+  DecisionTree<> tree;
+  const double entropy = tree.Train(trainingData, di, trainingLabels, 5,
+      weights, 10, 1e-7, 0, AllDimensionSelect(), true);
+  BOOST_REQUIRE_EQUAL(std::isfinite(entropy), true);
+  BOOST_REQUIRE_GT(tree.NumChildren(), 0);
+
+  arma::Row<size_t> predictions;
+  tree.Classify(testData, predictions);
+
+  BOOST_REQUIRE_EQUAL(predictions.n_elem, testData.n_cols);
+  size_t correct = 0;
+  for (size_t i = 0; i < testData.n_cols; ++i)
+    if (testLabels[i] == predictions[i])
+      ++correct;
+
+  // Make sure we got at least 70% accuracy.
+  const double correctPct = double(correct) / double(testData.n_cols);
+  BOOST_REQUIRE_GT(correctPct, 0.70);
+
+  // A decision stump trained in parallel should split only once.
+  DecisionTree<GiniGain, BestBinaryNumericSplit, AllCategoricalSplit,
+      AllDimensionSelect, double, true> stump;
+  stump.Train(trainingData, di, trainingLabels, 5, weights, 10, 1e-7, 0,
+      AllDimensionSelect(), true);
+  BOOST_REQUIRE_GT(stump.NumChildren(), 0);
+  for (size_t i = 0; i < stump.NumChildren(); ++i)
+    BOOST_REQUIRE_EQUAL(stump.Child(i).NumChildren(), 0);
+}
+
 BOOST_AUTO_TEST_SUITE_END();
@@ -278,4 +278,84 @@ BOOST_AUTO_TEST_CASE(BallTreeTest)
   }
 }
 
+/**
+ * Make sure that the parallel mode gives the same results as the serial mode,
+ * with dual-tree and naive computation, and with a tree that can't be split
+ * into subtrees.
+ */
+BOOST_AUTO_TEST_CASE(ParallelVsSerialTest)
+{
+  arma::mat inputData;
+  if (!data::Load("test_data_3_1000.csv", inputData))
+    BOOST_FAIL("Cannot load test dataset test_data_3_1000.csv!");
+
+  DualTreeBoruvka<> naive(inputData, true);
+  arma::mat naiveResults;
+  naive.ComputeMST(naiveResults);
+
+  DualTreeBoruvka<> parallelNaive(inputData, true);
+  DualTreeBoruvka<> kdt(inputData);
+  DualTreeBoruvka<EuclideanDistance, arma::mat, BallTree> ballt(inputData);
+  DualTreeBoruvka<EuclideanDistance, arma::mat, StandardCoverTree>
+      ct(inputData);
+
+  std::vector<arma::mat> results(4);
+  parallelNaive.ComputeMST(results[0], true);
+  kdt.ComputeMST(results[1], true);
+  ballt.ComputeMST(results[2], true);
+  ct.ComputeMST(results[3], true);
+
+  for (size_t r = 0; r < results.size(); ++r)
+  {
+    BOOST_REQUIRE_EQUAL(results[r].n_rows, naiveResults.n_rows);
+    BOOST_REQUIRE_EQUAL(results[r].n_cols, naiveResults.n_cols);
+
+    for (size_t i = 0; i < naiveResults.n_cols; i++)
+    {
+      BOOST_REQUIRE_EQUAL(results[r](0, i), naiveResults(0, i));
+      BOOST_REQUIRE_EQUAL(results[r](1, i), naiveResults(1, i));
+      BOOST_REQUIRE_CLOSE(results[r](2, i), naiveResults(2, i), 1e-5);
+    }
+  }
+}
+
+/**
+ * Make sure that the concurrent union-find merges components like UnionFind,
+ * and only reports a merge once.
+ */
+BOOST_AUTO_TEST_CASE(ConcurrentUnionFindTest)
+{
+  const size_t n = 1000;
+  UnionFind connections(n);
+  ConcurrentUnionFind parallelConnections(n);
+
+  const arma::umat pairs = arma::randi<arma::umat>(2, 2 * n,
+      arma::distr_param(0, n - 1));
+  size_t merges = 0;
+  for (size_t i = 0; i < pairs.n_cols; ++i)
+  {
+    if (connections.Find(pairs(0, i)) != connections.Find(pairs(1, i)))
+      ++merges;
+    connections.Union(pairs(0, i), pairs(1, i));
+  }
+
+  size_t parallelMerges = 0;
+  #pragma omp parallel for reduction(+:parallelMerges)
+  for (omp_size_t i = 0; i < (omp_size_t) pairs.n_cols; ++i)
+  {
+    if (parallelConnections.Union(pairs(0, i), pairs(1, i)))
+      ++parallelMerges;
+  }
+
+  BOOST_REQUIRE_EQUAL(parallelMerges, merges);
+  for (size_t i = 0; i < n; ++i)
+  {
+    for (size_t j = i + 1; j < n; j += 7)
+    {
+      BOOST_REQUIRE_EQUAL(connections.Find(i) == connections.Find(j),
+          parallelConnections.Find(i) == parallelConnections.Find(j));
+    }
+  }
+}
+
 BOOST_AUTO_TEST_SUITE_END();
@@ -127,6 +127,105 @@ BOOST_AUTO_TEST_CASE(DualTreeVsSingleTree)
   }
 }
 
+/**
+ * Make sure that searching a query set in batches, with the cached reference
+ * self-kernels, gives the same results as naive search, for kernels that are
+ * and aren't computed with matrix multiplications.
+ */
+template<typename KernelType>
+void CheckBatchedSearch(KernelType& kernel)
+{
+  arma::mat referenceData = arma::randu<arma::mat>(6, 1500);
+  arma::mat queryData = arma::randu<arma::mat>(6, 1000);
+
+  FastMKS<KernelType> naive(referenceData, kernel, false, true);
+  arma::Mat<size_t> naiveIndices;
+  arma::mat naiveKernels;
+  naive.Search(queryData, 5, naiveIndices, naiveKernels);
+
+  // Check the naive results against a simple double loop.
+  for (size_t q = 0; q < queryData.n_cols; q += 50)
+  {
+    arma::vec products(referenceData.n_cols);
+    for (size_t r = 0; r < referenceData.n_cols; ++r)
+      products[r] = kernel.Evaluate(queryData.col(q), referenceData.col(r));
+    const arma::uvec order = arma::sort_index(products, "descend");
+    for (size_t j = 0; j < 5; ++j)
+    {
+      BOOST_REQUIRE_EQUAL(naiveIndices(j, q), order[j]);
+      BOOST_REQUIRE_CLOSE(naiveKernels(j, q), products[order[j]], 1e-5);
+    }
+  }
+
+  for (size_t mode = 0; mode < 3; ++mode)
+  {
+    // Search the query set in three batches with the same model.
+    FastMKS<KernelType> f(referenceData, kernel, mode == 0, mode == 2);
+    const size_t bounds[] = { 0, 300, 301, 1000 };
+    for (size_t b = 0; b < 3; ++b)
+    {
+      arma::Mat<size_t> indices;
+      arma::mat kernels;
+      f.Search(queryData.cols(bounds[b], bounds[b + 1] - 1), 5, indices,
+          kernels);
+
+      BOOST_REQUIRE_EQUAL(indices.n_cols, bounds[b + 1] - bounds[b]);
+      for (size_t q = 0; q < indices.n_cols; ++q)
+      {
+        for (size_t j = 0; j < 5; ++j)
+        {
+          BOOST_REQUIRE_EQUAL(indices(j, q), naiveIndices(j, bounds[b] + q));
+          BOOST_REQUIRE_CLOSE(kernels(j, q), naiveKernels(j, bounds[b] + q),
+              1e-5);
+        }
+      }
+    }
+  }
+}
+
+BOOST_AUTO_TEST_CASE(BatchedLinearSearchTest)
+{
+  LinearKernel lk;
+  CheckBatchedSearch(lk);
+}
+
+BOOST_AUTO_TEST_CASE(BatchedPolynomialSearchTest)
+{
+  PolynomialKernel pk(2.0, 1.0);
+  CheckBatchedSearch(pk);
+}
+
+/**
+ * Make sure the cached reference self-kernels are not reused after the model
+ * is retrained on a different reference set of the same size.
+ */
+BOOST_AUTO_TEST_CASE(RetrainCachedKernelsTest)
+{
+  arma::mat firstData = arma::randu<arma::mat>(5, 500);
+  arma::mat secondData = 10.0 * arma::randu<arma::mat>(5, 500);
+  arma::mat queryData = arma::randu<arma::mat>(5, 200);
+  PolynomialKernel pk(3.0);
+
+  FastMKS<PolynomialKernel> f(firstData, pk);
+  arma::Mat<size_t> indices;
+  arma::mat kernels;
+  f.Search(queryData, 3, indices, kernels);
+
+  f.Train(secondData, pk);
+  f.Search(queryData, 3, indices, kernels);
+
+  FastMKS<PolynomialKernel> naive(secondData, pk, false, true);
+  arma::Mat<size_t> naiveIndices;
+  arma::mat naiveKernels;
+  naive.Search(queryData, 3, naiveIndices, naiveKernels);
+
+  for (size_t i = 0; i < indices.n_elem; ++i)
+  {
+    BOOST_REQUIRE_EQUAL(indices[i], naiveIndices[i]);
+    BOOST_REQUIRE_CLOSE(kernels[i], naiveKernels[i], 1e-5);
+  }
+}
+
 /**
  * Test sparse FastMKS (how useful is this, I'm not sure).
  */
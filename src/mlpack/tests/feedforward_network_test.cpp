@@ -523,6 +523,48 @@ BOOST_AUTO_TEST_CASE(PartialForwardTest)
   CheckMatrices(output, arma::ones(10, 1) * 20);
 }
 
+/**
+ * Test that Predict() gives the same results after PlanInference(), also when
+ * the last batch is not full and when the plan has to be made again.
+ */
+BOOST_AUTO_TEST_CASE(PlannedPredictTest)
+{
+  FFN<NegativeLogLikelihood<> > model;
+  model.Add<Linear<> >(5, 10);
+  model.Add<SigmoidLayer<> >();
+  model.Add<Dropout<> >();
+  model.Add<Linear<> >(10, 3);
+  model.Add<LogSoftMax<> >();
+
+  arma::mat data = arma::randu<arma::mat>(5, 23);
+  arma::mat predictions, plannedPredictions;
+  model.Predict(data, predictions);
+
+  model.PlanInference(8);
+  model.Predict(data, plannedPredictions);
+  CheckMatrices(predictions, plannedPredictions);
+
+  // Predicting again reuses the plan.
+  model.Predict(data.cols(0, 9), plannedPredictions);
+  CheckMatrices(predictions.cols(0, 9), plannedPredictions);
+
+  // Adding a layer makes the plan again.
+  model.Add<Linear<> >(3, 2);
+  model.ResetParameters();
+  model.Predict(data, plannedPredictions);
+
+  model.PlanInference(0);
+  model.Predict(data, predictions);
+  CheckMatrices(predictions, plannedPredictions);
+
+  model.PlanInference(4);
+
+  // A copy of the model makes its own plan.
+  FFN<NegativeLogLikelihood<> > copiedModel(model);
+  copiedModel.Predict(data, plannedPredictions);
+  CheckMatrices(predictions, plannedPredictions);
+}
+
 /**
  * Test that FFN::Train() returns finite objective value.
  */
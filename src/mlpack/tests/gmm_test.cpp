@@ -388,6 +388,66 @@ BOOST_AUTO_TEST_CASE(GMMTrainEMMultipleGaussiansWithProbability)
           - d3.Covariance()(row, col)), 0.7);
 }
 
+/**
+ * Make sure that one EM iteration, which processes the points in blocks (here,
+ * more than one), gives the same model as the direct calculation of the
+ * responsibilities and the weighted means and covariances, with and without
+ * observation probabilities.
+ */
+BOOST_AUTO_TEST_CASE(GMMEMIterationTest)
+{
+  arma::mat points(3, 2500, arma::fill::randn);
+  points.cols(0, 999) += 5.0;
+  arma::vec probabilities(points.n_cols, arma::fill::randu);
+  probabilities += 0.1;
+
+  std::vector<distribution::GaussianDistribution> initialDists;
+  initialDists.push_back(distribution::GaussianDistribution(
+      arma::vec("4.0 4.5 5.5"), 2.0 * arma::eye<arma::mat>(3, 3)));
+  initialDists.push_back(distribution::GaussianDistribution(
+      arma::vec("0.5 -0.5 0.0"), arma::eye<arma::mat>(3, 3)));
+  const arma::vec initialWeights("0.5 0.5");
+
+  for (size_t useProbabilities = 0; useProbabilities < 2; ++useProbabilities)
+  {
+    // Calculate the responsibilities of each component for each point.
+    arma::mat resp(points.n_cols, 2);
+    for (size_t i = 0; i < 2; ++i)
+    {
+      arma::vec prob;
+      initialDists[i].Probability(points, prob);
+      resp.col(i) = initialWeights[i] * prob;
+    }
+    resp.each_col() /= arma::sum(resp, 1);
+    if (useProbabilities == 1)
+      resp.each_col() %= probabilities;
+
+    // Only one iteration of EM.
+    EMFit<kmeans::KMeans<>, NoConstraint> fitter(2, 1e-10);
+    std::vector<distribution::GaussianDistribution> dists(initialDists);
+    arma::vec weights(initialWeights);
+    if (useProbabilities == 1)
+      fitter.Estimate(points, probabilities, dists, weights, true);
+    else
+      fitter.Estimate(points, dists, weights, true);
+
+    for (size_t i = 0; i < 2; ++i)
+    {
+      const double sum = arma::accu(resp.col(i));
+      const arma::vec mean = points * resp.col(i) / sum;
+      const arma::mat diffs = points.each_col() - mean;
+      const arma::mat covariance =
+          (diffs.each_row() % resp.col(i).t()) * diffs.t() / sum;
+
+      BOOST_REQUIRE_CLOSE(weights[i], sum / arma::accu(resp), 1e-5);
+      for (size_t j = 0; j < 3; ++j)
+        BOOST_REQUIRE_SMALL(dists[i].Mean()[j] - mean[j], 1e-8);
+      for (size_t j = 0; j < 9; ++j)
+        BOOST_REQUIRE_SMALL(dists[i].Covariance()[j] - covariance[j], 1e-8);
+    }
+  }
+}
+
 /**
  * Make sure generating observations randomly works.  We'll do this by
  * generating a bunch of random observations and then re-training on them, and
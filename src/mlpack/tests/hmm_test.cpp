@@ -184,6 +184,24 @@ BOOST_AUTO_TEST_CASE(SimplestBaumWelchDiscreteHMM)
   BOOST_REQUIRE_CLOSE(hmm.Transition()(0, 0), 1.0, 1e-5);
 }
 
+/**
+ * Make sure that an invalid observation gives an exception that can be caught,
+ * even though the sequences are processed in parallel.
+ */
+BOOST_AUTO_TEST_CASE(BaumWelchInvalidObservationTest)
+{
+  HMM<DiscreteDistribution> hmm(2, DiscreteDistribution(2));
+
+  std::vector<arma::mat> observations;
+  observations.push_back("0 1 0 1 1 0");
+  observations.push_back("0 1 5 1"); // 5 is not a valid observation.
+  observations.push_back("1 1 0 0 1");
+
+  Log::Fatal.ignoreInput = true;
+  BOOST_REQUIRE_THROW(hmm.Train(observations), std::runtime_error);
+  Log::Fatal.ignoreInput = false;
+}
+
 /**
  * A slightly more complex model to estimate.
  */
@@ -1258,6 +1276,114 @@ BOOST_AUTO_TEST_CASE(HMMTrainReturnLogLikelihood)
   BOOST_REQUIRE_EQUAL(std::isfinite(loglik), true);
 }
 
+/**
+ * Make sure that training a discrete HMM on sequences given by a sequence
+ * source gives the same model as training on the sequences in memory.
+ */
+BOOST_AUTO_TEST_CASE(DiscreteHMMSequenceSourceTrainTest)
+{
+  // Generate sequences from a known HMM.
+  arma::vec initial("0.6 0.4");
+  arma::mat transition("0.7 0.2; 0.3 0.8");
+  std::vector<DiscreteDistribution> emission(2, DiscreteDistribution(4));
+  emission[0].Probabilities() = "0.5 0.3 0.1 0.1";
+  emission[1].Probabilities() = "0.05 0.15 0.4 0.4";
+  HMM<DiscreteDistribution> trueHMM(initial, transition, emission);
+
+  std::vector<arma::mat> observations(40);
+  for (size_t i = 0; i < observations.size(); ++i)
+  {
+    arma::Row<size_t> states;
+    trueHMM.Generate(200, observations[i], states);
+  }
+
+  // Start both models from the same guess.
+  HMM<DiscreteDistribution> hmm(2, DiscreteDistribution(4));
+  hmm.Transition() = arma::mat("0.6 0.3; 0.4 0.7");
+  hmm.Emission()[0].Probabilities() = "0.4 0.3 0.2 0.1";
+  hmm.Emission()[1].Probabilities() = "0.1 0.2 0.3 0.4";
+  HMM<DiscreteDistribution> streamHMM(hmm);
+
+  const double loglik = hmm.Train(observations);
+  const double streamLoglik = streamHMM.Train(observations.size(),
+      [&observations](const size_t index, arma::mat& dataSeq)
+      {
+        dataSeq = observations[index];
+      });
+
+  BOOST_REQUIRE_CLOSE(streamLoglik, loglik, 1e-3);
+  for (size_t i = 0; i < 2; ++i)
+  {
+    BOOST_REQUIRE_SMALL(streamHMM.Initial()[i] - hmm.Initial()[i], 1e-4);
+    for (size_t j = 0; j < 2; ++j)
+    {
+      BOOST_REQUIRE_SMALL(streamHMM.Transition()(i, j) -
+          hmm.Transition()(i, j), 1e-4);
+    }
+    for (size_t j = 0; j < 4; ++j)
+    {
+      BOOST_REQUIRE_SMALL(streamHMM.Emission()[i].Probabilities()[j] -
+          hmm.Emission()[i].Probabilities()[j], 1e-4);
+    }
+  }
+}
+
+/**
+ * Make sure that training a Gaussian HMM on sequences given by a sequence
+ * source gives the same model as training on the sequences in memory.
+ */
+BOOST_AUTO_TEST_CASE(GaussianHMMSequenceSourceTrainTest)
+{
+  std::vector<GaussianDistribution> emission;
+  emission.push_back(GaussianDistribution("0.0 0.0", "1.0 0.2; 0.2 1.5"));
+  emission.push_back(GaussianDistribution("4.0 3.0", "0.7 0.1; 0.1 1.2"));
+  HMM<GaussianDistribution> trueHMM(arma::vec("0.5 0.5"),
+      arma::mat("0.8 0.3; 0.2 0.7"), emission);
+
+  std::vector<arma::mat> observations(20);
+  for (size_t i = 0; i < observations.size(); ++i)
+  {
+    arma::Row<size_t> states;
+    trueHMM.Generate(300, observations[i], states);
+  }
+
+  HMM<GaussianDistribution> hmm(2, GaussianDistribution(2));
+  hmm.Emission()[0].Mean() = "0.5 -0.5";
+  hmm.Emission()[1].Mean() = "3.0 3.5";
+  HMM<GaussianDistribution> streamHMM(hmm);
+
+  hmm.Train(observations);
+  streamHMM.Train(observations.size(),
+      [&observations](const size_t index, arma::mat& dataSeq)
+      {
+        dataSeq = observations[index];
+      });
+
+  for (size_t i = 0; i < 2; ++i)
+  {
+    BOOST_REQUIRE_SMALL(streamHMM.Initial()[i] - hmm.Initial()[i], 1e-4);
+    for (size_t j = 0; j < 2; ++j)
+    {
+      BOOST_REQUIRE_SMALL(streamHMM.Transition()(i, j) -
+          hmm.Transition()(i, j), 1e-4);
+    }
+
+    BOOST_REQUIRE_LT(arma::norm(streamHMM.Emission()[i].Mean() -
+        hmm.Emission()[i].Mean()), 1e-4);
+    BOOST_REQUIRE_LT(arma::norm(streamHMM.Emission()[i].Covariance() -
+        hmm.Emission()[i].Covariance()), 1e-4);
+  }
+
+  // A sequence with the wrong dimensionality should give an error.
+  Log::Fatal.ignoreInput = true;
+  BOOST_REQUIRE_THROW(streamHMM.Train(2,
+      [](const size_t /* index */, arma::mat& dataSeq)
+      {
+        dataSeq.randu(3, 10);
+      }), std::runtime_error);
+  Log::Fatal.ignoreInput = false;
+}
+
 /********************************************/
 /** DiagonalGMM Hidden Markov Models Tests **/
 /********************************************/
@@ -0,0 +1,186 @@
+/**
+ * @file hnsw_test.cpp
+ *
+ * Unit tests for the 'HNSWSearch' class.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#include <mlpack/core.hpp>
+#include <mlpack/methods/hnsw/hnsw_search.hpp>
+#include <mlpack/methods/neighbor_search/neighbor_search.hpp>
+
+#include <boost/test/unit_test.hpp>
+#include "test_tools.hpp"
+#include "serialization.hpp"
+
+using namespace mlpack;
+using namespace mlpack::neighbor;
+
+BOOST_AUTO_TEST_SUITE(HNSWTest);
+
+/**
+ * Make sure that the recall of HNSW search is high on random data, compared to
+ * exact search.
+ */
+BOOST_AUTO_TEST_CASE(HNSWRecallTest)
+{
+  arma::mat referenceData(10, 2000, arma::fill::randu);
+  arma::mat queryData(10, 200, arma::fill::randu);
+  const size_t k = 10;
+
+  KNN knn(referenceData);
+  arma::Mat<size_t> trueNeighbors;
+  arma::mat trueDistances;
+  knn.Search(queryData, k, trueNeighbors, trueDistances);
+
+  HNSWSearch<> hnsw(referenceData);
+  arma::Mat<size_t> neighbors;
+  arma::mat distances;
+  hnsw.Search(queryData, k, neighbors, distances, 100);
+
+  BOOST_REQUIRE_EQUAL(neighbors.n_rows, k);
+  BOOST_REQUIRE_EQUAL(neighbors.n_cols, queryData.n_cols);
+  BOOST_REQUIRE_GE(HNSWSearch<>::ComputeRecall(neighbors, trueNeighbors), 0.9);
+
+  // The distances must be the distances to the returned neighbors, in
+  // increasing order.
+  for (size_t i = 0; i < neighbors.n_cols; ++i)
+  {
+    for (size_t j = 0; j < k; ++j)
+    {
+      BOOST_REQUIRE_CLOSE(distances(j, i), metric::EuclideanDistance::Evaluate(
+          queryData.col(i), referenceData.col(neighbors(j, i))), 1e-5);
+      if (j > 0)
+        BOOST_REQUIRE_LE(distances(j - 1, i), distances(j, i));
+    }
+  }
+}
+
+/**
+ * Make sure that monochromatic search does not return each point as its own
+ * neighbor, and has high recall.
+ */
+BOOST_AUTO_TEST_CASE(HNSWMonochromaticTest)
+{
+  arma::mat referenceData(5, 1000, arma::fill::randu);
+  const size_t k = 5;
+
+  KNN knn(referenceData);
+  arma::Mat<size_t> trueNeighbors;
+  arma::mat trueDistances;
+  knn.Search(k, trueNeighbors, trueDistances);
+
+  HNSWSearch<> hnsw(referenceData, 8, 100);
+  arma::Mat<size_t> neighbors;
+  arma::mat distances;
+  hnsw.Search(k, neighbors, distances);
+
+  for (size_t i = 0; i < neighbors.n_cols; ++i)
+    for (size_t j = 0; j < k; ++j)
+      BOOST_REQUIRE_NE(neighbors(j, i), i);
+
+  BOOST_REQUIRE_GE(HNSWSearch<>::ComputeRecall(neighbors, trueNeighbors), 0.9);
+}
+
+/**
+ * Make sure that inserting the points one at a time builds the same graph as
+ * Train() with the same random seed, and that no point has too many links.
+ */
+BOOST_AUTO_TEST_CASE(HNSWInsertTest)
+{
+  arma::mat referenceData(4, 500, arma::fill::randu);
+  arma::mat queryData(4, 50, arma::fill::randu);
+
+  math::RandomSeed(42);
+  HNSWSearch<> hnsw(referenceData, 6, 50);
+
+  math::RandomSeed(42);
+  HNSWSearch<> inserted(6, 50);
+  for (size_t i = 0; i < referenceData.n_cols; ++i)
+    inserted.Insert(referenceData.col(i));
+
+  BOOST_REQUIRE_EQUAL(inserted.NumPoints(), referenceData.n_cols);
+  BOOST_REQUIRE_EQUAL(inserted.MaxLevel(), hnsw.MaxLevel());
+
+  // The bottom layer allows twice the maximum number of links.
+  for (size_t i = 0; i < referenceData.n_cols; ++i)
+  {
+    const std::vector<size_t>& links = hnsw.Links(i, 0);
+    const std::vector<size_t>& insertedLinks = inserted.Links(i, 0);
+    BOOST_REQUIRE_LE(links.size(), 12);
+    BOOST_REQUIRE_EQUAL(links.size(), insertedLinks.size());
+    for (size_t j = 0; j < links.size(); ++j)
+      BOOST_REQUIRE_EQUAL(links[j], insertedLinks[j]);
+  }
+
+  arma::Mat<size_t> neighbors, insertedNeighbors;
+  arma::mat distances, insertedDistances;
+  hnsw.Search(queryData, 3, neighbors, distances);
+  inserted.Search(queryData, 3, insertedNeighbors, insertedDistances);
+
+  CheckMatrices(neighbors, insertedNeighbors);
+  CheckMatrices(distances, insertedDistances);
+}
+
+/**
+ * Make sure that a serialized model gives the same results.
+ */
+BOOST_AUTO_TEST_CASE(HNSWSerializationTest)
+{
+  arma::mat referenceData(3, 300, arma::fill::randu);
+  arma::mat queryData(3, 30, arma::fill::randu);
+
+  HNSWSearch<> hnsw(referenceData, 8, 50);
+  // Insert one more point, so that the reference set has unused capacity.
+  hnsw.Insert(arma::vec("0.5 0.5 0.5"));
+
+  HNSWSearch<> xmlHnsw, textHnsw, binaryHnsw;
+  SerializeObjectAll(hnsw, xmlHnsw, textHnsw, binaryHnsw);
+
+  arma::Mat<size_t> neighbors, xmlNeighbors, textNeighbors, binaryNeighbors;
+  arma::mat distances, xmlDistances, textDistances, binaryDistances;
+  hnsw.Search(queryData, 5, neighbors, distances);
+  xmlHnsw.Search(queryData, 5, xmlNeighbors, xmlDistances);
+  textHnsw.Search(queryData, 5, textNeighbors, textDistances);
+  binaryHnsw.Search(queryData, 5, binaryNeighbors, binaryDistances);
+
+  BOOST_REQUIRE_EQUAL(xmlHnsw.NumPoints(), 301);
+  CheckMatrices(neighbors, xmlNeighbors, textNeighbors, binaryNeighbors);
+  CheckMatrices(distances, xmlDistances, textDistances, binaryDistances);
+
+  // The loaded model and the saved model can still take new points.
+  binaryHnsw.Insert(arma::vec("0.1 0.2 0.3"));
+  BOOST_REQUIRE_EQUAL(binaryHnsw.NumPoints(), 302);
+  hnsw.Insert(arma::vec("0.1 0.2 0.3"));
+  BOOST_REQUIRE_EQUAL(hnsw.NumPoints(), 302);
+}
+
+/**
+ * Make sure that invalid searches and insertions throw.
+ */
+BOOST_AUTO_TEST_CASE(HNSWInvalidInputTest)
+{
+  arma::mat referenceData(3, 50, arma::fill::randu);
+  HNSWSearch<> hnsw(referenceData);
+
+  arma::Mat<size_t> neighbors;
+  arma::mat distances;
+  arma::mat queryData(4, 10, arma::fill::randu);
+  BOOST_REQUIRE_THROW(hnsw.Search(queryData, 3, neighbors, distances),
+      std::invalid_argument);
+
+  queryData.randu(3, 10);
+  BOOST_REQUIRE_THROW(hnsw.Search(queryData, 51, neighbors, distances),
+      std::invalid_argument);
+  BOOST_REQUIRE_THROW(hnsw.Search(50, neighbors, distances),
+      std::invalid_argument);
+
+  BOOST_REQUIRE_THROW(hnsw.Insert(arma::vec("1.0 2.0")),
+      std::invalid_argument);
+  BOOST_REQUIRE_THROW(HNSWSearch<>(referenceData, 1), std::invalid_argument);
+}
+
+BOOST_AUTO_TEST_SUITE_END();
@@ -1052,6 +1052,78 @@ BOOST_AUTO_TEST_CASE(BatchTrainingTest)
   BOOST_REQUIRE_GE(batchCorrect, streamCorrect);
 }
 
+/**
+ * Make sure that training on a set of points in streaming mode gives exactly
+ * the same tree as training on the points one at a time, even when the points
+ * are given in several chunks.
+ */
+BOOST_AUTO_TEST_CASE(StreamingChunkTrainingTest)
+{
+  // Generate data with numeric and categorical features.
+  arma::mat dataset(4, 9000);
+  arma::Row<size_t> labels(9000);
+  data::DatasetInfo info(4); // All features are numeric, except the fourth.
+  info.MapString<double>("0", 3);
+  info.MapString<double>("1", 3);
+  info.MapString<double>("2", 3);
+  for (size_t i = 0; i < 9000; ++i)
+  {
+    labels[i] = math::RandInt(3);
+    dataset(0, i) = mlpack::math::Random() + 0.3 * labels[i];
+    dataset(1, i) = mlpack::math::Random();
+    dataset(2, i) = mlpack::math::Random() - 0.2 * labels[i];
+    dataset(3, i) = (mlpack::math::Random() < 0.7) ? labels[i] :
+        math::RandInt(3);
+  }
+
+  // Use a small check interval to get a deeper tree.
+  HoeffdingTree<> pointTree(info, 3, 0.95, 0, 10, 100);
+  for (size_t i = 0; i < 9000; ++i)
+    pointTree.Train(dataset.col(i), labels[i]);
+
+  arma::mat firstChunk = dataset.cols(0, 1234);
+  arma::Row<size_t> firstLabels = labels.subvec(0, 1234);
+  arma::mat secondChunk = dataset.cols(1235, 8999);
+  arma::Row<size_t> secondLabels = labels.subvec(1235, 8999);
+
+  HoeffdingTree<> chunkTree(info, 3, 0.95, 0, 10, 100);
+  chunkTree.Train(firstChunk, firstLabels, false);
+  chunkTree.Train(secondChunk, secondLabels, false);
+
+  BOOST_REQUIRE_GT(pointTree.NumChildren(), 0);
+
+  // Now check that the trees are the same.
+  std::stack<const HoeffdingTree<>*> pointStack, chunkStack;
+  pointStack.push(&pointTree);
+  chunkStack.push(&chunkTree);
+  while (!pointStack.empty())
+  {
+    const HoeffdingTree<>* pointNode = pointStack.top();
+    const HoeffdingTree<>* chunkNode = chunkStack.top();
+    pointStack.pop();
+    chunkStack.pop();
+
+    BOOST_REQUIRE_EQUAL(pointNode->NumChildren(), chunkNode->NumChildren());
+    BOOST_REQUIRE_EQUAL(pointNode->SplitDimension(),
+        chunkNode->SplitDimension());
+    BOOST_REQUIRE_EQUAL(pointNode->MajorityClass(), chunkNode->MajorityClass());
+    BOOST_REQUIRE_CLOSE(pointNode->MajorityProbability(),
+        chunkNode->MajorityProbability(), 1e-5);
+
+    for (size_t i = 0; i < pointNode->NumChildren(); ++i)
+    {
+      pointStack.push(&pointNode->Child(i));
+      chunkStack.push(&chunkNode->Child(i));
+    }
+  }
+
+  arma::Row<size_t> pointPredictions, chunkPredictions;
+  pointTree.Classify(dataset, pointPredictions);
+  chunkTree.Classify(dataset, chunkPredictions);
+  for (size_t i = 0; i < pointPredictions.n_elem; ++i)
+    BOOST_REQUIRE_EQUAL(pointPredictions[i], chunkPredictions[i]);
+}
+
 // Make sure that changing the confidence properly propagates to all leaves.
 BOOST_AUTO_TEST_CASE(ConfidenceChangeTest)
 {
@@ -1301,4 +1301,93 @@ BOOST_AUTO_TEST_CASE(GaussianBreadthDualKDTreeMonteCarloKDE)
   BOOST_REQUIRE_GT(correctResults, 70);
 }
 
+/**
+ * Test that the results stay within the error tolerance on datasets large
+ * enough that the evaluation is split between many threads when OpenMP is
+ * available.  This checks bichromatic and monochromatic evaluation in
+ * single-tree and dual-tree mode.
+ */
+BOOST_AUTO_TEST_CASE(ParallelKDEBruteForceTest)
+{
+  arma::mat reference = arma::randu(3, 3000);
+  arma::mat query = arma::randu(3, 2000);
+  const double kernelBandwidth = 0.2;
+  const double relError = 0.05;
+
+  // Brute force KDE.
+  GaussianKernel kernel(kernelBandwidth);
+  arma::vec bfEstimations = arma::vec(query.n_cols, arma::fill::zeros);
+  BruteForceKDE<GaussianKernel>(reference, query, bfEstimations, kernel);
+
+  // In monochromatic evaluation, points don't contribute to their own density.
+  arma::vec bfMonoEstimations = arma::vec(reference.n_cols, arma::fill::zeros);
+  BruteForceKDE<GaussianKernel>(reference, reference, bfMonoEstimations,
+      kernel);
+  bfMonoEstimations -= kernel.Evaluate(0.0) / reference.n_cols;
+
+  const KDEMode modes[2] = { KDEMode::DUAL_TREE_MODE,
+                             KDEMode::SINGLE_TREE_MODE };
+  for (size_t m = 0; m < 2; ++m)
+  {
+    KDE<GaussianKernel, metric::EuclideanDistance, arma::mat, tree::KDTree>
+        kde(relError, 0.0, kernel, modes[m]);
+    kde.Train(reference);
+
+    arma::vec treeEstimations;
+    kde.Evaluate(query, treeEstimations);
+    for (size_t i = 0; i < query.n_cols; ++i)
+      BOOST_REQUIRE_CLOSE(bfEstimations[i], treeEstimations[i], relError * 100);
+
+    kde.Evaluate(treeEstimations);
+    for (size_t i = 0; i < reference.n_cols; ++i)
+    {
+      BOOST_REQUIRE_CLOSE(bfMonoEstimations[i], treeEstimations[i],
+          relError * 100);
+    }
+  }
+}
+
+/**
+ * Test that Monte Carlo estimations still work when the evaluation is split
+ * between many threads.
+ */
+BOOST_AUTO_TEST_CASE(ParallelMonteCarloKDETest)
+{
+  arma::mat reference = arma::randu(2, 3000);
+  arma::mat query = arma::randu(2, 1000);
+  arma::vec bfEstimations = arma::vec(query.n_cols, arma::fill::zeros);
+  const double kernelBandwidth = 0.4;
+  const double relError = 0.05;
+
+  // Brute force KDE.
+  GaussianKernel kernel(kernelBandwidth);
+  BruteForceKDE<GaussianKernel>(reference, query, bfEstimations, kernel);
+
+  const KDEMode modes[2] = { KDEMode::DUAL_TREE_MODE,
+                             KDEMode::SINGLE_TREE_MODE };
+  for (size_t m = 0; m < 2; ++m)
+  {
+    metric::EuclideanDistance metric;
+    KDE<GaussianKernel, metric::EuclideanDistance, arma::mat, tree::KDTree>
+        kde(relError, 0.0, kernel, modes[m], metric, true, 0.95, 100, 3, 0.8);
+    kde.Train(reference);
+
+    arma::vec treeEstimations;
+    kde.Evaluate(query, treeEstimations);
+
+    // The Monte Carlo estimation has a random component so it can fail.
+    // Therefore we require a reasonable amount of results to be right.
+    size_t correctResults = 0;
+    for (size_t i = 0; i < query.n_cols; ++i)
+    {
+      const double resultRelativeError =
+          std::abs((bfEstimations[i] - treeEstimations[i]) / bfEstimations[i]);
+      if (resultRelativeError < relError)
+        ++correctResults;
+    }
+
+    BOOST_REQUIRE_GT(correctResults, 350);
+  }
+}
+
 BOOST_AUTO_TEST_SUITE_END();
@@ -737,4 +737,82 @@ BOOST_AUTO_TEST_CASE(SampleInitializationTest)
   }
 }
 
+/**
+ * Make sure that mini-batch k-means finds the means of well-separated clusters
+ * when the data is given in batches.
+ */
+BOOST_AUTO_TEST_CASE(MiniBatchClusterTest)
+{
+  // Three well-separated clusters, with the points in random order.
+  arma::mat means("0.0 10.0 -10.0; 0.0 10.0 10.0");
+  arma::Row<size_t> labels(3000);
+  arma::mat dataset(2, 3000);
+  for (size_t i = 0; i < dataset.n_cols; ++i)
+  {
+    labels[i] = math::RandInt(0, 3);
+    dataset.col(i) = means.col(labels[i]) + 0.5 * arma::randn<arma::vec>(2);
+  }
+
+  KMeans<> kmeans(0);
+  arma::mat centroids = means + 1.0;
+  MatrixBatchSource<> source(dataset, 100);
+  kmeans.MiniBatchCluster(source, 3, centroids, true);
+
+  // Each centroid must be the mean of all the points of its cluster.
+  for (size_t c = 0; c < 3; ++c)
+  {
+    const arma::mat clusterPoints = dataset.cols(arma::find(labels == c));
+    const arma::vec clusterMean = arma::mean(clusterPoints, 1);
+    for (size_t d = 0; d < 2; ++d)
+      BOOST_REQUIRE_SMALL(centroids(d, c) - clusterMean[d], 1e-8);
+  }
+
+  // A lambda can be used as a source too; the number of batches is limited by
+  // the maximum number of iterations.
+  size_t calls = 0;
+  kmeans.MaxIterations() = 5;
+  kmeans.MiniBatchCluster([&](arma::mat& batch)
+      {
+        ++calls;
+        batch = dataset.cols(0, 99);
+        return true;
+      }, 3, centroids, false);
+
+  BOOST_REQUIRE_EQUAL(calls, 5);
+  BOOST_REQUIRE_EQUAL(centroids.n_rows, 2);
+  BOOST_REQUIRE_EQUAL(centroids.n_cols, 3);
+}
+
+/**
+ * Make sure that loading the batches from files gives the same results as
+ * taking them from a matrix.
+ */
+BOOST_AUTO_TEST_CASE(MiniBatchClusterFileSourceTest)
+{
+  arma::mat dataset = arma::randu<arma::mat>(3, 300);
+  arma::mat initialCentroids = arma::randu<arma::mat>(3, 4);
+
+  std::vector<std::string> filenames;
+  for (size_t i = 0; i < 3; ++i)
+  {
+    filenames.push_back("mini_batch_kmeans_" + std::to_string(i) + ".bin");
+    data::Save(filenames.back(), arma::mat(dataset.cols(100 * i,
+        100 * i + 99)), true);
+  }
+
+  KMeans<> kmeans(0);
+  arma::mat centroids(initialCentroids);
+  kmeans.MiniBatchCluster(MatrixBatchSource<>(dataset, 100), 4, centroids,
+      true);
+
+  arma::mat fileCentroids(initialCentroids);
+  kmeans.MiniBatchCluster(FileBatchSource(filenames), 4, fileCentroids, true);
+
+  for (size_t i = 0; i < filenames.size(); ++i)
+    remove(filenames[i].c_str());
+
+  for (size_t i = 0; i < centroids.n_elem; ++i)
+    BOOST_REQUIRE_CLOSE(centroids[i], fileCentroids[i], 1e-5);
+}
+
 BOOST_AUTO_TEST_SUITE_END();
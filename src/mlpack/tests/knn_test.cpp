@@ -16,6 +16,7 @@
 #include <mlpack/core/tree/example_tree.hpp>
 #include <boost/test/unit_test.hpp>
 #include "test_tools.hpp"
+#include "serialization.hpp"
 
 using namespace mlpack;
 using namespace mlpack::neighbor;
@@ -889,6 +890,51 @@ BOOST_AUTO_TEST_CASE(DualBallTreeTest)
   }
 }
 
+/**
+ * Make sure that the dual-tree search gives the same results as the naive
+ * search on a dataset large enough that the query tree is split into many
+ * subtrees when OpenMP is available.  This checks both the bichromatic and the
+ * monochromatic search, for binary and non-binary trees.
+ */
+template<template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType>
+void CheckParallelDualTreeSearch(const arma::mat& referenceSet,
+                                 const arma::mat& querySet)
+{
+  typedef NeighborSearch<NearestNeighborSort, EuclideanDistance, arma::mat,
+      TreeType> KNNType;
+
+  KNNType tree(referenceSet);
+  KNNType naive(referenceSet, NAIVE_MODE);
+
+  arma::Mat<size_t> treeNeighbors, naiveNeighbors;
+  arma::mat treeDistances, naiveDistances;
+
+  tree.Search(querySet, 10, treeNeighbors, treeDistances);
+  naive.Search(querySet, 10, naiveNeighbors, naiveDistances);
+
+  CheckMatrices(treeNeighbors, naiveNeighbors);
+  CheckMatrices(treeDistances, naiveDistances);
+
+  tree.Search(10, treeNeighbors, treeDistances);
+  naive.Search(10, naiveNeighbors, naiveDistances);
+
+  CheckMatrices(treeNeighbors, naiveNeighbors);
+  CheckMatrices(treeDistances, naiveDistances);
+}
+
+BOOST_AUTO_TEST_CASE(ParallelDualTreeVsNaiveTest)
+{
+  arma::mat referenceSet(4, 3000, arma::fill::randu);
+  arma::mat querySet(4, 2000, arma::fill::randu);
+
+  CheckParallelDualTreeSearch<KDTree>(referenceSet, querySet);
+  CheckParallelDualTreeSearch<BallTree>(referenceSet, querySet);
+  CheckParallelDualTreeSearch<RTree>(referenceSet, querySet);
+  CheckParallelDualTreeSearch<Octree>(referenceSet, querySet);
+}
+
 /**
  * Test the spill tree hybrid sp-tree search (defeatist search on overlapping
  * nodes, and backtracking in non-overlapping nodes) against the naive method.
@@ -1226,6 +1272,156 @@ BOOST_AUTO_TEST_CASE(KNNModelMonochromaticTest)
   }
 }
 
+/**
+ * Check the results of the given model against brute-force search on the
+ * given points, which have the given indices.
+ */
+void CheckModifiedKNNModel(NSModel<NearestNeighborSort>& model,
+                           const arma::mat& queryData,
+                           const arma::mat& points,
+                           const arma::Col<size_t>& indices)
+{
+  KNN knn(points, NAIVE_MODE);
+  arma::Mat<size_t> baselineNeighbors, neighbors;
+  arma::mat baselineDistances, distances;
+
+  knn.Search(queryData, 5, baselineNeighbors, baselineDistances);
+  arma::mat queryCopy(queryData);
+  model.Search(std::move(queryCopy), 5, neighbors, distances);
+
+  BOOST_REQUIRE_EQUAL(neighbors.n_rows, 5);
+  BOOST_REQUIRE_EQUAL(neighbors.n_cols, queryData.n_cols);
+  for (size_t i = 0; i < neighbors.n_elem; ++i)
+  {
+    BOOST_REQUIRE_EQUAL(neighbors[i], indices[baselineNeighbors[i]]);
+    BOOST_REQUIRE_CLOSE(distances[i], baselineDistances[i], 1e-5);
+  }
+
+  // The monochromatic search is over the current points, in order of their
+  // indices.
+  knn.Search(5, baselineNeighbors, baselineDistances);
+  model.Search(5, neighbors, distances);
+
+  BOOST_REQUIRE_EQUAL(neighbors.n_rows, 5);
+  BOOST_REQUIRE_EQUAL(neighbors.n_cols, points.n_cols);
+  for (size_t i = 0; i < neighbors.n_elem; ++i)
+  {
+    BOOST_REQUIRE_EQUAL(neighbors[i], indices[baselineNeighbors[i]]);
+    BOOST_REQUIRE_CLOSE(distances[i], baselineDistances[i], 1e-5);
+  }
+}
+
+/**
+ * Make sure that an NSModel with inserted and deleted points returns the same
+ * results as brute-force search on the current points, before and after the
+ * tree is rebuilt and the model is serialized.
+ */
+BOOST_AUTO_TEST_CASE(KNNModelInsertDeleteTest)
+{
+  typedef NSModel<NearestNeighborSort> KNNModel;
+
+  arma::mat referenceData = arma::randu<arma::mat>(4, 300);
+  arma::mat newData = arma::randu<arma::mat>(4, 40);
+  arma::mat queryData = arma::randu<arma::mat>(4, 50);
+
+  const KNNModel::TreeTypes treeTypes[] = { KNNModel::TreeTypes::KD_TREE,
+      KNNModel::TreeTypes::BALL_TREE, KNNModel::TreeTypes::COVER_TREE };
+  const NeighborSearchMode modes[] = { DUAL_TREE_MODE, SINGLE_TREE_MODE };
+  for (size_t t = 0; t < 3; ++t)
+  {
+    for (size_t m = 0; m < 2; ++m)
+    {
+      KNNModel model(treeTypes[t]);
+      arma::mat referenceCopy(referenceData);
+      model.BuildModel(std::move(referenceCopy), 10, modes[m]);
+      model.RebuildFraction() = 1.0;
+
+      // Delete every third point of the reference set, and insert new points.
+      for (size_t i = 0; i < referenceData.n_cols; i += 3)
+        model.Delete(i);
+      model.Insert(newData);
+      model.Delete(305);
+
+      BOOST_REQUIRE_THROW(model.Delete(0), std::invalid_argument);
+      BOOST_REQUIRE_THROW(model.Delete(305), std::invalid_argument);
+      BOOST_REQUIRE_THROW(model.Delete(340), std::invalid_argument);
+      BOOST_REQUIRE_EQUAL(model.PendingChanges(), 139);
+
+      arma::mat points(4, 239);
+      arma::Col<size_t> indices(239);
+      size_t col = 0;
+      for (size_t i = 0; i < referenceData.n_cols; ++i)
+      {
+        if (i % 3 != 0)
+        {
+          points.col(col) = referenceData.col(i);
+          indices[col++] = i;
+        }
+      }
+      for (size_t i = 0; i < newData.n_cols; ++i)
+      {
+        if (i != 5)
+        {
+          points.col(col) = newData.col(i);
+          indices[col++] = 300 + i;
+        }
+      }
+
+      CheckModifiedKNNModel(model, queryData, points, indices);
+
+      // The indices must not change when the tree is rebuilt.
+      model.Rebuild();
+      BOOST_REQUIRE_EQUAL(model.PendingChanges(), 0);
+      BOOST_REQUIRE_EQUAL(model.Dataset().n_cols, 239);
+      CheckModifiedKNNModel(model, queryData, points, indices);
+
+      // Delete a point of the rebuilt tree and check the serialized models.
+      model.Delete(4);
+      points.shed_col(2);
+      indices.shed_row(2);
+
+      KNNModel xmlModel, textModel, binaryModel;
+      SerializeObjectAll(model, xmlModel, textModel, binaryModel);
+      CheckModifiedKNNModel(model, queryData, points, indices);
+      CheckModifiedKNNModel(xmlModel, queryData, points, indices);
+      CheckModifiedKNNModel(textModel, queryData, points, indices);
+      CheckModifiedKNNModel(binaryModel, queryData, points, indices);
+    }
+  }
+}
+
+/**
+ * Make sure that the tree is rebuilt when there are too many pending changes.
+ */
+BOOST_AUTO_TEST_CASE(KNNModelAutomaticRebuildTest)
+{
+  typedef NSModel<NearestNeighborSort> KNNModel;
+
+  arma::mat referenceData = arma::randu<arma::mat>(3, 200);
+  arma::mat newData = arma::randu<arma::mat>(3, 15);
+
+  KNNModel model(KNNModel::TreeTypes::KD_TREE);
+  arma::mat referenceCopy(referenceData);
+  model.BuildModel(std::move(referenceCopy), 10, DUAL_TREE_MODE);
+  model.RebuildFraction() = 0.1;
+
+  model.Insert(newData);
+  BOOST_REQUIRE_EQUAL(model.PendingChanges(), 15);
+  BOOST_REQUIRE_EQUAL(model.Dataset().n_cols, 200);
+
+  // The 21st pending change triggers the rebuild.
+  for (size_t i = 0; i < 5; ++i)
+    model.Delete(i);
+  BOOST_REQUIRE_EQUAL(model.PendingChanges(), 20);
+  model.Delete(5);
+  BOOST_REQUIRE_EQUAL(model.PendingChanges(), 0);
+  BOOST_REQUIRE_EQUAL(model.Dataset().n_cols, 209);
+
+  arma::mat points = arma::join_rows(referenceData.cols(6, 199), newData);
+  arma::Col<size_t> indices = arma::regspace<arma::Col<size_t>>(6, 214);
+  CheckModifiedKNNModel(model, referenceData, points, indices);
+}
+
 /**
  * If we search twice with the same reference tree, the bounds need to be reset
  * before the second search.  This test ensures that that happens, by making
@@ -9,6 +9,7 @@
  * 3-clause BSD license along with mlpack.  If not, see
  * http://www.opensource.org/licenses/BSD-3-Clause for more information.
  */
+#include <iomanip>
 #include <sstream>
 
 #include <mlpack/core.hpp>
@@ -686,6 +687,83 @@ BOOST_AUTO_TEST_CASE(LoadArmaBinaryTest)
   remove("test_file.bin");
 }
 
+/**
+ * Make sure that mlpack mapped binary files are saved and loaded correctly,
+ * both through data::Load() and by mapping them.
+ */
+BOOST_AUTO_TEST_CASE(SaveLoadMappedBinaryTest)
+{
+  arma::mat test = "1 5;"
+                   "2 6;"
+                   "3 7;"
+                   "4 8;";
+
+  BOOST_REQUIRE(data::Save("test_file.mmb", test) == true);
+
+  // The file is never transposed.
+  arma::mat loaded;
+  BOOST_REQUIRE(data::Load("test_file.mmb", loaded) == true);
+
+  BOOST_REQUIRE_EQUAL(loaded.n_rows, 4);
+  BOOST_REQUIRE_EQUAL(loaded.n_cols, 2);
+  for (size_t i = 0; i < 8; i++)
+    BOOST_REQUIRE_CLOSE(loaded[i], (double) (i + 1), 1e-5);
+
+  data::MappedMatrix<double> mapped;
+  BOOST_REQUIRE(data::Load("test_file.mmb", mapped) == true);
+
+  BOOST_REQUIRE_EQUAL(mapped.Matrix().n_rows, 4);
+  BOOST_REQUIRE_EQUAL(mapped.Matrix().n_cols, 2);
+  for (size_t i = 0; i < 8; i++)
+    BOOST_REQUIRE_CLOSE(mapped.Matrix()[i], (double) (i + 1), 1e-5);
+
+  // The elements must be aligned to a cache line.
+  BOOST_REQUIRE_EQUAL((size_t) mapped.Matrix().memptr() % 64, 0);
+
+  // Modifying the mapped matrix must not change the file.
+  mapped.Matrix()(0, 0) = 10.0;
+  mapped.Unmap();
+  BOOST_REQUIRE_EQUAL(mapped.Matrix().n_elem, 0);
+
+  BOOST_REQUIRE(data::Load("test_file.mmb", loaded) == true);
+  BOOST_REQUIRE_CLOSE(loaded(0, 0), 1.0, 1e-5);
+
+  // Loading with the wrong element type must fail.
+  arma::fmat floatLoaded;
+  data::MappedMatrix<float> floatMapped;
+  BOOST_REQUIRE(data::Load("test_file.mmb", floatLoaded) == false);
+  BOOST_REQUIRE(data::Load("test_file.mmb", floatMapped) == false);
+
+  // Remove the file.
+  remove("test_file.mmb");
+}
+
+/**
+ * Make sure that a mapped binary file whose header claims a size so large that
+ * rows * cols overflows is rejected.
+ */
+BOOST_AUTO_TEST_CASE(LoadMappedBinaryOverflowTest)
+{
+  // 2^32 * 2^32 elements wrap around to 0.
+  const data::MappedBinaryHeader header =
+      data::MappedBinaryHeader::Create<double>(size_t(1) << 32,
+                                               size_t(1) << 32);
+  const double elements[8] = { 1, 2, 3, 4, 5, 6, 7, 8 };
+
+  std::ofstream ofs("test_file.mmb", std::ios::binary);
+  ofs.write((const char*) &header, sizeof(header));
+  ofs.write((const char*) elements, sizeof(elements));
+  ofs.close();
+
+  arma::mat loaded;
+  data::MappedMatrix<double> mapped;
+  BOOST_REQUIRE(data::Load("test_file.mmb", loaded) == false);
+  BOOST_REQUIRE(data::Load("test_file.mmb", mapped) == false);
+
+  // Remove the file.
+  remove("test_file.mmb");
+}
+
 /**
  * Make sure arma_binary is saved correctly.
  */
@@ -1727,6 +1805,74 @@ BOOST_AUTO_TEST_CASE(CategoricalNontransposedCSVLoadTest04)
     remove("test.csv");
 }
 
+/**
+ * Load a CSV that is large enough to be split into many chunks, with
+ * categories that first appear in different chunks, and make sure that the
+ * mappings and values are the same as if it were parsed line by line.
+ */
+BOOST_AUTO_TEST_CASE(LargeCategoricalCSVLoadTest)
+{
+  const size_t numLines = 400000;
+  vector<vector<string>> tokens(numLines, vector<string>(3));
+  fstream f;
+  f.open("test.csv", fstream::out);
+  for (size_t i = 0; i < numLines; ++i)
+  {
+    ostringstream number;
+    number << setprecision(17) << (0.37 * i - 1000.0);
+    tokens[i][0] = number.str();
+
+    // New categories keep appearing throughout the file.
+    const size_t category = (i % 3 == 0) ? i / 100 : (i * 7919) % (i / 100 + 1);
+    tokens[i][1] = "cat" + to_string(category);
+    tokens[i][2] = (i % 5 == 0) ? "\"a, b\"" : to_string(i % 7);
+
+    f << tokens[i][0] << ", " << tokens[i][1] << "," << tokens[i][2] << endl;
+  }
+  f.close();
+
+  arma::mat matrix;
+  DatasetInfo info;
+  data::Load("test.csv", matrix, info, true);
+
+  BOOST_REQUIRE_EQUAL(matrix.n_rows, 3);
+  BOOST_REQUIRE_EQUAL(matrix.n_cols, numLines);
+  BOOST_REQUIRE(info.Type(0) == Datatype::numeric);
+  BOOST_REQUIRE(info.Type(1) == Datatype::categorical);
+  BOOST_REQUIRE(info.Type(2) == Datatype::categorical);
+
+  // Compute the mappings in the order of the file.
+  vector<map<string, size_t>> mappings(3);
+  for (size_t i = 0; i < numLines; ++i)
+  {
+    // Numbers must be the same as with a stringstream extraction.
+    istringstream number(tokens[i][0]);
+    double value;
+    number >> value;
+    BOOST_REQUIRE_EQUAL(matrix(0, i), value);
+
+    for (size_t d = 1; d < 3; ++d)
+    {
+      if (mappings[d].count(tokens[i][d]) == 0)
+      {
+        const size_t id = mappings[d].size();
+        mappings[d][tokens[i][d]] = id;
+      }
+
+      BOOST_REQUIRE_EQUAL((size_t) matrix(d, i), mappings[d][tokens[i][d]]);
+    }
+  }
+
+  for (size_t d = 1; d < 3; ++d)
+  {
+    BOOST_REQUIRE_EQUAL(info.NumMappings(d), mappings[d].size());
+    for (auto& m : mappings[d])
+      BOOST_REQUIRE_EQUAL(info.UnmapString(m.second, d), m.first);
+  }
+
+  remove("test.csv");
+}
+
 /**
  * A harder test CSV based on the concerns in #658.
  */
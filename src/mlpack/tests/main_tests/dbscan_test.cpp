@@ -469,4 +469,59 @@ BOOST_AUTO_TEST_CASE(DBSCANRandomSelectionFlagTest)
   BOOST_REQUIRE_GT(arma::accu(orderedOutput != randomOutput), 0);
 }
 
+/**
+ * Check that the grid gives the same clusters as range search, up to the
+ * numbering of the clusters.
+ */
+BOOST_AUTO_TEST_CASE(DBSCANGridTest)
+{
+  arma::mat inputData;
+  if (!data::Load("iris.csv", inputData))
+    BOOST_FAIL("Unable to load dataset iris.csv!");
+
+  SetInputParam("input", inputData);
+
+  mlpackMain();
+
+  arma::Row<size_t> output;
+  output = std::move(CLI::GetParam<arma::Row<size_t>>("assignments"));
+
+  bindings::tests::CleanMemory();
+
+  CLI::GetSingleton().Parameters()["input"].wasPassed = false;
+
+  SetInputParam("input", inputData);
+  SetInputParam("grid", true);
+
+  mlpackMain();
+
+  arma::Row<size_t> gridOutput;
+  gridOutput = std::move(CLI::GetParam<arma::Row<size_t>>("assignments"));
+
+  BOOST_REQUIRE_EQUAL(output.n_elem, gridOutput.n_elem);
+  for (size_t i = 0; i < output.n_elem; ++i)
+  {
+    for (size_t j = i + 1; j < output.n_elem; ++j)
+    {
+      BOOST_REQUIRE_EQUAL(output[i] == output[j],
+          gridOutput[i] == gridOutput[j]);
+    }
+  }
+}
+
+/**
+ * Make sure that the grid can't be used with high-dimensional data.
+ */
+BOOST_AUTO_TEST_CASE(DBSCANGridDimensionalityTest)
+{
+  arma::mat inputData(5, 100, arma::fill::randu);
+
+  SetInputParam("input", std::move(inputData));
+  SetInputParam("grid", true);
+
+  Log::Fatal.ignoreInput = true;
+  BOOST_REQUIRE_THROW(mlpackMain(), std::runtime_error);
+  Log::Fatal.ignoreInput = false;
+}
+
 BOOST_AUTO_TEST_SUITE_END();
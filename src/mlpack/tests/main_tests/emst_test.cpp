@@ -89,6 +89,31 @@ BOOST_AUTO_TEST_CASE(EMSTNaiveOutputDimensionTest)
   BOOST_REQUIRE_EQUAL(CLI::GetParam<arma::mat>("output").n_cols, 999);
 }
 
+/**
+ * Make sure that the parallel mode gives the same output as the serial mode.
+ */
+BOOST_AUTO_TEST_CASE(EMSTParallelTest)
+{
+  arma::mat x;
+  if (!data::Load("test_data_3_1000.csv", x))
+    BOOST_FAIL("Cannot load test dataset test_data_3_1000.csv!");
+
+  SetInputParam("input", x);
+
+  mlpackMain();
+
+  const arma::mat serialOutput = CLI::GetParam<arma::mat>("output");
+
+  bindings::tests::CleanMemory();
+
+  SetInputParam("input", std::move(x));
+  SetInputParam("parallel", true);
+
+  mlpackMain();
+
+  CheckMatrices(serialOutput, CLI::GetParam<arma::mat>("output"));
+}
+
 /**
  * Ensure that we can't specify an invalid leaf size.
  */
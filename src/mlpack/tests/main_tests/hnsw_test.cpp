@@ -0,0 +1,116 @@
+/**
+ * @file hnsw_test.cpp
+ *
+ * Test mlpackMain() of hnsw_main.cpp.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#include <string>
+
+#define BINDING_TYPE BINDING_TYPE_TEST
+static const std::string testName = "HNSW";
+
+#include <mlpack/core.hpp>
+#include <mlpack/core/util/mlpack_main.hpp>
+#include "test_helper.hpp"
+#include <mlpack/methods/hnsw/hnsw_main.cpp>
+
+#include <boost/test/unit_test.hpp>
+#include "../test_tools.hpp"
+
+using namespace mlpack;
+
+struct HNSWTestFixture
+{
+ public:
+  HNSWTestFixture()
+  {
+    // Cache in the options for this program.
+    CLI::RestoreSettings(testName);
+  }
+
+  ~HNSWTestFixture()
+  {
+    // Clear the settings.
+    bindings::tests::CleanMemory();
+    CLI::ClearSettings();
+  }
+};
+
+BOOST_FIXTURE_TEST_SUITE(HNSWMainTest, HNSWTestFixture);
+
+/**
+ * Check that output neighbors and distances have valid dimensions.
+ */
+BOOST_AUTO_TEST_CASE(HNSWOutputDimensionTest)
+{
+  arma::mat reference = arma::randu<arma::mat>(5, 100);
+  arma::mat query = arma::randu<arma::mat>(5, 40);
+
+  SetInputParam("reference", std::move(reference));
+  SetInputParam("query", std::move(query));
+  SetInputParam("k", (int) 6);
+
+  mlpackMain();
+
+  BOOST_REQUIRE_EQUAL(CLI::GetParam<arma::Mat<size_t>>("neighbors").n_rows, 6);
+  BOOST_REQUIRE_EQUAL(CLI::GetParam<arma::Mat<size_t>>("neighbors").n_cols,
+                      40);
+  BOOST_REQUIRE_EQUAL(CLI::GetParam<arma::mat>("distances").n_rows, 6);
+  BOOST_REQUIRE_EQUAL(CLI::GetParam<arma::mat>("distances").n_cols, 40);
+}
+
+/**
+ * Ensure that k, max_neighbors, ef_construction and ef are checked.
+ */
+BOOST_AUTO_TEST_CASE(HNSWParamValidityTest)
+{
+  arma::mat reference = arma::randu<arma::mat>(5, 100);
+
+  const char* params[] = { "k", "max_neighbors", "ef_construction", "ef" };
+  for (size_t i = 0; i < 4; ++i)
+  {
+    SetInputParam("reference", reference);
+    SetInputParam("k", (int) 6);
+    SetInputParam(params[i], (int) -1);
+
+    Log::Fatal.ignoreInput = true;
+    BOOST_REQUIRE_THROW(mlpackMain(), std::runtime_error);
+    Log::Fatal.ignoreInput = false;
+
+    bindings::tests::CleanMemory();
+    CLI::ClearSettings();
+    CLI::RestoreSettings(testName);
+  }
+}
+
+/**
+ * Make sure that a saved model gives the same results as the model it was
+ * trained from.
+ */
+BOOST_AUTO_TEST_CASE(HNSWModelReuseTest)
+{
+  arma::mat reference = arma::randu<arma::mat>(5, 200);
+
+  SetInputParam("reference", std::move(reference));
+  SetInputParam("k", (int) 4);
+
+  mlpackMain();
+
+  arma::Mat<size_t> neighbors = CLI::GetParam<arma::Mat<size_t>>("neighbors");
+  arma::mat distances = CLI::GetParam<arma::mat>("distances");
+
+  SetInputParam("input_model",
+      std::move(CLI::GetParam<neighbor::HNSWSearch<>*>("output_model")));
+  CLI::GetSingleton().Parameters()["reference"].wasPassed = false;
+
+  mlpackMain();
+
+  CheckMatrices(neighbors, CLI::GetParam<arma::Mat<size_t>>("neighbors"));
+  CheckMatrices(distances, CLI::GetParam<arma::mat>("distances"));
+}
+
+BOOST_AUTO_TEST_SUITE_END();
@@ -87,4 +87,48 @@ BOOST_AUTO_TEST_CASE(LINFMetricTest)
                       lMetric.Evaluate(a2, b2), 1e-5);
 }
 
+// Make sure that BatchEvaluate() gives the same distances as Evaluate().
+template<typename MetricType, typename eT>
+void CheckBatchEvaluate(const size_t dims = 7)
+{
+  arma::Mat<eT> points(dims, 50, arma::fill::randn);
+  arma::Col<eT> point(dims, arma::fill::randn);
+
+  arma::Col<eT> distances;
+  MetricType::BatchEvaluate(point, points.cols(10, 39), distances);
+  BOOST_REQUIRE_EQUAL(distances.n_elem, 30);
+  for (size_t i = 0; i < distances.n_elem; ++i)
+  {
+    BOOST_REQUIRE_CLOSE(distances[i],
+        MetricType::Evaluate(point, points.col(10 + i)), 1e-3);
+  }
+
+  // A column of a matrix can be used as the point too.
+  MetricType::BatchEvaluate(points.col(0), points, distances);
+  BOOST_REQUIRE_EQUAL(distances.n_elem, 50);
+  BOOST_REQUIRE_SMALL(distances[0], (eT) 1e-5);
+  for (size_t i = 1; i < distances.n_elem; ++i)
+  {
+    BOOST_REQUIRE_CLOSE(distances[i],
+        MetricType::Evaluate(points.col(0), points.col(i)), 1e-3);
+  }
+}
+
+BOOST_AUTO_TEST_CASE(BatchEvaluateTest)
+{
+  CheckBatchEvaluate<ManhattanDistance, double>();
+  CheckBatchEvaluate<SquaredEuclideanDistance, double>();
+  CheckBatchEvaluate<EuclideanDistance, double>();
+  CheckBatchEvaluate<ChebyshevDistance, double>();
+  CheckBatchEvaluate<LMetric<3, true>, double>();
+  // Enough dimensions for the blocked L-infinity computation.
+  CheckBatchEvaluate<ChebyshevDistance, double>(20);
+
+  CheckBatchEvaluate<ManhattanDistance, float>();
+  CheckBatchEvaluate<SquaredEuclideanDistance, float>();
+  CheckBatchEvaluate<EuclideanDistance, float>();
+  CheckBatchEvaluate<ChebyshevDistance, float>();
+  CheckBatchEvaluate<ChebyshevDistance, float>(20);
+}
+
 BOOST_AUTO_TEST_SUITE_END();
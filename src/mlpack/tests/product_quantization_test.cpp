@@ -0,0 +1,205 @@
+/**
+ * @file product_quantization_test.cpp
+ *
+ * Tests for the ProductQuantizer and PQSearch classes.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#include <mlpack/core.hpp>
+#include <mlpack/methods/product_quantization/pq_search.hpp>
+#include <mlpack/methods/neighbor_search/neighbor_search.hpp>
+
+#include <boost/test/unit_test.hpp>
+#include "test_tools.hpp"
+#include "serialization.hpp"
+
+using namespace mlpack;
+using namespace mlpack::neighbor;
+
+BOOST_AUTO_TEST_SUITE(ProductQuantizationTest);
+
+/**
+ * Make sure that each point is encoded with the closest centroid of each
+ * subspace, and that decoding gives those centroids.  The dimensionality is not
+ * a multiple of the number of subspaces.
+ */
+BOOST_AUTO_TEST_CASE(ProductQuantizerEncodeDecodeTest)
+{
+  arma::mat data(7, 1500, arma::fill::randu);
+  ProductQuantizer<> quantizer(data, 3, 16);
+
+  BOOST_REQUIRE_EQUAL(quantizer.Dimensionality(), 7);
+  BOOST_REQUIRE_EQUAL(quantizer.NumSubspaces(), 3);
+  BOOST_REQUIRE_EQUAL(quantizer.SubspaceBegin(1), 3);
+  BOOST_REQUIRE_EQUAL(quantizer.SubspaceBegin(2), 5);
+
+  arma::Mat<unsigned char> codes;
+  quantizer.Encode(data, codes);
+  BOOST_REQUIRE_EQUAL(codes.n_rows, 3);
+  BOOST_REQUIRE_EQUAL(codes.n_cols, data.n_cols);
+
+  arma::mat decoded;
+  quantizer.Decode(codes, decoded);
+
+  for (size_t i = 0; i < data.n_cols; ++i)
+  {
+    for (size_t j = 0; j < 3; ++j)
+    {
+      const size_t begin = quantizer.SubspaceBegin(j);
+      const size_t end = quantizer.SubspaceBegin(j + 1);
+      const arma::vec point = data.col(i).subvec(begin, end - 1);
+      const arma::mat& codebook = quantizer.Codebook(j);
+
+      double minDistance = DBL_MAX;
+      for (size_t c = 0; c < codebook.n_cols; ++c)
+      {
+        minDistance = std::min(minDistance,
+            arma::accu(arma::square(point - codebook.col(c))));
+      }
+
+      BOOST_REQUIRE_LE(arma::accu(arma::square(point -
+          codebook.col(codes(j, i)))), minDistance + 1e-10);
+      for (size_t r = begin; r < end; ++r)
+        BOOST_REQUIRE_EQUAL(decoded(r, i), codebook(r - begin, codes(j, i)));
+    }
+  }
+}
+
+/**
+ * Make sure that the distances returned without re-ranking are the distances to
+ * the decoded reference points, and that they are the smallest ones.
+ */
+BOOST_AUTO_TEST_CASE(PQSearchDecodedDistanceTest)
+{
+  arma::mat referenceData(8, 1000, arma::fill::randu);
+  arma::mat queryData(8, 20, arma::fill::randu);
+
+  PQSearch<> pq(referenceData, 4, 32);
+  BOOST_REQUIRE_EQUAL(pq.NumPoints(), referenceData.n_cols);
+
+  arma::Mat<size_t> neighbors;
+  arma::mat distances;
+  pq.Search(queryData, 5, neighbors, distances);
+
+  arma::mat decoded;
+  pq.Quantizer().Decode(pq.Codes(), decoded);
+
+  for (size_t i = 0; i < queryData.n_cols; ++i)
+  {
+    arma::vec allDistances(decoded.n_cols);
+    for (size_t p = 0; p < decoded.n_cols; ++p)
+    {
+      allDistances[p] = metric::EuclideanDistance::Evaluate(queryData.col(i),
+          decoded.col(p));
+    }
+    allDistances = arma::sort(allDistances);
+
+    for (size_t j = 0; j < 5; ++j)
+    {
+      BOOST_REQUIRE_CLOSE(distances(j, i), metric::EuclideanDistance::Evaluate(
+          queryData.col(i), decoded.col(neighbors(j, i))), 1e-5);
+      BOOST_REQUIRE_CLOSE(distances(j, i), allDistances[j], 1e-5);
+    }
+  }
+}
+
+/**
+ * Make sure that re-ranking gives exact distances and high recall.
+ */
+BOOST_AUTO_TEST_CASE(PQSearchRerankTest)
+{
+  arma::mat referenceData(8, 2000, arma::fill::randu);
+  arma::mat queryData(8, 100, arma::fill::randu);
+  const size_t k = 5;
+
+  KNN knn(referenceData);
+  arma::Mat<size_t> trueNeighbors;
+  arma::mat trueDistances;
+  knn.Search(queryData, k, trueNeighbors, trueDistances);
+
+  PQSearch<> pq(referenceData, 4, 64);
+  arma::Mat<size_t> neighbors;
+  arma::mat distances;
+  pq.Search(queryData, k, neighbors, distances, referenceData, 100);
+
+  size_t found = 0;
+  for (size_t i = 0; i < queryData.n_cols; ++i)
+  {
+    for (size_t j = 0; j < k; ++j)
+    {
+      BOOST_REQUIRE_CLOSE(distances(j, i), metric::EuclideanDistance::Evaluate(
+          queryData.col(i), referenceData.col(neighbors(j, i))), 1e-5);
+      if (j > 0)
+        BOOST_REQUIRE_LE(distances(j - 1, i), distances(j, i));
+
+      for (size_t l = 0; l < k; ++l)
+        if (neighbors(j, i) == trueNeighbors(l, i))
+          ++found;
+    }
+  }
+
+  BOOST_REQUIRE_GE((double) found / trueNeighbors.n_elem, 0.9);
+}
+
+/**
+ * Make sure that adding the reference points in batches gives the same codes,
+ * and that a serialized model gives the same results.
+ */
+BOOST_AUTO_TEST_CASE(PQSearchAddSerializationTest)
+{
+  arma::mat referenceData(6, 600, arma::fill::randu);
+  arma::mat queryData(6, 20, arma::fill::randu);
+
+  PQSearch<> pq(referenceData, 3, 16);
+
+  PQSearch<> added(pq.Quantizer());
+  added.Add(referenceData.cols(0, 249));
+  added.Add(referenceData.cols(250, 599));
+  BOOST_REQUIRE_EQUAL(added.NumPoints(), referenceData.n_cols);
+  BOOST_REQUIRE_EQUAL(arma::accu(added.Codes() != pq.Codes()), 0);
+
+  PQSearch<> xmlPq, textPq, binaryPq;
+  SerializeObjectAll(pq, xmlPq, textPq, binaryPq);
+
+  arma::Mat<size_t> neighbors, xmlNeighbors, textNeighbors, binaryNeighbors;
+  arma::mat distances, xmlDistances, textDistances, binaryDistances;
+  pq.Search(queryData, 3, neighbors, distances);
+  xmlPq.Search(queryData, 3, xmlNeighbors, xmlDistances);
+  textPq.Search(queryData, 3, textNeighbors, textDistances);
+  binaryPq.Search(queryData, 3, binaryNeighbors, binaryDistances);
+
+  CheckMatrices(neighbors, xmlNeighbors, textNeighbors, binaryNeighbors);
+  CheckMatrices(distances, xmlDistances, textDistances, binaryDistances);
+}
+
+/**
+ * Make sure that invalid parameters and searches throw.
+ */
+BOOST_AUTO_TEST_CASE(PQSearchInvalidInputTest)
+{
+  arma::mat referenceData(4, 100, arma::fill::randu);
+
+  BOOST_REQUIRE_THROW(PQSearch<>(referenceData, 5), std::invalid_argument);
+  BOOST_REQUIRE_THROW(PQSearch<>(referenceData, 2, 300),
+      std::invalid_argument);
+  BOOST_REQUIRE_THROW(PQSearch<>(referenceData, 2, 101),
+      std::invalid_argument);
+
+  PQSearch<> pq(referenceData, 2, 8);
+  arma::Mat<size_t> neighbors;
+  arma::mat distances;
+  arma::mat queryData(3, 10, arma::fill::randu);
+  BOOST_REQUIRE_THROW(pq.Search(queryData, 3, neighbors, distances),
+      std::invalid_argument);
+
+  queryData.randu(4, 10);
+  BOOST_REQUIRE_THROW(pq.Search(queryData, 101, neighbors, distances),
+      std::invalid_argument);
+  BOOST_REQUIRE_THROW(pq.Search(queryData, 3, neighbors, distances,
+      referenceData.cols(0, 49), 10), std::invalid_argument);
+}
+
+BOOST_AUTO_TEST_SUITE_END();
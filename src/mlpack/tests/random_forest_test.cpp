@@ -11,6 +11,7 @@
  */
 #include <mlpack/core.hpp>
 #include <mlpack/methods/random_forest/random_forest.hpp>
+#include <mlpack/methods/random_forest/flat_forest.hpp>
 #include <mlpack/methods/decision_tree/random_dimension_select.hpp>
 
 #include <boost/test/unit_test.hpp>
@@ -487,4 +488,87 @@ BOOST_AUTO_TEST_CASE(DifferentTreesTest)
   BOOST_REQUIRE_EQUAL(success, true);
 }
 
+/**
+ * Make sure that a FlatForest gives the same results as the random forest it
+ * was compiled from, on numeric data.
+ */
+BOOST_AUTO_TEST_CASE(FlatForestNumericTest)
+{
+  arma::mat dataset;
+  data::Load("vc2.csv", dataset);
+  arma::Row<size_t> labels;
+  data::Load("vc2_labels.txt", labels);
+
+  RandomForest<> rf(dataset, labels, 3, 20 /* 20 trees */, 1);
+  FlatForest flat(rf);
+  BOOST_REQUIRE_EQUAL(flat.NumTrees(), 20);
+  BOOST_REQUIRE_EQUAL(flat.NumClasses(), 3);
+
+  arma::Row<size_t> predictions, flatPredictions;
+  arma::mat probabilities, flatProbabilities;
+  rf.Classify(dataset, predictions, probabilities);
+  flat.Classify(dataset, flatPredictions, flatProbabilities);
+
+  CheckMatrices(predictions, flatPredictions);
+  CheckMatrices(probabilities, flatProbabilities);
+
+  // A single decision tree can be compiled too.
+  FlatForest flatTree(rf.Tree(0));
+  rf.Tree(0).Classify(dataset, predictions, probabilities);
+  flatTree.Classify(dataset, flatPredictions, flatProbabilities);
+
+  CheckMatrices(predictions, flatPredictions);
+  CheckMatrices(probabilities, flatProbabilities);
+
+  // Make sure the compiled forest can be serialized.
+  FlatForest xmlFlat, textFlat, binaryFlat;
+  SerializeObjectAll(flat, xmlFlat, textFlat, binaryFlat);
+
+  arma::Row<size_t> xmlPredictions, textPredictions, binaryPredictions;
+  flat.Classify(dataset, flatPredictions);
+  xmlFlat.Classify(dataset, xmlPredictions);
+  textFlat.Classify(dataset, textPredictions);
+  binaryFlat.Classify(dataset, binaryPredictions);
+
+  CheckMatrices(flatPredictions, xmlPredictions, textPredictions,
+      binaryPredictions);
+}
+
+/**
+ * Make sure that a FlatForest gives the same results as the random forest it
+ * was compiled from, on categorical data.
+ */
+BOOST_AUTO_TEST_CASE(FlatForestCategoricalTest)
+{
+  arma::mat d;
+  arma::Row<size_t> l;
+  data::DatasetInfo di;
+  MockCategoricalData(d, l, di);
+
+  RandomForest<> rf(d, di, l, 5, 10 /* 10 trees */, 1, 1e-7, 0,
+      MultipleRandomDimensionSelect(4));
+  FlatForest flat(rf);
+
+  arma::Row<size_t> predictions, flatPredictions;
+  arma::mat probabilities, flatProbabilities;
+  rf.Classify(d, predictions, probabilities);
+  flat.Classify(d, flatPredictions, flatProbabilities);
+
+  CheckMatrices(predictions, flatPredictions);
+  CheckMatrices(probabilities, flatProbabilities);
+}
+
+/**
+ * An empty FlatForest can't classify anything.
+ */
+BOOST_AUTO_TEST_CASE(FlatForestEmptyClassifyTest)
+{
+  FlatForest flat;
+  arma::mat points(10, 100, arma::fill::randu);
+  arma::Row<size_t> predictions;
+
+  BOOST_REQUIRE_THROW(flat.Classify(points, predictions),
+      std::invalid_argument);
+}
+
 BOOST_AUTO_TEST_SUITE_END();
@@ -15,6 +15,7 @@
 #include <mlpack/methods/range_search/rs_model.hpp>
 #include <boost/test/unit_test.hpp>
 #include "test_tools.hpp"
+#include "serialization.hpp"
 
 using namespace mlpack;
 using namespace mlpack::range;
@@ -1049,6 +1050,92 @@ BOOST_AUTO_TEST_CASE(DualBallTreeTest2)
   }
 }
 
+/**
+ * Compare the CSR results of a range search with the regular results of a
+ * naive search.
+ */
+void CheckCSRResults(const arma::Col<size_t>& offsets,
+                     const arma::Col<size_t>& neighbors,
+                     const arma::vec& distances,
+                     const vector<vector<size_t>>& naiveNeighbors,
+                     const vector<vector<double>>& naiveDistances)
+{
+  BOOST_REQUIRE_EQUAL(offsets.n_elem, naiveNeighbors.size() + 1);
+  BOOST_REQUIRE_EQUAL(offsets[0], 0);
+  BOOST_REQUIRE_EQUAL(neighbors.n_elem, offsets[naiveNeighbors.size()]);
+  BOOST_REQUIRE_EQUAL(distances.n_elem, offsets[naiveNeighbors.size()]);
+
+  vector<vector<size_t>> csrNeighbors(naiveNeighbors.size());
+  vector<vector<double>> csrDistances(naiveNeighbors.size());
+  for (size_t i = 0; i < naiveNeighbors.size(); ++i)
+  {
+    for (size_t j = offsets[i]; j < offsets[i + 1]; ++j)
+    {
+      csrNeighbors[i].push_back(neighbors[j]);
+      csrDistances[i].push_back(distances[j]);
+    }
+  }
+
+  vector<vector<pair<double, size_t>>> sortedCSR, sortedNaive;
+  SortResults(csrNeighbors, csrDistances, sortedCSR);
+  SortResults(naiveNeighbors, naiveDistances, sortedNaive);
+
+  for (size_t i = 0; i < sortedNaive.size(); ++i)
+  {
+    BOOST_REQUIRE_EQUAL(sortedCSR[i].size(), sortedNaive[i].size());
+    for (size_t j = 0; j < sortedNaive[i].size(); ++j)
+    {
+      BOOST_REQUIRE_EQUAL(sortedCSR[i][j].second, sortedNaive[i][j].second);
+      BOOST_REQUIRE_CLOSE(sortedCSR[i][j].first, sortedNaive[i][j].first,
+          1e-5);
+    }
+  }
+}
+
+/**
+ * Make sure that the CSR overloads of Search() give the same results as the
+ * regular naive search, in every search mode, for both the monochromatic and
+ * the bichromatic case.
+ */
+BOOST_AUTO_TEST_CASE(CSRSearchTest)
+{
+  arma::mat referenceSet = arma::randu<arma::mat>(3, 800);
+  arma::mat querySet = arma::randu<arma::mat>(3, 500);
+  const Range r(0.05, 0.3);
+
+  RangeSearch<> naive(referenceSet, true);
+  vector<vector<size_t>> naiveNeighbors, naiveMonoNeighbors;
+  vector<vector<double>> naiveDistances, naiveMonoDistances;
+  naive.Search(querySet, r, naiveNeighbors, naiveDistances);
+  naive.Search(r, naiveMonoNeighbors, naiveMonoDistances);
+
+  // Test naive, single-tree, and dual-tree mode.
+  for (size_t mode = 0; mode < 3; ++mode)
+  {
+    RangeSearch<> rs(referenceSet, (mode == 0), (mode == 1));
+
+    arma::Col<size_t> offsets, neighbors;
+    arma::vec distances;
+    rs.Search(querySet, r, offsets, neighbors, distances);
+    CheckCSRResults(offsets, neighbors, distances, naiveNeighbors,
+        naiveDistances);
+
+    rs.Search(r, offsets, neighbors, distances);
+    CheckCSRResults(offsets, neighbors, distances, naiveMonoNeighbors,
+        naiveMonoDistances);
+  }
+
+  // Also check the cover tree, which does not rearrange the dataset and caches
+  // base cases in the reference tree (so it is searched on one thread).
+  RangeSearch<EuclideanDistance, arma::mat, StandardCoverTree> coverRS(
+      referenceSet, false, true);
+  arma::Col<size_t> offsets, neighbors;
+  arma::vec distances;
+  coverRS.Search(querySet, r, offsets, neighbors, distances);
+  CheckCSRResults(offsets, neighbors, distances, naiveNeighbors,
+      naiveDistances);
+}
+
 /**
  * Make sure that no results are returned when we build a range search object
  * with no reference set.
@@ -1417,6 +1504,134 @@ BOOST_AUTO_TEST_CASE(RSModelMonochromaticTest)
   }
 }
 
+/**
+ * Check the results of the given model against brute-force search on the
+ * given points, which have the given indices.
+ */
+void CheckModifiedRSModel(RSModel& model,
+                          const arma::mat& queryData,
+                          const arma::mat& points,
+                          const arma::Col<size_t>& indices)
+{
+  RangeSearch<> rs(points, true);
+  const Range range(0.1, 0.3);
+
+  vector<vector<size_t>> baselineNeighbors, neighbors;
+  vector<vector<double>> baselineDistances, distances;
+  vector<vector<pair<double, size_t>>> baselineSorted, sorted;
+
+  for (size_t mono = 0; mono < 2; ++mono)
+  {
+    if (mono == 0)
+    {
+      rs.Search(queryData, range, baselineNeighbors, baselineDistances);
+      arma::mat queryCopy(queryData);
+      model.Search(std::move(queryCopy), range, neighbors, distances);
+    }
+    else
+    {
+      // The monochromatic search is over the current points, in order of
+      // their indices.
+      rs.Search(range, baselineNeighbors, baselineDistances);
+      model.Search(range, neighbors, distances);
+    }
+
+    for (size_t i = 0; i < baselineNeighbors.size(); ++i)
+      for (size_t j = 0; j < baselineNeighbors[i].size(); ++j)
+        baselineNeighbors[i][j] = indices[baselineNeighbors[i][j]];
+
+    SortResults(baselineNeighbors, baselineDistances, baselineSorted);
+    SortResults(neighbors, distances, sorted);
+
+    BOOST_REQUIRE_EQUAL(sorted.size(), baselineSorted.size());
+    for (size_t i = 0; i < sorted.size(); ++i)
+    {
+      BOOST_REQUIRE_EQUAL(sorted[i].size(), baselineSorted[i].size());
+      for (size_t j = 0; j < sorted[i].size(); ++j)
+      {
+        BOOST_REQUIRE_EQUAL(sorted[i][j].second, baselineSorted[i][j].second);
+        BOOST_REQUIRE_CLOSE(sorted[i][j].first, baselineSorted[i][j].first,
+            1e-5);
+      }
+    }
+  }
+}
+
+/**
+ * Make sure that an RSModel with inserted and deleted points returns the same
+ * results as brute-force search on the current points, before and after the
+ * tree is rebuilt and the model is serialized.
+ */
+BOOST_AUTO_TEST_CASE(RSModelInsertDeleteTest)
+{
+  arma::mat referenceData = arma::randu<arma::mat>(3, 300);
+  arma::mat newData = arma::randu<arma::mat>(3, 40);
+  arma::mat queryData = arma::randu<arma::mat>(3, 50);
+
+  const RSModel::TreeTypes treeTypes[] = { RSModel::TreeTypes::KD_TREE,
+      RSModel::TreeTypes::BALL_TREE, RSModel::TreeTypes::COVER_TREE };
+  for (size_t t = 0; t < 3; ++t)
+  {
+    for (size_t singleMode = 0; singleMode < 2; ++singleMode)
+    {
+      RSModel model(treeTypes[t]);
+      arma::mat referenceCopy(referenceData);
+      model.BuildModel(std::move(referenceCopy), 10, false, singleMode == 1);
+      model.RebuildFraction() = 1.0;
+
+      // Delete every third point of the reference set, and insert new points.
+      for (size_t i = 0; i < referenceData.n_cols; i += 3)
+        model.Delete(i);
+      model.Insert(newData);
+      model.Delete(305);
+
+      BOOST_REQUIRE_THROW(model.Delete(0), std::invalid_argument);
+      BOOST_REQUIRE_THROW(model.Delete(340), std::invalid_argument);
+      BOOST_REQUIRE_EQUAL(model.PendingChanges(), 139);
+
+      arma::mat points(3, 239);
+      arma::Col<size_t> indices(239);
+      size_t col = 0;
+      for (size_t i = 0; i < referenceData.n_cols; ++i)
+      {
+        if (i % 3 != 0)
+        {
+          points.col(col) = referenceData.col(i);
+          indices[col++] = i;
+        }
+      }
+      for (size_t i = 0; i < newData.n_cols; ++i)
+      {
+        if (i != 5)
+        {
+          points.col(col) = newData.col(i);
+          indices[col++] = 300 + i;
+        }
+      }
+
+      CheckModifiedRSModel(model, queryData, points, indices);
+
+      // The indices must not change when the tree is rebuilt.
+      model.Rebuild();
+      BOOST_REQUIRE_EQUAL(model.PendingChanges(), 0);
+      BOOST_REQUIRE_EQUAL(model.Dataset().n_cols, 239);
+      CheckModifiedRSModel(model, queryData, points, indices);
+
+      // Delete a point of the rebuilt tree and check the serialized models.
+      model.Delete(4);
+      points.shed_col(2);
+      indices.shed_row(2);
+
+      RSModel xmlModel, textModel, binaryModel;
+      SerializeObjectAll(model, xmlModel, textModel, binaryModel);
+      CheckModifiedRSModel(model, queryData, points, indices);
+      CheckModifiedRSModel(xmlModel, queryData, points, indices);
+      CheckModifiedRSModel(textModel, queryData, points, indices);
+      CheckModifiedRSModel(binaryModel, queryData, points, indices);
+    }
+  }
+}
+
 /**
  * Make sure that the neighborPtr matrix isn't accidentally deleted.
  * See issue #478.
@@ -1372,6 +1372,171 @@ BOOST_AUTO_TEST_CASE(RStarTreeSplitTest)
       0.9, 1e-15);
 }
 
+/**
+ * Check the structure of a bulk loaded tree: all the points must be held, the
+ * bounds must be exact and the leaves must all be on the same level.
+ */
+template<typename TreeType>
+void CheckBulkLoadedTree(const TreeType& tree, const size_t numPoints)
+{
+  BOOST_REQUIRE_EQUAL(tree.NumDescendants(), numPoints);
+
+  CheckContainment(tree);
+  CheckExactContainment(tree);
+  CheckHierarchy(tree);
+  CheckNumDescendants(tree);
+
+  BOOST_REQUIRE_EQUAL(GetMinLevel(tree), GetMaxLevel(tree));
+  BOOST_REQUIRE_EQUAL(tree.TreeDepth(), GetMinLevel(tree));
+}
+
+// Make sure that a bulk loaded R tree is valid, fully packed, and gives the
+// same results as a naive search.
+BOOST_AUTO_TEST_CASE(RTreeBulkLoadTest)
+{
+  arma::mat dataset;
+  dataset.randu(8, 1000); // 1000 points in 8 dimensions.
+
+  typedef RTree<EuclideanDistance, NeighborSearchStat<NearestNeighborSort>,
+      arma::mat> TreeType;
+  TreeType tree(dataset, TreeType::BulkLoadTag(), 20, 6, 5, 2);
+
+  CheckBulkLoadedTree(tree, 1000);
+  CheckFills(tree);
+
+  // With 1000 points, every leaf is full.
+  BOOST_REQUIRE_EQUAL(tree.TreeDepth(), 4);
+
+  arma::Mat<size_t> neighbors1;
+  arma::mat distances1;
+  arma::Mat<size_t> neighbors2;
+  arma::mat distances2;
+
+  NeighborSearch<NearestNeighborSort, metric::LMetric<2, true>, arma::mat,
+      RTree> knn1(std::move(tree), SINGLE_TREE_MODE);
+  knn1.Search(5, neighbors1, distances1);
+
+  KNN knn2(dataset, NAIVE_MODE);
+  knn2.Search(5, neighbors2, distances2);
+
+  for (size_t i = 0; i < neighbors1.size(); i++)
+  {
+    BOOST_REQUIRE_EQUAL(neighbors1[i], neighbors2[i]);
+    BOOST_REQUIRE_EQUAL(distances1[i], distances2[i]);
+  }
+}
+
+// Make sure that the Hilbert values of a bulk loaded Hilbert R tree are sorted
+// and in sync with the points.
+BOOST_AUTO_TEST_CASE(HilbertRTreeBulkLoadTest)
+{
+  arma::mat dataset;
+  dataset.randu(8, 1000); // 1000 points in 8 dimensions.
+
+  typedef HilbertRTree<EuclideanDistance,
+      NeighborSearchStat<NearestNeighborSort>, arma::mat> TreeType;
+  TreeType tree(dataset, TreeType::BulkLoadTag(), 20, 6, 5, 2);
+
+  CheckBulkLoadedTree(tree, 1000);
+  CheckFills(tree);
+  CheckHilbertValue(tree);
+  CheckDiscreteHilbertValueSync(tree);
+  CheckHilbertOrdering(tree);
+}
+
+// Make sure that the children of bulk loaded R+ and R++ trees do not overlap.
+BOOST_AUTO_TEST_CASE(RPlusTreeBulkLoadTest)
+{
+  arma::mat dataset;
+  dataset.randu(8, 1000); // 1000 points in 8 dimensions.
+
+  typedef RPlusTree<EuclideanDistance,
+      NeighborSearchStat<NearestNeighborSort>, arma::mat> TreeType;
+  TreeType rPlusTree(dataset, TreeType::BulkLoadTag(), 20, 6, 5, 2);
+
+  CheckBulkLoadedTree(rPlusTree, 1000);
+  CheckFills(rPlusTree);
+  CheckOverlap(rPlusTree);
+
+  typedef RPlusPlusTree<EuclideanDistance,
+      NeighborSearchStat<NearestNeighborSort>, arma::mat> PlusPlusTreeType;
+  PlusPlusTreeType rPlusPlusTree(dataset, PlusPlusTreeType::BulkLoadTag(), 20,
+      6, 5, 2);
+
+  CheckBulkLoadedTree(rPlusPlusTree, 1000);
+  CheckFills(rPlusPlusTree);
+  CheckRPlusPlusTreeBound(rPlusPlusTree);
+}
+
+/**
+ * Bulk load a tree, then delete and insert points, and make sure that the tree
+ * stays valid and gives the same results as a naive search.
+ */
+template<template<typename, typename, typename> class TreeType>
+void CheckBulkLoadedTreeUpdates()
+{
+  const size_t numIter = 50;
+  arma::mat dataset;
+  dataset.randu(8, 1000); // 1000 points in 8 dimensions.
+
+  typedef TreeType<EuclideanDistance, NeighborSearchStat<NearestNeighborSort>,
+      arma::mat> Tree;
+  Tree tree(dataset, typename Tree::BulkLoadTag(), 20, 6, 5, 2);
+
+  for (size_t i = 0; i < numIter; i++)
+    tree.DeletePoint(999 - i);
+
+  CheckContainment(tree);
+  CheckExactContainment(tree);
+  CheckNumDescendants(tree);
+  BOOST_REQUIRE_EQUAL(tree.NumDescendants(), 1000 - numIter);
+
+  // Replace the deleted points with new ones.
+  arma::mat tmpData;
+  tmpData.randu(8, numIter);
+  for (size_t i = 0; i < numIter; i++)
+  {
+    tree.Dataset().col(1000 - numIter + i) = tmpData.col(i);
+    dataset.col(1000 - numIter + i) = tmpData.col(i);
+    tree.InsertPoint(1000 - numIter + i);
+  }
+
+  CheckContainment(tree);
+  CheckExactContainment(tree);
+  CheckNumDescendants(tree);
+  BOOST_REQUIRE_EQUAL(tree.NumDescendants(), 1000);
+  BOOST_REQUIRE_EQUAL(GetMinLevel(tree), GetMaxLevel(tree));
+
+  arma::Mat<size_t> neighbors1;
+  arma::mat distances1;
+  arma::Mat<size_t> neighbors2;
+  arma::mat distances2;
+
+  NeighborSearch<NearestNeighborSort, metric::LMetric<2, true>, arma::mat,
+      TreeType> knn1(std::move(tree), SINGLE_TREE_MODE);
+  knn1.Search(5, neighbors1, distances1);
+
+  KNN knn2(dataset, NAIVE_MODE);
+  knn2.Search(5, neighbors2, distances2);
+
+  for (size_t i = 0; i < neighbors1.size(); i++)
+  {
+    BOOST_REQUIRE_EQUAL(neighbors1[i], neighbors2[i]);
+    BOOST_REQUIRE_EQUAL(distances1[i], distances2[i]);
+  }
+}
+
+// Make sure that bulk loaded trees still support insertion and deletion.
+BOOST_AUTO_TEST_CASE(BulkLoadedTreeUpdateTest)
+{
+  CheckBulkLoadedTreeUpdates<RTree>();
+  CheckBulkLoadedTreeUpdates<RStarTree>();
+  CheckBulkLoadedTreeUpdates<XTree>();
+  CheckBulkLoadedTreeUpdates<HilbertRTree>();
+  CheckBulkLoadedTreeUpdates<RPlusTree>();
+  CheckBulkLoadedTreeUpdates<RPlusPlusTree>();
+}
+
 BOOST_AUTO_TEST_CASE(RectangleTreeMoveDatasetTest)
 {
   arma::mat dataset = arma::randu<arma::mat>(3, 1000);
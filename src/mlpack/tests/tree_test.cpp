@@ -1803,6 +1803,77 @@ BOOST_AUTO_TEST_CASE(BinarySpaceTreeMoveConstructorTest)
   BOOST_REQUIRE_EQUAL(tree2.NumChildren(), 2);
 }
 
+// Make sure that the given trees have the same structure and bounds, and that
+// the parent pointers of the first tree are correct.
+template<typename TreeType>
+void CheckSameTree(const TreeType& node, const TreeType& other)
+{
+  BOOST_REQUIRE_EQUAL(node.Begin(), other.Begin());
+  BOOST_REQUIRE_EQUAL(node.Count(), other.Count());
+  BOOST_REQUIRE_EQUAL(node.NumChildren(), other.NumChildren());
+  BOOST_REQUIRE_EQUAL(&node.Dataset(), &node.Parent()->Dataset());
+  for (size_t d = 0; d < node.Bound().Dim(); ++d)
+  {
+    BOOST_REQUIRE_EQUAL(node.Bound()[d].Lo(), other.Bound()[d].Lo());
+    BOOST_REQUIRE_EQUAL(node.Bound()[d].Hi(), other.Bound()[d].Hi());
+  }
+
+  for (size_t i = 0; i < node.NumChildren(); ++i)
+  {
+    BOOST_REQUIRE_EQUAL(node.Child(i).Parent(), &node);
+    CheckSameTree(node.Child(i), other.Child(i));
+  }
+}
+
+/**
+ * Make sure that compacting a tree, in both layouts, does not change it, and
+ * that all nodes below the root are stored contiguously.
+ */
+BOOST_AUTO_TEST_CASE(BinarySpaceTreeCompactTest)
+{
+  typedef KDTree<EuclideanDistance, EmptyStatistic, arma::mat> TreeType;
+
+  arma::mat dataset(4, 2000);
+  dataset.randu();
+
+  TreeType tree(dataset, 5);
+  TreeType original(tree);
+  BOOST_REQUIRE(!tree.IsCompact());
+
+  tree.Compact();
+  BOOST_REQUIRE(tree.IsCompact());
+  for (size_t i = 0; i < tree.NumChildren(); ++i)
+    CheckSameTree(tree.Child(i), original.Child(i));
+
+  // In breadth-first order, the children of the root are the first two nodes.
+  BOOST_REQUIRE_EQUAL(&tree.Child(1), &tree.Child(0) + 1);
+  BOOST_REQUIRE_EQUAL(&tree.Child(0).Child(0), &tree.Child(0) + 2);
+
+  // Compact the tree again, in the other order.
+  tree.Compact(VAN_EMDE_BOAS_LAYOUT);
+  BOOST_REQUIRE(tree.IsCompact());
+  for (size_t i = 0; i < tree.NumChildren(); ++i)
+    CheckSameTree(tree.Child(i), original.Child(i));
+
+  // Copies and moves of the tree must still work.
+  TreeType copy(tree);
+  BOOST_REQUIRE(!copy.IsCompact());
+  for (size_t i = 0; i < copy.NumChildren(); ++i)
+    CheckSameTree(copy.Child(i), original.Child(i));
+
+  TreeType moved(std::move(tree));
+  BOOST_REQUIRE(moved.IsCompact());
+  BOOST_REQUIRE(!tree.IsCompact());
+  for (size_t i = 0; i < moved.NumChildren(); ++i)
+    CheckSameTree(moved.Child(i), original.Child(i));
+
+  copy = std::move(moved);
+  BOOST_REQUIRE(copy.IsCompact());
+
+  // Only the root can be compacted.
+  BOOST_REQUIRE_THROW(copy.Child(0).Compact(), std::invalid_argument);
+}
+
 template<typename TreeType>
 void RecurseTreeCountLeaves(const TreeType& node, arma::vec& counts)
 {
@@ -1951,6 +2022,58 @@ BOOST_AUTO_TEST_CASE(CoverTreeConstructionTest)
   // implementation.
 }
 
+// Ensure that two cover trees built on the same data have the same structure.
+template<typename TreeType>
+void CheckSameCoverTree(const TreeType& a, const TreeType& b)
+{
+  BOOST_REQUIRE_EQUAL(a.Point(), b.Point());
+  BOOST_REQUIRE_EQUAL(a.Scale(), b.Scale());
+  BOOST_REQUIRE_EQUAL(a.NumDescendants(), b.NumDescendants());
+  BOOST_REQUIRE_EQUAL(a.NumChildren(), b.NumChildren());
+  BOOST_REQUIRE_CLOSE(a.FurthestDescendantDistance(),
+      b.FurthestDescendantDistance(), 1e-5);
+
+  for (size_t i = 0; i < a.NumChildren(); ++i)
+    CheckSameCoverTree(a.Child(i), b.Child(i));
+}
+
+#ifdef HAS_OPENMP
+
+/**
+ * Make sure that a cover tree built with several threads is valid, and is the
+ * same as the tree built with one thread.
+ */
+BOOST_AUTO_TEST_CASE(ParallelCoverTreeConstructionTest)
+{
+  // Enough points that the children near the root are built in parallel.
+  arma::mat dataset;
+  dataset.randu(3, 20000);
+
+  typedef StandardCoverTree<EuclideanDistance, EmptyStatistic, arma::mat>
+      TreeType;
+  TreeType tree(dataset);
+
+  const size_t prevNumThreads = omp_get_max_threads();
+  omp_set_num_threads(1);
+  TreeType serialTree(dataset);
+  omp_set_num_threads(prevNumThreads);
+
+  arma::vec counts;
+  counts.zeros(20000);
+  RecurseTreeCountLeaves(tree, counts);
+
+  for (size_t i = 0; i < 20000; ++i)
+    BOOST_REQUIRE_EQUAL(counts[i], 1);
+
+  CheckSelfChild<TreeType>(tree);
+  CheckCovering<TreeType, LMetric<2, true> >(tree);
+
+  BOOST_REQUIRE_EQUAL(tree.DistanceComps(), serialTree.DistanceComps());
+  CheckSameCoverTree(tree, serialTree);
+}
+
+#endif
+
 /**
  * Create a cover tree on sparse data and make sure it's accurate.
  */